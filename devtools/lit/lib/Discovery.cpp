@@ -17,6 +17,7 @@
 #include <iostream>
 #include "formats/Base.h"
 #include "Run.h"
+#include "Utils.h"
 #include "LitTestCase.h"
 #include "CfgSetterPluginLoader.h"
 #include "polarphp/basic/adt/StringRef.h"
@@ -284,17 +285,15 @@ TestList get_tests_in_suite(TestSuitePointer testSuite, LitConfigPointer litConf
    if (lc->getTestFormat() && lc->getTestFormat()->needSearchAgain()) {
       tests = lc->getTestFormat()->getTestsInDirectory(testSuite, pathInSuite, litConfig, lc);
    }
-   for(auto& p: fs::directory_iterator(sourcePath)) {
-      const fs::path &path = p.path();
+   for (const DirectoryEntry &entry : crawl_directory(sourcePath, false)) {
+      fs::path path(entry.path);
       std::string filename = path.filename();
       if (filename == "Output" ||
-          filename == ".svn" ||
-          filename == ".git" ||
           lc->getExcludes().find(filename) != lc->getExcludes().end()) {
          continue;
       }
       // Ignore non-directories.
-      if (!fs::is_directory(path)) {
+      if (!entry.isDirectory) {
          continue;
       }
       // Check for nested test suites, first in the execpath in case there is a
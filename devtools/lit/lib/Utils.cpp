@@ -13,12 +13,14 @@
 #include "ProcessUtils.h"
 #include "polarphp/basic/adt/ArrayRef.h"
 #include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/utils/DirectoryCrawler.h"
 #include "polarphp/utils/OptionalError.h"
 #include "LitConfig.h"
 #include <cmath>
 #include <iostream>
 #include <thread>
 #include <atomic>
+#include <mutex>
 #include <algorithm>
 #include <cctype>
 #include <locale>
@@ -28,6 +30,9 @@ namespace lit {
 
 using polar::basic::StringRef;
 using polar::basic::ArrayRef;
+using polar::utils::CrawlEntry;
+using polar::utils::DirectoryCrawler;
+using polar::utils::cant_fail;
 using polar::utils::OptionalError;
 
 const char *sg_emptyStr = "";
@@ -105,8 +110,52 @@ bool check_file_have_ext(const std::string &filename, const std::set<std::string
    return false;
 }
 
+/// The crawler shared by all of lit. Version control directories never hold
+/// tests, so it does not read them at all.
+DirectoryCrawler &get_shared_crawler()
+{
+   static DirectoryCrawler crawler;
+   static bool initialized = []() {
+      // Patterns match paths relative to the crawled directory, so the
+      // directories are excluded at the top level and below it.
+      for (const char *pattern : {".git", "*/.git", ".svn", "*/.svn"}) {
+         cant_fail(crawler.addExcludePattern(pattern));
+      }
+      return true;
+   }();
+   (void) initialized;
+   return crawler;
+}
+
 } // anonymous namespace
 
+std::vector<DirectoryEntry> crawl_directory(const std::string &dirname, bool recursive,
+                                            bool skipHidden)
+{
+   DirectoryCrawler &crawler = get_shared_crawler();
+   // The crawler runs one crawl at a time, and its options must not change
+   // while it runs.
+   static std::mutex crawlerLock;
+   std::vector<CrawlEntry> found;
+   {
+      std::lock_guard<std::mutex> locker(crawlerLock);
+      crawler.setRecursive(recursive);
+      crawler.setSkipHiddenEntries(skipHidden);
+      found = crawler.crawl({dirname});
+   }
+   std::vector<DirectoryEntry> entries;
+   entries.reserve(found.size());
+   for (CrawlEntry &entry : found) {
+      if (entry.error) {
+         continue;
+      }
+      bool isDirectory = entry.type == polar::fs::FileType::directory_file ||
+            (entry.type == polar::fs::FileType::symlink_file && stdfs::is_directory(entry.path));
+      entries.push_back(DirectoryEntry{std::move(entry.path), isDirectory});
+   }
+   return entries;
+}
+
 std::list<std::string> listdir_files(const std::string &dirname,
                                      const std::set<std::string> &suffixes,
                                      const std::set<std::string> &excludeFilenames)
@@ -116,14 +165,14 @@ std::list<std::string> listdir_files(const std::string &dirname,
       return {};
    }
    std::list<std::string> files;
-   for (const stdfs::directory_entry &entry: stdfs::recursive_directory_iterator(dir)) {
-      std::string filename = entry.path().string();
-      if (entry.is_directory() || filename[0] == '.' ||
+   for (DirectoryEntry &entry : crawl_directory(dirname, true)) {
+      std::string &filename = entry.path;
+      if (filename[0] == '.' || entry.isDirectory ||
           excludeFilenames.find(filename) != excludeFilenames.end() ||
           !check_file_have_ext(filename, suffixes)) {
          continue;
       }
-      files.push_back(filename);
+      files.push_back(std::move(filename));
    }
    return files;
 }
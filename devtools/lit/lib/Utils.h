@@ -19,6 +19,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <vector>
 #include <cstring>
 #include "LitGlobal.h"
 
@@ -47,6 +48,22 @@ inline bool mkdir_p(const std::string &path, std::error_code& ec)
    return stdfs::create_directories(path, ec);
 }
 
+/// A file or directory found by crawl_directory.
+struct DirectoryEntry
+{
+   std::string path;
+   /// Whether the entry is a directory or a symbolic link to one.
+   bool isDirectory;
+};
+
+/// Reads \p dirname, and its subdirectories if \p recursive is set, with the
+/// directory crawler shared by all of lit, so that test discovery runs on a
+/// single thread pool. Returns the entries sorted by path, directories that
+/// cannot be read are skipped. .git and .svn directories are neither read
+/// nor reported.
+std::vector<DirectoryEntry> crawl_directory(const std::string &dirname, bool recursive,
+                                            bool skipHidden = false);
+
 std::list<std::string> listdir_files(const std::string &dirname,
                                      const std::set<std::string> &suffixes = {""},
                                      const std::set<std::string> &excludeFilenames = {});
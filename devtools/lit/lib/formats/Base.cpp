@@ -41,16 +41,16 @@ FileBasedTest::getTestsInDirectory(TestSuitePointer testSuite,
 {
    std::string sourcePath = testSuite->getSourcePath(pathInSuite);
    std::list<std::shared_ptr<Test>> tests;
-   for(auto& entry: stdfs::directory_iterator(sourcePath)) {
-      stdfs::path pathInfo = entry.path();
-      // Ignore dot files and excluded tests.
+   // Dot files are skipped by the crawler.
+   for (const DirectoryEntry &entry : crawl_directory(sourcePath, false, true)) {
+      stdfs::path pathInfo(entry.path);
+      // Ignore excluded tests.
       std::string filename = pathInfo.filename();
       const std::set<std::string> &excludes = localConfig->getExcludes();
-      if (string_startswith(filename, ".") ||
-          excludes.find(filename) != excludes.end()) {
+      if (excludes.find(filename) != excludes.end()) {
          continue;
       }
-      if (!stdfs::is_directory(pathInfo)) {
+      if (!entry.isDirectory) {
          std::string ext = pathInfo.extension();
          const std::set<std::string> &suffixes = localConfig->getSuffixes();
          if (suffixes.find(ext) != suffixes.end()) {
@@ -88,28 +88,25 @@ OneCommandPerFileTest::getTestsInDirectory(std::shared_ptr<TestSuite> testSuite,
       dir = testSuite->getSourcePath(pathInSuite);
    }
    std::list<stdfs::path> fileInfos;
-   if (!m_recursive) {
-      for(auto &entry : stdfs::directory_iterator(dir)) {
-         if (!stdfs::is_directory(entry.path())) {
-            fileInfos.push_back(entry.path());
-         }
+   for (const DirectoryEntry &entry : crawl_directory(dir, m_recursive)) {
+      if (entry.isDirectory) {
+         continue;
       }
-   } else {
-      for(auto iter = stdfs::recursive_directory_iterator(dir);
-          iter != stdfs::recursive_directory_iterator();
-          ++iter) {
-
-         const stdfs::path &fileInfo = iter->path();
-         std::string filename = fileInfo.filename();
-         if (filename == ".svn" ||
-             filename == ".git" ||
-             excludes.find(filename) != excludes.end()) {
-            iter.disable_recursion_pending();
-         }
-         if (!stdfs::is_directory(fileInfo)) {
-            fileInfos.push_back(fileInfo);
+      // Skip the files below version control and excluded directories.
+      stdfs::path fileInfo(entry.path);
+      bool skipped = false;
+      for (const stdfs::path &part : fileInfo.lexically_relative(dir).parent_path()) {
+         std::string dirname = part.string();
+         if (dirname == ".svn" ||
+             dirname == ".git" ||
+             excludes.find(dirname) != excludes.end()) {
+            skipped = true;
+            break;
          }
       }
+      if (!skipped) {
+         fileInfos.push_back(fileInfo);
+      }
    }
    for (const stdfs::path &filePath : fileInfos) {
       const std::string &filename = filePath.filename();
@@ -176,6 +176,58 @@ TEST_F(UtilsTest, testListdirFiles)
    }
 }
 
+TEST_F(UtilsTest, testCrawlDirectory)
+{
+   try {
+      fs::create_directories(sm_tempDir / "aaa" / "bbb");
+      fs::copy_file(sg_dataDir/"Empty", sm_tempDir / "aaa"/ "a.txt");
+      fs::copy_file(sg_dataDir/"Empty", sm_tempDir / "aaa"/ ".b.txt");
+      fs::copy_file(sg_dataDir/"Empty", sm_tempDir / "aaa" / "bbb" / "c.txt");
+      fs::create_directory_symlink(sm_tempDir / "aaa" / "bbb", sm_tempDir / "aaa" / "link");
+      // Version control directories are skipped at any level.
+      fs::create_directories(sm_tempDir / "aaa" / ".git");
+      fs::create_directories(sm_tempDir / "aaa" / "bbb" / ".svn");
+      fs::copy_file(sg_dataDir/"Empty", sm_tempDir / "aaa" / ".git" / "HEAD");
+      fs::copy_file(sg_dataDir/"Empty", sm_tempDir / "aaa" / "bbb" / ".svn" / "entries");
+   } catch(...) {
+      FAIL() << "testCrawlDirectory prepare directory error";
+   }
+   auto to_strings = [](const std::vector<polar::lit::DirectoryEntry> &entries) {
+      std::list<std::string> paths;
+      for (const polar::lit::DirectoryEntry &entry : entries) {
+         paths.push_back(entry.path + (entry.isDirectory ? "/" : ""));
+      }
+      return paths;
+   };
+   {
+      std::list<std::string> expected{
+         sm_tempDir / "aaa"/ ".b.txt",
+               sm_tempDir / "aaa"/ "a.txt",
+               (sm_tempDir / "aaa"/ "bbb").string() + "/",
+               (sm_tempDir / "aaa"/ "link").string() + "/"
+      };
+      ASSERT_EQ(expected, to_strings(polar::lit::crawl_directory((sm_tempDir / "aaa").string(), false)));
+   }
+   {
+      std::list<std::string> expected{
+         sm_tempDir / "aaa"/ "a.txt",
+               sm_tempDir / "aaa" / "bbb" / "c.txt",
+               (sm_tempDir / "aaa"/ "link").string() + "/"
+      };
+      ASSERT_EQ(expected, to_strings(polar::lit::crawl_directory((sm_tempDir / "aaa").string(), true, true)));
+   }
+   {
+      std::list<std::string> expected{
+         sm_tempDir / "aaa"/ ".b.txt",
+               sm_tempDir / "aaa"/ "a.txt",
+               sm_tempDir / "aaa" / "bbb" / "c.txt",
+               (sm_tempDir / "aaa"/ "link").string() + "/"
+      };
+      ASSERT_EQ(expected, to_strings(polar::lit::crawl_directory((sm_tempDir / "aaa").string(), true)));
+   }
+   ASSERT_TRUE(polar::lit::crawl_directory((sm_tempDir / "missing").string(), true).empty());
+}
+
 TEST_F(UtilsTest, testJoinStringList)
 {
    {
@@ -0,0 +1,140 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/13.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file declares the classes that let several files be diagnosed in
+//  parallel: every file gets its own DiagnosticEngine whose only consumer
+//  buffers the diagnostics, and the buffers are handed to the real consumers
+//  in file order once the files are finished.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_AST_BUFFERED_DIAGNOSTICS_H
+#define POLARPHP_AST_BUFFERED_DIAGNOSTICS_H
+
+#include "polarphp/ast/StoredDiagnostic.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace polar::ast {
+
+/// A consumer that keeps all diagnostics in a \c StoredDiagnosticList until
+/// they are flushed to other consumers. It is meant to be filled by a single
+/// thread and needs no locking.
+class BufferingDiagnosticConsumer : public DiagnosticConsumer
+{
+public:
+   /// The buffered diagnostics retain their buffers in \p sourceMgr.
+   explicit BufferingDiagnosticConsumer(SourceManager &sourceMgr)
+      : m_diagnostics(sourceMgr)
+   {}
+
+   void handleDiagnostic(SourceManager &sourceMgr, SourceLoc loc,
+                         DiagnosticKind kind,
+                         StringRef formatString,
+                         ArrayRef<DiagnosticArgument> formatArgs,
+                         const DiagnosticInfo &info) override;
+
+   const StoredDiagnosticList &getDiagnostics() const
+   {
+      return m_diagnostics;
+   }
+
+   bool hadAnyError() const
+   {
+      return m_hadAnyError;
+   }
+
+   /// Hand all buffered diagnostics in order to \p consumers and empty the
+   /// buffer.
+   void flushTo(ArrayRef<DiagnosticConsumer *> consumers, SourceManager &sourceMgr);
+
+   void clear()
+   {
+      m_diagnostics.clear();
+   }
+
+private:
+   StoredDiagnosticList m_diagnostics;
+   bool m_hadAnyError = false;
+};
+
+/// Merges the diagnostics of files that are diagnosed in parallel into the
+/// consumers of a target engine.
+///
+/// Every file gets its own engine from \c makeFileEngine, which takes over
+/// the settings of the target engine, so diagnostic transactions and
+/// suppression work per file and the workers share no diagnostic state.
+/// When a file is finished its diagnostics are emitted as soon as those of
+/// all files before it are emitted, so the output is the same as when the
+/// files are diagnosed one after another, whatever order they finish in.
+class OrderedDiagnosticMerger
+{
+public:
+   OrderedDiagnosticMerger(DiagnosticEngine &target, SourceManager &sourceMgr,
+                           size_t numFiles);
+
+   ~OrderedDiagnosticMerger();
+
+   size_t getNumFiles() const
+   {
+      return m_files.size();
+   }
+
+   /// Create an engine that diagnoses the file \p fileIndex into its buffer.
+   /// The engine may only be used by one thread at a time.
+   std::shared_ptr<DiagnosticEngine> makeFileEngine(size_t fileIndex);
+
+   /// Mark the file \p fileIndex as finished and emit the diagnostics of
+   /// every file whose turn has come. Can be called from any thread; the
+   /// consumers of the target engine are only ever called by one thread at a
+   /// time, and errors of the emitted files are recorded in the target
+   /// engine, so its error state is only meaningful once all files are
+   /// complete.
+   void finishFile(size_t fileIndex);
+
+   /// Returns true if all files have been finished and emitted.
+   bool isComplete() const;
+
+   /// Returns true if any of the emitted files had an error.
+   bool hadAnyError() const;
+
+private:
+   struct FileState
+   {
+      explicit FileState(SourceManager &sourceMgr)
+         : buffer(sourceMgr)
+      {}
+
+      BufferingDiagnosticConsumer buffer;
+      bool finished = false;
+   };
+
+   DiagnosticEngine &m_target;
+   SourceManager &m_sourceMgr;
+   std::vector<std::unique_ptr<FileState>> m_files;
+   /// Guards the file states, it is never held while calling consumers.
+   mutable std::mutex m_lock;
+   /// Held while taking files out for emitting and emitting them, so that
+   /// files are emitted in order without blocking finishFile for files whose
+   /// turn has not come.
+   mutable std::mutex m_flushLock;
+   /// The first file whose diagnostics have not been taken out for emitting.
+   size_t m_nextFile = 0;
+   bool m_hadAnyError = false;
+};
+
+} // polar::ast
+
+#endif // POLARPHP_AST_BUFFERED_DIAGNOSTICS_H
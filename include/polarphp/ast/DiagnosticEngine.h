@@ -29,6 +29,7 @@
 #define POLARPHP_AST_DIAGNOSTIC_ENGINE_H
 
 #include "polarphp/ast/DiagnosticConsumer.h"
+#include "polarphp/ast/StoredDiagnostic.h"
 #include "polarphp/utils/VersionTuple.h"
 #include "polarphp/basic/adt/DenseMap.h"
 
@@ -505,12 +506,28 @@ public:
       m_fatalErrorOccurred = false;
    }
 
+   /// Record that an error was diagnosed on behalf of this state.
+   void setHadAnyError()
+   {
+      m_anyErrorOccurred = true;
+   }
+
    /// Set per-diagnostic behavior
    void setDiagnosticBehavior(DiagID id, Behavior behavior)
    {
       m_perDiagnosticBehavior[(unsigned)id] = behavior;
    }
 
+   /// Take over the settings of \p other, but not whether any errors
+   /// occurred.
+   void inheritSettingsFrom(const DiagnosticState &other)
+   {
+      m_showDiagnosticsAfterFatalError = other.m_showDiagnosticsAfterFatalError;
+      m_suppressWarnings = other.m_suppressWarnings;
+      m_warningsAsErrors = other.m_warningsAsErrors;
+      m_perDiagnosticBehavior = other.m_perDiagnosticBehavior;
+   }
+
 private:
    // Make the state movable only
    DiagnosticState(const DiagnosticState &) = delete;
@@ -522,12 +539,16 @@ private:
 
 /// Class responsible for formatting diagnostics and presenting them
 /// to the user.
+///
+/// An engine is not thread-safe. To diagnose several files in parallel give
+/// every file its own engine, see \c OrderedDiagnosticMerger.
 class DiagnosticEngine
 {
 public:
    explicit DiagnosticEngine(SourceManager &sourceMgr)
       : m_sourceMgr(sourceMgr),
-        m_activeDiagnostic()
+        m_activeDiagnostic(),
+        m_tentativeDiagnostics(sourceMgr)
    {}
 
    /// hadAnyError - return true if any *error* diagnostics have been emitted.
@@ -583,6 +604,21 @@ public:
       m_state.resetHadAnyError();
    }
 
+   /// Record that an error was diagnosed on behalf of this engine, e.g. by
+   /// the engine of a single file whose diagnostics are forwarded to the
+   /// consumers of this one.
+   void setHadAnyError()
+   {
+      m_state.setHadAnyError();
+   }
+
+   /// Take over the warning and per-diagnostic settings of \p other, e.g.
+   /// for an engine that diagnoses a single file on a worker thread.
+   void inheritSettingsFrom(const DiagnosticEngine &other)
+   {
+      m_state.inheritSettingsFrom(other.m_state);
+   }
+
    /// Add an additional DiagnosticConsumer to receive diagnostics.
    void addConsumer(DiagnosticConsumer &consumer)
    {
@@ -683,11 +719,15 @@ public:
    static void formatDiagnosticText(
          RawOutStream &outStream, StringRef inText,
          ArrayRef<DiagnosticArgument> formatArgs,
-         DiagnosticFormatOptions formatOpts = DiagnosticFormatOptions());
+         const DiagnosticFormatOptions &formatOpts = DiagnosticFormatOptions());
 
 public:
    static const char *diagnosticStringFor(const DiagID id);
 
+   /// Returns the kind \p id is declared with, before any remapping such as
+   /// warnings-as-errors is applied.
+   static DiagnosticKind getDeclaredDiagnosticKind(const DiagID id);
+
 private:
    /// Flush the active diagnostic.
    void flushActiveDiagnostic();
@@ -701,6 +741,9 @@ private:
    /// Send \c diag to all diagnostic consumers.
    void emitDiagnostic(const Diagnostic &diag);
 
+   void emitDiagnostic(SourceLoc loc, DiagID id, ArrayRef<DiagnosticArgument> args,
+                       const DiagnosticInfo &info);
+
    /// Send all tentative diagnostics to all diagnostic consumers and
    /// delete them.
    void emitTentativeDiagnostics();
@@ -721,8 +764,9 @@ private:
    std::optional<Diagnostic> m_activeDiagnostic;
 
    /// All diagnostics that have are no longer active but have not yet
-   /// been emitted due to an open transaction.
-   SmallVector<Diagnostic, 4> m_tentativeDiagnostics;
+   /// been emitted due to an open transaction. They own copies of their
+   /// string arguments, which may not outlive the call that diagnosed them.
+   StoredDiagnosticList m_tentativeDiagnostics;
 
    /// The number of open diagnostic transactions. Diagnostics are only
    /// emitted once all transactions have closed.
@@ -763,9 +807,7 @@ public:
    void abort()
    {
       close();
-      m_engine.m_tentativeDiagnostics.erase(
-               m_engine.m_tentativeDiagnostics.begin() + m_prevDiagnostics,
-               m_engine.m_tentativeDiagnostics.end());
+      m_engine.m_tentativeDiagnostics.truncate(m_prevDiagnostics);
    }
 
    /// Commit and close this transaction. If this is the top-level
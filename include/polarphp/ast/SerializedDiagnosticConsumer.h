@@ -0,0 +1,113 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/12.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file declares the SerializedDiagnosticConsumer class, which streams
+//  diagnostics into a compact binary file without formatting their messages.
+//
+//  The file starts with the magic "PDIA" and a version byte, followed by a
+//  sequence of records. Every record starts with its kind byte, all numbers
+//  are ULEB128 encoded:
+//
+//    Buffer     := 0x01 fileID nameLength name
+//    Message    := 0x02 diagID textLength text
+//    Diagnostic := 0x03 diagID kind location
+//                  numRanges (location location)*
+//                  numFixIts (location location textLength text)*
+//                  argsLength packedArgs
+//    location   := fileID line column offset | 0
+//
+//  A Buffer record is written before the first location in that buffer and
+//  assigns it a file id starting at 1; the file id 0 is a missing location
+//  and is not followed by line, column and offset. A Message record holds the
+//  unformatted message text of a diagnostic id and is written before the
+//  first diagnostic with that id. The arguments are in the packed argument
+//  encoding of pack_diagnostic_arguments.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_AST_SERIALIZED_DIAGNOSTIC_CONSUMER_H
+#define POLARPHP_AST_SERIALIZED_DIAGNOSTIC_CONSUMER_H
+
+#include "polarphp/ast/DiagnosticConsumer.h"
+#include "polarphp/basic/adt/DenseMap.h"
+
+#include <memory>
+#include <system_error>
+#include <vector>
+
+namespace polar::utils {
+class RawOutStream;
+class RawFdOutStream;
+} // polar::utils
+
+namespace polar::ast {
+
+using polar::utils::RawOutStream;
+
+class SerializedDiagnosticConsumer : public DiagnosticConsumer
+{
+public:
+   enum RecordKind : uint8_t
+   {
+      BufferRecord = 1,
+      MessageRecord = 2,
+      DiagnosticRecord = 3
+   };
+
+   static constexpr uint8_t sm_formatVersion = 1;
+
+   /// Stream the diagnostics into \p outStream, which has to outlive the
+   /// consumer.
+   explicit SerializedDiagnosticConsumer(RawOutStream &outStream);
+
+   /// Create a consumer that writes the file at \p outputPath. Returns null
+   /// and sets \p errorCode if the file cannot be opened.
+   static std::unique_ptr<SerializedDiagnosticConsumer>
+   create(StringRef outputPath, std::error_code &errorCode);
+
+   ~SerializedDiagnosticConsumer() override;
+
+   void handleDiagnostic(SourceManager &sourceMgr, SourceLoc loc,
+                         DiagnosticKind kind,
+                         StringRef formatString,
+                         ArrayRef<DiagnosticArgument> formatArgs,
+                         const DiagnosticInfo &info) override;
+
+   /// Flush the output, returns true if writing the file failed.
+   bool finishProcessing() override;
+
+private:
+   SerializedDiagnosticConsumer(std::unique_ptr<polar::utils::RawFdOutStream> file);
+
+   void writeHeader();
+   /// Returns the file id of the buffer containing \p loc, writing its
+   /// buffer record first if the buffer is new.
+   unsigned getFileID(SourceManager &sourceMgr, SourceLoc loc);
+   void writeLocation(SourceManager &sourceMgr, SourceLoc loc);
+   void writeString(StringRef text);
+   void writeULEB128(uint64_t value);
+
+private:
+   std::unique_ptr<polar::utils::RawFdOutStream> m_file;
+   RawOutStream &m_outStream;
+   /// The file ids of the buffers written so far.
+   polar::basic::DenseMap<unsigned, unsigned> m_fileIDs;
+   /// The diagnostic ids whose message was written already.
+   std::vector<bool> m_writtenMessages;
+   /// Scratch buffer for the packed arguments of a diagnostic.
+   SmallVector<uint8_t, 64> m_argBytes;
+};
+
+} // polar::ast
+
+#endif // POLARPHP_AST_SERIALIZED_DIAGNOSTIC_CONSUMER_H
@@ -0,0 +1,159 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/12.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file declares StoredDiagnosticList, which keeps diagnostics as their
+//  id, location and packed arguments and only formats their message text on
+//  request.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_AST_STORED_DIAGNOSTIC_H
+#define POLARPHP_AST_STORED_DIAGNOSTIC_H
+
+#include "polarphp/ast/DiagnosticConsumer.h"
+
+#include <vector>
+
+namespace polar::utils {
+class RawOutStream;
+} // polar::utils
+
+namespace polar::ast {
+
+using polar::utils::RawOutStream;
+
+class DiagnosticArgument;
+class Diagnostic;
+struct DiagnosticFormatOptions;
+
+/// Append \p args to \p bytes in the packed argument encoding: every argument
+/// is a kind byte followed by its value, integers as LEB128, strings as their
+/// length followed by their bytes. String arguments are copied.
+void pack_diagnostic_arguments(ArrayRef<DiagnosticArgument> args,
+                               SmallVectorImpl<uint8_t> &bytes);
+
+/// Decode the arguments packed by \c pack_diagnostic_arguments. String
+/// arguments reference \p bytes, which has to outlive \p args.
+void unpack_diagnostic_arguments(ArrayRef<uint8_t> bytes,
+                                 SmallVectorImpl<DiagnosticArgument> &args);
+
+/// A list of diagnostics that keeps every diagnostic as its id, kind and
+/// location plus its packed arguments. The arguments, ranges and fix-its of
+/// all diagnostics share a few contiguous arrays and the diagnostics own
+/// their string arguments, so diagnostics can be collected long before they
+/// are handed to a consumer. The message text is only formatted by
+/// \c formatMessage or by the consumer the list is replayed to.
+///
+/// A list that is given a source manager retains the buffer of every stored
+/// diagnostic with a location until the diagnostic is dropped, so that the
+/// buffer is not unmapped while the diagnostic points into it.
+class StoredDiagnosticList
+{
+public:
+   using FixIt = DiagnosticInfo::FixIt;
+
+   StoredDiagnosticList() = default;
+
+   explicit StoredDiagnosticList(SourceManager &sourceMgr)
+      : m_sourceMgr(&sourceMgr)
+   {}
+
+   StoredDiagnosticList(const StoredDiagnosticList &) = delete;
+   StoredDiagnosticList &operator=(const StoredDiagnosticList &) = delete;
+
+   ~StoredDiagnosticList()
+   {
+      clear();
+   }
+
+   struct Entry
+   {
+      DiagID id;
+      DiagnosticKind kind;
+      SourceLoc loc;
+      /// The buffer retained for the diagnostic, zero if none is.
+      unsigned bufferID;
+      /// Start of the packed arguments, ranges and fix-its of the diagnostic,
+      /// they end where the next diagnostic starts.
+      uint32_t argsBegin;
+      uint32_t rangesBegin;
+      uint32_t fixItsBegin;
+   };
+
+   void add(DiagnosticKind kind, SourceLoc loc, DiagID id,
+            ArrayRef<DiagnosticArgument> args, ArrayRef<CharSourceRange> ranges,
+            ArrayRef<FixIt> fixIts);
+
+   void add(DiagnosticKind kind, const Diagnostic &diagnostic);
+
+   size_t size() const
+   {
+      return m_entries.size();
+   }
+
+   bool empty() const
+   {
+      return m_entries.empty();
+   }
+
+   const Entry &operator[](size_t index) const
+   {
+      return m_entries[index];
+   }
+
+   /// Get the packed arguments of the \p index th diagnostic.
+   ArrayRef<uint8_t> getPackedArgs(size_t index) const;
+
+   /// Decode the arguments of the \p index th diagnostic into \p args. String
+   /// arguments reference the list.
+   void getArgs(size_t index, SmallVectorImpl<DiagnosticArgument> &args) const;
+
+   ArrayRef<CharSourceRange> getRanges(size_t index) const;
+   ArrayRef<FixIt> getFixIts(size_t index) const;
+
+   /// Format the message text of the \p index th diagnostic.
+   void formatMessage(size_t index, RawOutStream &outStream) const;
+   void formatMessage(size_t index, RawOutStream &outStream,
+                      const DiagnosticFormatOptions &formatOpts) const;
+
+   /// Hand the diagnostics in [begin, end) in order to \p consumer.
+   void replay(size_t begin, size_t end, DiagnosticConsumer &consumer,
+               SourceManager &sourceMgr) const;
+
+   void replay(DiagnosticConsumer &consumer, SourceManager &sourceMgr) const
+   {
+      replay(0, size(), consumer, sourceMgr);
+   }
+
+   /// Drop all diagnostics after the first \p size ones.
+   void truncate(size_t size);
+
+   void clear()
+   {
+      truncate(0);
+   }
+
+   /// Returns the number of bytes allocated for the list.
+   size_t getMemoryUsage() const;
+
+private:
+   SourceManager *m_sourceMgr = nullptr;
+   std::vector<Entry> m_entries;
+   std::vector<uint8_t> m_argBytes;
+   std::vector<CharSourceRange> m_ranges;
+   std::vector<FixIt> m_fixIts;
+};
+
+} // polar::ast
+
+#endif // POLARPHP_AST_STORED_DIAGNOSTIC_H
@@ -0,0 +1,178 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/02.
+//
+/// \file
+/// Provides an interface for reading data that has been serialized with
+/// \c ByteTreeWriter.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_BASIC_BYTETREEDESERIALIZATION_H
+#define POLARPHP_BASIC_BYTETREEDESERIALIZATION_H
+
+#include "polarphp/basic/adt/ArrayRef.h"
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/utils/BinaryStreamError.h"
+#include "polarphp/utils/BinaryStreamReader.h"
+
+#include <cstring>
+
+namespace polar::basic::bytetree {
+
+using polar::utils::BinaryStreamReader;
+using polar::utils::BinaryStreamError;
+using polar::utils::StreamErrorCode;
+using polar::utils::Error;
+using polar::basic::StringRef;
+using polar::basic::ArrayRef;
+
+/// Reads a ByteTree produced by \c ByteTreeWriter.
+///
+/// Every construct in a ByteTree starts with a 32 bit header. If its most
+/// significant bit is set, the construct is an object and the remaining bits
+/// hold the number of fields that follow. Otherwise it is a scalar and the
+/// header holds the number of payload bytes that follow.
+///
+/// The reader never copies scalar payloads. Everything handed out by
+/// \c readScalar references the buffer passed to the constructor, so that
+/// buffer (typically a memory mapped \c MemoryBuffer) has to outlive all
+/// values derived from it.
+class ByteTreeReader
+{
+public:
+   explicit ByteTreeReader(ArrayRef<uint8_t> data)
+      : m_streamReader(data, polar::utils::Endianness::Little)
+   {}
+
+   explicit ByteTreeReader(StringRef data)
+      : m_streamReader(data, polar::utils::Endianness::Little)
+   {}
+
+   /// Read the protocol version that prefixes every ByteTree.
+   Error readProtocolVersion(uint32_t &version)
+   {
+      return m_streamReader.readInteger(version);
+   }
+
+   /// Returns true if the next construct is an object. Does not advance
+   /// the reader.
+   bool isAtObject() const
+   {
+      BinaryStreamReader peeker(m_streamReader);
+      uint32_t header;
+      if (auto error = peeker.readInteger(header)) {
+         polar::utils::consume_error(std::move(error));
+         return false;
+      }
+      return (header & sm_objectFlag) != 0;
+   }
+
+   /// Read the header of an object and return its number of fields in
+   /// \p numFields. Fails if the next construct is a scalar.
+   Error readObjectHeader(uint32_t &numFields)
+   {
+      uint32_t header;
+      if (auto error = m_streamReader.readInteger(header)) {
+         return error;
+      }
+      if ((header & sm_objectFlag) == 0) {
+         return polar::utils::make_error<BinaryStreamError>(
+                  StreamErrorCode::unspecified, "expected a ByteTree object");
+      }
+      numFields = header & ~sm_objectFlag;
+      return Error::getSuccess();
+   }
+
+   /// Read a scalar and return a reference to its payload without copying it.
+   Error readScalar(StringRef &payload)
+   {
+      uint32_t size;
+      if (auto error = readScalarSize(size)) {
+         return error;
+      }
+      return m_streamReader.readFixedString(payload, size);
+   }
+
+   /// Read a scalar whose payload is the binary representation of \p T on
+   /// the serializing machine (see \c DirectlyEncodable).
+   template <typename T>
+   Error readRaw(T &value)
+   {
+      uint32_t size;
+      if (auto error = readScalarSize(size)) {
+         return error;
+      }
+      if (size != sizeof(T)) {
+         return polar::utils::make_error<BinaryStreamError>(
+                  StreamErrorCode::unspecified, "unexpected ByteTree scalar size");
+      }
+      ArrayRef<uint8_t> bytes;
+      if (auto error = m_streamReader.readBytes(bytes, size)) {
+         return error;
+      }
+      ::memcpy(&value, bytes.data(), sizeof(T));
+      return Error::getSuccess();
+   }
+
+   /// Skip the next \p count constructs including everything nested in
+   /// them. Used to step over fields written by newer protocol versions.
+   Error skip(uint32_t count = 1)
+   {
+      // Objects only add to the number of pending constructs, so nesting
+      // depth does not affect the amount of stack used.
+      uint64_t pending = count;
+      while (pending > 0) {
+         uint32_t header;
+         if (auto error = m_streamReader.readInteger(header)) {
+            return error;
+         }
+         --pending;
+         if (header & sm_objectFlag) {
+            pending += header & ~sm_objectFlag;
+         } else if (auto error = m_streamReader.skip(header)) {
+            return error;
+         }
+      }
+      return Error::getSuccess();
+   }
+
+   uint32_t getOffset() const
+   {
+      return m_streamReader.getOffset();
+   }
+
+   uint32_t getBytesRemaining() const
+   {
+      return m_streamReader.getBytesRemaining();
+   }
+
+private:
+   Error readScalarSize(uint32_t &size)
+   {
+      uint32_t header;
+      if (auto error = m_streamReader.readInteger(header)) {
+         return error;
+      }
+      if (header & sm_objectFlag) {
+         return polar::utils::make_error<BinaryStreamError>(
+                  StreamErrorCode::unspecified, "expected a ByteTree scalar");
+      }
+      size = header;
+      return Error::getSuccess();
+   }
+
+   static constexpr uint32_t sm_objectFlag = uint32_t(1) << 31;
+   BinaryStreamReader m_streamReader;
+};
+
+} // polar::basic::bytetree
+
+#endif // POLARPHP_BASIC_BYTETREEDESERIALIZATION_H
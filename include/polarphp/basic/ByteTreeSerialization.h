@@ -32,7 +32,9 @@
 #include "polarphp/utils/BinaryStreamError.h"
 #include "polarphp/utils/BinaryStreamWriter.h"
 #include "polarphp/basic/ExponentialGrowthAppendingBinaryByteStream.h"
+#include "polarphp/basic/SegmentedAppendingBinaryByteStream.h"
 #include <map>
+#include <optional>
 
 namespace polar::basic::bytetree {
 
@@ -179,7 +181,12 @@ private:
    /// we can call \c ExponentialGrowthAppendingBinaryByteStream.writeRaw
    /// which is more efficient than the generic \c writeBytes of
    /// \c BinaryStreamWriter since it avoids the arbitrary size memcopy.
-   ExponentialGrowthAppendingBinaryByteStream &m_stream;
+   /// \c nullptr if the tree is written to a \c SegmentedAppendingBinaryByteStream.
+   ExponentialGrowthAppendingBinaryByteStream *m_stream;
+
+   /// Same as \c m_stream for trees written to a
+   /// \c SegmentedAppendingBinaryByteStream. Exactly one of the two is set.
+   SegmentedAppendingBinaryByteStream *m_segmentedStream;
 
    /// The number of fields this object contains. \c UINT_MAX if it has not been
    /// set yet. No member may be written to the object if expected number of
@@ -196,11 +203,26 @@ private:
    /// The \c ByteTreeWriter can only be constructed internally. Use
    /// \c ByteTreeWriter.write to serialize a new object.
    /// \p m_stream must be the underlying m_stream of \p SteamWriter.
-   ByteTreeWriter(ExponentialGrowthAppendingBinaryByteStream &stream,
+   ByteTreeWriter(ExponentialGrowthAppendingBinaryByteStream *stream,
+                  SegmentedAppendingBinaryByteStream *segmentedStream,
                   BinaryStreamWriter &streamWriter, UserInfoMap &userInfo)
       : m_streamWriter(streamWriter),
         m_stream(stream),
+        m_segmentedStream(segmentedStream),
         m_userInfo(userInfo)
+   {
+      assert((stream == nullptr) != (segmentedStream == nullptr) &&
+             "exactly one output stream must be given");
+   }
+
+   ByteTreeWriter(ExponentialGrowthAppendingBinaryByteStream &stream,
+                  BinaryStreamWriter &streamWriter, UserInfoMap &userInfo)
+      : ByteTreeWriter(&stream, nullptr, streamWriter, userInfo)
+   {}
+
+   ByteTreeWriter(SegmentedAppendingBinaryByteStream &stream,
+                  BinaryStreamWriter &streamWriter, UserInfoMap &userInfo)
+      : ByteTreeWriter(nullptr, &stream, streamWriter, userInfo)
    {}
 
    /// Write the given value to the ByteTree in the same form in which it is
@@ -210,7 +232,9 @@ private:
    {
       // FIXME: We implicitly inherit the endianess of the serializing machine.
       // Since we're currently only supporting macOS that's not a problem for now.
-      auto error = m_stream.writeRaw(m_streamWriter.getOffset(), value);
+      auto error = m_stream
+            ? m_stream->writeRaw(m_streamWriter.getOffset(), value)
+            : m_segmentedStream->writeRaw(m_streamWriter.getOffset(), value);
       m_streamWriter.setOffset(m_streamWriter.getOffset() + sizeof(T));
       return error;
    }
@@ -265,6 +289,25 @@ public:
    static write(ExponentialGrowthAppendingBinaryByteStream &stream,
                 uint32_t protocolVersion, const T &object,
                 UserInfoMap &userInfo)
+   {
+      writeRoot(stream, protocolVersion, object, userInfo);
+   }
+
+   /// Same as above but for outputs too large to be kept in one contiguous
+   /// buffer.
+   template <typename T>
+   typename std::enable_if<HasObjectTraits<T>::value, void>::type
+   static write(SegmentedAppendingBinaryByteStream &stream,
+                uint32_t protocolVersion, const T &object,
+                UserInfoMap &userInfo)
+   {
+      writeRoot(stream, protocolVersion, object, userInfo);
+   }
+
+private:
+   template <typename StreamType, typename T>
+   static void writeRoot(StreamType &stream, uint32_t protocolVersion,
+                         const T &object, UserInfoMap &userInfo)
    {
       BinaryStreamWriter streamWriter(stream);
       ByteTreeWriter writer(stream, streamWriter, userInfo);
@@ -279,12 +322,14 @@ public:
       writer.write(object, /*index=*/0);
    }
 
+public:
    template <typename T>
    typename std::enable_if<HasObjectTraits<T>::value, void>::type
    write(const T &object, unsigned index)
    {
       validateAndIncreaseFieldIndex(index);
-      auto objectWriter = ByteTreeWriter(m_stream, m_streamWriter, m_userInfo);
+      ByteTreeWriter objectWriter(m_stream, m_segmentedStream, m_streamWriter,
+                                  m_userInfo);
       objectWriter.setNumFields(ObjectTraits<T>::getNumFields(object, m_userInfo));
 
       ObjectTraits<T>::write(objectWriter, object, m_userInfo);
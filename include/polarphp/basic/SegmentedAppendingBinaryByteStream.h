@@ -0,0 +1,165 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/04.
+//
+/// \file
+/// Defines a \c WritableBinaryStream that stores its data in a chain of fixed
+/// size chunks. Unlike \c ExponentialGrowthAppendingBinaryByteStream it never
+/// moves data that has already been written, so growing the stream costs no
+/// copies and no temporary doubling of memory, which matters for very large
+/// serialized outputs.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_BASIC_SEGMENTEDAPPENDINGBINARYBYTESTREAM_H
+#define POLARPHP_BASIC_SEGMENTEDAPPENDINGBINARYBYTESTREAM_H
+
+#include "polarphp/basic/adt/ArrayRef.h"
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/utils/Allocator.h"
+#include "polarphp/utils/BinaryByteStream.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace polar::utils {
+class FileOutputBuffer;
+} // polar::utils
+
+namespace polar::basic {
+
+using polar::utils::WritableBinaryStream;
+using polar::utils::BinaryStreamFlags;
+using polar::utils::FileOutputBuffer;
+
+/// An implementation of WritableBinaryStream which can write at its end
+/// causing the underlying data to grow by whole chunks. This class owns the
+/// underlying data.
+///
+/// Any offset that has already been written can be overwritten again, e.g. to
+/// patch a length field once the size of the data following it is known.
+class SegmentedAppendingBinaryByteStream : public WritableBinaryStream
+{
+public:
+   /// The default chunk size. Large enough to keep the number of chunks (and
+   /// thus the number of \c writev entries) low, small enough to not waste
+   /// much memory at the end of the last chunk.
+   static constexpr uint32_t DefaultChunkSize = 64 * 1024;
+
+   SegmentedAppendingBinaryByteStream()
+      : SegmentedAppendingBinaryByteStream(polar::utils::Endianness::Little)
+   {}
+
+   /// \p chunkSize has to be a power of two.
+   explicit SegmentedAppendingBinaryByteStream(
+         polar::utils::Endianness endian,
+         uint32_t chunkSize = DefaultChunkSize);
+
+   SegmentedAppendingBinaryByteStream(
+         const SegmentedAppendingBinaryByteStream &) = delete;
+   SegmentedAppendingBinaryByteStream &operator=(
+         const SegmentedAppendingBinaryByteStream &) = delete;
+
+   /// Allocate enough chunks to hold \p size bytes without further
+   /// allocations.
+   void reserve(size_t size);
+
+   polar::utils::Endianness getEndian() const override
+   {
+      return m_endian;
+   }
+
+   /// Reads that stay within a single chunk reference the stream directly.
+   /// Reads that cross a chunk boundary are copied into storage owned by the
+   /// stream; such a copy does not reflect bytes patched after the read.
+   polar::utils::Error readBytes(uint32_t offset, uint32_t size,
+                                 ArrayRef<uint8_t> &buffer) override;
+
+   polar::utils::Error readLongestContiguousChunk(uint32_t offset,
+                                                  ArrayRef<uint8_t> &buffer) override;
+
+   uint32_t getLength() override
+   {
+      return m_length;
+   }
+
+   uint32_t getChunkSize() const
+   {
+      return m_chunkMask + 1;
+   }
+
+   size_t getNumChunks() const
+   {
+      return (uint64_t(m_length) + m_chunkMask) >> m_chunkShift;
+   }
+
+   /// Returns the written part of chunk \p index.
+   ArrayRef<uint8_t> getChunk(size_t index) const;
+
+   polar::utils::Error writeBytes(uint32_t offset, ArrayRef<uint8_t> buffer) override;
+
+   /// The counterpart of \c ExponentialGrowthAppendingBinaryByteStream::writeRaw.
+   /// Writes \p value in the native endianess of the executing machine with a
+   /// fixed size memcpy unless the value straddles a chunk boundary.
+   template<typename T>
+   polar::utils::Error writeRaw(uint32_t offset, T value)
+   {
+      uint32_t chunkOffset = offset & m_chunkMask;
+      if (offset + sizeof(T) <= m_length &&
+          chunkOffset + sizeof(T) <= getChunkSize()) {
+         ::memcpy(m_chunks[offset >> m_chunkShift].get() + chunkOffset,
+                  &value, sizeof value);
+         return polar::utils::Error::getSuccess();
+      }
+      return writeBytes(offset, ArrayRef<uint8_t>(
+                           reinterpret_cast<const uint8_t *>(&value),
+                           sizeof value));
+   }
+
+   polar::utils::Error commit() override
+   {
+      return polar::utils::Error::getSuccess();
+   }
+
+   virtual BinaryStreamFlags getFlags() const override
+   {
+      return BinaryStreamFlags::BSF_Write | BinaryStreamFlags::BSF_Append;
+   }
+
+   /// Write the contents of the stream to the file descriptor \p fd with as
+   /// few \c writev calls as possible. The chunks are handed to the kernel
+   /// directly, nothing is copied.
+   polar::utils::Error writeToFileDescriptor(int fd) const;
+
+   /// Copy the contents of the stream to the start of \p buffer, which has to
+   /// be at least \c getLength() bytes large. The buffer is not committed.
+   polar::utils::Error writeToOutputBuffer(FileOutputBuffer &buffer) const;
+
+   /// Write the contents of the stream to a new file at \p filePath through a
+   /// \c FileOutputBuffer.
+   polar::utils::Error writeToFile(StringRef filePath) const;
+
+private:
+   /// Make sure the chunks cover the first \p size bytes.
+   void ensureCapacity(uint64_t size);
+
+   std::vector<std::unique_ptr<uint8_t[]>> m_chunks;
+   /// Storage for reads that cross a chunk boundary.
+   polar::utils::BumpPtrAllocator m_readCache;
+   uint32_t m_length = 0;
+   uint32_t m_chunkShift;
+   uint32_t m_chunkMask;
+   polar::utils::Endianness m_endian;
+};
+
+} // polar::basic
+
+#endif // POLARPHP_BASIC_SEGMENTEDAPPENDINGBINARYBYTESTREAM_H
@@ -491,6 +491,14 @@ public:
    void toString(SmallVectorImpl<char> &str, unsigned formatPrecision = 0,
                  unsigned formatMaxPadding = 3, bool truncateZero = true) const;
 
+   /// Converts a value into the shortest decimal string that converts back to
+   /// the same value, 0.1 prints as "0.1" where toString() gives
+   /// "0.10000000000000001". \p formatMaxPadding works as for toString().
+   ///
+   /// Only IEEE doubles have a shortest conversion, other formats print as
+   /// toString() with the default precision.
+   void toShortestString(SmallVectorImpl<char> &str, unsigned formatMaxPadding = 3) const;
+
    /// If this value has an exact multiplicative inverse, store it in inv and
    /// return true.
    bool getExactInverse(ApFloat *inv) const;
@@ -753,6 +761,7 @@ public:
 
    void toString(SmallVectorImpl<char> &str, unsigned formatPrecision,
                  unsigned formatMaxPadding, bool truncateZero = true) const;
+   void toShortestString(SmallVectorImpl<char> &str, unsigned formatMaxPadding) const;
 
    bool getExactInverse(ApFloat *inv) const;
 
@@ -1466,6 +1475,11 @@ public:
                toString(str, formatPrecision, formatMaxPadding, truncateZero));
    }
 
+   void toShortestString(SmallVectorImpl<char> &str, unsigned formatMaxPadding = 3) const
+   {
+      APFLOAT_DISPATCH_ON_SEMANTICS(toShortestString(str, formatMaxPadding));
+   }
+
    void print(RawOutStream &) const;
    void dump() const;
 
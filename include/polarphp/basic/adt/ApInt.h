@@ -113,11 +113,17 @@ public:
    static const WordType WORDTYPE_MAX = ~WordType(0);
 
 private:
+   /// The number of words stored in the ApInt itself, wider values are
+   /// allocated on the heap.
+   static constexpr unsigned sm_inlineWords = 2;
+
    /// This union is used to store the integer value. When the
-   /// integer bit-width <= 64, it uses VAL, otherwise it uses pVal.
+   /// integer bit-width <= 64, it uses m_value, up to 128 bits it uses
+   /// m_inlineValues, otherwise it uses m_pValue.
    union {
       uint64_t m_value;   ///< Used to store the <= 64 bits integer value.
-      uint64_t *m_pValue; ///< Used to store the >64 bits integer value.
+      uint64_t m_inlineValues[sm_inlineWords]; ///< Used to store the <= 128 bits integer value.
+      uint64_t *m_pValue; ///< Used to store the >128 bits integer value.
    } m_intValue;
 
    unsigned m_bitWidth; ///< The number of bits in this ApInt.
@@ -126,14 +132,20 @@ private:
 
    friend class ApSInt;
 
+   struct UninitializedTag
+   {};
+
    /// Fast internal constructor
    ///
    /// This constructor is used only internally for speed of construction of
-   /// temporaries. It is unsafe for general use so it is not public.
-   ApInt(uint64_t *val, unsigned bits)
+   /// temporaries. The value is left uninitialized. It is unsafe for general
+   /// use so it is not public.
+   ApInt(unsigned bits, UninitializedTag)
       : m_bitWidth(bits)
    {
-      m_intValue.m_pValue = val;
+      if (!isInline()) {
+         m_intValue.m_pValue = new uint64_t[getNumWords()];
+      }
    }
 
    /// Determine if this ApInt just has one word to store value.
@@ -144,6 +156,25 @@ private:
       return m_bitWidth <= APINT_BITS_PER_WORD;
    }
 
+   /// Determine if the words of this ApInt are stored in the object itself.
+   ///
+   /// \returns true if the number of bits <= 128, false otherwise.
+   bool isInline() const
+   {
+      return m_bitWidth <= sm_inlineWords * APINT_BITS_PER_WORD;
+   }
+
+   /// The words of the value, least significant first.
+   uint64_t *getWords()
+   {
+      return isInline() ? m_intValue.m_inlineValues : m_intValue.m_pValue;
+   }
+
+   const uint64_t *getWords() const
+   {
+      return isInline() ? m_intValue.m_inlineValues : m_intValue.m_pValue;
+   }
+
    /// Determine which word a bit is in.
    ///
    /// \returns the word position for the specified bit position.
@@ -188,7 +219,7 @@ private:
       if (isSingleWord()) {
          m_intValue.m_value &= mask;
       } else {
-         m_intValue.m_pValue[getNumWords() - 1] &= mask;
+         getWords()[getNumWords() - 1] &= mask;
       }
       return *this;
    }
@@ -197,7 +228,7 @@ private:
    /// \returns the corresponding word for the specified bit position.
    uint64_t getWord(unsigned bitPosition) const
    {
-      return isSingleWord() ? m_intValue.m_value : m_intValue.m_pValue[whichWord(bitPosition)];
+      return isSingleWord() ? m_intValue.m_value : getWords()[whichWord(bitPosition)];
    }
 
    /// Utility method to change the bit width of this ApInt to new bit width,
@@ -392,7 +423,7 @@ public:
    /// Returns whether this instance allocated memory.
    bool needsCleanup() const
    {
-      return !isSingleWord();
+      return !isInline();
    }
 
    /// Used to insert ApInt objects, or objects other contain ApInt objects, into
@@ -789,7 +820,7 @@ public:
       if (isSingleWord()) {
          return &m_intValue.m_value;
       }
-      return &m_intValue.m_pValue[0];
+      return getWords();
    }
 
    /// @}
@@ -870,7 +901,7 @@ public:
          return *this;
 #endif
       assert(this != &other && "Self-move not supported");
-      if (!isSingleWord()) {
+      if (needsCleanup()) {
          delete[] m_intValue.m_pValue;
       }
       // Use memcpy so other type based alias analysis sees both VAL and pVal
@@ -894,8 +925,8 @@ public:
          m_intValue.m_value = rhs;
          clearUnusedBits();
       } else {
-         m_intValue.m_pValue[0] = rhs;
-         memset(m_intValue.m_pValue+1, 0, (getNumWords() - 1) * APINT_WORD_SIZE);
+         getWords()[0] = rhs;
+         memset(getWords()+1, 0, (getNumWords() - 1) * APINT_WORD_SIZE);
       }
       return *this;
    }
@@ -928,8 +959,8 @@ public:
          m_intValue.m_value &= rhs;
          return *this;
       }
-      m_intValue.m_pValue[0] &= rhs;
-      memset(m_intValue.m_pValue+1, 0, (getNumWords() - 1) * APINT_WORD_SIZE);
+      getWords()[0] &= rhs;
+      memset(getWords()+1, 0, (getNumWords() - 1) * APINT_WORD_SIZE);
       return *this;
    }
 
@@ -961,7 +992,7 @@ public:
          m_intValue.m_value |= rhs;
          clearUnusedBits();
       } else {
-         m_intValue.m_pValue[0] |= rhs;
+         getWords()[0] |= rhs;
       }
       return *this;
    }
@@ -994,7 +1025,7 @@ public:
          m_intValue.m_value ^= rhs;
          clearUnusedBits();
       } else {
-         m_intValue.m_pValue[0] ^= rhs;
+         getWords()[0] ^= rhs;
       }
       return *this;
    }
@@ -1594,7 +1625,7 @@ public:
          m_intValue.m_value = WORDTYPE_MAX;
       } else {
          // Set all the bits in all the words.
-         memset(m_intValue.m_pValue, -1, getNumWords() * APINT_WORD_SIZE);
+         memset(getWords(), -1, getNumWords() * APINT_WORD_SIZE);
       }
       // Clear the unused ones
       clearUnusedBits();
@@ -1610,7 +1641,7 @@ public:
       if (isSingleWord()) {
          m_intValue.m_value |= Mask;
       } else {
-         m_intValue.m_pValue[whichWord(bitPosition)] |= Mask;
+         getWords()[whichWord(bitPosition)] |= Mask;
       }
    }
 
@@ -1635,7 +1666,7 @@ public:
          if (isSingleWord()) {
             m_intValue.m_value |= mask;
          } else {
-            m_intValue.m_pValue[0] |= mask;
+            getWords()[0] |= mask;
          }
       } else {
          setBitsSlowCase(loBit, hiBit);
@@ -1666,7 +1697,7 @@ public:
       if (isSingleWord()) {
          m_intValue.m_value = 0;
       } else {
-         memset(m_intValue.m_pValue, 0, getNumWords() * APINT_WORD_SIZE);
+         memset(getWords(), 0, getNumWords() * APINT_WORD_SIZE);
       }
    }
 
@@ -1680,7 +1711,7 @@ public:
       if (isSingleWord()) {
          m_intValue.m_value &= mask;
       } else {
-         m_intValue.m_pValue[whichWord(bitPosition)] &= mask;
+         getWords()[whichWord(bitPosition)] &= mask;
       }
    }
 
@@ -1798,7 +1829,7 @@ public:
          return m_intValue.m_value;
       }
       assert(getActiveBits() <= 64 && "Too many bits for uint64_t");
-      return m_intValue.m_pValue[0];
+      return getWords()[0];
    }
 
    /// Get sign extended value
@@ -1812,7 +1843,7 @@ public:
          return sign_extend64(m_intValue.m_value, m_bitWidth);
       }
       assert(getMinSignedBits() <= 64 && "Too many bits for int64_t");
-      return int64_t(m_intValue.m_pValue[0]);
+      return int64_t(getWords()[0]);
    }
 
    /// Get bits required for string value.
@@ -20,6 +20,7 @@
 #define POLARPHP_BASIC_ADT_BIT_VECTOR_H
 
 #include "polarphp/basic/adt/ArrayRef.h"
+#include "polarphp/basic/adt/BitVectorKernels.h"
 #include "polarphp/basic/adt/IteratorRange.h"
 #include "polarphp/utils/MathExtras.h"
 #include <algorithm>
@@ -234,22 +235,14 @@ public:
    /// count - Returns the number of bits which are set.
    size_type count() const
    {
-      unsigned numBits = 0;
-      for (unsigned i = 0; i < numBitWords(size()); ++i) {
-         numBits += count_population(m_bits[i]);
-      }
-      return numBits;
+      return internal::count_population_words(m_bits.getData(), numBitWords(size()));
    }
 
    /// any - Returns true if any bit is set.
    bool any() const
    {
-      for (unsigned i = 0; i < numBitWords(size()); ++i) {
-         if (m_bits[i] != 0) {
-            return true;
-         }
-      }
-      return false;
+      unsigned numWords = numBitWords(size());
+      return internal::find_non_zero_word(m_bits.getData(), numWords) != numWords;
    }
 
    /// all - Returns true if all bits are set.
@@ -285,7 +278,8 @@ public:
       unsigned firstWord = begin / BITWORD_SIZE;
       unsigned lastWord = (end - 1) / BITWORD_SIZE;
 
-      // Check subsequent words.
+      // Check subsequent words, skipping the zero words between the first
+      // and the last one in bulk.
       for (unsigned i = firstWord; i <= lastWord; ++i) {
          BitWord copy = m_bits[i];
          if (i == firstWord) {
@@ -299,6 +293,9 @@ public:
          if (copy != 0) {
             return i * BITWORD_SIZE + count_trailing_zeros(copy);
          }
+         if (i == firstWord && lastWord - firstWord > 1) {
+            i += internal::find_non_zero_word(&m_bits[i + 1], lastWord - i - 1);
+         }
       }
       return -1;
    }
@@ -692,10 +689,8 @@ public:
    {
       unsigned thisWords = numBitWords(size());
       unsigned rhsWords  = numBitWords(rhs.size());
-      unsigned i;
-      for (i = 0; i != std::min(thisWords, rhsWords); ++i) {
-         m_bits[i] &= rhs.m_bits[i];
-      }
+      unsigned i = std::min(thisWords, rhsWords);
+      internal::bitwise_and_words(m_bits.getData(), rhs.m_bits.getData(), i);
       // Any bits that are just in this bitvector become zero, because they aren't
       // in the rhs bit vector.  Any words only in rhs are ignored because they
       // are already zero in the LHS.
@@ -710,10 +705,8 @@ public:
    {
       unsigned thisWords = numBitWords(size());
       unsigned rhsWords  = numBitWords(rhs.size());
-      unsigned i;
-      for (i = 0; i != std::min(thisWords, rhsWords); ++i) {
-         m_bits[i] &= ~rhs.m_bits[i];
-      }
+      internal::bitwise_and_not_words(m_bits.getData(), rhs.m_bits.getData(),
+                                      std::min(thisWords, rhsWords));
       return *this;
    }
 
@@ -742,9 +735,7 @@ public:
       if (size() < rhs.size()) {
          resize(rhs.size());
       }
-      for (size_t i = 0, e = numBitWords(rhs.size()); i != e; ++i) {
-         m_bits[i] |= rhs.m_bits[i];
-      }
+      internal::bitwise_or_words(m_bits.getData(), rhs.m_bits.getData(), numBitWords(rhs.size()));
       return *this;
    }
 
@@ -753,9 +744,7 @@ public:
       if (size() < rhs.size()) {
          resize(rhs.size());
       }
-      for (size_t i = 0, e = numBitWords(rhs.size()); i != e; ++i) {
-         m_bits[i] ^= rhs.m_bits[i];
-      }
+      internal::bitwise_xor_words(m_bits.getData(), rhs.m_bits.getData(), numBitWords(rhs.size()));
       return *this;
    }
 
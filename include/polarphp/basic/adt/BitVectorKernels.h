@@ -0,0 +1,130 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file declares the word array kernels BitVector and SparseBitVector
+//  use for their bulk operations. The kernels pick an AVX2 or SSE2
+//  implementation for the running CPU the first time they are called.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_BASIC_ADT_BIT_VECTOR_KERNELS_H
+#define POLARPHP_BASIC_ADT_BIT_VECTOR_KERNELS_H
+
+#include "polarphp/utils/MathExtras.h"
+
+#include <cstddef>
+
+namespace polar::basic::internal {
+
+using BitVectorWord = unsigned long;
+
+/// Below this many words the loops are inlined, a call through the kernel
+/// table costs more than it saves.
+constexpr size_t sg_bitVectorKernelMinWords = 8;
+
+struct BitVectorKernels
+{
+   /// dest op= src for \p count words, returning true if dest changed.
+   bool (*bitwiseOr)(BitVectorWord *dest, const BitVectorWord *src, size_t count);
+   bool (*bitwiseAnd)(BitVectorWord *dest, const BitVectorWord *src, size_t count);
+   bool (*bitwiseAndNot)(BitVectorWord *dest, const BitVectorWord *src, size_t count);
+   void (*bitwiseXor)(BitVectorWord *dest, const BitVectorWord *src, size_t count);
+   /// The number of set bits of \p count words.
+   size_t (*countPopulation)(const BitVectorWord *words, size_t count);
+   /// The index of the first word that is not zero, or \p count.
+   size_t (*findNonZero)(const BitVectorWord *words, size_t count);
+};
+
+/// The kernels for the running CPU.
+const BitVectorKernels &get_bit_vector_kernels();
+
+/// The portable kernels, which the tests compare the selected ones against.
+const BitVectorKernels &get_generic_bit_vector_kernels();
+
+inline bool bitwise_or_words(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   if (count >= sg_bitVectorKernelMinWords) {
+      return get_bit_vector_kernels().bitwiseOr(dest, src, count);
+   }
+   BitVectorWord changed = 0;
+   for (size_t i = 0; i != count; ++i) {
+      changed |= src[i] & ~dest[i];
+      dest[i] |= src[i];
+   }
+   return changed != 0;
+}
+
+inline bool bitwise_and_words(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   if (count >= sg_bitVectorKernelMinWords) {
+      return get_bit_vector_kernels().bitwiseAnd(dest, src, count);
+   }
+   BitVectorWord changed = 0;
+   for (size_t i = 0; i != count; ++i) {
+      changed |= dest[i] & ~src[i];
+      dest[i] &= src[i];
+   }
+   return changed != 0;
+}
+
+inline bool bitwise_and_not_words(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   if (count >= sg_bitVectorKernelMinWords) {
+      return get_bit_vector_kernels().bitwiseAndNot(dest, src, count);
+   }
+   BitVectorWord changed = 0;
+   for (size_t i = 0; i != count; ++i) {
+      changed |= dest[i] & src[i];
+      dest[i] &= ~src[i];
+   }
+   return changed != 0;
+}
+
+inline void bitwise_xor_words(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   if (count >= sg_bitVectorKernelMinWords) {
+      get_bit_vector_kernels().bitwiseXor(dest, src, count);
+      return;
+   }
+   for (size_t i = 0; i != count; ++i) {
+      dest[i] ^= src[i];
+   }
+}
+
+inline size_t count_population_words(const BitVectorWord *words, size_t count)
+{
+   if (count >= sg_bitVectorKernelMinWords) {
+      return get_bit_vector_kernels().countPopulation(words, count);
+   }
+   size_t numBits = 0;
+   for (size_t i = 0; i != count; ++i) {
+      numBits += polar::utils::count_population(words[i]);
+   }
+   return numBits;
+}
+
+inline size_t find_non_zero_word(const BitVectorWord *words, size_t count)
+{
+   if (count >= sg_bitVectorKernelMinWords) {
+      return get_bit_vector_kernels().findNonZero(words, count);
+   }
+   size_t i = 0;
+   while (i != count && words[i] == 0) {
+      ++i;
+   }
+   return i;
+}
+
+} // polar::basic::internal
+
+#endif // POLARPHP_BASIC_ADT_BIT_VECTOR_KERNELS_H
@@ -26,12 +26,16 @@
 // (because, unlike std::string, CachedHashString lets us have empty and
 // tombstone values).
 //
+// The hash is the one StringMap uses, so the cached hash can be passed to the
+// StringMap lookups that take a precomputed hash.
+//
 //===----------------------------------------------------------------------===//
 
 #ifndef POLARPHP_BASIC_ADT_CACHED_HASH_STRING_H
 #define POLARPHP_BASIC_ADT_CACHED_HASH_STRING_H
 
 #include "polarphp/basic/adt/DenseMap.h"
+#include "polarphp/basic/adt/StringMap.h"
 #include "polarphp/basic/adt/StringRef.h"
 #include "polarphp/utils/RawOutStream.h"
 
@@ -47,7 +51,7 @@ class CachedHashStringRef
 public:
    // Explicit because hashing a string isn't free.
    explicit CachedHashStringRef(StringRef str)
-      : CachedHashStringRef(str, DenseMapInfo<StringRef>::getHashValue(str))
+      : CachedHashStringRef(str, StringMapImpl::hash(str))
    {}
 
    CachedHashStringRef(StringRef str, uint32_t hash)
@@ -143,7 +147,7 @@ public:
 
    // Explicit because copying and hashing a string isn't free.
    explicit CachedHashString(StringRef str)
-      : CachedHashString(str, DenseMapInfo<StringRef>::getHashValue(str))
+      : CachedHashString(str, StringMapImpl::hash(str))
    {}
 
    CachedHashString(StringRef str, uint32_t hash)
@@ -20,7 +20,7 @@
 //
 // This file defines a Levenshtein distance function that works for any two
 // sequences, with each element of each sequence being analogous to a character
-// in a string.
+// in a string, and bit-parallel versions specialized for strings.
 //
 //===----------------------------------------------------------------------===//
 
@@ -28,7 +28,9 @@
 #define POLARPHP_BASIC_ADT_EDIT_DISTANCE_H
 
 #include "polarphp/basic/adt/ArrayRef.h"
+#include "polarphp/basic/adt/StringRef.h"
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 
 namespace polar::basic {
@@ -110,6 +112,49 @@ unsigned compute_edit_distance(ArrayRef<T> fromArray, ArrayRef<T> toArray,
    return result;
 }
 
+/// Determine the Levenshtein distance between two strings, allowing
+/// replacements.
+///
+/// This computes the same distance as compute_edit_distance with Myers'
+/// bit-parallel algorithm (as reformulated by Hyyrö), handling 64 characters
+/// of the shorter string per machine word.
+///
+/// \param maxEditDistance If non-zero, the maximum edit distance that this
+/// routine is allowed to compute. If the edit distance will exceed that
+/// maximum, returns \c maxEditDistance+1.
+unsigned string_edit_distance(StringRef from, StringRef to,
+                              unsigned maxEditDistance = 0);
+
+/// Like string_edit_distance, but ASCII letters match regardless of case, the
+/// way PHP compares function, class and method names.
+unsigned string_edit_distance_lower(StringRef from, StringRef to,
+                                    unsigned maxEditDistance = 0);
+
+/// Computes the edit distance from one fixed string to many others. The
+/// bit masks of the pattern are built once, so each comparison costs one
+/// pass over the other string per 64 characters of the pattern.
+class LevenshteinMatcher
+{
+public:
+   explicit LevenshteinMatcher(StringRef pattern, bool ignoreCase = false);
+
+   /// The edit distance between the pattern and \p text, with the same
+   /// \p maxEditDistance convention as string_edit_distance.
+   unsigned getDistance(StringRef text, unsigned maxEditDistance = 0) const;
+
+   size_t getPatternLength() const
+   {
+      return m_length;
+   }
+
+private:
+   /// For every byte value, the bit mask of the pattern positions holding
+   /// it, m_blocks words per byte value.
+   std::unique_ptr<uint64_t[]> m_matchMasks;
+   size_t m_length;
+   size_t m_blocks;
+};
+
 } // polar::basic
 
 #endif // POLARPHP_BASIC_ADT_EDIT_DISTANCE_H
@@ -0,0 +1,103 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines EditDistanceIndex, a set of strings that answers
+//  nearest-match queries under the Levenshtein distance, used to find
+//  "did you mean" candidates in a large symbol table.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_BASIC_ADT_EDIT_DISTANCE_INDEX_H
+#define POLARPHP_BASIC_ADT_EDIT_DISTANCE_INDEX_H
+
+#include "polarphp/basic/adt/SmallVector.h"
+#include "polarphp/basic/adt/StringMap.h"
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/utils/Allocator.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace polar::basic {
+
+/// A string of an EditDistanceIndex and its edit distance from the query.
+struct EditDistanceMatch
+{
+   StringRef key;
+   unsigned distance;
+};
+
+/// Keys are bucketed by length, since a key more than r characters longer or
+/// shorter than the query is more than r edits away. Each key also carries a
+/// 64-bit signature of the character classes it contains; a class present in
+/// only one of two strings costs at least one edit, so the signature rules
+/// out most keys of the right length with a few word operations before the
+/// bit-parallel distance is computed for the rest.
+class EditDistanceIndex
+{
+public:
+   /// \p ignoreCase makes ASCII letters match regardless of case, the way
+   /// PHP compares function, class and method names.
+   explicit EditDistanceIndex(bool ignoreCase = false);
+
+   EditDistanceIndex(const EditDistanceIndex &) = delete;
+   EditDistanceIndex &operator=(const EditDistanceIndex &) = delete;
+
+   /// Add a copy of \p key. Returns false if an equal key was already
+   /// present.
+   bool insert(StringRef key);
+
+   /// The keys within \p maxDistance edits of \p query, closest first and
+   /// alphabetically among equal distances. With a non-zero \p limit only
+   /// the \p limit closest keys are returned, which also lets the search
+   /// narrow as soon as that many close keys are found.
+   SmallVector<EditDistanceMatch, 4> findNearest(StringRef query, unsigned maxDistance,
+                                                 size_t limit = 0) const;
+
+   /// Whether an equal key is present.
+   bool contains(StringRef key) const;
+
+   size_t getSize() const
+   {
+      return m_keys.getSize();
+   }
+
+   bool isEmpty() const
+   {
+      return m_keys.empty();
+   }
+
+   bool isIgnoreCase() const
+   {
+      return m_ignoreCase;
+   }
+
+private:
+   struct Bucket
+   {
+      std::vector<uint64_t> signatures;
+      std::vector<StringRef> keys;
+   };
+
+   /// The keys, case folded when ignoring case.
+   StringMap<char> m_keys;
+   /// The keys of each length.
+   std::vector<Bucket> m_buckets;
+   /// Holds the original spelling of case folded keys.
+   polar::utils::BumpPtrAllocator m_allocator;
+   bool m_ignoreCase;
+};
+
+} // polar::basic
+
+#endif // POLARPHP_BASIC_ADT_EDIT_DISTANCE_INDEX_H
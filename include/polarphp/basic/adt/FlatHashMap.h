@@ -0,0 +1,790 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/15.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the FlatHashMap class, an open addressing hash table
+//  that keeps one control byte per slot and probes the control bytes in
+//  groups of sixteen.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_BASIC_ADT_FLAT_HASH_MAP_H
+#define POLARPHP_BASIC_ADT_FLAT_HASH_MAP_H
+
+#include "polarphp/basic/adt/DenseMap.h"
+#include "polarphp/basic/adt/DenseMapInfo.h"
+#include "polarphp/utils/MathExtras.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace polar::basic {
+
+/// Adapts a standard hash functor and equality predicate to the static
+/// interface of DenseMapInfo, so FlatHashMap and FlatHashSet can use hashes
+/// written for std::unordered_map. Transparent functors allow heterogeneous
+/// lookup.
+template <typename HashT, typename KeyEqualT = std::equal_to<>>
+struct HashFunctorInfo
+{
+   template <typename T>
+   static size_t getHashValue(const T &value)
+   {
+      return HashT()(value);
+   }
+
+   template <typename LhsT, typename RhsT>
+   static bool isEqual(const LhsT &lhs, const RhsT &rhs)
+   {
+      return KeyEqualT()(lhs, rhs);
+   }
+};
+
+namespace internal {
+
+/// The control byte of a slot. Full slots hold the low seven bits of the
+/// hash of their key, so the sign bit tells free slots from full ones.
+enum FlatHashCtrl : int8_t
+{
+   FlatHashEmpty = -128,
+   FlatHashDeleted = -2
+};
+
+/// Sixteen control bytes that are matched at once, with SSE2 if available.
+/// The bit masks have bit i set for the i-th byte of the group.
+class FlatHashGroup
+{
+public:
+   static constexpr size_t sm_width = 16;
+
+   explicit FlatHashGroup(const int8_t *ctrl)
+   {
+#if defined(__SSE2__)
+      m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+#else
+      std::memcpy(m_ctrl, ctrl, sm_width);
+#endif
+   }
+
+   /// The full slots whose hash ends with \p h2.
+   uint32_t match(uint8_t h2) const
+   {
+#if defined(__SSE2__)
+      __m128i pattern = _mm_set1_epi8(static_cast<char>(h2));
+      return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(pattern, m_ctrl)));
+#else
+      uint32_t mask = 0;
+      for (size_t index = 0; index < sm_width; ++index) {
+         mask |= uint32_t(m_ctrl[index] == static_cast<int8_t>(h2)) << index;
+      }
+      return mask;
+#endif
+   }
+
+   uint32_t matchEmpty() const
+   {
+      return match(static_cast<uint8_t>(FlatHashEmpty));
+   }
+
+   uint32_t matchEmptyOrDeleted() const
+   {
+      // Free slots are the ones with the sign bit set.
+#if defined(__SSE2__)
+      return static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl));
+#else
+      uint32_t mask = 0;
+      for (size_t index = 0; index < sm_width; ++index) {
+         mask |= uint32_t(m_ctrl[index] < 0) << index;
+      }
+      return mask;
+#endif
+   }
+
+private:
+#if defined(__SSE2__)
+   __m128i m_ctrl;
+#else
+   int8_t m_ctrl[sm_width];
+#endif
+};
+
+template <typename ValueT, bool IsConst>
+class FlatHashIterator;
+
+/// The table behind FlatHashMap and FlatHashSet. \c KeyOfValueT::get
+/// returns the key of a stored value.
+template <typename ValueT, typename KeyT, typename KeyInfoT, typename KeyOfValueT>
+class FlatHashTable
+{
+public:
+   using size_type = unsigned;
+   using key_type = KeyT;
+   using value_type = ValueT;
+   using iterator = FlatHashIterator<ValueT, false>;
+   using const_iterator = FlatHashIterator<ValueT, true>;
+
+   FlatHashTable() = default;
+
+   explicit FlatHashTable(unsigned initialReserve)
+   {
+      reserve(initialReserve);
+   }
+
+   FlatHashTable(const FlatHashTable &other)
+   {
+      copyFrom(other);
+   }
+
+   FlatHashTable(FlatHashTable &&other)
+   {
+      swap(other);
+   }
+
+   ~FlatHashTable()
+   {
+      destroyAll();
+      deallocate();
+   }
+
+   FlatHashTable &operator=(const FlatHashTable &other)
+   {
+      if (&other != this) {
+         destroyAll();
+         deallocate();
+         copyFrom(other);
+      }
+      return *this;
+   }
+
+   FlatHashTable &operator=(FlatHashTable &&other)
+   {
+      destroyAll();
+      deallocate();
+      swap(other);
+      return *this;
+   }
+
+   void swap(FlatHashTable &other)
+   {
+      std::swap(m_ctrl, other.m_ctrl);
+      std::swap(m_slots, other.m_slots);
+      std::swap(m_capacity, other.m_capacity);
+      std::swap(m_size, other.m_size);
+      std::swap(m_growthLeft, other.m_growthLeft);
+   }
+
+   iterator begin()
+   {
+      return m_size == 0 ? end() : makeIteratorAt(0);
+   }
+
+   iterator end()
+   {
+      return iterator(m_ctrl + m_capacity, m_slots + m_capacity, m_ctrl + m_capacity);
+   }
+
+   const_iterator begin() const
+   {
+      return const_cast<FlatHashTable *>(this)->begin();
+   }
+
+   const_iterator end() const
+   {
+      return const_cast<FlatHashTable *>(this)->end();
+   }
+
+   bool empty() const
+   {
+      return m_size == 0;
+   }
+
+   unsigned size() const
+   {
+      return m_size;
+   }
+
+   unsigned getSize() const
+   {
+      return m_size;
+   }
+
+   /// The number of slots, a power of two.
+   unsigned getCapacity() const
+   {
+      return m_capacity;
+   }
+
+   /// Grow the table so it holds \p numEntries without rehashing.
+   void reserve(size_type numEntries)
+   {
+      if (numEntries <= m_size + m_growthLeft) {
+         return;
+      }
+      rehash(capacityFor(numEntries));
+   }
+
+   /// Remove all entries but keep the memory.
+   void clear()
+   {
+      if (m_size == 0 && m_growthLeft == maxLoad(m_capacity)) {
+         return;
+      }
+      destroyAll();
+      resetCtrl();
+   }
+
+   size_type count(const KeyT &key) const
+   {
+      return findSlot(key, hashOf(key)) != nullptr ? 1 : 0;
+   }
+
+   iterator find(const KeyT &key)
+   {
+      return findAs(key);
+   }
+
+   const_iterator find(const KeyT &key) const
+   {
+      return findAs(key);
+   }
+
+   /// Look up a key of another type, for which \c KeyInfoT provides
+   /// \c getHashValue(const LookupKeyT &) and
+   /// \c isEqual(const LookupKeyT &, const KeyT &). The hash has to agree
+   /// with the one of the equal key.
+   template <typename LookupKeyT>
+   iterator findAs(const LookupKeyT &key)
+   {
+      if (ValueT *slot = findSlot(key, hashOf(key))) {
+         return makeIteratorAt(slot - m_slots);
+      }
+      return end();
+   }
+
+   template <typename LookupKeyT>
+   const_iterator findAs(const LookupKeyT &key) const
+   {
+      return const_cast<FlatHashTable *>(this)->findAs(key);
+   }
+
+   bool erase(const KeyT &key)
+   {
+      ValueT *slot = findSlot(key, hashOf(key));
+      if (slot == nullptr) {
+         return false;
+      }
+      eraseSlot(slot - m_slots);
+      return true;
+   }
+
+   void erase(iterator iter)
+   {
+      eraseSlot(iter.m_slot - m_slots);
+   }
+
+   void erase(const_iterator iter)
+   {
+      eraseSlot(iter.m_slot - m_slots);
+   }
+
+   /// The memory the table allocated, in bytes.
+   size_t getMemorySize() const
+   {
+      return m_capacity == 0
+            ? 0 : m_capacity * sizeof(ValueT) + m_capacity + FlatHashGroup::sm_width;
+   }
+
+protected:
+   /// Find the slot of \p key, or claim a slot for it. The caller has to
+   /// construct the value in a claimed slot, which is reported by the second
+   /// member being true.
+   template <typename LookupKeyT>
+   std::pair<ValueT *, bool> findOrPrepareInsert(const LookupKeyT &key)
+   {
+      uint64_t hash = hashOf(key);
+      if (ValueT *slot = findSlot(key, hash)) {
+         return {slot, false};
+      }
+      // Inserting may move the slots.
+      size_t index = prepareInsert(hash);
+      return {m_slots + index, true};
+   }
+
+   iterator makeIterator(ValueT *slot)
+   {
+      return makeIteratorAt(slot - m_slots);
+   }
+
+private:
+   template <typename, bool>
+   friend class FlatHashIterator;
+
+   /// DenseMapInfo hashes are 32 bits and often weak, pointers for instance
+   /// only shift their address, so the hash is spread over 64 bits first.
+   template <typename LookupKeyT>
+   static uint64_t hashOf(const LookupKeyT &key)
+   {
+      uint64_t hash = static_cast<uint64_t>(KeyInfoT::getHashValue(key)) *
+            0x9E3779B97F4A7C15ULL;
+      return hash ^ (hash >> 32);
+   }
+
+   static uint8_t h2Of(uint64_t hash)
+   {
+      return hash & 0x7F;
+   }
+
+   static unsigned maxLoad(unsigned capacity)
+   {
+      return capacity - capacity / 8;
+   }
+
+   static unsigned capacityFor(unsigned numEntries)
+   {
+      unsigned capacity = FlatHashGroup::sm_width;
+      while (maxLoad(capacity) < numEntries) {
+         capacity *= 2;
+      }
+      return capacity;
+   }
+
+   iterator makeIteratorAt(size_t index)
+   {
+      iterator iter(m_ctrl + index, m_slots + index, m_ctrl + m_capacity);
+      iter.skipFreeSlots();
+      return iter;
+   }
+
+   template <typename LookupKeyT>
+   ValueT *findSlot(const LookupKeyT &key, uint64_t hash) const
+   {
+      if (m_capacity == 0) {
+         return nullptr;
+      }
+      size_t mask = m_capacity - 1;
+      size_t pos = (hash >> 7) & mask;
+      uint8_t h2 = h2Of(hash);
+      for (size_t step = FlatHashGroup::sm_width;; step += FlatHashGroup::sm_width) {
+         FlatHashGroup group(m_ctrl + pos);
+         for (uint32_t bits = group.match(h2); bits != 0; bits &= bits - 1) {
+            size_t index = (pos + polar::utils::count_trailing_zeros(bits)) & mask;
+            if (KeyInfoT::isEqual(key, KeyOfValueT::get(m_slots[index]))) {
+               return m_slots + index;
+            }
+         }
+         if (group.matchEmpty() != 0) {
+            return nullptr;
+         }
+         assert(step <= m_capacity && "probed the whole table");
+         // Triangular steps visit every group of a power of two table.
+         pos = (pos + step) & mask;
+      }
+   }
+
+   size_t findFreeSlot(uint64_t hash) const
+   {
+      size_t mask = m_capacity - 1;
+      size_t pos = (hash >> 7) & mask;
+      for (size_t step = FlatHashGroup::sm_width;; step += FlatHashGroup::sm_width) {
+         FlatHashGroup group(m_ctrl + pos);
+         if (uint32_t bits = group.matchEmptyOrDeleted()) {
+            return (pos + polar::utils::count_trailing_zeros(bits)) & mask;
+         }
+         assert(step <= m_capacity && "no free slot in the table");
+         pos = (pos + step) & mask;
+      }
+   }
+
+   size_t prepareInsert(uint64_t hash)
+   {
+      if (m_capacity == 0) {
+         rehash(FlatHashGroup::sm_width);
+      }
+      size_t index = findFreeSlot(hash);
+      if (m_growthLeft == 0 && m_ctrl[index] == FlatHashEmpty) {
+         // Drop the tombstones if they take much of the load, grow otherwise.
+         rehash(m_size < maxLoad(m_capacity) / 2 ? m_capacity : m_capacity * 2);
+         index = findFreeSlot(hash);
+      }
+      if (m_ctrl[index] == FlatHashEmpty) {
+         --m_growthLeft;
+      }
+      setCtrl(index, h2Of(hash));
+      ++m_size;
+      return index;
+   }
+
+   void eraseSlot(size_t index)
+   {
+      assert(m_ctrl[index] >= 0 && "erasing a free slot");
+      m_slots[index].~ValueT();
+      --m_size;
+      // If every group covering the slot still has an empty slot, no probe
+      // ever went past it and it can be made empty again.
+      size_t before = (index - FlatHashGroup::sm_width) & (m_capacity - 1);
+      uint32_t emptyAfter = FlatHashGroup(m_ctrl + index).matchEmpty();
+      uint32_t emptyBefore = FlatHashGroup(m_ctrl + before).matchEmpty();
+      bool wasNeverFull = emptyAfter != 0 && emptyBefore != 0 &&
+            polar::utils::count_trailing_zeros(emptyAfter) +
+            polar::utils::count_leading_zeros(emptyBefore) - 16 < FlatHashGroup::sm_width;
+      if (wasNeverFull) {
+         setCtrl(index, static_cast<uint8_t>(FlatHashEmpty));
+         ++m_growthLeft;
+      } else {
+         setCtrl(index, static_cast<uint8_t>(FlatHashDeleted));
+      }
+   }
+
+   /// The first group of control bytes is repeated after the last slot, so
+   /// a group can be loaded at any slot.
+   void setCtrl(size_t index, uint8_t ctrl)
+   {
+      m_ctrl[index] = static_cast<int8_t>(ctrl);
+      if (index < FlatHashGroup::sm_width) {
+         m_ctrl[m_capacity + index] = static_cast<int8_t>(ctrl);
+      }
+   }
+
+   void resetCtrl()
+   {
+      std::memset(m_ctrl, FlatHashEmpty, m_capacity + FlatHashGroup::sm_width);
+      m_size = 0;
+      m_growthLeft = maxLoad(m_capacity);
+   }
+
+   void rehash(unsigned newCapacity)
+   {
+      int8_t *oldCtrl = m_ctrl;
+      ValueT *oldSlots = m_slots;
+      unsigned oldCapacity = m_capacity;
+      unsigned oldSize = m_size;
+      m_capacity = newCapacity;
+      m_ctrl = static_cast<int8_t *>(operator new(newCapacity + FlatHashGroup::sm_width));
+      m_slots = static_cast<ValueT *>(operator new(sizeof(ValueT) * newCapacity));
+      resetCtrl();
+      for (size_t index = 0; index < oldCapacity; ++index) {
+         if (oldCtrl[index] < 0) {
+            continue;
+         }
+         ValueT &value = oldSlots[index];
+         uint64_t hash = hashOf(KeyOfValueT::get(value));
+         size_t newIndex = findFreeSlot(hash);
+         setCtrl(newIndex, h2Of(hash));
+         ::new (m_slots + newIndex) ValueT(std::move(value));
+         value.~ValueT();
+      }
+      m_size = oldSize;
+      m_growthLeft -= oldSize;
+      if (oldCapacity != 0) {
+         operator delete(oldCtrl);
+         operator delete(oldSlots);
+      }
+   }
+
+   void copyFrom(const FlatHashTable &other)
+   {
+      if (other.m_capacity == 0) {
+         return;
+      }
+      m_capacity = other.m_capacity;
+      m_ctrl = static_cast<int8_t *>(operator new(m_capacity + FlatHashGroup::sm_width));
+      m_slots = static_cast<ValueT *>(operator new(sizeof(ValueT) * m_capacity));
+      std::memcpy(m_ctrl, other.m_ctrl, m_capacity + FlatHashGroup::sm_width);
+      for (size_t index = 0; index < m_capacity; ++index) {
+         if (m_ctrl[index] >= 0) {
+            ::new (m_slots + index) ValueT(other.m_slots[index]);
+         }
+      }
+      m_size = other.m_size;
+      m_growthLeft = other.m_growthLeft;
+   }
+
+   void destroyAll()
+   {
+      if (std::is_trivially_destructible<ValueT>::value) {
+         return;
+      }
+      for (size_t index = 0; index < m_capacity; ++index) {
+         if (m_ctrl[index] >= 0) {
+            m_slots[index].~ValueT();
+         }
+      }
+   }
+
+   void deallocate()
+   {
+      if (m_capacity != 0) {
+         operator delete(m_ctrl);
+         operator delete(m_slots);
+      }
+      m_ctrl = nullptr;
+      m_slots = nullptr;
+      m_capacity = 0;
+      m_size = 0;
+      m_growthLeft = 0;
+   }
+
+private:
+   int8_t *m_ctrl = nullptr;
+   ValueT *m_slots = nullptr;
+   unsigned m_capacity = 0;
+   unsigned m_size = 0;
+   /// The number of empty slots that can be filled before the load factor
+   /// of 7/8 is reached.
+   unsigned m_growthLeft = 0;
+};
+
+template <typename ValueT, bool IsConst>
+class FlatHashIterator
+{
+   template <typename, typename, typename, typename>
+   friend class FlatHashTable;
+   friend class FlatHashIterator<ValueT, true>;
+   friend class FlatHashIterator<ValueT, false>;
+
+public:
+   using difference_type = ptrdiff_t;
+   using value_type = typename std::conditional<IsConst, const ValueT, ValueT>::type;
+   using pointer = value_type *;
+   using reference = value_type &;
+   using iterator_category = std::forward_iterator_tag;
+
+   FlatHashIterator() = default;
+
+   // Converting from a non-const iterator to a const iterator.
+   template <bool IsConstSrc,
+             typename = typename std::enable_if<!IsConstSrc && IsConst>::type>
+   FlatHashIterator(const FlatHashIterator<ValueT, IsConstSrc> &other)
+      : m_ctrl(other.m_ctrl),
+        m_slot(other.m_slot),
+        m_ctrlEnd(other.m_ctrlEnd)
+   {}
+
+   reference operator*() const
+   {
+      return *m_slot;
+   }
+
+   pointer operator->() const
+   {
+      return m_slot;
+   }
+
+   bool operator==(const FlatHashIterator &other) const
+   {
+      return m_slot == other.m_slot;
+   }
+
+   bool operator!=(const FlatHashIterator &other) const
+   {
+      return m_slot != other.m_slot;
+   }
+
+   FlatHashIterator &operator++()
+   {
+      ++m_ctrl;
+      ++m_slot;
+      skipFreeSlots();
+      return *this;
+   }
+
+   FlatHashIterator operator++(int)
+   {
+      FlatHashIterator temp = *this;
+      ++*this;
+      return temp;
+   }
+
+private:
+   FlatHashIterator(const int8_t *ctrl, ValueT *slot, const int8_t *ctrlEnd)
+      : m_ctrl(ctrl),
+        m_slot(slot),
+        m_ctrlEnd(ctrlEnd)
+   {}
+
+   void skipFreeSlots()
+   {
+      while (m_ctrl != m_ctrlEnd && *m_ctrl < 0) {
+         ++m_ctrl;
+         ++m_slot;
+      }
+   }
+
+private:
+   const int8_t *m_ctrl = nullptr;
+   ValueT *m_slot = nullptr;
+   const int8_t *m_ctrlEnd = nullptr;
+};
+
+template <typename KeyT, typename ValueT>
+struct FlatHashPairKey
+{
+   static const KeyT &get(const DenseMapPair<KeyT, ValueT> &pair)
+   {
+      return pair.getFirst();
+   }
+};
+
+} // internal
+
+/// A hash map that stores its entries in one array, like DenseMap, but finds
+/// them through a parallel array of control bytes. Each control byte holds
+/// seven bits of the hash of its entry, sixteen of them are compared at once
+/// with SSE2, so a lookup rarely touches an entry with another key and needs
+/// no empty or tombstone key values. The table is kept at most 7/8 full.
+///
+/// \c KeyInfoT is a DenseMapInfo like class of which only \c getHashValue
+/// and \c isEqual are used, HashFunctorInfo adapts standard hash functors.
+/// As with DenseMap, inserting and erasing invalidates iterators and
+/// pointers to the entries.
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>>
+class FlatHashMap
+      : public internal::FlatHashTable<internal::DenseMapPair<KeyT, ValueT>, KeyT,
+                                       KeyInfoT, internal::FlatHashPairKey<KeyT, ValueT>>
+{
+   using BaseT = internal::FlatHashTable<internal::DenseMapPair<KeyT, ValueT>, KeyT,
+                                         KeyInfoT, internal::FlatHashPairKey<KeyT, ValueT>>;
+
+public:
+   using mapped_type = ValueT;
+   using value_type = internal::DenseMapPair<KeyT, ValueT>;
+   using iterator = typename BaseT::iterator;
+   using const_iterator = typename BaseT::const_iterator;
+
+   FlatHashMap() = default;
+
+   explicit FlatHashMap(unsigned initialReserve)
+      : BaseT(initialReserve)
+   {}
+
+   FlatHashMap(std::initializer_list<value_type> values)
+   {
+      this->reserve(values.size());
+      insert(values.begin(), values.end());
+   }
+
+   template <typename InputIter>
+   FlatHashMap(const InputIter &first, const InputIter &last)
+   {
+      insert(first, last);
+   }
+
+   /// Return the value of \p key, or a default-constructed value if there is
+   /// none.
+   ValueT lookup(const KeyT &key) const
+   {
+      const_iterator iter = this->find(key);
+      if (iter != this->end()) {
+         return iter->getSecond();
+      }
+      return ValueT();
+   }
+
+   std::pair<iterator, bool> insert(const std::pair<KeyT, ValueT> &keyValue)
+   {
+      return tryEmplace(keyValue.first, keyValue.second);
+   }
+
+   std::pair<iterator, bool> insert(std::pair<KeyT, ValueT> &&keyValue)
+   {
+      return tryEmplace(std::move(keyValue.first), std::move(keyValue.second));
+   }
+
+   template <typename InputIter>
+   void insert(InputIter first, InputIter last)
+   {
+      for (; first != last; ++first) {
+         insert(*first);
+      }
+   }
+
+   /// Insert a value constructed from \p args unless \p key is in the map
+   /// already, in which case nothing is constructed.
+   template <typename... Ts>
+   std::pair<iterator, bool> tryEmplace(KeyT &&key, Ts &&... args)
+   {
+      auto result = this->findOrPrepareInsert(key);
+      if (result.second) {
+         ::new (&result.first->getFirst()) KeyT(std::move(key));
+         ::new (&result.first->getSecond()) ValueT(std::forward<Ts>(args)...);
+      }
+      return {this->makeIterator(result.first), result.second};
+   }
+
+   template <typename... Ts>
+   std::pair<iterator, bool> tryEmplace(const KeyT &key, Ts &&... args)
+   {
+      auto result = this->findOrPrepareInsert(key);
+      if (result.second) {
+         ::new (&result.first->getFirst()) KeyT(key);
+         ::new (&result.first->getSecond()) ValueT(std::forward<Ts>(args)...);
+      }
+      return {this->makeIterator(result.first), result.second};
+   }
+
+   /// Insert \p keyValue unless an entry equal to \p lookupKey exists. The
+   /// key of \p keyValue has to be equal to \p lookupKey.
+   template <typename LookupKeyT>
+   std::pair<iterator, bool> insertAs(value_type &&keyValue, const LookupKeyT &lookupKey)
+   {
+      auto result = this->findOrPrepareInsert(lookupKey);
+      if (result.second) {
+         ::new (result.first) value_type(std::move(keyValue));
+      }
+      return {this->makeIterator(result.first), result.second};
+   }
+
+   value_type &findAndConstruct(const KeyT &key)
+   {
+      return *tryEmplace(key).first;
+   }
+
+   value_type &findAndConstruct(KeyT &&key)
+   {
+      return *tryEmplace(std::move(key)).first;
+   }
+
+   ValueT &operator[](const KeyT &key)
+   {
+      return findAndConstruct(key).getSecond();
+   }
+
+   ValueT &operator[](KeyT &&key)
+   {
+      return findAndConstruct(std::move(key)).getSecond();
+   }
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT>
+inline void swap(FlatHashMap<KeyT, ValueT, KeyInfoT> &lhs,
+                 FlatHashMap<KeyT, ValueT, KeyInfoT> &rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // polar::basic
+
+#endif // POLARPHP_BASIC_ADT_FLAT_HASH_MAP_H
@@ -0,0 +1,139 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/15.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the FlatHashSet class, the set counterpart of
+//  FlatHashMap.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_BASIC_ADT_FLAT_HASH_SET_H
+#define POLARPHP_BASIC_ADT_FLAT_HASH_SET_H
+
+#include "polarphp/basic/adt/FlatHashMap.h"
+
+namespace polar::basic {
+
+namespace internal {
+
+template <typename KeyT>
+struct FlatHashSetKey
+{
+   static const KeyT &get(const KeyT &key)
+   {
+      return key;
+   }
+};
+
+} // internal
+
+/// A set of keys in a FlatHashMap style table. The keys are not mutable
+/// through the iterators.
+template <typename KeyT, typename KeyInfoT = DenseMapInfo<KeyT>>
+class FlatHashSet
+      : public internal::FlatHashTable<KeyT, KeyT, KeyInfoT, internal::FlatHashSetKey<KeyT>>
+{
+   using BaseT = internal::FlatHashTable<KeyT, KeyT, KeyInfoT, internal::FlatHashSetKey<KeyT>>;
+
+public:
+   using value_type = KeyT;
+   using iterator = typename BaseT::const_iterator;
+   using const_iterator = typename BaseT::const_iterator;
+
+   FlatHashSet() = default;
+
+   explicit FlatHashSet(unsigned initialReserve)
+      : BaseT(initialReserve)
+   {}
+
+   FlatHashSet(std::initializer_list<KeyT> keys)
+   {
+      this->reserve(keys.size());
+      insert(keys.begin(), keys.end());
+   }
+
+   template <typename InputIter>
+   FlatHashSet(const InputIter &first, const InputIter &last)
+   {
+      insert(first, last);
+   }
+
+   const_iterator begin() const
+   {
+      return BaseT::begin();
+   }
+
+   const_iterator end() const
+   {
+      return BaseT::end();
+   }
+
+   const_iterator find(const KeyT &key) const
+   {
+      return BaseT::find(key);
+   }
+
+   template <typename LookupKeyT>
+   const_iterator findAs(const LookupKeyT &key) const
+   {
+      return BaseT::findAs(key);
+   }
+
+   bool contains(const KeyT &key) const
+   {
+      return this->count(key) != 0;
+   }
+
+   std::pair<const_iterator, bool> insert(const KeyT &key)
+   {
+      return emplaceAs(key, key);
+   }
+
+   std::pair<const_iterator, bool> insert(KeyT &&key)
+   {
+      auto result = this->findOrPrepareInsert(key);
+      if (result.second) {
+         ::new (result.first) KeyT(std::move(key));
+      }
+      return {this->makeIterator(result.first), result.second};
+   }
+
+   template <typename InputIter>
+   void insert(InputIter first, InputIter last)
+   {
+      for (; first != last; ++first) {
+         insert(*first);
+      }
+   }
+
+   /// Insert a key constructed from \p args unless an entry equal to
+   /// \p lookupKey exists, in which case nothing is constructed.
+   template <typename LookupKeyT, typename... Ts>
+   std::pair<const_iterator, bool> emplaceAs(const LookupKeyT &lookupKey, Ts &&... args)
+   {
+      auto result = this->findOrPrepareInsert(lookupKey);
+      if (result.second) {
+         ::new (result.first) KeyT(std::forward<Ts>(args)...);
+      }
+      return {this->makeIterator(result.first), result.second};
+   }
+};
+
+template <typename KeyT, typename KeyInfoT>
+inline void swap(FlatHashSet<KeyT, KeyInfoT> &lhs, FlatHashSet<KeyT, KeyInfoT> &rhs)
+{
+   lhs.swap(rhs);
+}
+
+} // polar::basic
+
+#endif // POLARPHP_BASIC_ADT_FLAT_HASH_SET_H
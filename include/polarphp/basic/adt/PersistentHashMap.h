@@ -0,0 +1,1204 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the PersistentHashMap and PersistentHashSet classes,
+//  immutable hash tries that share structure between versions.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_BASIC_ADT_PERSISTENT_HASH_MAP_H
+#define POLARPHP_BASIC_ADT_PERSISTENT_HASH_MAP_H
+
+#include "polarphp/basic/adt/DenseMapInfo.h"
+#include "polarphp/basic/adt/SmallVector.h"
+#include "polarphp/utils/MathExtras.h"
+#include "polarphp/utils/MemoryAlloc.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace polar::basic {
+
+namespace internal {
+
+/// The hash bits each level of the trie consumes.
+constexpr unsigned sg_hamtBitsPerLevel = 5;
+constexpr unsigned sg_hamtHashBits = 32;
+/// Seven levels of bitmap nodes, then a level of collision nodes.
+constexpr unsigned sg_hamtMaxDepth =
+      (sg_hamtHashBits + sg_hamtBitsPerLevel - 1) / sg_hamtBitsPerLevel + 1;
+
+/// Spreads the hash of DenseMapInfo, which keeps the low bits of pointers and
+/// integers as they are, over all 32 bits.
+inline uint32_t hamt_mix_hash(unsigned hash)
+{
+   uint32_t value = hash;
+   value ^= value >> 16;
+   value *= 0x85ebca6b;
+   value ^= value >> 13;
+   value *= 0xc2b2ae35;
+   value ^= value >> 16;
+   return value;
+}
+
+/// The bitmap bit of \p hash at the level that starts at \p shift.
+inline uint32_t hamt_bit(uint32_t hash, unsigned shift)
+{
+   assert(shift < sg_hamtHashBits);
+   return uint32_t(1) << ((hash >> shift) & 31);
+}
+
+/// The position of the entry or child of \p bit in the arrays of a node.
+inline unsigned hamt_index(uint32_t bitmap, uint32_t bit)
+{
+   return polar::utils::count_population(bitmap & (bit - 1));
+}
+
+/// A node of the trie. The entries and children follow the header in one
+/// allocation, both in the order of their bitmap bits. Below the last level
+/// of bitmap nodes the keys have equal hashes, so these collision nodes only
+/// hold entries and leave the bitmaps zero.
+///
+/// The reference count is not atomic, so the versions sharing a node have to
+/// stay on one thread.
+template <typename EntryT>
+class HamtNode
+{
+public:
+   static_assert(alignof(EntryT) <= alignof(std::max_align_t), "over-aligned entries");
+
+   /// Allocates a node whose entries and children are not constructed yet.
+   static HamtNode *create(uint32_t dataMap, uint32_t nodeMap, unsigned numEntries,
+                           size_t size)
+   {
+      unsigned numChildren = polar::utils::count_population(nodeMap);
+      size_t allocSize = getChildrenOffset(numEntries) + numChildren * sizeof(HamtNode *);
+      void *memory = polar::utils::safe_malloc(allocSize);
+      return new (memory) HamtNode(dataMap, nodeMap, numEntries, size);
+   }
+
+   void retain() const
+   {
+      ++m_refCount;
+   }
+
+   void release() const
+   {
+      assert(m_refCount > 0 && "node released too often");
+      if (--m_refCount == 0) {
+         const_cast<HamtNode *>(this)->destroy();
+      }
+   }
+
+   uint32_t getDataMap() const
+   {
+      return m_dataMap;
+   }
+
+   uint32_t getNodeMap() const
+   {
+      return m_nodeMap;
+   }
+
+   unsigned getNumEntries() const
+   {
+      return m_numEntries;
+   }
+
+   unsigned getNumChildren() const
+   {
+      return polar::utils::count_population(m_nodeMap);
+   }
+
+   /// The number of entries in the subtree.
+   size_t getSize() const
+   {
+      return m_size;
+   }
+
+   EntryT *getEntries()
+   {
+      return reinterpret_cast<EntryT *>(reinterpret_cast<char *>(this) + getEntriesOffset());
+   }
+
+   const EntryT *getEntries() const
+   {
+      return const_cast<HamtNode *>(this)->getEntries();
+   }
+
+   const EntryT &getEntry(uint32_t bit) const
+   {
+      assert((m_dataMap & bit) && "no entry at this bit");
+      return getEntries()[hamt_index(m_dataMap, bit)];
+   }
+
+   HamtNode **getChildren()
+   {
+      return reinterpret_cast<HamtNode **>(reinterpret_cast<char *>(this) +
+                                           getChildrenOffset(m_numEntries));
+   }
+
+   HamtNode *const *getChildren() const
+   {
+      return const_cast<HamtNode *>(this)->getChildren();
+   }
+
+   HamtNode *getChild(uint32_t bit) const
+   {
+      assert((m_nodeMap & bit) && "no child at this bit");
+      return getChildren()[hamt_index(m_nodeMap, bit)];
+   }
+
+private:
+   HamtNode(uint32_t dataMap, uint32_t nodeMap, unsigned numEntries, size_t size)
+      : m_dataMap(dataMap),
+        m_nodeMap(nodeMap),
+        m_numEntries(numEntries),
+        m_size(size)
+   {}
+
+   static constexpr size_t getEntriesOffset()
+   {
+      return (sizeof(HamtNode) + alignof(EntryT) - 1) / alignof(EntryT) * alignof(EntryT);
+   }
+
+   static constexpr size_t getChildrenOffset(unsigned numEntries)
+   {
+      return (getEntriesOffset() + numEntries * sizeof(EntryT) + alignof(HamtNode *) - 1) /
+            alignof(HamtNode *) * alignof(HamtNode *);
+   }
+
+   void destroy()
+   {
+      EntryT *entries = getEntries();
+      for (unsigned index = 0; index != m_numEntries; ++index) {
+         entries[index].~EntryT();
+      }
+      HamtNode **children = getChildren();
+      for (unsigned index = 0, count = getNumChildren(); index != count; ++index) {
+         children[index]->release();
+      }
+      this->~HamtNode();
+      std::free(this);
+   }
+
+private:
+   mutable unsigned m_refCount = 1;
+   uint32_t m_dataMap;
+   uint32_t m_nodeMap;
+   uint32_t m_numEntries;
+   size_t m_size;
+};
+
+/// Visits the entries of a trie, those of a node before the ones of its
+/// children.
+template <typename EntryT>
+class HamtIterator
+{
+public:
+   using iterator_category = std::forward_iterator_tag;
+   using value_type = EntryT;
+   using difference_type = std::ptrdiff_t;
+   using pointer = const EntryT *;
+   using reference = const EntryT &;
+
+   HamtIterator() = default;
+
+   explicit HamtIterator(const HamtNode<EntryT> *root)
+   {
+      if (root) {
+         m_stack[0] = {root, 0, 0};
+         m_depth = 0;
+         advance();
+      }
+   }
+
+   reference operator*() const
+   {
+      assert(m_current && "dereferencing the end iterator");
+      return *m_current;
+   }
+
+   pointer operator->() const
+   {
+      return &operator*();
+   }
+
+   bool operator==(const HamtIterator &other) const
+   {
+      return m_current == other.m_current;
+   }
+
+   bool operator!=(const HamtIterator &other) const
+   {
+      return m_current != other.m_current;
+   }
+
+   HamtIterator &operator++()
+   {
+      advance();
+      return *this;
+   }
+
+   HamtIterator operator++(int)
+   {
+      HamtIterator result = *this;
+      advance();
+      return result;
+   }
+
+private:
+   void advance()
+   {
+      while (m_depth >= 0) {
+         Frame &frame = m_stack[m_depth];
+         if (frame.entry != frame.node->getNumEntries()) {
+            m_current = &frame.node->getEntries()[frame.entry++];
+            return;
+         }
+         if (frame.child != frame.node->getNumChildren()) {
+            const HamtNode<EntryT> *child = frame.node->getChildren()[frame.child++];
+            assert(m_depth + 1 < static_cast<int>(sg_hamtMaxDepth) && "trie too deep");
+            m_stack[++m_depth] = {child, 0, 0};
+            continue;
+         }
+         --m_depth;
+      }
+      m_current = nullptr;
+   }
+
+   struct Frame
+   {
+      const HamtNode<EntryT> *node;
+      unsigned entry;
+      unsigned child;
+   };
+
+private:
+   Frame m_stack[sg_hamtMaxDepth];
+   int m_depth = -1;
+   const EntryT *m_current = nullptr;
+};
+
+/// The algorithms of the trie, shared by the map and the set. Traits provide
+/// the entry and key types and getKey(), getHash() and isEqual() for them.
+///
+/// The tries are kept canonical: a node that is not the root never holds a
+/// single entry and no children, that entry is stored in the parent instead.
+/// So the shape of a trie only depends on its keys, and the set operations
+/// can compare subtrees by address.
+///
+/// The functions return nodes with a reference owned by the caller, or null
+/// for an empty trie.
+template <typename Traits>
+class HamtTrie
+{
+public:
+   using EntryT = typename Traits::EntryType;
+   using KeyT = typename Traits::KeyType;
+   using NodeT = HamtNode<EntryT>;
+
+   static uint32_t getEntryHash(const EntryT &entry)
+   {
+      return Traits::getHash(Traits::getKey(entry));
+   }
+
+   static bool hasKey(const EntryT &entry, const KeyT &key)
+   {
+      return Traits::isEqual(Traits::getKey(entry), key);
+   }
+
+   static const EntryT *find(const NodeT *node, const KeyT &key, uint32_t hash,
+                             unsigned shift = 0)
+   {
+      for (; node; shift += sg_hamtBitsPerLevel) {
+         if (shift >= sg_hamtHashBits) {
+            return findCollision(node, key);
+         }
+         uint32_t bit = hamt_bit(hash, shift);
+         if (node->getDataMap() & bit) {
+            const EntryT &entry = node->getEntry(bit);
+            return hasKey(entry, key) ? &entry : nullptr;
+         }
+         if (!(node->getNodeMap() & bit)) {
+            return nullptr;
+         }
+         node = node->getChild(bit);
+      }
+      return nullptr;
+   }
+
+   /// Adds \p entry, or replaces the entry with its key by
+   /// combine(existing, entry).
+   template <typename CombineT>
+   static NodeT *insert(const NodeT *node, const EntryT &entry, uint32_t hash,
+                        unsigned shift, CombineT &combine)
+   {
+      Builder builder;
+      std::optional<EntryT> combined;
+      if (shift >= sg_hamtHashBits) {
+         bool found = false;
+         for (unsigned index = 0; node && index != node->getNumEntries(); ++index) {
+            const EntryT &existing = node->getEntries()[index];
+            if (!found && hasKey(existing, Traits::getKey(entry))) {
+               combined.emplace(combine(existing, entry));
+               builder.addEntry(0, *combined);
+               found = true;
+            } else {
+               builder.addEntry(0, existing);
+            }
+         }
+         if (!found) {
+            builder.addEntry(0, entry);
+         }
+         return builder.finish();
+      }
+      uint32_t bit = hamt_bit(hash, shift);
+      if (!node) {
+         builder.addEntry(bit, entry);
+         return builder.finish();
+      }
+      for (uint32_t bits = node->getDataMap() | node->getNodeMap() | bit; bits;
+           bits &= bits - 1) {
+         uint32_t current = bits & (~bits + 1);
+         if (current != bit) {
+            builder.copySlot(node, current);
+         } else if (node->getDataMap() & bit) {
+            const EntryT &existing = node->getEntry(bit);
+            if (hasKey(existing, Traits::getKey(entry))) {
+               combined.emplace(combine(existing, entry));
+               builder.addEntry(bit, *combined);
+            } else {
+               builder.addChild(bit, makePair(existing, getEntryHash(existing), entry, hash,
+                                              shift + sg_hamtBitsPerLevel));
+            }
+         } else if (node->getNodeMap() & bit) {
+            builder.addChild(bit, insert(node->getChild(bit), entry, hash,
+                                         shift + sg_hamtBitsPerLevel, combine));
+         } else {
+            builder.addEntry(bit, entry);
+         }
+      }
+      return builder.finish();
+   }
+
+   /// Removes \p key, \p found tells if it was there. If it was not, the
+   /// result is null and the trie is unchanged.
+   static NodeT *remove(const NodeT *node, const KeyT &key, uint32_t hash,
+                        unsigned shift, bool &found)
+   {
+      found = false;
+      if (!node) {
+         return nullptr;
+      }
+      Builder builder;
+      if (shift >= sg_hamtHashBits) {
+         for (unsigned index = 0; index != node->getNumEntries(); ++index) {
+            const EntryT &existing = node->getEntries()[index];
+            if (!found && hasKey(existing, key)) {
+               found = true;
+            } else {
+               builder.addEntry(0, existing);
+            }
+         }
+         return found ? builder.finish() : nullptr;
+      }
+      uint32_t bit = hamt_bit(hash, shift);
+      NodeT *newChild = nullptr;
+      if (node->getDataMap() & bit) {
+         found = hasKey(node->getEntry(bit), key);
+      } else if (node->getNodeMap() & bit) {
+         newChild = remove(node->getChild(bit), key, hash, shift + sg_hamtBitsPerLevel, found);
+      }
+      if (!found) {
+         return nullptr;
+      }
+      for (uint32_t bits = node->getDataMap() | node->getNodeMap(); bits; bits &= bits - 1) {
+         uint32_t current = bits & (~bits + 1);
+         if (current != bit) {
+            builder.copySlot(node, current);
+         } else if (node->getNodeMap() & bit) {
+            builder.addSubtree(bit, newChild);
+         }
+      }
+      return builder.finish();
+   }
+
+   /// The union of two tries, entries with keys in both are
+   /// combine(lhsEntry, rhsEntry).
+   template <typename CombineT>
+   static NodeT *unite(const NodeT *lhs, const NodeT *rhs, unsigned shift, CombineT &combine)
+   {
+      if (!lhs || lhs == rhs) {
+         return retained(rhs);
+      }
+      if (!rhs) {
+         return retained(lhs);
+      }
+      Builder builder;
+      SmallVector<EntryT, 4> combined;
+      if (shift >= sg_hamtHashBits) {
+         combined.reserve(lhs->getNumEntries());
+         for (unsigned index = 0; index != lhs->getNumEntries(); ++index) {
+            const EntryT &entry = lhs->getEntries()[index];
+            if (const EntryT *other = findCollision(rhs, Traits::getKey(entry))) {
+               combined.push_back(combine(entry, *other));
+               builder.addEntry(0, combined.back());
+            } else {
+               builder.addEntry(0, entry);
+            }
+         }
+         for (unsigned index = 0; index != rhs->getNumEntries(); ++index) {
+            const EntryT &entry = rhs->getEntries()[index];
+            if (!findCollision(lhs, Traits::getKey(entry))) {
+               builder.addEntry(0, entry);
+            }
+         }
+         return builder.finish();
+      }
+      auto swappedCombine = [&combine](const EntryT &existing, const EntryT &entry) {
+         return combine(entry, existing);
+      };
+      combined.reserve(polar::utils::count_population(lhs->getDataMap() & rhs->getDataMap()));
+      unsigned nextShift = shift + sg_hamtBitsPerLevel;
+      for (uint32_t bits = lhs->getDataMap() | lhs->getNodeMap() | rhs->getDataMap() |
+           rhs->getNodeMap(); bits; bits &= bits - 1) {
+         uint32_t bit = bits & (~bits + 1);
+         bool lhsEntry = lhs->getDataMap() & bit;
+         bool lhsChild = lhs->getNodeMap() & bit;
+         bool rhsEntry = rhs->getDataMap() & bit;
+         bool rhsChild = rhs->getNodeMap() & bit;
+         if (!rhsEntry && !rhsChild) {
+            builder.copySlot(lhs, bit);
+         } else if (!lhsEntry && !lhsChild) {
+            builder.copySlot(rhs, bit);
+         } else if (lhsEntry && rhsEntry) {
+            const EntryT &lhsValue = lhs->getEntry(bit);
+            const EntryT &rhsValue = rhs->getEntry(bit);
+            if (hasKey(lhsValue, Traits::getKey(rhsValue))) {
+               combined.push_back(combine(lhsValue, rhsValue));
+               builder.addEntry(bit, combined.back());
+            } else {
+               builder.addChild(bit, makePair(lhsValue, getEntryHash(lhsValue), rhsValue,
+                                              getEntryHash(rhsValue), nextShift));
+            }
+         } else if (lhsEntry) {
+            const EntryT &entry = lhs->getEntry(bit);
+            builder.addChild(bit, insert(rhs->getChild(bit), entry, getEntryHash(entry),
+                                         nextShift, swappedCombine));
+         } else if (rhsEntry) {
+            const EntryT &entry = rhs->getEntry(bit);
+            builder.addChild(bit, insert(lhs->getChild(bit), entry, getEntryHash(entry),
+                                         nextShift, combine));
+         } else {
+            builder.addChild(bit, unite(lhs->getChild(bit), rhs->getChild(bit), nextShift,
+                                        combine));
+         }
+      }
+      return builder.finish();
+   }
+
+   /// The entries of \p lhs whose keys are in \p rhs if \p keepFound is set,
+   /// the ones whose keys are not otherwise.
+   static NodeT *filter(const NodeT *lhs, const NodeT *rhs, unsigned shift, bool keepFound)
+   {
+      if (!lhs) {
+         return nullptr;
+      }
+      if (!rhs || lhs == rhs) {
+         return (lhs == rhs) == keepFound ? retained(lhs) : nullptr;
+      }
+      Builder builder;
+      if (shift >= sg_hamtHashBits) {
+         for (unsigned index = 0; index != lhs->getNumEntries(); ++index) {
+            const EntryT &entry = lhs->getEntries()[index];
+            if ((findCollision(rhs, Traits::getKey(entry)) != nullptr) == keepFound) {
+               builder.addEntry(0, entry);
+            }
+         }
+         return keepUnchanged(lhs, builder.finish());
+      }
+      unsigned nextShift = shift + sg_hamtBitsPerLevel;
+      for (uint32_t bits = lhs->getDataMap() | lhs->getNodeMap(); bits; bits &= bits - 1) {
+         uint32_t bit = bits & (~bits + 1);
+         bool rhsEntry = rhs->getDataMap() & bit;
+         bool rhsChild = rhs->getNodeMap() & bit;
+         if (lhs->getDataMap() & bit) {
+            const EntryT &entry = lhs->getEntry(bit);
+            bool found = false;
+            if (rhsEntry) {
+               found = hasKey(rhs->getEntry(bit), Traits::getKey(entry));
+            } else if (rhsChild) {
+               found = find(rhs->getChild(bit), Traits::getKey(entry), getEntryHash(entry),
+                            nextShift) != nullptr;
+            }
+            if (found == keepFound) {
+               builder.addEntry(bit, entry);
+            }
+            continue;
+         }
+         const NodeT *child = lhs->getChild(bit);
+         if (rhsChild) {
+            builder.addSubtree(bit, filter(child, rhs->getChild(bit), nextShift, keepFound));
+         } else if (rhsEntry) {
+            const KeyT &key = Traits::getKey(rhs->getEntry(bit));
+            uint32_t hash = getEntryHash(rhs->getEntry(bit));
+            if (keepFound) {
+               if (const EntryT *entry = find(child, key, hash, nextShift)) {
+                  builder.addEntry(bit, *entry);
+               }
+            } else {
+               bool found;
+               NodeT *newChild = remove(child, key, hash, nextShift, found);
+               builder.addSubtree(bit, found ? newChild : retained(child));
+            }
+         } else if (!keepFound) {
+            builder.copySlot(lhs, bit);
+         }
+      }
+      return keepUnchanged(lhs, builder.finish());
+   }
+
+   /// Calls visit(lhsEntry, rhsEntry) for the keys in either trie, with null
+   /// for the side that lacks the key, skipping the subtrees both share. The
+   /// visit stops when the callback returns false, and so does the result.
+   template <typename VisitT>
+   static bool diff(const NodeT *lhs, const NodeT *rhs, unsigned shift, VisitT &visit)
+   {
+      if (lhs == rhs) {
+         return true;
+      }
+      if (!lhs || !rhs) {
+         return visitAll(lhs ? lhs : rhs, visit, lhs != nullptr);
+      }
+      if (shift >= sg_hamtHashBits) {
+         for (unsigned index = 0; index != lhs->getNumEntries(); ++index) {
+            const EntryT &entry = lhs->getEntries()[index];
+            if (!visit(&entry, findCollision(rhs, Traits::getKey(entry)))) {
+               return false;
+            }
+         }
+         for (unsigned index = 0; index != rhs->getNumEntries(); ++index) {
+            const EntryT &entry = rhs->getEntries()[index];
+            if (!findCollision(lhs, Traits::getKey(entry)) &&
+                !visit(static_cast<const EntryT *>(nullptr), &entry)) {
+               return false;
+            }
+         }
+         return true;
+      }
+      unsigned nextShift = shift + sg_hamtBitsPerLevel;
+      for (uint32_t bits = lhs->getDataMap() | lhs->getNodeMap() | rhs->getDataMap() |
+           rhs->getNodeMap(); bits; bits &= bits - 1) {
+         uint32_t bit = bits & (~bits + 1);
+         const EntryT *lhsEntry = (lhs->getDataMap() & bit) ? &lhs->getEntry(bit) : nullptr;
+         const EntryT *rhsEntry = (rhs->getDataMap() & bit) ? &rhs->getEntry(bit) : nullptr;
+         const NodeT *lhsChild = (lhs->getNodeMap() & bit) ? lhs->getChild(bit) : nullptr;
+         const NodeT *rhsChild = (rhs->getNodeMap() & bit) ? rhs->getChild(bit) : nullptr;
+         bool proceed = true;
+         if (lhsEntry && rhsEntry) {
+            if (hasKey(*lhsEntry, Traits::getKey(*rhsEntry))) {
+               proceed = visit(lhsEntry, rhsEntry);
+            } else {
+               proceed = visit(lhsEntry, static_cast<const EntryT *>(nullptr)) &&
+                     visit(static_cast<const EntryT *>(nullptr), rhsEntry);
+            }
+         } else if (lhsEntry || rhsEntry) {
+            // An entry on one side and a subtree or nothing on the other.
+            const EntryT *entry = lhsEntry ? lhsEntry : rhsEntry;
+            const NodeT *subtree = lhsEntry ? rhsChild : lhsChild;
+            const EntryT *match = subtree ? find(subtree, Traits::getKey(*entry),
+                                                 getEntryHash(*entry), nextShift)
+                                          : nullptr;
+            if (!match) {
+               proceed = lhsEntry ? visit(entry, static_cast<const EntryT *>(nullptr))
+                                  : visit(static_cast<const EntryT *>(nullptr), entry);
+            }
+            if (proceed && subtree) {
+               auto visitOthers = [&](const EntryT *lhsOther, const EntryT *rhsOther) {
+                  const EntryT *other = lhsOther ? lhsOther : rhsOther;
+                  if (other == match) {
+                     return lhsEntry ? visit(entry, match) : visit(match, entry);
+                  }
+                  return visit(lhsOther, rhsOther);
+               };
+               proceed = visitAll(subtree, visitOthers, subtree == lhsChild);
+            }
+         } else {
+            proceed = diff(lhsChild, rhsChild, nextShift, visit);
+         }
+         if (!proceed) {
+            return false;
+         }
+      }
+      return true;
+   }
+
+private:
+   static NodeT *retained(const NodeT *node)
+   {
+      if (node) {
+         node->retain();
+      }
+      return const_cast<NodeT *>(node);
+   }
+
+   /// Returns \p lhs instead of \p result if nothing was filtered out, so the
+   /// result shares its nodes.
+   static NodeT *keepUnchanged(const NodeT *lhs, NodeT *result)
+   {
+      if (result && result->getSize() == lhs->getSize()) {
+         result->release();
+         return retained(lhs);
+      }
+      return result;
+   }
+
+   static const EntryT *findCollision(const NodeT *node, const KeyT &key)
+   {
+      for (unsigned index = 0; index != node->getNumEntries(); ++index) {
+         if (hasKey(node->getEntries()[index], key)) {
+            return &node->getEntries()[index];
+         }
+      }
+      return nullptr;
+   }
+
+   /// A subtree of two entries with distinct keys.
+   static NodeT *makePair(const EntryT &first, uint32_t firstHash, const EntryT &second,
+                          uint32_t secondHash, unsigned shift)
+   {
+      Builder builder;
+      if (shift >= sg_hamtHashBits) {
+         builder.addEntry(0, first);
+         builder.addEntry(0, second);
+         return builder.finish();
+      }
+      uint32_t firstBit = hamt_bit(firstHash, shift);
+      uint32_t secondBit = hamt_bit(secondHash, shift);
+      if (firstBit == secondBit) {
+         builder.addChild(firstBit, makePair(first, firstHash, second, secondHash,
+                                             shift + sg_hamtBitsPerLevel));
+      } else if (firstBit < secondBit) {
+         builder.addEntry(firstBit, first);
+         builder.addEntry(secondBit, second);
+      } else {
+         builder.addEntry(secondBit, second);
+         builder.addEntry(firstBit, first);
+      }
+      return builder.finish();
+   }
+
+   /// Visits every entry of \p node, as the left side if \p asLhs is set.
+   template <typename VisitT>
+   static bool visitAll(const NodeT *node, VisitT &visit, bool asLhs)
+   {
+      for (unsigned index = 0; index != node->getNumEntries(); ++index) {
+         const EntryT *entry = &node->getEntries()[index];
+         if (!(asLhs ? visit(entry, static_cast<const EntryT *>(nullptr))
+                     : visit(static_cast<const EntryT *>(nullptr), entry))) {
+            return false;
+         }
+      }
+      for (unsigned index = 0, count = node->getNumChildren(); index != count; ++index) {
+         if (!visitAll(node->getChildren()[index], visit, asLhs)) {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /// Collects the slots of a new node in the order of their bits. The entries
+   /// are copied when the node is made, so they have to outlive the builder.
+   class Builder
+   {
+   public:
+      Builder() = default;
+      Builder(const Builder &) = delete;
+      Builder &operator=(const Builder &) = delete;
+
+      ~Builder()
+      {
+         for (NodeT *child : m_children) {
+            child->release();
+         }
+         for (NodeT *node : m_inlined) {
+            node->release();
+         }
+      }
+
+      void addEntry(uint32_t bit, const EntryT &entry)
+      {
+         assert(bit > m_lastEntryBit || bit == 0);
+         m_dataMap |= bit;
+         m_lastEntryBit = bit;
+         m_entries.push_back(&entry);
+      }
+
+      /// Adds a subtree the builder takes the reference of.
+      void addChild(uint32_t bit, NodeT *child)
+      {
+         assert(child && bit > m_lastChildBit);
+         m_nodeMap |= bit;
+         m_lastChildBit = bit;
+         m_size += child->getSize();
+         m_children.push_back(child);
+      }
+
+      /// Adds a subtree that may have shrunk, an empty one is dropped and one
+      /// with a single entry is stored as that entry.
+      void addSubtree(uint32_t bit, NodeT *child)
+      {
+         if (!child) {
+            return;
+         }
+         if (child->getSize() == 1 && child->getNumChildren() == 0) {
+            addEntry(bit, child->getEntries()[0]);
+            m_inlined.push_back(child);
+            return;
+         }
+         addChild(bit, child);
+      }
+
+      void copySlot(const NodeT *node, uint32_t bit)
+      {
+         if (node->getDataMap() & bit) {
+            addEntry(bit, node->getEntry(bit));
+         } else {
+            addChild(bit, retained(node->getChild(bit)));
+         }
+      }
+
+      NodeT *finish()
+      {
+         if (m_entries.empty() && m_children.empty()) {
+            return nullptr;
+         }
+         NodeT *node = NodeT::create(m_dataMap, m_nodeMap, m_entries.size(),
+                                     m_size + m_entries.size());
+         EntryT *entries = node->getEntries();
+         for (size_t index = 0, count = m_entries.size(); index != count; ++index) {
+            new (&entries[index]) EntryT(*m_entries[index]);
+         }
+         NodeT **children = node->getChildren();
+         for (size_t index = 0, count = m_children.size(); index != count; ++index) {
+            children[index] = m_children[index];
+         }
+         m_children.clear();
+         return node;
+      }
+
+   private:
+      uint32_t m_dataMap = 0;
+      uint32_t m_nodeMap = 0;
+      uint32_t m_lastEntryBit = 0;
+      uint32_t m_lastChildBit = 0;
+      size_t m_size = 0;
+      SmallVector<const EntryT *, 32> m_entries;
+      SmallVector<NodeT *, 32> m_children;
+      /// Single entry subtrees whose entry was added, released at the end.
+      SmallVector<NodeT *, 2> m_inlined;
+   };
+};
+
+/// Holds the root of a trie and its reference.
+template <typename Traits>
+class HamtRoot
+{
+public:
+   using NodeT = HamtNode<typename Traits::EntryType>;
+
+   HamtRoot() = default;
+
+   explicit HamtRoot(NodeT *root)
+      : m_root(root)
+   {}
+
+   HamtRoot(const HamtRoot &other)
+      : m_root(other.m_root)
+   {
+      if (m_root) {
+         m_root->retain();
+      }
+   }
+
+   HamtRoot(HamtRoot &&other)
+      : m_root(other.m_root)
+   {
+      other.m_root = nullptr;
+   }
+
+   ~HamtRoot()
+   {
+      if (m_root) {
+         m_root->release();
+      }
+   }
+
+   HamtRoot &operator=(HamtRoot other)
+   {
+      std::swap(m_root, other.m_root);
+      return *this;
+   }
+
+   const NodeT *get() const
+   {
+      return m_root;
+   }
+
+   size_t getSize() const
+   {
+      return m_root ? m_root->getSize() : 0;
+   }
+
+private:
+   NodeT *m_root = nullptr;
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT>
+struct PersistentHashMapTraits
+{
+   using EntryType = std::pair<KeyT, ValueT>;
+   using KeyType = KeyT;
+
+   static const KeyT &getKey(const EntryType &entry)
+   {
+      return entry.first;
+   }
+
+   static uint32_t getHash(const KeyT &key)
+   {
+      return hamt_mix_hash(KeyInfoT::getHashValue(key));
+   }
+
+   static bool isEqual(const KeyT &lhs, const KeyT &rhs)
+   {
+      return KeyInfoT::isEqual(lhs, rhs);
+   }
+};
+
+template <typename KeyT, typename KeyInfoT>
+struct PersistentHashSetTraits
+{
+   using EntryType = KeyT;
+   using KeyType = KeyT;
+
+   static const KeyT &getKey(const KeyT &entry)
+   {
+      return entry;
+   }
+
+   static uint32_t getHash(const KeyT &key)
+   {
+      return hamt_mix_hash(KeyInfoT::getHashValue(key));
+   }
+
+   static bool isEqual(const KeyT &lhs, const KeyT &rhs)
+   {
+      return KeyInfoT::isEqual(lhs, rhs);
+   }
+};
+
+} // internal
+
+/// An immutable map that shares structure between versions, a hash array
+/// mapped trie in the compressed layout of Steindorfer and Vinju. A version
+/// made by add() or remove() copies the at most eight nodes on the path to
+/// the key and shares all others, so forking the state of an analysis is a
+/// reference count increment and changing a fork costs O(log32 n).
+///
+/// The nodes are reference counted and freed with the last version that
+/// uses them, no factory has to outlive the maps. The tries are canonical,
+/// so unionWith(), intersectWith(), difference() and forEachDifference()
+/// skip the subtrees two versions share, which makes merging the states of
+/// two branches proportional to what the branches changed.
+///
+/// The keys use the getHashValue() and isEqual() of KeyInfoT, the empty and
+/// tombstone keys are not needed and may be stored. Versions that share
+/// nodes must stay on one thread.
+template <typename KeyT, typename ValueT, typename KeyInfoT = DenseMapInfo<KeyT>>
+class PersistentHashMap
+{
+   using Traits = internal::PersistentHashMapTraits<KeyT, ValueT, KeyInfoT>;
+   using TrieType = internal::HamtTrie<Traits>;
+   using RootType = internal::HamtRoot<Traits>;
+
+public:
+   using EntryType = std::pair<KeyT, ValueT>;
+   using Iterator = internal::HamtIterator<EntryType>;
+
+   PersistentHashMap() = default;
+
+   bool isEmpty() const
+   {
+      return m_root.get() == nullptr;
+   }
+
+   size_t getSize() const
+   {
+      return m_root.getSize();
+   }
+
+   const ValueT *lookup(const KeyT &key) const
+   {
+      const EntryType *entry = TrieType::find(m_root.get(), key, Traits::getHash(key));
+      return entry ? &entry->second : nullptr;
+   }
+
+   bool contains(const KeyT &key) const
+   {
+      return lookup(key) != nullptr;
+   }
+
+   /// Returns a map with \p key mapped to \p value, which replaces the value
+   /// of the key in this map if it has one.
+   PersistentHashMap add(const KeyT &key, const ValueT &value) const
+   {
+      EntryType entry(key, value);
+      auto replace = [](const EntryType &, const EntryType &newEntry) {
+         return newEntry;
+      };
+      return PersistentHashMap(TrieType::insert(m_root.get(), entry, Traits::getHash(key), 0,
+                                                replace));
+   }
+
+   /// Returns a map without \p key, which is this map if the key is not in it.
+   PersistentHashMap remove(const KeyT &key) const
+   {
+      bool found;
+      typename RootType::NodeT *root = TrieType::remove(m_root.get(), key, Traits::getHash(key),
+                                                        0, found);
+      return found ? PersistentHashMap(root) : *this;
+   }
+
+   /// The keys of both maps, with the values of \p other for the keys in both.
+   PersistentHashMap unionWith(const PersistentHashMap &other) const
+   {
+      return unionWith(other, [](const KeyT &, const ValueT &, const ValueT &value) {
+         return value;
+      });
+   }
+
+   /// The keys of both maps, with merge(key, value, otherValue) for the keys
+   /// in both. The subtrees both maps share are taken as they are, so merge
+   /// has to return the value it is given twice, as the join of a lattice
+   /// does.
+   template <typename MergeT>
+   PersistentHashMap unionWith(const PersistentHashMap &other, MergeT merge) const
+   {
+      auto combine = [&merge](const EntryType &lhs, const EntryType &rhs) {
+         return EntryType(lhs.first, merge(lhs.first, lhs.second, rhs.second));
+      };
+      return PersistentHashMap(TrieType::unite(m_root.get(), other.m_root.get(), 0, combine));
+   }
+
+   /// The entries of this map whose keys are in \p other.
+   PersistentHashMap intersectWith(const PersistentHashMap &other) const
+   {
+      return PersistentHashMap(TrieType::filter(m_root.get(), other.m_root.get(), 0, true));
+   }
+
+   /// The entries of this map whose keys are not in \p other.
+   PersistentHashMap difference(const PersistentHashMap &other) const
+   {
+      return PersistentHashMap(TrieType::filter(m_root.get(), other.m_root.get(), 0, false));
+   }
+
+   /// Calls callback(key, value, otherValue) for every key that is in one map
+   /// only or has different values in both, with null for a missing value.
+   template <typename CallbackT>
+   void forEachDifference(const PersistentHashMap &other, CallbackT callback) const
+   {
+      auto visit = [&callback](const EntryType *lhs, const EntryType *rhs) {
+         if (!lhs || !rhs || !(lhs->second == rhs->second)) {
+            const KeyT &key = lhs ? lhs->first : rhs->first;
+            callback(key, lhs ? &lhs->second : nullptr, rhs ? &rhs->second : nullptr);
+         }
+         return true;
+      };
+      TrieType::diff(m_root.get(), other.m_root.get(), 0, visit);
+   }
+
+   bool operator==(const PersistentHashMap &other) const
+   {
+      if (getSize() != other.getSize()) {
+         return false;
+      }
+      auto visit = [](const EntryType *lhs, const EntryType *rhs) {
+         return lhs && rhs && lhs->second == rhs->second;
+      };
+      return TrieType::diff(m_root.get(), other.m_root.get(), 0, visit);
+   }
+
+   bool operator!=(const PersistentHashMap &other) const
+   {
+      return !(*this == other);
+   }
+
+   /// Tells if both maps share their root, which makes them equal, without
+   /// looking at the entries.
+   bool isIdenticalTo(const PersistentHashMap &other) const
+   {
+      return m_root.get() == other.m_root.get();
+   }
+
+   Iterator begin() const
+   {
+      return Iterator(m_root.get());
+   }
+
+   Iterator end() const
+   {
+      return Iterator();
+   }
+
+private:
+   explicit PersistentHashMap(typename RootType::NodeT *root)
+      : m_root(root)
+   {}
+
+private:
+   RootType m_root;
+};
+
+/// The set counterpart of PersistentHashMap.
+template <typename KeyT, typename KeyInfoT = DenseMapInfo<KeyT>>
+class PersistentHashSet
+{
+   using Traits = internal::PersistentHashSetTraits<KeyT, KeyInfoT>;
+   using TrieType = internal::HamtTrie<Traits>;
+   using RootType = internal::HamtRoot<Traits>;
+
+public:
+   using Iterator = internal::HamtIterator<KeyT>;
+
+   PersistentHashSet() = default;
+
+   bool isEmpty() const
+   {
+      return m_root.get() == nullptr;
+   }
+
+   size_t getSize() const
+   {
+      return m_root.getSize();
+   }
+
+   bool contains(const KeyT &key) const
+   {
+      return TrieType::find(m_root.get(), key, Traits::getHash(key)) != nullptr;
+   }
+
+   /// Returns a set with \p key, which is this set if the key is in it.
+   PersistentHashSet add(const KeyT &key) const
+   {
+      uint32_t hash = Traits::getHash(key);
+      if (TrieType::find(m_root.get(), key, hash)) {
+         return *this;
+      }
+      auto keep = [](const KeyT &existing, const KeyT &) {
+         return existing;
+      };
+      return PersistentHashSet(TrieType::insert(m_root.get(), key, hash, 0, keep));
+   }
+
+   /// Returns a set without \p key, which is this set if the key is not in it.
+   PersistentHashSet remove(const KeyT &key) const
+   {
+      bool found;
+      typename RootType::NodeT *root = TrieType::remove(m_root.get(), key, Traits::getHash(key),
+                                                        0, found);
+      return found ? PersistentHashSet(root) : *this;
+   }
+
+   PersistentHashSet unionWith(const PersistentHashSet &other) const
+   {
+      auto keep = [](const KeyT &existing, const KeyT &) {
+         return existing;
+      };
+      return PersistentHashSet(TrieType::unite(m_root.get(), other.m_root.get(), 0, keep));
+   }
+
+   PersistentHashSet intersectWith(const PersistentHashSet &other) const
+   {
+      return PersistentHashSet(TrieType::filter(m_root.get(), other.m_root.get(), 0, true));
+   }
+
+   /// The keys of this set that are not in \p other.
+   PersistentHashSet difference(const PersistentHashSet &other) const
+   {
+      return PersistentHashSet(TrieType::filter(m_root.get(), other.m_root.get(), 0, false));
+   }
+
+   /// Calls callback(key, inThisSet) for every key that is in one set only.
+   template <typename CallbackT>
+   void forEachDifference(const PersistentHashSet &other, CallbackT callback) const
+   {
+      auto visit = [&callback](const KeyT *lhs, const KeyT *rhs) {
+         if (!lhs || !rhs) {
+            callback(lhs ? *lhs : *rhs, lhs != nullptr);
+         }
+         return true;
+      };
+      TrieType::diff(m_root.get(), other.m_root.get(), 0, visit);
+   }
+
+   bool operator==(const PersistentHashSet &other) const
+   {
+      if (getSize() != other.getSize()) {
+         return false;
+      }
+      auto visit = [](const KeyT *lhs, const KeyT *rhs) {
+         return lhs && rhs;
+      };
+      return TrieType::diff(m_root.get(), other.m_root.get(), 0, visit);
+   }
+
+   bool operator!=(const PersistentHashSet &other) const
+   {
+      return !(*this == other);
+   }
+
+   bool isIdenticalTo(const PersistentHashSet &other) const
+   {
+      return m_root.get() == other.m_root.get();
+   }
+
+   Iterator begin() const
+   {
+      return Iterator(m_root.get());
+   }
+
+   Iterator end() const
+   {
+      return Iterator();
+   }
+
+private:
+   explicit PersistentHashSet(typename RootType::NodeT *root)
+      : m_root(root)
+   {}
+
+private:
+   RootType m_root;
+};
+
+} // polar::basic
+
+#endif // POLARPHP_BASIC_ADT_PERSISTENT_HASH_MAP_H
@@ -12,6 +12,7 @@
 #ifndef POLARPHP_BASIC_ADT_SPARSE_BIT_VECTOR_H
 #define POLARPHP_BASIC_ADT_SPARSE_BIT_VECTOR_H
 
+#include "polarphp/basic/adt/BitVectorKernels.h"
 #include "polarphp/utils/ErrorHandling.h"
 #include "polarphp/utils/MathExtras.h"
 #include "polarphp/utils/RawOutStream.h"
@@ -42,6 +43,13 @@ using polar::utils::RawOutStream;
 /// have better worst cases for insertion in the middle (various balanced trees,
 /// etc) do not perform as well in practice as a linked list with this iterator
 /// kept up to date.  They are also significantly more memory intensive.
+///
+/// Sets that are dense in places are best kept with a larger ElementSize,
+/// 512 bits or more, whose elements are combined with the vectorized word
+/// kernels of BitVector instead of word by word. The default 128 bit element
+/// is two words, which the kernels handle with inline loops. Adjacent
+/// elements are separate list nodes, so they cannot be batched either, and
+/// sparse sets with the default ElementSize see no speedup from the kernels.
 
 template <unsigned ElementSize = 128>
 struct SparseBitVectorElement
@@ -106,12 +114,7 @@ public:
 
    bool empty() const
    {
-      for (unsigned i = 0; i < BITWORDS_PER_ELEMENT; ++i) {
-         if (m_bits[i]) {
-            return false;
-         }
-      }
-      return true;
+      return internal::find_non_zero_word(m_bits, BITWORDS_PER_ELEMENT) == BITWORDS_PER_ELEMENT;
    }
 
    void set(unsigned idx)
@@ -141,11 +144,7 @@ public:
 
    size_type count() const
    {
-      unsigned numBits = 0;
-      for (unsigned i = 0; i < BITWORDS_PER_ELEMENT; ++i) {
-         numBits += count_population(m_bits[i]);
-      }
-      return numBits;
+      return internal::count_population_words(m_bits, BITWORDS_PER_ELEMENT);
    }
 
    /// findFirst - Returns the index of the first set bit.
@@ -203,15 +202,7 @@ public:
    // Union this element with other and return true if this one changed.
    bool unionWith(const SparseBitVectorElement &other)
    {
-      bool changed = false;
-      for (unsigned i = 0; i < BITWORDS_PER_ELEMENT; ++i) {
-         BitWord old = changed ? 0 : m_bits[i];
-         m_bits[i] |= other.m_bits[i];
-         if (!changed && old != m_bits[i]) {
-            changed = true;
-         }
-      }
-      return changed;
+      return internal::bitwise_or_words(m_bits, other.m_bits, BITWORDS_PER_ELEMENT);
    }
 
    // Return true if we have any bits in common with other
@@ -230,20 +221,8 @@ public:
    bool intersectWith(const SparseBitVectorElement &other,
                       bool &becameZero)
    {
-      bool changed = false;
-      bool allzero = true;
-      becameZero = false;
-      for (unsigned i = 0; i < BITWORDS_PER_ELEMENT; ++i) {
-         BitWord old = changed ? 0 : m_bits[i];
-         m_bits[i] &= other.m_bits[i];
-         if (m_bits[i] != 0) {
-            allzero = false;
-         }
-         if (!changed && old != m_bits[i]) {
-            changed = true;
-         }
-      }
-      becameZero = allzero;
+      bool changed = internal::bitwise_and_words(m_bits, other.m_bits, BITWORDS_PER_ELEMENT);
+      becameZero = empty();
       return changed;
    }
 
@@ -253,21 +232,8 @@ public:
    bool intersectWithComplement(const SparseBitVectorElement &other,
                                 bool &becameZero)
    {
-      bool changed = false;
-      bool allzero = true;
-      becameZero = false;
-      for (unsigned i = 0; i < BITWORDS_PER_ELEMENT; ++i) {
-         BitWord old = changed ? 0 : m_bits[i];
-
-         m_bits[i] &= ~other.m_bits[i];
-         if (m_bits[i] != 0) {
-            allzero = false;
-         }
-         if (!changed && old != m_bits[i]) {
-            changed = true;
-         }
-      }
-      becameZero = allzero;
+      bool changed = internal::bitwise_and_not_words(m_bits, other.m_bits, BITWORDS_PER_ELEMENT);
+      becameZero = empty();
       return changed;
    }
 
@@ -277,15 +243,9 @@ public:
                                 const SparseBitVectorElement &rhs,
                                 bool &becameZero)
    {
-      bool allzero = true;
-      becameZero = false;
-      for (unsigned i = 0; i < BITWORDS_PER_ELEMENT; ++i) {
-         m_bits[i] = lhs.m_bits[i] & ~rhs.m_bits[i];
-         if (m_bits[i] != 0) {
-            allzero = false;
-         }
-      }
-      becameZero = allzero;
+      memcpy(&m_bits[0], &lhs.m_bits[0], sizeof (BitWord) * BITWORDS_PER_ELEMENT);
+      internal::bitwise_and_not_words(m_bits, rhs.m_bits, BITWORDS_PER_ELEMENT);
+      becameZero = empty();
    }
 };
 
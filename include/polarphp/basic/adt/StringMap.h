@@ -100,12 +100,22 @@ protected:
    /// specified bucket will be non-null.  Otherwise, it will be null.  In either
    /// case, the FullHashValue field of the bucket will be set to the hash value
    /// of the string.
-   unsigned lookupBucketFor(StringRef key);
+   unsigned lookupBucketFor(StringRef key)
+   {
+      return lookupBucketFor(key, hash(key));
+   }
+
+   unsigned lookupBucketFor(StringRef key, uint32_t fullHashValue);
 
    /// FindKey - Look up the bucket that contains the specified key. If it exists
    /// in the map, return the bucket number of the key.  Otherwise return -1.
    /// This does not modify the map.
-   int findKey(StringRef key) const;
+   int findKey(StringRef key) const
+   {
+      return findKey(key, hash(key));
+   }
+
+   int findKey(StringRef key, uint32_t fullHashValue) const;
 
    /// RemoveKey - Remove the specified StringMapEntry from the table, but do not
    /// delete it.  This aborts if the value isn't in the table.
@@ -120,6 +130,10 @@ protected:
    void init(unsigned size);
 
 public:
+   /// The hash of \p key that the map uses. Lookups with a precomputed hash
+   /// have to pass this value, CachedHashStringRef caches it.
+   static uint32_t hash(StringRef key);
+
    static StringMapEntryBase *getTombstoneValue()
    {
       uintptr_t value = static_cast<uintptr_t>(-1);
@@ -427,16 +441,28 @@ public:
 
    iterator find(StringRef key)
    {
-      int bucket = findKey(key);
+      return find(key, hash(key));
+   }
+
+   const_iterator find(StringRef key) const
+   {
+      return find(key, hash(key));
+   }
+
+   /// Find \p key, whose hash() is \p fullHashValue, without hashing it
+   /// again.
+   iterator find(StringRef key, uint32_t fullHashValue)
+   {
+      int bucket = findKey(key, fullHashValue);
       if (bucket == -1) {
          return end();
       }
       return iterator(m_theTable + bucket, true);
    }
 
-   const_iterator find(StringRef key) const
+   const_iterator find(StringRef key, uint32_t fullHashValue) const
    {
-      int bucket = findKey(key);
+      int bucket = findKey(key, fullHashValue);
       if (bucket == -1) {
          return end();
       }
@@ -467,6 +493,11 @@ public:
       return find(key) == end() ? 0 : 1;
    }
 
+   size_type count(StringRef key, uint32_t fullHashValue) const
+   {
+      return find(key, fullHashValue) == end() ? 0 : 1;
+   }
+
    template <typename InputTy>
    size_type count(const StringMapEntry<InputTy> &entry) const
    {
@@ -503,6 +534,13 @@ public:
       return tryEmplace(item.first, std::move(item.second));
    }
 
+   /// insert - Like the above, with the hash() of the key precomputed.
+   std::pair<iterator, bool> insert(std::pair<StringRef, ValueType> item,
+                                    uint32_t fullHashValue)
+   {
+      return tryEmplaceWithHash(item.first, fullHashValue, std::move(item.second));
+   }
+
    /// Emplace a new element for the specified key into the map if the key isn't
    /// already in the map. The bool component of the returned pair is true
    /// if and only if the insertion takes place, and the iterator component of
@@ -510,7 +548,15 @@ public:
    template <typename... ArgsType>
    std::pair<iterator, bool> tryEmplace(StringRef key, ArgsType &&... args)
    {
-      unsigned bucketNo = lookupBucketFor(key);
+      return tryEmplaceWithHash(key, hash(key), std::forward<ArgsType>(args)...);
+   }
+
+   /// tryEmplace - Like the above, with the hash() of the key precomputed.
+   template <typename... ArgsType>
+   std::pair<iterator, bool> tryEmplaceWithHash(StringRef key, uint32_t fullHashValue,
+                                                ArgsType &&... args)
+   {
+      unsigned bucketNo = lookupBucketFor(key, fullHashValue);
       StringMapEntryBase *&bucket = m_theTable[bucketNo];
       if (bucket && bucket != getTombstoneValue())
          return std::make_pair(iterator(m_theTable + bucketNo, false),
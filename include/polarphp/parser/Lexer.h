@@ -26,6 +26,10 @@
 
 #include <stack>
 
+namespace polar::utils {
+class ConcurrentStringInterner;
+} // polar::utils
+
 namespace polar::parser {
 
 namespace internal {
@@ -414,6 +418,19 @@ public:
       return *this;
    }
 
+   /// Intern the names of identifier and variable tokens in \p interner,
+   /// which may be shared by the lexers of several threads.
+   Lexer &setStringInterner(polar::utils::ConcurrentStringInterner *interner)
+   {
+      m_stringInterner = interner;
+      return *this;
+   }
+
+   polar::utils::ConcurrentStringInterner *getStringInterner() const
+   {
+      return m_stringInterner;
+   }
+
    Lexer &setSemanticValueContainer(ParserSemantic *container)
    {
       m_valueContainer = container;
@@ -485,6 +502,7 @@ private:
    void formVariableToken(const unsigned char *tokenStart);
    void formIdentifierToken(const unsigned char *tokenStart);
    void formStringVariableToken(const unsigned char *tokenStart);
+   void setNameValue(StringRef name);
    void formErrorToken(const unsigned char *tokenStart);
 
    /// Advance to the end of the line.
@@ -553,6 +571,7 @@ private:
    const unsigned int m_bufferId;
    DiagnosticEngine *m_diags;
    Parser *m_parser = nullptr;
+   polar::utils::ConcurrentStringInterner *m_stringInterner = nullptr;
 
    /// Pointer to the first character of the buffer, even in a lexer that
    /// scans a subrange of the buffer.
@@ -25,10 +25,12 @@
 
 #include "polarphp/basic/adt/ArrayRef.h"
 #include "polarphp/basic/adt/SmallVector.h"
+#include "polarphp/utils/Allocator.h"
 
 namespace polar::syntax {
 enum class TriviaKind : uint8_t;
 struct Trivia;
+class CompactTrivia;
 } // polar::syntax
 
 namespace polar::parser {
@@ -88,6 +90,11 @@ public:
    static syntax::Trivia
    convertToSyntaxTrivia(ArrayRef<ParsedTriviaPiece> pieces, SourceLoc loc,
                          const SourceManager &sourceMgr, unsigned bufferID);
+
+   /// Encode \p pieces without copying any text, see CompactTrivia.h.
+   static syntax::CompactTrivia
+   convertToCompactTrivia(ArrayRef<ParsedTriviaPiece> pieces,
+                          polar::utils::BumpPtrAllocator &allocator);
 private:
    syntax::TriviaKind m_kind;
    unsigned m_length;
@@ -170,6 +177,9 @@ struct ParsedTrivia
 
    syntax::Trivia convertToSyntaxTrivia(SourceLoc loc, const SourceManager &sourceMgr,
                                         unsigned bufferID) const;
+
+   syntax::CompactTrivia
+   convertToCompactTrivia(polar::utils::BumpPtrAllocator &allocator) const;
 };
 
 } // polar::parser
@@ -30,24 +30,34 @@
 #include "polarphp/basic/adt/StringMap.h"
 #include "polarphp/basic/adt/IntrusiveRefCountPtr.h"
 #include "polarphp/basic/adt/DenseMap.h"
+#include "polarphp/basic/adt/FlatHashMap.h"
 #include "polarphp/utils/FileSystem.h"
 #include "polarphp/utils/VirtualFileSystem.h"
 #include "polarphp/utils/SourceMgr.h"
 #include "polarphp/utils/MemoryBuffer.h"
 #include "polarphp/parser/SourceLoc.h"
+#include <atomic>
+#include <list>
 #include <map>
+#include <mutex>
+
+namespace polar::syntax {
+class RawSyntax;
+} // polar::syntax
 
 namespace polar::parser {
 
 using BasicSourceMgr = polar::utils::SourceMgr;
 using polar::basic::IntrusiveRefCountPtr;
 using polar::basic::DenseMap;
+using polar::basic::FlatHashMap;
 using polar::basic::ArrayRef;
 using polar::basic::Twine;
 using polar::utils::MemoryBuffer;
 using polar::utils::SMDiagnostic;
 using polar::utils::SMFixIt;
 using polar::utils::SMRange;
+using polar::syntax::RawSyntax;
 
 /// This class manages and owns source buffers.
 class SourceManager
@@ -252,6 +262,43 @@ public:
    /// Verifies that all buffers are still valid.
    void verifyAllBuffers() const;
 
+   /// Limit the memory-mapped buffers that are kept resident to about
+   /// \p bytes. When the limit is exceeded the pages of the least recently
+   /// used buffers that are not retained are dropped. Their addresses stay
+   /// reserved, so every \c SourceLoc remains valid; the content is read
+   /// back from the file when it is accessed again. Zero, the default,
+   /// keeps all buffers resident.
+   void setResidentBufferLimit(size_t bytes);
+
+   size_t getResidentBufferLimit() const
+   {
+      return m_residentBufferLimit.load(std::memory_order_relaxed);
+   }
+
+   /// Returns the number of bytes of memory-mapped buffers that are counted
+   /// as resident.
+   size_t getResidentBufferBytes() const;
+
+   /// Returns false if the pages of the buffer have been dropped and not been
+   /// used again since. Buffers that are not memory-mapped are always
+   /// resident.
+   bool isBufferResident(unsigned bufferID) const;
+
+   /// Keep the buffer resident until the matching \c releaseBuffer, for
+   /// example while a syntax tree or pending diagnostics refer to it.
+   void retainBuffer(unsigned bufferID);
+   void releaseBuffer(unsigned bufferID);
+
+   /// Returns a copy of \p root, the root of a syntax tree parsed from
+   /// \p bufferID, that keeps the buffer retained until the copy is
+   /// destroyed. The source manager has to outlive the tree.
+   IntrusiveRefCountPtr<RawSyntax>
+   retainBufferForSyntaxTree(unsigned bufferID, const IntrusiveRefCountPtr<RawSyntax> &root);
+
+   /// Mark the buffer as most recently used. If its pages were dropped they
+   /// are read back ahead of the access.
+   void touchBuffer(unsigned bufferID) const;
+
    /// Translate line and column pair to the offset.
    std::optional<unsigned> resolveFromLineCol(unsigned bufferId, unsigned line,
                                               unsigned col) const;
@@ -264,8 +311,25 @@ public:
    }
 
 private:
+   /// The residency state of a memory-mapped buffer.
+   struct BufferResidency
+   {
+      const MemoryBuffer *buffer;
+      std::list<unsigned>::iterator lruPos;
+      unsigned retainCount = 0;
+      bool resident = true;
+   };
+
    const VirtualFile *getVirtualFile(SourceLoc loc) const;
 
+   /// Drop the pages of least recently used buffers until the resident
+   /// bytes are within the limit. m_residencyLock has to be held.
+   void evictBuffers() const;
+
+   /// Move the buffer to the front of the LRU list, reading its pages back
+   /// if they were dropped. m_residencyLock has to be held.
+   void markBufferUsed(unsigned bufferID, BufferResidency &state) const;
+
    int getLineOffset(SourceLoc loc) const
    {
       if (auto vfile = getVirtualFile(loc)) {
@@ -282,13 +346,23 @@ private:
    unsigned m_codeCompletionOffset;
 
    /// Associates buffer identifiers to buffer IDs.
-   DenseMap<StringRef, unsigned> m_bufIdentIDMap;
+   FlatHashMap<StringRef, unsigned> m_bufIdentIDMap;
 
    /// A cache mapping buffer identifiers to vfs Status entries.
    ///
    /// This is as much a hack to prolong the lifetime of status objects as it is
    /// to speed up stats.
-   mutable DenseMap<StringRef, polar::vfs::Status> m_statusCache;
+   mutable FlatHashMap<StringRef, polar::vfs::Status> m_statusCache;
+
+   /// The memory-mapped buffers, other buffers cannot give back memory.
+   mutable DenseMap<unsigned, BufferResidency> m_residency;
+   /// The resident memory-mapped buffers, most recently used first.
+   mutable std::list<unsigned> m_residentBuffers;
+   mutable size_t m_residentBufferBytes = 0;
+   /// Written under m_residencyLock, atomic so that touchBuffer() can skip
+   /// the lock when there is no limit.
+   std::atomic<size_t> m_residentBufferLimit{0};
+   mutable std::mutex m_residencyLock;
 };
 
 } // polar::parser
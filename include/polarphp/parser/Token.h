@@ -20,6 +20,7 @@
 
 #include "polarphp/basic/adt/StringRef.h"
 #include "polarphp/basic/FlagSet.h"
+#include "polarphp/utils/InternedString.h"
 #include "polarphp/utils/SourceLocation.h"
 #include "polarphp/parser/SourceLoc.h"
 #include "polarphp/syntax/TokenKinds.h"
@@ -37,6 +38,7 @@ namespace polar::parser {
 using polar::basic::StringRef;
 using polar::basic::FlagSet;
 using polar::utils::RawOutStream;
+using polar::utils::InternedString;
 using polar::syntax::TokenKindType;
 using polar::parser::internal::ParserSemantic;
 
@@ -341,6 +343,19 @@ public:
       return std::any_cast<const T &>(m_value);
    }
 
+   /// The interned name of an identifier or variable token, which is only
+   /// set if the lexer interns names.
+   InternedString getInternedValue() const
+   {
+      return m_internedValue;
+   }
+
+   Token &setInternedValue(InternedString value)
+   {
+      m_internedValue = value;
+      return *this;
+   }
+
    ValueType getValueType() const
    {
       return m_valueType;
@@ -367,6 +382,7 @@ public:
       m_text = text;
       m_commentLength = commentLength;
       m_flags.setEscapedIdentifier(false);
+      m_internedValue = InternedString();
       return *this;
    }
 
@@ -398,6 +414,8 @@ private:
 
    /// The token value
    std::any m_value;
+
+   InternedString m_internedValue;
 };
 
 } // polar::syntax
@@ -23,6 +23,7 @@
 #ifndef POLARPHP_SYNTAX_ATOMICCACHE_H
 #define POLARPHP_SYNTAX_ATOMICCACHE_H
 
+#include <atomic>
 #include <functional>
 #include "polarphp/syntax/References.h"
 #include "polarphp/basic/adt/StlExtras.h"
@@ -51,9 +52,11 @@ public:
    RefCountPtr<T> getOrCreate(polar::basic::FunctionRef<RefCountPtr<T>()> create) const
    {
       auto &ptr = *reinterpret_cast<std::atomic<uintptr_t> *>(&m_storage);
-      // If an atomic load gets an initialized value, then return m_storage.
-      if (ptr) {
-         return m_storage;
+      // If an atomic load gets an initialized value, then return it. The
+      // value is always read through the atomic, a plain copy of m_storage
+      // would race with the thread that is just storing it.
+      if (uintptr_t value = ptr.load(std::memory_order_acquire)) {
+         return RefCountPtr<T>(reinterpret_cast<T *>(value));
       }
       // We expect the uncached value to wrap a nullptr. If another thread
       // beats us to caching the child, it'll be non-null, so we would
@@ -64,13 +67,17 @@ public:
       auto data = create();
       // Try to swap in raw pointer value.
       // If we won, then leave the RefCount == 1.
-      if (ptr.compare_exchange_strong(expected,
-                                      reinterpret_cast<uintptr_t>(data.get()))) {
+      T *created = data.get();
+      if (ptr.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(created),
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
          data.resetWithoutRelease();
+         return RefCountPtr<T>(created);
       }
       // Otherwise, the data we just made is unfortunately useless.
-      // Let it die on this scope exit after its terminal release.
-      return m_storage;
+      // Let it die on this scope exit after its terminal release, and
+      // return the value stored by the winner.
+      return RefCountPtr<T>(reinterpret_cast<T *>(expected));
    }
 
 private:
@@ -0,0 +1,248 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/08.
+//
+//===----------------------------------------------------------------------===//
+//
+// A compact encoding of a trivia list that does not store any text. Each
+// piece is only described by its kind and its length in bytes, the text is
+// recovered from the source buffer the trivia was lexed from when needed.
+//
+// Every piece is encoded as
+//
+//   byte 0: bits 0-3 kind, bits 4-6 low 3 bits of the length,
+//           bit 7 set if more length bytes follow
+//   byte 1..: the remaining length bits as ULEB128
+//
+// so pieces shorter than 8 bytes take one byte and pieces shorter than 1KB
+// take two. A whole list fits into a single 64 bit word as long as its
+// encoding is at most 7 bytes long; longer lists are stored in an allocator
+// owned by the client.
+//
+// The overwhelmingly common lists "no trivia", " " and "\n" followed by
+// indentation spaces are stored as two plain counts and never need to be
+// decoded byte by byte.
+//
+// RawSyntax does not use this encoding yet and still stores its trivia as
+// TriviaPiece objects (32 bytes each) that own their text. Its trivia getters
+// hand out ArrayRef<TriviaPiece>, which every token consumer relies on, and
+// a token does not know the buffer and offset it was lexed from, so it could
+// not read its trivia text back. Until tokens carry their source location,
+// the encoding is used where the source buffer is at hand: FrozenSyntaxTree
+// and ParsedTrivia::convertToCompactTrivia.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_SYNTAX_COMPACT_TRIVIA_H
+#define POLARPHP_SYNTAX_COMPACT_TRIVIA_H
+
+#include "polarphp/syntax/Trivia.h"
+#include "polarphp/basic/adt/ArrayRef.h"
+#include "polarphp/basic/adt/SmallVector.h"
+#include "polarphp/utils/Allocator.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace polar::syntax {
+
+using polar::basic::ArrayRef;
+using polar::basic::SmallVectorImpl;
+
+/// A piece of trivia without its text.
+struct CompactTriviaPiece
+{
+   TriviaKind kind;
+   /// The number of bytes the piece takes up in the source.
+   uint32_t length;
+
+   bool operator==(const CompactTriviaPiece &other) const
+   {
+      return kind == other.kind && length == other.length;
+   }
+
+   bool operator!=(const CompactTriviaPiece &other) const
+   {
+      return !(*this == other);
+   }
+};
+
+/// A trivia list in the encoding described at the top of this file. The
+/// object itself is 8 bytes large and trivially copyable. Lists that do not
+/// fit into it reference memory of the allocator passed to \c make, which
+/// has to outlive the list.
+class CompactTrivia
+{
+public:
+   CompactTrivia()
+      : m_bits(0)
+   {}
+
+   /// Encode \p pieces. \p allocator is only used if the encoding does not
+   /// fit inline.
+   static CompactTrivia make(ArrayRef<CompactTriviaPiece> pieces,
+                             polar::utils::BumpPtrAllocator &allocator);
+
+   /// Encode the trivia list \p trivia, which has to be spelled exactly as
+   /// in the source.
+   static CompactTrivia make(const Trivia &trivia,
+                             polar::utils::BumpPtrAllocator &allocator);
+
+   /// Returns a list of \p newlines '\n' characters followed by \p spaces
+   /// spaces. Never allocates.
+   static CompactTrivia getIndentation(uint32_t newlines, uint32_t spaces);
+
+   bool empty() const
+   {
+      return m_bits == 0;
+   }
+
+   /// Returns true if the list is stored in the object itself.
+   bool isInline() const
+   {
+      return getStorageKind() != StorageKind::External;
+   }
+
+   /// Returns the number of bytes the trivia takes up in the source.
+   size_t getTextLength() const;
+
+   /// Call \p callback with each piece of the list in order.
+   template <typename CallbackType>
+   void forEachPiece(CallbackType callback) const
+   {
+      switch (getStorageKind()) {
+      case StorageKind::Indentation: {
+         uint32_t newlines = getIndentationNewlines();
+         uint32_t spaces = getIndentationSpaces();
+         if (newlines) {
+            callback(CompactTriviaPiece{TriviaKind::Newline, newlines});
+         }
+         if (spaces) {
+            callback(CompactTriviaPiece{TriviaKind::Space, spaces});
+         }
+         return;
+      }
+      case StorageKind::Inline: {
+         uint8_t bytes[sm_maxInlineBytes];
+         size_t numBytes = getInlineBytes(bytes);
+         decodePieces(bytes, bytes + numBytes, callback);
+         return;
+      }
+      case StorageKind::External: {
+         ArrayRef<uint8_t> bytes = getExternalBytes();
+         decodePieces(bytes.begin(), bytes.end(), callback);
+         return;
+      }
+      }
+   }
+
+   /// Append the pieces of the list to \p pieces.
+   void getPieces(SmallVectorImpl<CompactTriviaPiece> &pieces) const;
+
+   /// Rebuild the full trivia list. \p text is the source text starting at
+   /// the first byte of the trivia.
+   Trivia getTrivia(StringRef text) const;
+
+   /// Returns the text of the piece at \p index. \p text is the source text
+   /// starting at the first byte of the trivia.
+   StringRef getPieceText(StringRef text, size_t index) const;
+
+   bool operator==(const CompactTrivia &other) const;
+
+   bool operator!=(const CompactTrivia &other) const
+   {
+      return !(*this == other);
+   }
+
+private:
+   enum class StorageKind : uint8_t
+   {
+      /// Up to 7 encoded bytes in the upper bytes of m_bits, the number of
+      /// bytes in bits 2-4.
+      Inline = 0,
+      /// Newline count in bits 2-32, space count in bits 33-63.
+      Indentation = 1,
+      /// Pointer to a uint32_t byte count followed by the encoded bytes.
+      External = 2
+   };
+
+   static constexpr unsigned sm_maxInlineBytes = 7;
+   static constexpr uint64_t sm_storageKindMask = 3;
+   static constexpr uint32_t sm_maxIndentationCount = (uint32_t(1) << 31) - 1;
+
+   explicit CompactTrivia(uint64_t bits)
+      : m_bits(bits)
+   {}
+
+   StorageKind getStorageKind() const
+   {
+      return static_cast<StorageKind>(m_bits & sm_storageKindMask);
+   }
+
+   uint32_t getIndentationNewlines() const
+   {
+      return (m_bits >> 2) & sm_maxIndentationCount;
+   }
+
+   uint32_t getIndentationSpaces() const
+   {
+      return (m_bits >> 33) & sm_maxIndentationCount;
+   }
+
+   size_t getInlineBytes(uint8_t *bytes) const
+   {
+      size_t numBytes = (m_bits >> 2) & 7;
+      for (size_t index = 0; index < numBytes; ++index) {
+         bytes[index] = static_cast<uint8_t>(m_bits >> (8 * (index + 1)));
+      }
+      return numBytes;
+   }
+
+   ArrayRef<uint8_t> getExternalBytes() const
+   {
+      const uint8_t *storage = reinterpret_cast<const uint8_t *>(
+               static_cast<uintptr_t>(m_bits & ~sm_storageKindMask));
+      uint32_t numBytes;
+      ::memcpy(&numBytes, storage, sizeof(numBytes));
+      return ArrayRef<uint8_t>(storage + sizeof(numBytes), numBytes);
+   }
+
+   template <typename CallbackType>
+   static void decodePieces(const uint8_t *iter, const uint8_t *end,
+                            CallbackType &callback)
+   {
+      while (iter != end) {
+         uint8_t head = *iter++;
+         uint32_t length = (head >> 4) & 7;
+         if (head & 0x80) {
+            unsigned shift = 3;
+            uint8_t byte;
+            do {
+               assert(iter != end && "truncated trivia encoding");
+               byte = *iter++;
+               length |= static_cast<uint32_t>(byte & 0x7f) << shift;
+               shift += 7;
+            } while (byte & 0x80);
+         }
+         callback(CompactTriviaPiece{static_cast<TriviaKind>(head & 0xf), length});
+      }
+   }
+
+   static void encodePiece(const CompactTriviaPiece &piece,
+                           SmallVectorImpl<uint8_t> &bytes);
+
+   uint64_t m_bits;
+};
+
+static_assert(sizeof(CompactTrivia) == 8, "CompactTrivia has to stay a single word");
+
+} // polar::syntax
+
+#endif // POLARPHP_SYNTAX_COMPACT_TRIVIA_H
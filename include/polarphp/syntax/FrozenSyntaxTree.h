@@ -0,0 +1,290 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/09.
+//
+//===----------------------------------------------------------------------===//
+//
+// A read-only copy of a finished syntax tree laid out in a handful of
+// contiguous arrays.
+//
+// The nodes are numbered in post-order, so the children of a node always
+// come before it and a subtree occupies a contiguous range of node indices
+// ending at its root. Every property of a node lives in its own column
+// indexed by the node index:
+//
+//   kinds    - SyntaxKind of layout nodes, TokenKindType of tokens
+//   flags    - whether the node is a token and whether it is missing
+//   offsets  - absolute offset of the node before its leading trivia
+//   lengths  - number of bytes the node takes up in the source
+//   payloads - index into the child table (layout nodes) or into the token
+//              table (tokens)
+//
+// The child table stores the number of children of a layout node followed
+// by the distance from the node to each of its children as 32 bit values;
+// a distance of 0 marks an absent child. Tokens store their trivia as
+// CompactTrivia, all text lives in a single pool that starts with the full
+// source text of the tree. The spelling of missing tokens is appended to the
+// pool after the source text.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_SYNTAX_FROZEN_SYNTAX_TREE_H
+#define POLARPHP_SYNTAX_FROZEN_SYNTAX_TREE_H
+
+#include "polarphp/syntax/RawSyntax.h"
+#include "polarphp/syntax/CompactTrivia.h"
+#include "polarphp/utils/Allocator.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace polar::syntax {
+
+class Syntax;
+class FrozenSyntaxTree;
+
+/// A read-only handle of a node of a \c FrozenSyntaxTree. It is only a tree
+/// pointer and an index, all accessors read the columns of the tree. Moving
+/// or destroying the tree invalidates all of its node handles.
+class FrozenSyntaxNode
+{
+public:
+   using NodeIndex = uint32_t;
+
+   NodeIndex getIndex() const
+   {
+      return m_index;
+   }
+
+   const FrozenSyntaxTree &getTree() const
+   {
+      return *m_tree;
+   }
+
+   /// Get the kind of syntax, \c SyntaxKind::Token for tokens.
+   SyntaxKind getKind() const;
+
+   bool kindOf(SyntaxKind kind) const
+   {
+      return getKind() == kind;
+   }
+
+   /// Returns true if the node has the kind of the syntax node class \c T.
+   template <typename T>
+   bool is() const
+   {
+      return T::kindOf(getKind());
+   }
+
+   bool isToken() const;
+   bool isMissing() const;
+
+   bool isPresent() const
+   {
+      return !isMissing();
+   }
+
+   bool isDecl() const
+   {
+      return is_decl_kind(getKind());
+   }
+
+   bool isStmt() const
+   {
+      return is_stmt_kind(getKind());
+   }
+
+   bool isExpr() const
+   {
+      return is_expr_kind(getKind());
+   }
+
+   bool isUnknown() const
+   {
+      return is_unknown_kind(getKind());
+   }
+
+   TokenKindType getTokenKind() const;
+
+   bool isToken(TokenKindType kind) const
+   {
+      return isToken() && getTokenKind() == kind;
+   }
+
+   /// Get the spelling of the token without trivia.
+   StringRef getTokenText() const;
+
+   CompactTrivia getCompactLeadingTrivia() const;
+   CompactTrivia getCompactTrailingTrivia() const;
+
+   Trivia getLeadingTrivia() const;
+   Trivia getTrailingTrivia() const;
+
+   size_t getNumChildren() const;
+
+   /// Get the Nth child of this node, if it is present in the layout.
+   std::optional<FrozenSyntaxNode> getChild(size_t index) const;
+
+   /// Get the child at \p cursor, which is one of the \c Cursor values of the
+   /// syntax node class this node is an instance of.
+   template <typename CursorType>
+   std::optional<FrozenSyntaxNode> getChild(CursorType cursor) const
+   {
+      return getChild(static_cast<size_t>(cursor_index(cursor)));
+   }
+
+   /// Get the offset at which the leading trivia of this node starts.
+   size_t getAbsoluteOffsetBeforeLeadingTrivia() const;
+
+   /// Get the offset at which the first token of this node starts.
+   size_t getAbsoluteOffset() const;
+
+   /// Get the offset at which the trailing trivia of this node ends.
+   size_t getAbsoluteEndOffsetAfterTrailingTrivia() const
+   {
+      return getAbsoluteOffsetBeforeLeadingTrivia() + getTextLength();
+   }
+
+   /// Return the number of bytes this node takes when spelled out in the
+   /// source. Missing nodes take up no bytes.
+   size_t getTextLength() const;
+
+   /// Return the full source text of this node including trivia.
+   StringRef getText() const;
+
+   /// Returns the index of the first node of the subtree of this node.
+   NodeIndex getSubtreeBegin() const;
+
+   /// Print the syntax node with full fidelity to the given output stream.
+   void print(RawOutStream &outStream) const
+   {
+      outStream << getText();
+   }
+
+   /// Convert the subtree of this node back into \c RawSyntax nodes. The
+   /// new nodes get fresh node ids.
+   RefCountPtr<RawSyntax> thaw() const;
+
+   bool operator==(const FrozenSyntaxNode &other) const
+   {
+      return m_tree == other.m_tree && m_index == other.m_index;
+   }
+
+   bool operator!=(const FrozenSyntaxNode &other) const
+   {
+      return !(*this == other);
+   }
+
+private:
+   friend class FrozenSyntaxTree;
+
+   FrozenSyntaxNode(const FrozenSyntaxTree *tree, NodeIndex index)
+      : m_tree(tree),
+        m_index(index)
+   {}
+
+   const FrozenSyntaxTree *m_tree;
+   NodeIndex m_index;
+};
+
+/// A finished syntax tree in the contiguous layout described at the top of
+/// this file. It is created from a \c RawSyntax tree by \c freeze, does not
+/// reference the original tree and is never modified afterwards.
+///
+/// Walking all nodes in post-order is a plain loop over the node indices.
+/// Compared to \c RawSyntax, a node costs 15 bytes plus 4 bytes per child
+/// slot, and 24 bytes per token in addition to its text.
+class FrozenSyntaxTree
+{
+public:
+   using NodeIndex = FrozenSyntaxNode::NodeIndex;
+
+   /// Lay out the tree rooted at \p root.
+   static FrozenSyntaxTree freeze(const RawSyntax &root);
+
+   /// Lay out the tree rooted at \p root. \p root does not need to be the
+   /// root of its own tree.
+   static FrozenSyntaxTree freeze(const Syntax &root);
+
+   FrozenSyntaxTree(FrozenSyntaxTree &&) = default;
+   FrozenSyntaxTree &operator=(FrozenSyntaxTree &&) = default;
+   FrozenSyntaxTree(const FrozenSyntaxTree &) = delete;
+   FrozenSyntaxTree &operator=(const FrozenSyntaxTree &) = delete;
+
+   /// Returns the number of nodes, absent children are not counted.
+   size_t size() const
+   {
+      return m_kinds.size();
+   }
+
+   FrozenSyntaxNode getRoot() const
+   {
+      return getNode(size() - 1);
+   }
+
+   FrozenSyntaxNode getNode(NodeIndex index) const
+   {
+      assert(index < size() && "node index out of range");
+      return FrozenSyntaxNode(this, index);
+   }
+
+   /// Returns the full source text of the tree.
+   StringRef getText() const
+   {
+      return StringRef(m_text.data(), m_sourceLength);
+   }
+
+   /// Convert the tree back into \c RawSyntax nodes.
+   RefCountPtr<RawSyntax> thaw() const
+   {
+      return getRoot().thaw();
+   }
+
+   /// Returns the number of bytes allocated for the tree.
+   size_t getMemoryUsage() const;
+
+private:
+   friend class FrozenSyntaxNode;
+
+   enum NodeFlags : uint8_t
+   {
+      TokenFlag = 1 << 0,
+      MissingFlag = 1 << 1
+   };
+
+   struct TokenRecord
+   {
+      /// Offset of the leading trivia of the token in the text pool.
+      uint32_t textOffset;
+      /// Length of the token text without trivia.
+      uint32_t tokenLength;
+      CompactTrivia leadingTrivia;
+      CompactTrivia trailingTrivia;
+   };
+
+   FrozenSyntaxTree() = default;
+
+   std::vector<uint16_t> m_kinds;
+   std::vector<uint8_t> m_flags;
+   std::vector<uint32_t> m_offsets;
+   std::vector<uint32_t> m_lengths;
+   std::vector<uint32_t> m_payloads;
+   std::vector<uint32_t> m_children;
+   std::vector<TokenRecord> m_tokens;
+   std::string m_text;
+   size_t m_sourceLength = 0;
+   /// Storage of trivia lists that do not fit into a CompactTrivia.
+   polar::utils::BumpPtrAllocator m_triviaAllocator;
+};
+
+} // polar::syntax
+
+#endif // POLARPHP_SYNTAX_FROZEN_SYNTAX_TREE_H
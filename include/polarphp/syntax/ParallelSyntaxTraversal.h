@@ -0,0 +1,135 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/10.
+
+#ifndef POLARPHP_SYNTAX_PARALLEL_SYNTAX_TRAVERSAL_H
+#define POLARPHP_SYNTAX_PARALLEL_SYNTAX_TRAVERSAL_H
+
+#include "polarphp/syntax/Syntax.h"
+#include "polarphp/basic/adt/StlExtras.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace polar::utils {
+class ThreadPool;
+} // polar::utils
+
+namespace polar::syntax {
+
+/// Runs a whole-tree analysis on several threads.
+///
+/// The tree is cut into independent subtrees ("tasks") at the natural
+/// boundaries of the source: a node is split into its children only if it is
+/// larger than the grain size, so a large source file falls apart into its
+/// top level statements, a large class into its members and so on, while
+/// small nodes stay in one piece. The tasks are handed out in source order in
+/// contiguous blocks to the workers, a worker that runs out of tasks steals
+/// the second half of the remaining block of another worker.
+///
+/// The results of the tasks are combined by a user supplied reduction strictly
+/// in source order after all tasks finished, so the result does not depend on
+/// the scheduling.
+///
+/// Children of the tree are realized concurrently by the workers, which is
+/// safe since \c SyntaxData realizes its children through an \c AtomicCache.
+/// The lazily cached text lengths of the \c RawSyntax nodes are computed up
+/// front on the calling thread, and so are the absolute positions of the
+/// tasks and of the nodes above them. Positions within a task are cached by
+/// the workers as they are asked for, \c SyntaxData publishes each of them
+/// once. The nodes on the path from the root to the tasks are not part of
+/// any task; analyses that need an enclosing node of a task can get it
+/// through \c Syntax::getParent.
+class ParallelSyntaxTraversal
+{
+public:
+   /// Schedule the work on \p pool using \p numWorkers concurrent workers, or
+   /// one worker per hardware thread if it is 0. The calling thread is one of
+   /// the workers.
+   explicit ParallelSyntaxTraversal(polar::utils::ThreadPool &pool,
+                                    unsigned numWorkers = 0);
+
+   unsigned getNumWorkers() const
+   {
+      return m_numWorkers;
+   }
+
+   /// Set the size in bytes above which a node is split into its children.
+   /// With the default of 0 the grain size is derived from the size of the
+   /// tree and the number of workers.
+   void setGrainSize(size_t grainSize)
+   {
+      m_grainSize = grainSize;
+   }
+
+   /// Cut the tree \p root into tasks. The tasks are returned in source order.
+   std::vector<Syntax> partition(const Syntax &root) const;
+
+   /// Call \p map for every task of \p root in parallel and fold the results
+   /// into \p init with \p reduce in source order:
+   ///
+   ///   ResultType map(Syntax task);
+   ///   ResultType reduce(ResultType accumulated, ResultType taskResult);
+   template <typename ResultType, typename MapFunction, typename ReduceFunction>
+   ResultType mapReduce(const Syntax &root, ResultType init, MapFunction map,
+                        ReduceFunction reduce) const
+   {
+      std::vector<Syntax> tasks = partition(root);
+      std::vector<std::optional<ResultType>> results(tasks.size());
+      run(tasks.size(), [&](size_t index) {
+         results[index].emplace(map(tasks[index]));
+      });
+      for (std::optional<ResultType> &result : results) {
+         init = reduce(std::move(init), std::move(*result));
+      }
+      return init;
+   }
+
+   /// Walk every task of \p root with a fresh visitor created by
+   /// \p makeVisitor and fold the visitors into \p init with \p reduce in
+   /// source order:
+   ///
+   ///   VisitorType makeVisitor();
+   ///   ResultType reduce(ResultType accumulated, VisitorType &visitor);
+   ///
+   /// The visitors are kept alive until all of them finished.
+   template <typename ResultType, typename VisitorFactory, typename ReduceFunction>
+   ResultType visit(const Syntax &root, ResultType init, VisitorFactory makeVisitor,
+                    ReduceFunction reduce) const
+   {
+      using VisitorType = decltype(makeVisitor());
+      std::vector<Syntax> tasks = partition(root);
+      std::vector<std::optional<VisitorType>> visitors(tasks.size());
+      run(tasks.size(), [&](size_t index) {
+         visitors[index].emplace(makeVisitor());
+         visitors[index]->visit(tasks[index]);
+      });
+      for (std::optional<VisitorType> &visitor : visitors) {
+         init = reduce(std::move(init), *visitor);
+      }
+      return init;
+   }
+
+   /// Call \p task with every index in [0, numTasks) on the workers.
+   void run(size_t numTasks, polar::basic::FunctionRef<void(size_t)> task) const;
+
+private:
+   /// Nodes smaller than this are never split by the automatic grain size.
+   static constexpr size_t sm_minGrainSize = 1024;
+
+   polar::utils::ThreadPool &m_pool;
+   unsigned m_numWorkers;
+   size_t m_grainSize = 0;
+};
+
+} // polar::syntax
+
+#endif // POLARPHP_SYNTAX_PARALLEL_SYNTAX_TRAVERSAL_H
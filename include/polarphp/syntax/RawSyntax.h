@@ -266,7 +266,8 @@ public:
 
    // This is a copy-pased implementation of llvm::ThreadSafeRefCountedBase with
    // the difference that we do not delete the RawSyntax node's memory if the
-   // node was allocated within a SyntaxArena and thus doesn't own its memory.
+   // node was allocated within a SyntaxArena and thus doesn't own its memory,
+   // and that nested nodes are freed without recursion.
    void retain() const
    {
       m_refCount.fetch_add(1, std::memory_order_relaxed);
@@ -277,15 +278,7 @@ public:
       int newRefCount = m_refCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
       assert(newRefCount >= 0 && "Reference count was already zero.");
       if (newRefCount == 0) {
-         if (arena) {
-            // The node was allocated inside a SyntaxArena and thus doesn't own its
-            // own memory region. Hence we cannot free it. It will be deleted once
-            // the last RawSyntax node allocated with it will release its reference
-            // to the arena.
-            this->~RawSyntax();
-         } else {
-            delete this;
-         }
+         destroy_without_recursion(this, &RawSyntax::destroy);
       }
    }
 
@@ -698,17 +691,10 @@ private:
              const RefCountPtr<SyntaxArena> &arena, std::optional<SyntaxNodeId> nodeId);
 
    /// Compute the node's text length by summing up the length of its childern
-   size_t computeTextLength()
-   {
-      size_t textLength = 0;
-      for (size_t index = 0, numChildren = getNumChildren(); index < numChildren; ++index) {
-         auto &childNode = getChild(index);
-         if (childNode && !childNode->isMissing()) {
-            textLength += childNode->getTextLength();
-         }
-      }
-      return textLength;
-   }
+   size_t computeTextLength();
+
+   /// Free a node whose reference count dropped to zero.
+   static void destroy(const RawSyntax *node);
 
    mutable std::atomic<int> m_refCount;
 };
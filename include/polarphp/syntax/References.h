@@ -25,6 +25,8 @@
 
 #include "polarphp/basic/adt/IntrusiveRefCountPtr.h"
 
+#include <vector>
+
 namespace polar::syntax {
 
 /// A shorthand to clearly indicate that a value is a reference counted and
@@ -33,6 +35,31 @@ namespace polar::syntax {
 template <typename InnerClsType>
 using RefCountPtr = polar::utils::IntrusiveRefCountPtr<InnerClsType>;
 
+/// Free \p node, whose reference count dropped to zero, with \p destroy.
+///
+/// Destroying a node releases its children, which may then be destroyed as
+/// well. Nodes of the same type released while a destruction is already
+/// running on this thread are queued and freed by the outermost call, so
+/// that freeing a deeply nested tree does not recurse once per level.
+template <typename NodeType>
+void destroy_without_recursion(const NodeType *node, void (*destroy)(const NodeType *))
+{
+   thread_local std::vector<const NodeType *> pending;
+   thread_local bool destroying = false;
+   if (destroying) {
+      pending.push_back(node);
+      return;
+   }
+   destroying = true;
+   destroy(node);
+   while (!pending.empty()) {
+      const NodeType *next = pending.back();
+      pending.pop_back();
+      destroy(next);
+   }
+   destroying = false;
+}
+
 } // polar::syntax
 
 #endif // POLARPHP_SYNTAX_REFERENCES_H
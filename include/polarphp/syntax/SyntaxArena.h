@@ -32,6 +32,9 @@
 #include "polarphp/basic/adt/IntrusiveRefCountPtr.h"
 #include "polarphp/utils/Allocator.h"
 
+#include <functional>
+#include <vector>
+
 namespace polar::syntax {
 
 using polar::utils::BumpPtrAllocator;
@@ -44,6 +47,13 @@ public:
    SyntaxArena()
    {}
 
+   ~SyntaxArena()
+   {
+      for (auto iter = m_cleanups.rbegin(); iter != m_cleanups.rend(); ++iter) {
+         (*iter)();
+      }
+   }
+
    polar::utils::BumpPtrAllocator &getAllocator()
    {
       return m_allocator;
@@ -54,10 +64,19 @@ public:
       return m_allocator.allocate(size, alignment);
    }
 
+   /// Run \p cleanup when the arena is destroyed, that is after the last node
+   /// allocated in it is gone. Used to tie resources, such as the source
+   /// buffer a tree was parsed from, to the lifetime of the tree.
+   void addCleanup(std::function<void()> cleanup)
+   {
+      m_cleanups.push_back(std::move(cleanup));
+   }
+
 private:
    SyntaxArena(const SyntaxArena &) = delete;
    void operator=(const SyntaxArena &) = delete;
    BumpPtrAllocator m_allocator;
+   std::vector<std::function<void()>> m_cleanups;
 };
 
 } // polar::syntax
@@ -0,0 +1,185 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/02.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the ByteTree encoding of syntax trees.
+//
+// Every RawSyntax node is written as an object. Layout nodes have the fields
+//
+//   [0] presence   (bool)
+//   [1] node id    (uint32)
+//   [2] syntax kind (uint16)
+//   [3] layout     (object, one field per child, absent children are
+//                   written as empty objects)
+//
+// and token nodes have the fields
+//
+//   [0] presence   (bool)
+//   [1] node id    (uint32)
+//   [2] syntax kind (uint16, always SyntaxKind::Token)
+//   [3] token kind (uint16)
+//   [4] token text (string)
+//   [5] leading trivia  (object, one TriviaPiece object per field)
+//   [6] trailing trivia (object, one TriviaPiece object per field)
+//
+// Readers ignore fields beyond the ones listed here so that later protocol
+// versions can append information without breaking older readers.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_SYNTAX_SYNTAX_BYTETREE_SERIALIZATION_H
+#define POLARPHP_SYNTAX_SYNTAX_BYTETREE_SERIALIZATION_H
+
+#include "polarphp/basic/ByteTreeSerialization.h"
+#include "polarphp/syntax/RawSyntax.h"
+#include "polarphp/utils/Error.h"
+
+namespace polar::utils {
+class MemoryBuffer;
+} // polar::utils
+
+namespace polar::basic::bytetree {
+
+using polar::syntax::RawSyntax;
+using polar::syntax::RefCountPtr;
+using polar::syntax::TokenKindType;
+using polar::syntax::TriviaPiece;
+
+template <>
+struct WrapperTypeTraits<TokenKindType>
+{
+   static uint16_t numericValue(const TokenKindType &kind)
+   {
+      return static_cast<uint16_t>(kind);
+   }
+
+   static void write(ByteTreeWriter &writer, const TokenKindType &kind,
+                     unsigned index)
+   {
+      writer.write(numericValue(kind), index);
+   }
+};
+
+template <>
+struct ObjectTraits<ArrayRef<TriviaPiece>>
+{
+   static unsigned getNumFields(const ArrayRef<TriviaPiece> &trivia,
+                                UserInfoMap &userInfo)
+   {
+      return trivia.size();
+   }
+
+   static void write(ByteTreeWriter &writer, const ArrayRef<TriviaPiece> &trivia,
+                     UserInfoMap &userInfo)
+   {
+      for (unsigned index = 0, size = trivia.size(); index < size; ++index) {
+         writer.write(trivia[index], index);
+      }
+   }
+};
+
+template <>
+struct ObjectTraits<ArrayRef<RefCountPtr<RawSyntax>>>
+{
+   static unsigned getNumFields(const ArrayRef<RefCountPtr<RawSyntax>> &layout,
+                                UserInfoMap &userInfo)
+   {
+      return layout.size();
+   }
+
+   static void write(ByteTreeWriter &writer,
+                     const ArrayRef<RefCountPtr<RawSyntax>> &layout,
+                     UserInfoMap &userInfo);
+};
+
+template <>
+struct ObjectTraits<RawSyntax>
+{
+   static unsigned getNumFields(const RawSyntax &syntax, UserInfoMap &userInfo)
+   {
+      return syntax.isToken() ? 7 : 4;
+   }
+
+   static void write(ByteTreeWriter &writer, const RawSyntax &syntax,
+                     UserInfoMap &userInfo)
+   {
+      writer.write(syntax.isPresent(), /*index=*/0);
+      writer.write(static_cast<uint32_t>(syntax.getId()), /*index=*/1);
+      writer.write(syntax.getKind(), /*index=*/2);
+      if (syntax.isToken()) {
+         writer.write(syntax.getTokenKind(), /*index=*/3);
+         writer.write(syntax.getTokenText(), /*index=*/4);
+         writer.write(syntax.getLeadingTrivia(), /*index=*/5);
+         writer.write(syntax.getTrailingTrivia(), /*index=*/6);
+      } else {
+         writer.write(syntax.getLayout(), /*index=*/3);
+      }
+   }
+};
+
+inline void ObjectTraits<ArrayRef<RefCountPtr<RawSyntax>>>::write(
+      ByteTreeWriter &writer, const ArrayRef<RefCountPtr<RawSyntax>> &layout,
+      UserInfoMap &userInfo)
+{
+   for (unsigned index = 0, size = layout.size(); index < size; ++index) {
+      if (layout[index]) {
+         writer.write(*layout[index], index);
+      } else {
+         writer.write(std::nullopt, index);
+      }
+   }
+}
+
+} // polar::basic::bytetree
+
+namespace polar::syntax {
+
+using polar::basic::ExponentialGrowthAppendingBinaryByteStream;
+using polar::basic::SegmentedAppendingBinaryByteStream;
+using polar::utils::Expected;
+using polar::utils::MemoryBuffer;
+
+/// The protocol version written in front of every serialized syntax tree.
+/// Bump it whenever the field layout documented above changes in a way that
+/// older readers cannot skip over.
+constexpr uint32_t SyntaxByteTreeProtocolVersion = 1;
+
+/// Serialize the syntax tree rooted at \p root into \p stream.
+void serialize_syntax_tree(ExponentialGrowthAppendingBinaryByteStream &stream,
+                           const RawSyntax &root);
+
+/// Serialize the syntax tree rooted at \p root into \p stream without
+/// requiring the whole output to be contiguous in memory.
+void serialize_syntax_tree(SegmentedAppendingBinaryByteStream &stream,
+                           const RawSyntax &root);
+
+/// Rebuild a syntax tree from ByteTree data produced by
+/// \c serialize_syntax_tree.
+///
+/// Token and comment text is not copied: the returned nodes reference
+/// \p data directly, so \p data has to stay alive as long as the tree (or
+/// any text obtained from it) is in use. Nodes are allocated in \p arena if
+/// one is given. Serialized node ids are preserved.
+Expected<RefCountPtr<RawSyntax>>
+deserialize_syntax_tree(StringRef data,
+                        const RefCountPtr<SyntaxArena> &arena = nullptr);
+
+/// Rebuild a syntax tree directly from the contents of \p buffer, typically a
+/// memory mapped file. The same lifetime rules as for the \c StringRef
+/// overload apply to \p buffer.
+Expected<RefCountPtr<RawSyntax>>
+deserialize_syntax_tree(const MemoryBuffer &buffer,
+                        const RefCountPtr<SyntaxArena> &arena = nullptr);
+
+} // polar::syntax
+
+#endif // POLARPHP_SYNTAX_SYNTAX_BYTETREE_SERIALIZATION_H
@@ -57,7 +57,6 @@
 
 namespace polar::syntax {
 
-using polar::basic::ThreadSafeRefCountedBase;
 using polar::basic::TrailingObjects;
 
 /// The class for holding parented syntax.
@@ -69,10 +68,25 @@ using polar::basic::TrailingObjects;
 /// reference to the m_parent, and, in subclasses, lazily created strong
 /// references to non-terminal child nodes.
 class SyntaxData final
-      : public ThreadSafeRefCountedBase<SyntaxData>,
-      private TrailingObjects<SyntaxData, AtomicCache<SyntaxData>>
+      : private TrailingObjects<SyntaxData, AtomicCache<SyntaxData>>
 {
 public:
+   // The same as ThreadSafeRefCountedBase, except that the realized children
+   // of a node are freed without recursion.
+   void retain() const
+   {
+      m_refCount.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   void release() const
+   {
+      int newRefCount = m_refCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+      assert(newRefCount >= 0 && "Reference count was already zero.");
+      if (newRefCount == 0) {
+         destroy_without_recursion(this, &SyntaxData::destroy);
+      }
+   }
+
    /// Get the node immediately before this current node that does contain a
    /// non-missing token. Return nullptr if we cannot find such node.
    RefCountPtr<SyntaxData> getPreviousNode() const;
@@ -251,8 +265,35 @@ private:
    /// If there is no m_parent, this is 0.
    const CursorIndex m_indexInParent;
 
+   enum PositionCacheState : uint8_t
+   {
+      PositionUnknown,
+      PositionWriting,
+      PositionKnown
+   };
+
    /// Cache the absolute position of this node.
-   std::optional<AbsolutePosition> m_positionCache;
+   ///
+   /// Threads walking the same tree query positions concurrently and fill in
+   /// the caches of each other's nodes, so the cache is published once: only
+   /// the thread that moves m_positionState from PositionUnknown to
+   /// PositionWriting stores the position, and m_positionCache is read only
+   /// after m_positionState became PositionKnown.
+   mutable std::atomic<uint8_t> m_positionState{PositionUnknown};
+   mutable AbsolutePosition m_positionCache;
+
+   mutable std::atomic<int> m_refCount{0};
+
+   /// Get the cached position into \p position, if it is known.
+   bool getCachedPosition(AbsolutePosition &position) const;
+
+   /// Cache \p position unless another thread got there first.
+   void cachePosition(const AbsolutePosition &position) const;
+
+   static void destroy(const SyntaxData *data)
+   {
+      delete data;
+   }
 
    size_t numTrailingObjects(OverloadToken<AtomicCache<SyntaxData>>) const
    {
@@ -0,0 +1,99 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/06.
+
+#ifndef POLARPHP_SYNTAX_SYNTAX_EDIT_BATCH_H
+#define POLARPHP_SYNTAX_SYNTAX_EDIT_BATCH_H
+
+#include "polarphp/syntax/Syntax.h"
+#include "polarphp/syntax/SyntaxRef.h"
+#include "polarphp/basic/adt/SmallVector.h"
+
+#include <vector>
+
+namespace polar::syntax {
+
+/// Collects replacements of nodes of one syntax tree and applies all of them
+/// at once.
+///
+/// Every \c with* mutator of the syntax nodes rebuilds the whole path from the
+/// modified node up to the root, so applying N edits one after another
+/// rebuilds the shared ancestors N times. A \c SyntaxEditBatch rebuilds every
+/// ancestor of the edited nodes exactly once in a single bottom-up pass and
+/// shares all untouched subtrees with the original tree.
+///
+/// Nodes are identified by their position in the tree they were obtained
+/// from, which must be the tree of the root passed to the constructor. If a
+/// node is replaced more than once the last replacement wins. Replacements of
+/// nodes nested inside another replaced node are dropped.
+class SyntaxEditBatch
+{
+public:
+   explicit SyntaxEditBatch(Syntax root)
+      : m_root(root)
+   {}
+
+   /// Schedule replacing \p node with \p replacement.
+   void replace(const Syntax &node, RefCountPtr<RawSyntax> replacement);
+
+   /// Schedule replacing the node \p node references with \p replacement.
+   void replace(const SyntaxRef &node, RefCountPtr<RawSyntax> replacement);
+
+   /// Schedule replacing \p node with \p replacement.
+   template <typename SyntaxNode>
+   void replace(const Syntax &node, const SyntaxNode &replacement)
+   {
+      replace(node, replacement.getRaw());
+   }
+
+   /// Returns the number of scheduled replacements.
+   size_t size() const
+   {
+      return m_edits.size();
+   }
+
+   bool empty() const
+   {
+      return m_edits.empty();
+   }
+
+   /// Apply all scheduled replacements and return the new root. The batch is
+   /// empty afterwards and the original tree is not modified.
+   RefCountPtr<RawSyntax> applyRaw();
+
+   /// Apply all scheduled replacements and return a handle of the new root.
+   template <typename SyntaxNode = Syntax>
+   SyntaxNode apply()
+   {
+      return make<SyntaxNode>(applyRaw());
+   }
+
+private:
+   struct Edit
+   {
+      polar::basic::SmallVector<CursorIndex, 8> path;
+      RefCountPtr<RawSyntax> replacement;
+      /// Position of the edit in the order of the replace() calls.
+      size_t sequence;
+   };
+
+   using EditIterator = std::vector<Edit>::const_iterator;
+
+   RefCountPtr<RawSyntax> rebuild(const RefCountPtr<RawSyntax> &node,
+                                  EditIterator begin, EditIterator end,
+                                  size_t depth);
+
+   Syntax m_root;
+   std::vector<Edit> m_edits;
+};
+
+} // polar::syntax
+
+#endif // POLARPHP_SYNTAX_SYNTAX_EDIT_BATCH_H
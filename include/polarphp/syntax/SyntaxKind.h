@@ -63,8 +63,10 @@ using polar::syntax::SyntaxKind;
 template <>
 struct WrapperTypeTraits<syntax::SyntaxKind>
 {
-   // Explicitly spell out all SyntaxKinds to keep the serialized value stable
-   // even if its members get reordered or members get removed
+   // Token and Unknown have fixed values so that a reader can always
+   // recognize them, all other kinds are stored by their ordinal shifted
+   // past these reserved values. Reordering SyntaxKind therefore requires
+   // bumping the protocol version of the serialized syntax tree.
    static uint16_t numericValue(const syntax::SyntaxKind &kind)
    {
       switch (kind) {
@@ -73,7 +75,24 @@ struct WrapperTypeTraits<syntax::SyntaxKind>
       case syntax::SyntaxKind::Unknown:
          return 1;
       default:
-         polar_unreachable("unhandled kind");
+         return static_cast<uint16_t>(polar::as_integer<SyntaxKind>(kind) + 1);
+      }
+   }
+
+   /// Map a value produced by \c numericValue back to its kind. Returns
+   /// \c std::nullopt if \p value does not name a known kind.
+   static std::optional<syntax::SyntaxKind> fromNumericValue(uint16_t value)
+   {
+      switch (value) {
+      case 0:
+         return syntax::SyntaxKind::Token;
+      case 1:
+         return syntax::SyntaxKind::Unknown;
+      default:
+         if (value - 1u >= polar::as_integer<SyntaxKind>(SyntaxKind::Unknown)) {
+            return std::nullopt;
+         }
+         return static_cast<syntax::SyntaxKind>(value - 1u);
       }
    }
 
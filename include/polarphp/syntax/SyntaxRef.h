@@ -0,0 +1,290 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/05.
+
+#ifndef POLARPHP_SYNTAX_SYNTAX_REF_H
+#define POLARPHP_SYNTAX_SYNTAX_REF_H
+
+#include "polarphp/syntax/RawSyntax.h"
+#include "polarphp/basic/adt/SmallVector.h"
+
+#include <optional>
+
+namespace polar::syntax {
+
+class Syntax;
+
+/// A non-owning, read-only handle to a syntax node.
+///
+/// Unlike \c Syntax, a \c SyntaxRef does not realize a \c SyntaxData for the
+/// node and does not retain anything. It is made of the root of the tree, the
+/// node itself, its parent, the index of the node in its parent and the
+/// absolute offset of the node (before its leading trivia), so navigating to
+/// a child or a sibling is a couple of pointer reads and additions.
+///
+/// The typed accessors of the syntax node classes are available on
+/// \c SyntaxRef through the views in SyntaxRefNodes.h, e.g.
+/// \c ParenDecoratedExprSyntaxRef::getExpr.
+///
+/// A \c SyntaxRef is only valid as long as the tree it points into is kept
+/// alive by somebody else, e.g. by a \c Syntax handle of the root. It is
+/// intended for read-only consumers (linters, indexers, ...) that walk large
+/// parts of a tree. Use \c realize to get a full \c Syntax handle for a node
+/// that is about to be modified.
+class SyntaxRef
+{
+public:
+   /// Create a handle for the root of the tree \p root.
+   explicit SyntaxRef(const RawSyntax &root)
+      : SyntaxRef(&root, &root, nullptr, 0, 0)
+   {}
+
+   /// Create a handle for the node \p node refers to.
+   explicit SyntaxRef(const Syntax &node);
+
+   /// Get the kind of syntax.
+   SyntaxKind getKind() const
+   {
+      return m_raw->getKind();
+   }
+
+   const RawSyntax *getRaw() const
+   {
+      return m_raw;
+   }
+
+   /// Get an ID for this node that is stable across incremental parses
+   SyntaxNodeId getId() const
+   {
+      return m_raw->getId();
+   }
+
+   bool isToken() const
+   {
+      return m_raw->isToken();
+   }
+
+   bool isStmt() const
+   {
+      return m_raw->isStmt();
+   }
+
+   bool isDecl() const
+   {
+      return m_raw->isDecl();
+   }
+
+   bool isExpr() const
+   {
+      return m_raw->isExpr();
+   }
+
+   bool isUnknown() const
+   {
+      return m_raw->isUnknown();
+   }
+
+   bool isMissing() const
+   {
+      return m_raw->isMissing();
+   }
+
+   bool isPresent() const
+   {
+      return m_raw->isPresent();
+   }
+
+   TokenKindType getTokenKind() const
+   {
+      return m_raw->getTokenKind();
+   }
+
+   StringRef getTokenText() const
+   {
+      return m_raw->getTokenText();
+   }
+
+   /// Returns true if the node has the kind of the syntax node class \c T.
+   template <typename T>
+   bool is() const
+   {
+      return T::kindOf(getKind());
+   }
+
+   /// Get a typed view of this node, e.g. a \c ParenDecoratedExprSyntaxRef,
+   /// if the node has the kind of the view.
+   template <typename ViewType>
+   std::optional<ViewType> getAs() const
+   {
+      if (!ViewType::kindOf(getKind())) {
+         return std::nullopt;
+      }
+      return ViewType(*this);
+   }
+
+   size_t getNumChildren() const
+   {
+      return m_raw->getNumChildren();
+   }
+
+   /// Get the Nth child of this node, if it is present in the layout.
+   ///
+   /// The offset of the child is computed from the offset of this node and
+   /// the lengths of the children before it. Use \c getFirstChild and
+   /// \c getNextSibling, or \c forEachChild, to visit all children of a node
+   /// in linear time.
+   std::optional<SyntaxRef> getChild(size_t index) const;
+
+   /// Get the child at \p cursor, which is one of the \c Cursor values of the
+   /// syntax node class this node is an instance of, e.g.
+   /// \c ParenDecoratedExprSyntax::Cursor::Expr.
+   template <typename CursorType>
+   std::optional<SyntaxRef> getChild(CursorType cursor) const
+   {
+      return getChild(static_cast<size_t>(cursor_index(cursor)));
+   }
+
+   /// Get the first child of this node that is present in the layout.
+   std::optional<SyntaxRef> getFirstChild() const
+   {
+      return getPresentChild(m_root, m_raw, 0, m_offset);
+   }
+
+   /// Get the next sibling of this node that is present in the layout of its
+   /// parent. The offset of the sibling is the end offset of this node.
+   std::optional<SyntaxRef> getNextSibling() const
+   {
+      if (!m_parent) {
+         return std::nullopt;
+      }
+      return getPresentChild(m_root, m_parent, m_indexInParent + 1,
+                             getAbsoluteEndOffsetAfterTrailingTrivia());
+   }
+
+   /// Call \p callback with every child of this node that is present in the
+   /// layout.
+   template <typename Callback>
+   void forEachChild(Callback &&callback) const
+   {
+      for (std::optional<SyntaxRef> child = getFirstChild(); child;
+           child = child->getNextSibling()) {
+         callback(*child);
+      }
+   }
+
+   /// Return the parent of this node, if it has one.
+   ///
+   /// A \c SyntaxRef only stores its parent node, not the parent's own
+   /// position, so the position is found again by walking down from the root
+   /// along the offset of this node. This takes time proportional to the
+   /// depth of the node, unless the parent is the root.
+   std::optional<SyntaxRef> getParent() const;
+
+   SyntaxRef getRoot() const
+   {
+      return SyntaxRef(m_root, m_root, nullptr, 0, 0);
+   }
+
+   bool isRoot() const
+   {
+      return m_parent == nullptr;
+   }
+
+   /// Returns the child index of this node in its parent, if it has one,
+   /// otherwise 0.
+   CursorIndex getIndexInParent() const
+   {
+      return m_indexInParent;
+   }
+
+   /// Get the offset at which the leading trivia of this node starts.
+   size_t getAbsoluteOffsetBeforeLeadingTrivia() const
+   {
+      return m_offset;
+   }
+
+   /// Get the offset at which the first token of this node starts.
+   size_t getAbsoluteOffset() const;
+
+   /// Get the offset at which the trailing trivia of this node ends.
+   size_t getAbsoluteEndOffsetAfterTrailingTrivia() const
+   {
+      return m_offset + getTextLength();
+   }
+
+   /// Return the number of bytes this node takes when spelled out in the source
+   size_t getTextLength() const
+   {
+      return m_raw->isMissing() ? 0 : mutableRaw(m_raw)->getTextLength();
+   }
+
+   /// Create a full \c Syntax handle for this node. \p root has to be a
+   /// handle of the root of the tree this reference points into.
+   Syntax realize(const Syntax &root) const;
+
+   /// Collect the child indices leading from the root to this node.
+   void getPathFromRoot(polar::basic::SmallVectorImpl<CursorIndex> &path) const;
+
+   bool hasSameIdentityAs(const SyntaxRef &other) const
+   {
+      return m_raw == other.m_raw && m_root == other.m_root &&
+            m_parent == other.m_parent && m_offset == other.m_offset &&
+            m_indexInParent == other.m_indexInParent;
+   }
+
+   /// Print the syntax node with full fidelity to the given output stream.
+   void print(RawOutStream &outStream, SyntaxPrintOptions opts = SyntaxPrintOptions()) const
+   {
+      m_raw->print(outStream, opts);
+   }
+
+   /// Print a debug representation of the syntax node to the given output stream
+   /// and indentation level.
+   void dump(RawOutStream &outStream, unsigned indent = 0) const
+   {
+      m_raw->dump(outStream, indent);
+   }
+
+private:
+   SyntaxRef(const RawSyntax *root, const RawSyntax *raw, const RawSyntax *parent,
+             CursorIndex indexInParent, size_t offset)
+      : m_root(root),
+        m_raw(raw),
+        m_parent(parent),
+        m_indexInParent(indexInParent),
+        m_offset(offset)
+   {
+      assert(m_root && m_raw);
+   }
+
+   /// Get the first child of \p parent present in its layout at or after
+   /// \p index, given that the child at \p index starts at \p offset.
+   static std::optional<SyntaxRef> getPresentChild(const RawSyntax *root,
+                                                   const RawSyntax *parent,
+                                                   size_t index, size_t offset);
+
+   /// RawSyntax caches the text length of layout nodes lazily, which is the
+   /// only reason its getter is not const.
+   static RawSyntax *mutableRaw(const RawSyntax *raw)
+   {
+      return const_cast<RawSyntax *>(raw);
+   }
+
+   const RawSyntax *m_root;
+   const RawSyntax *m_raw;
+   /// The parent node, or null for the root.
+   const RawSyntax *m_parent;
+   CursorIndex m_indexInParent;
+   size_t m_offset;
+};
+
+} // polar::syntax
+
+#endif // POLARPHP_SYNTAX_SYNTAX_REF_H
@@ -0,0 +1,3919 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#ifndef POLARPHP_SYNTAX_SYNTAX_REF_NODES_H
+#define POLARPHP_SYNTAX_SYNTAX_REF_NODES_H
+
+#include "polarphp/syntax/SyntaxRef.h"
+#include "polarphp/syntax/syntaxnode/DeclSyntaxNodes.h"
+#include "polarphp/syntax/syntaxnode/ExprSyntaxNodes.h"
+#include "polarphp/syntax/syntaxnode/StmtSyntaxNodes.h"
+
+namespace polar::syntax {
+
+/// A \c SyntaxRef that is known to refer to a node of the syntax node class
+/// \c SyntaxType.
+///
+/// The views below give a \c SyntaxRef the same accessors as the syntax node
+/// classes. The children are returned as plain \c SyntaxRef handles, which
+/// can be turned into a view again with \c SyntaxRef::getAs.
+template <typename SyntaxType>
+class TypedSyntaxRef : public SyntaxRef
+{
+public:
+   using Cursor = typename SyntaxType::Cursor;
+
+   explicit TypedSyntaxRef(const SyntaxRef &node)
+      : SyntaxRef(node)
+   {
+      assert(kindOf(node.getKind()) && "node is not of the kind of the view");
+   }
+
+   static bool kindOf(SyntaxKind kind)
+   {
+      return SyntaxType::kindOf(kind);
+   }
+
+protected:
+   SyntaxRef getRequiredChild(Cursor cursor) const
+   {
+      std::optional<SyntaxRef> child = getChild(cursor);
+      assert(child.has_value() && "required child is missing from the layout");
+      return *child;
+   }
+};
+
+//===----------------------------------------------------------------------===//
+// Declaration nodes
+//===----------------------------------------------------------------------===//
+
+class ReservedNonModifierSyntaxRef final : public TypedSyntaxRef<ReservedNonModifierSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getModifier() const
+   {
+      return getRequiredChild(Cursor::Modifier);
+   }
+};
+
+class IdentifierSyntaxRef final : public TypedSyntaxRef<IdentifierSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getNameItem() const
+   {
+      return getRequiredChild(Cursor::NameItem);
+   }
+};
+
+class NamespaceNameSyntaxRef final : public TypedSyntaxRef<NamespaceNameSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getParentNs() const
+   {
+      return getChild(Cursor::ParentNs);
+   }
+
+   std::optional<SyntaxRef> getNsSeparator() const
+   {
+      return getChild(Cursor::NsSeparator);
+   }
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+};
+
+class NameSyntaxRef final : public TypedSyntaxRef<NameSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getNsToken() const
+   {
+      return getChild(Cursor::NsToken);
+   }
+
+   std::optional<SyntaxRef> getNsSeparator() const
+   {
+      return getChild(Cursor::NsSeparator);
+   }
+
+   SyntaxRef getNamespaceName() const
+   {
+      return getRequiredChild(Cursor::Namespace);
+   }
+};
+
+class NameListItemSyntaxRef final : public TypedSyntaxRef<NameListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+};
+
+class InitializerClauseSyntaxRef final : public TypedSyntaxRef<InitializerClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getEqualToken() const
+   {
+      return getRequiredChild(Cursor::EqualToken);
+   }
+
+   SyntaxRef getValueExpr() const
+   {
+      return getRequiredChild(Cursor::ValueExpr);
+   }
+};
+
+class TypeClauseSyntaxRef final : public TypedSyntaxRef<TypeClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getType() const
+   {
+      return getRequiredChild(Cursor::Type);
+   }
+};
+
+class TypeExprClauseSyntaxRef final : public TypedSyntaxRef<TypeExprClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getQuestionToken() const
+   {
+      return getChild(Cursor::QuestionToken);
+   }
+
+   SyntaxRef getTypeClause() const
+   {
+      return getRequiredChild(Cursor::TypeClause);
+   }
+};
+
+class ReturnTypeClauseSyntaxRef final : public TypedSyntaxRef<ReturnTypeClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getColon() const
+   {
+      return getRequiredChild(Cursor::ColonToken);
+   }
+
+   SyntaxRef getType() const
+   {
+      return getRequiredChild(Cursor::TypeExpr);
+   }
+};
+
+class ParameterSyntaxRef final : public TypedSyntaxRef<ParameterSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getTypeHint() const
+   {
+      return getChild(Cursor::TypeHint);
+   }
+
+   std::optional<SyntaxRef> getReferenceMark() const
+   {
+      return getChild(Cursor::ReferenceMark);
+   }
+
+   std::optional<SyntaxRef> getVariadicMark() const
+   {
+      return getChild(Cursor::VariadicMark);
+   }
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+
+   std::optional<SyntaxRef> getInitializer() const
+   {
+      return getChild(Cursor::Initializer);
+   }
+};
+
+class ParameterListItemSyntaxRef final : public TypedSyntaxRef<ParameterListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::Comma);
+   }
+
+   SyntaxRef getParameter() const
+   {
+      return getRequiredChild(Cursor::Parameter);
+   }
+};
+
+class ParameterClauseSyntaxRef final : public TypedSyntaxRef<ParameterClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftParen() const
+   {
+      return getRequiredChild(Cursor::LeftParen);
+   }
+
+   std::optional<SyntaxRef> getParameters() const
+   {
+      return getChild(Cursor::Parameters);
+   }
+
+   SyntaxRef getRightParen() const
+   {
+      return getRequiredChild(Cursor::RightParen);
+   }
+};
+
+class FunctionDefinitionSyntaxRef final : public TypedSyntaxRef<FunctionDefinitionSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFuncToken() const
+   {
+      return getRequiredChild(Cursor::FuncToken);
+   }
+
+   std::optional<SyntaxRef> getReturnRefToken() const
+   {
+      return getChild(Cursor::ReturnRefToken);
+   }
+
+   SyntaxRef getFuncName() const
+   {
+      return getRequiredChild(Cursor::FuncName);
+   }
+
+   SyntaxRef getParameterClause() const
+   {
+      return getRequiredChild(Cursor::ParameterListClause);
+   }
+
+   std::optional<SyntaxRef> getReturnType() const
+   {
+      return getChild(Cursor::ReturnType);
+   }
+
+   SyntaxRef getBody() const
+   {
+      return getRequiredChild(Cursor::Body);
+   }
+};
+
+class ClassModifierSyntaxRef final : public TypedSyntaxRef<ClassModifierSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getModifier() const
+   {
+      return getRequiredChild(Cursor::Modifier);
+   }
+};
+
+class ExtendsFromClauseSyntaxRef final : public TypedSyntaxRef<ExtendsFromClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getExtendToken() const
+   {
+      return getRequiredChild(Cursor::ExtendToken);
+   }
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+};
+
+class ImplementsClauseSyntaxRef final : public TypedSyntaxRef<ImplementsClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getImplementToken() const
+   {
+      return getRequiredChild(Cursor::ImplementToken);
+   }
+
+   SyntaxRef getInterfaces() const
+   {
+      return getRequiredChild(Cursor::Interfaces);
+   }
+};
+
+class MemberModifierSyntaxRef final : public TypedSyntaxRef<MemberModifierSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getModifier() const
+   {
+      return getRequiredChild(Cursor::Modifier);
+   }
+};
+
+class ClassPropertyDeclSyntaxRef final : public TypedSyntaxRef<ClassPropertyDeclSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getModifiers() const
+   {
+      return getRequiredChild(Cursor::Modifiers);
+   }
+
+   std::optional<SyntaxRef> getTypeHint() const
+   {
+      return getChild(Cursor::TypeHint);
+   }
+
+   SyntaxRef getPropertyList() const
+   {
+      return getRequiredChild(Cursor::PropertyList);
+   }
+};
+
+class ClassConstDeclSyntaxRef final : public TypedSyntaxRef<ClassConstDeclSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getModifiers() const
+   {
+      return getRequiredChild(Cursor::Modifiers);
+   }
+
+   std::optional<SyntaxRef> getConstToken() const
+   {
+      return getChild(Cursor::ConstToken);
+   }
+
+   SyntaxRef getConstList() const
+   {
+      return getRequiredChild(Cursor::ConstList);
+   }
+};
+
+class ClassMethodDeclSyntaxRef final : public TypedSyntaxRef<ClassMethodDeclSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getModifiers() const
+   {
+      return getRequiredChild(Cursor::Modifiers);
+   }
+
+   SyntaxRef getFunctionToken() const
+   {
+      return getRequiredChild(Cursor::FunctionToken);
+   }
+
+   std::optional<SyntaxRef> getReturnRefToken() const
+   {
+      return getChild(Cursor::ReturnRefToken);
+   }
+
+   SyntaxRef getFuncName() const
+   {
+      return getRequiredChild(Cursor::FuncName);
+   }
+
+   SyntaxRef getParameterClause() const
+   {
+      return getRequiredChild(Cursor::ParameterListClause);
+   }
+
+   std::optional<SyntaxRef> getReturnType() const
+   {
+      return getChild(Cursor::ReturnType);
+   }
+
+   std::optional<SyntaxRef> getBody() const
+   {
+      return getChild(Cursor::Body);
+   }
+};
+
+class ClassTraitMethodReferenceSyntaxRef final : public TypedSyntaxRef<ClassTraitMethodReferenceSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getReference() const
+   {
+      return getRequiredChild(Cursor::Reference);
+   }
+};
+
+class ClassAbsoluteTraitMethodReferenceSyntaxRef final : public TypedSyntaxRef<ClassAbsoluteTraitMethodReferenceSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getBaseName() const
+   {
+      return getRequiredChild(Cursor::BaseName);
+   }
+
+   SyntaxRef getSeparator() const
+   {
+      return getRequiredChild(Cursor::Separator);
+   }
+
+   SyntaxRef getMemberName() const
+   {
+      return getRequiredChild(Cursor::MemberName);
+   }
+};
+
+class ClassTraitPrecedenceSyntaxRef final : public TypedSyntaxRef<ClassTraitPrecedenceSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getMethodReference() const
+   {
+      return getRequiredChild(Cursor::MethodReference);
+   }
+
+   SyntaxRef getInsteadOfToken() const
+   {
+      return getRequiredChild(Cursor::InsteadOfToken);
+   }
+
+   SyntaxRef getNames() const
+   {
+      return getRequiredChild(Cursor::Names);
+   }
+};
+
+class ClassTraitAliasSyntaxRef final : public TypedSyntaxRef<ClassTraitAliasSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getMethodReference() const
+   {
+      return getRequiredChild(Cursor::MethodReference);
+   }
+
+   SyntaxRef getAsToken() const
+   {
+      return getRequiredChild(Cursor::AsToken);
+   }
+
+   std::optional<SyntaxRef> getModifier() const
+   {
+      return getChild(Cursor::Modifier);
+   }
+
+   std::optional<SyntaxRef> getAliasName() const
+   {
+      return getChild(Cursor::AliasName);
+   }
+};
+
+class ClassTraitAdaptationSyntaxRef final : public TypedSyntaxRef<ClassTraitAdaptationSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getAdaptation() const
+   {
+      return getRequiredChild(Cursor::Adaptation);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class ClassTraitAdaptationBlockSyntaxRef final : public TypedSyntaxRef<ClassTraitAdaptationBlockSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+
+   std::optional<SyntaxRef> getAdaptationList() const
+   {
+      return getChild(Cursor::AdaptationList);
+   }
+
+   SyntaxRef getRightBrace() const
+   {
+      return getRequiredChild(Cursor::RightBrace);
+   }
+};
+
+class ClassTraitDeclSyntaxRef final : public TypedSyntaxRef<ClassTraitDeclSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getUseToken() const
+   {
+      return getRequiredChild(Cursor::UseToken);
+   }
+
+   SyntaxRef getNameList() const
+   {
+      return getRequiredChild(Cursor::NameList);
+   }
+
+   std::optional<SyntaxRef> getAdaptationBlock() const
+   {
+      return getChild(Cursor::AdaptationBlock);
+   }
+};
+
+class InterfaceExtendsClauseSyntaxRef final : public TypedSyntaxRef<InterfaceExtendsClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getExtendsToken() const
+   {
+      return getRequiredChild(Cursor::ExtendsToken);
+   }
+
+   SyntaxRef getInterfaces() const
+   {
+      return getRequiredChild(Cursor::Interfaces);
+   }
+};
+
+class ClassPropertyClauseSyntaxRef final : public TypedSyntaxRef<ClassPropertyClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+
+   std::optional<SyntaxRef> getInitializer() const
+   {
+      return getChild(Cursor::Initializer);
+   }
+};
+
+class ClassPropertyListItemSyntaxRef final : public TypedSyntaxRef<ClassPropertyListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::Comma);
+   }
+
+   SyntaxRef getProperty() const
+   {
+      return getRequiredChild(Cursor::Property);
+   }
+};
+
+class ClassConstClauseSyntaxRef final : public TypedSyntaxRef<ClassConstClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getIdentifier() const
+   {
+      return getRequiredChild(Cursor::Identifier);
+   }
+
+   SyntaxRef getInitializer() const
+   {
+      return getRequiredChild(Cursor::Initializer);
+   }
+};
+
+class ClassConstListItemSyntaxRef final : public TypedSyntaxRef<ClassConstListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::Comma);
+   }
+
+   SyntaxRef getConstDecl() const
+   {
+      return getRequiredChild(Cursor::ConstDecl);
+   }
+};
+
+class MemberDeclListItemSyntaxRef final : public TypedSyntaxRef<MemberDeclListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDecl() const
+   {
+      return getRequiredChild(Cursor::Decl);
+   }
+
+   std::optional<SyntaxRef> getSemicolon() const
+   {
+      return getChild(Cursor::Semicolon);
+   }
+};
+
+class MemberDeclBlockSyntaxRef final : public TypedSyntaxRef<MemberDeclBlockSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+
+   SyntaxRef getMembers() const
+   {
+      return getRequiredChild(Cursor::Members);
+   }
+
+   SyntaxRef getRightBrace() const
+   {
+      return getRequiredChild(Cursor::RightBrace);
+   }
+};
+
+class ClassDefinitionSyntaxRef final : public TypedSyntaxRef<ClassDefinitionSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getModififers() const
+   {
+      return getChild(Cursor::Modififers);
+   }
+
+   SyntaxRef getClassToken() const
+   {
+      return getRequiredChild(Cursor::ClassToken);
+   }
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+
+   std::optional<SyntaxRef> getExtendsFrom() const
+   {
+      return getChild(Cursor::ExtendsFrom);
+   }
+
+   std::optional<SyntaxRef> getImplementsList() const
+   {
+      return getChild(Cursor::ExtendsFrom);
+   }
+
+   SyntaxRef getMembers() const
+   {
+      return getRequiredChild(Cursor::Members);
+   }
+};
+
+class InterfaceDefinitionSyntaxRef final : public TypedSyntaxRef<InterfaceDefinitionSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getInterfaceToken() const
+   {
+      return getRequiredChild(Cursor::InterfaceToken);
+   }
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+
+   std::optional<SyntaxRef> getExtendsFrom() const
+   {
+      return getChild(Cursor::ExtendsFrom);
+   }
+
+   SyntaxRef getMembers() const
+   {
+      return getRequiredChild(Cursor::Members);
+   }
+};
+
+class TraitDefinitionSyntaxRef final : public TypedSyntaxRef<TraitDefinitionSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getTraitToken() const
+   {
+      return getRequiredChild(Cursor::TraitToken);
+   }
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+
+   SyntaxRef getMembers() const
+   {
+      return getRequiredChild(Cursor::Members);
+   }
+};
+
+class SourceFileSyntaxRef final : public TypedSyntaxRef<SourceFileSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getEofToken() const
+   {
+      return getRequiredChild(Cursor::EOFToken);
+   }
+
+   SyntaxRef getStatements() const
+   {
+      return getRequiredChild(Cursor::Statements);
+   }
+};
+
+//===----------------------------------------------------------------------===//
+// Expression nodes
+//===----------------------------------------------------------------------===//
+
+class ParenDecoratedExprSyntaxRef final : public TypedSyntaxRef<ParenDecoratedExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+};
+
+class NullExprSyntaxRef final : public TypedSyntaxRef<NullExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getNullKeyword() const
+   {
+      return getRequiredChild(Cursor::NullKeyword);
+   }
+};
+
+class OptionalExprSyntaxRef final : public TypedSyntaxRef<OptionalExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getExpr() const
+   {
+      return getChild(Cursor::Expr);
+   }
+};
+
+class ExprListItemSyntaxRef final : public TypedSyntaxRef<ExprListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::Comma);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+};
+
+class VariableExprSyntaxRef final : public TypedSyntaxRef<VariableExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVar() const
+   {
+      return getRequiredChild(Cursor::Var);
+   }
+};
+
+class ReferencedVariableExprSyntaxRef final : public TypedSyntaxRef<ReferencedVariableExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getRefToken() const
+   {
+      return getRequiredChild(Cursor::RefToken);
+   }
+
+   SyntaxRef getVariableExpr() const
+   {
+      return getRequiredChild(Cursor::VariableExpr);
+   }
+};
+
+class ClassConstIdentifierExprSyntaxRef final : public TypedSyntaxRef<ClassConstIdentifierExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getClassName() const
+   {
+      return getRequiredChild(Cursor::ClassName);
+   }
+
+   SyntaxRef getSeparatorToken() const
+   {
+      return getRequiredChild(Cursor::SeparatorToken);
+   }
+
+   SyntaxRef getIdentifier() const
+   {
+      return getRequiredChild(Cursor::Identifier);
+   }
+};
+
+class ConstExprSyntaxRef final : public TypedSyntaxRef<ConstExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getIdentifier() const
+   {
+      return getRequiredChild(Cursor::Identifier);
+   }
+};
+
+class NewVariableClauseSyntaxRef final : public TypedSyntaxRef<NewVariableClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVar() const
+   {
+      return getRequiredChild(Cursor::VarNode);
+   }
+};
+
+class CallableVariableExprSyntaxRef final : public TypedSyntaxRef<CallableVariableExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVar() const
+   {
+      return getRequiredChild(Cursor::Var);
+   }
+};
+
+class CallableFuncNameClauseSyntaxRef final : public TypedSyntaxRef<CallableFuncNameClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFuncName() const
+   {
+      return getRequiredChild(Cursor::FuncName);
+   }
+};
+
+class MemberNameClauseSyntaxRef final : public TypedSyntaxRef<MemberNameClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+};
+
+class PropertyNameClauseSyntaxRef final : public TypedSyntaxRef<PropertyNameClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+};
+
+class InstancePropertyExprSyntaxRef final : public TypedSyntaxRef<InstancePropertyExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getObjectRef() const
+   {
+      return getRequiredChild(Cursor::ObjectRef);
+   }
+
+   SyntaxRef getSeparator() const
+   {
+      return getRequiredChild(Cursor::Separator);
+   }
+
+   SyntaxRef getPropertyName() const
+   {
+      return getRequiredChild(Cursor::PropertyName);
+   }
+};
+
+class StaticPropertyExprSyntaxRef final : public TypedSyntaxRef<StaticPropertyExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getClassName() const
+   {
+      return getRequiredChild(Cursor::ClassName);
+   }
+
+   SyntaxRef getSeparator() const
+   {
+      return getRequiredChild(Cursor::Separator);
+   }
+
+   SyntaxRef getMemberName() const
+   {
+      return getRequiredChild(Cursor::MemberName);
+   }
+};
+
+class ArgumentSyntaxRef final : public TypedSyntaxRef<ArgumentSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getEllipsisToken() const
+   {
+      return getChild(Cursor::EllipsisToken);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+};
+
+class ArgumentListItemSyntaxRef final : public TypedSyntaxRef<ArgumentListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::Argument);
+   }
+
+   SyntaxRef getArgument() const
+   {
+      return getRequiredChild(Cursor::Argument);
+   }
+};
+
+class ArgumentListClauseSyntaxRef final : public TypedSyntaxRef<ArgumentListClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   std::optional<SyntaxRef> getArguments() const
+   {
+      return getChild(Cursor::Arguments);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+};
+
+class DereferencableClauseSyntaxRef final : public TypedSyntaxRef<DereferencableClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDereferencableExpr() const
+   {
+      return getRequiredChild(Cursor::DereferencableExpr);
+   }
+};
+
+class VariableClassNameClauseSyntaxRef final : public TypedSyntaxRef<VariableClassNameClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDereferencableExpr() const
+   {
+      return getRequiredChild(Cursor::DereferencableExpr);
+   }
+};
+
+class ClassNameClauseSyntaxRef final : public TypedSyntaxRef<ClassNameClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+};
+
+class ClassNameRefClauseSyntaxRef final : public TypedSyntaxRef<ClassNameRefClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+};
+
+class BraceDecoratedExprClauseSyntaxRef final : public TypedSyntaxRef<BraceDecoratedExprClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+
+   SyntaxRef getRightBrace() const
+   {
+      return getRequiredChild(Cursor::RightBrace);
+   }
+};
+
+class BraceDecoratedVariableExprSyntaxRef final : public TypedSyntaxRef<BraceDecoratedVariableExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDollarSign() const
+   {
+      return getRequiredChild(Cursor::DollarSign);
+   }
+
+   SyntaxRef getDecoratedExpr() const
+   {
+      return getRequiredChild(Cursor::DecoratedExpr);
+   }
+};
+
+class ArrayKeyValuePairItemSyntaxRef final : public TypedSyntaxRef<ArrayKeyValuePairItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getKeyExpr() const
+   {
+      return getChild(Cursor::KeyExpr);
+   }
+
+   std::optional<SyntaxRef> getDoubleArrowToken() const
+   {
+      return getChild(Cursor::DoubleArrowToken);
+   }
+
+   SyntaxRef getValue() const
+   {
+      return getRequiredChild(Cursor::Value);
+   }
+};
+
+class ArrayUnpackPairItemSyntaxRef final : public TypedSyntaxRef<ArrayUnpackPairItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getEllipsisToken() const
+   {
+      return getRequiredChild(Cursor::EllipsisToken);
+   }
+
+   SyntaxRef getUnpackExpr() const
+   {
+      return getRequiredChild(Cursor::UnpackExpr);
+   }
+};
+
+class ArrayPairSyntaxRef final : public TypedSyntaxRef<ArrayPairSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getItem() const
+   {
+      return getRequiredChild(Cursor::Item);
+   }
+};
+
+class ArrayPairListItemSyntaxRef final : public TypedSyntaxRef<ArrayPairListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   std::optional<SyntaxRef> getArrayPair() const
+   {
+      return getChild(Cursor::ArrayPair);
+   }
+};
+
+class ListRecursivePairItemSyntaxRef final : public TypedSyntaxRef<ListRecursivePairItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getKeyExpr() const
+   {
+      return getChild(Cursor::KeyExpr);
+   }
+
+   std::optional<SyntaxRef> getDoubleArrowToken() const
+   {
+      return getChild(Cursor::DoubleArrowToken);
+   }
+
+   SyntaxRef getListToken() const
+   {
+      return getRequiredChild(Cursor::ListToken);
+   }
+
+   SyntaxRef getLeftParen() const
+   {
+      return getRequiredChild(Cursor::LeftParen);
+   }
+
+   SyntaxRef getArrayPairList() const
+   {
+      return getRequiredChild(Cursor::ArrayPairList);
+   }
+
+   SyntaxRef getRightParen() const
+   {
+      return getRequiredChild(Cursor::RightParen);
+   }
+};
+
+class SimpleVariableExprSyntaxRef final : public TypedSyntaxRef<SimpleVariableExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getDollarSign() const
+   {
+      return getChild(Cursor::DollarSign);
+   }
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+};
+
+class ArrayCreateExprSyntaxRef final : public TypedSyntaxRef<ArrayCreateExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getArrayToken() const
+   {
+      return getRequiredChild(Cursor::ArrayToken);
+   }
+
+   SyntaxRef getLeftParen() const
+   {
+      return getRequiredChild(Cursor::LeftParen);
+   }
+
+   SyntaxRef getPairItemList() const
+   {
+      return getRequiredChild(Cursor::PairItemList);
+   }
+
+   SyntaxRef getRightParen() const
+   {
+      return getRequiredChild(Cursor::RightParen);
+   }
+};
+
+class SimplifiedArrayCreateExprSyntaxRef final : public TypedSyntaxRef<SimplifiedArrayCreateExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftSquareBracket() const
+   {
+      return getRequiredChild(Cursor::LeftSquareBracket);
+   }
+
+   SyntaxRef getPairItemList() const
+   {
+      return getRequiredChild(Cursor::PairItemList);
+   }
+
+   SyntaxRef getRightSquareBracket() const
+   {
+      return getRequiredChild(Cursor::RightSquareBracket);
+   }
+};
+
+class ArrayAccessExprSyntaxRef final : public TypedSyntaxRef<ArrayAccessExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getArrayRef() const
+   {
+      return getRequiredChild(Cursor::ArrayRef);
+   }
+
+   SyntaxRef getLeftSquareBracket() const
+   {
+      return getRequiredChild(Cursor::LeftSquareBracket);
+   }
+
+   SyntaxRef getOffset() const
+   {
+      return getRequiredChild(Cursor::Offset);
+   }
+
+   SyntaxRef getRightSquareBracket() const
+   {
+      return getRequiredChild(Cursor::RightSquareBracket);
+   }
+};
+
+class BraceDecoratedArrayAccessExprSyntaxRef final : public TypedSyntaxRef<BraceDecoratedArrayAccessExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getArrayRef() const
+   {
+      return getRequiredChild(Cursor::ArrayRef);
+   }
+
+   SyntaxRef getOffsetExpr() const
+   {
+      return getRequiredChild(Cursor::OffsetExpr);
+   }
+};
+
+class SimpleFunctionCallExprSyntaxRef final : public TypedSyntaxRef<SimpleFunctionCallExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFuncName() const
+   {
+      return getRequiredChild(Cursor::FuncName);
+   }
+
+   SyntaxRef getArgumentsClause() const
+   {
+      return getRequiredChild(Cursor::ArgumentsClause);
+   }
+};
+
+class FunctionCallExprSyntaxRef final : public TypedSyntaxRef<FunctionCallExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getCallable() const
+   {
+      return getRequiredChild(Cursor::Callable);
+   }
+};
+
+class InstanceMethodCallExprSyntaxRef final : public TypedSyntaxRef<InstanceMethodCallExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getQualifiedMethodName() const
+   {
+      return getRequiredChild(Cursor::QualifiedMethodName);
+   }
+
+   SyntaxRef getArgumentListClause() const
+   {
+      return getRequiredChild(Cursor::ArgumentListClause);
+   }
+};
+
+class StaticMethodCallExprSyntaxRef final : public TypedSyntaxRef<StaticMethodCallExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getClassName() const
+   {
+      return getRequiredChild(Cursor::ClassName);
+   }
+
+   SyntaxRef getSeparator() const
+   {
+      return getRequiredChild(Cursor::Separator);
+   }
+
+   SyntaxRef getMethodName() const
+   {
+      return getRequiredChild(Cursor::MethodName);
+   }
+
+   SyntaxRef getArguments() const
+   {
+      return getRequiredChild(Cursor::Arguments);
+   }
+};
+
+class DereferencableScalarExprSyntaxRef final : public TypedSyntaxRef<DereferencableScalarExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getScalarValue() const
+   {
+      return getRequiredChild(Cursor::ScalarValue);
+   }
+};
+
+class AnonymousClassDefinitionClauseSyntaxRef final : public TypedSyntaxRef<AnonymousClassDefinitionClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getClassToken() const
+   {
+      return getRequiredChild(Cursor::ClassToken);
+   }
+
+   std::optional<SyntaxRef> getCtorArguments() const
+   {
+      return getChild(Cursor::CtorArguments);
+   }
+
+   std::optional<SyntaxRef> getExtendsFrom() const
+   {
+      return getChild(Cursor::ExtendsFrom);
+   }
+
+   std::optional<SyntaxRef> getImplementsList() const
+   {
+      return getChild(Cursor::ImplementsList);
+   }
+
+   SyntaxRef getMembers() const
+   {
+      return getRequiredChild(Cursor::Members);
+   }
+};
+
+class SimpleInstanceCreateExprSyntaxRef final : public TypedSyntaxRef<SimpleInstanceCreateExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getNewToken() const
+   {
+      return getRequiredChild(Cursor::NewToken);
+   }
+
+   SyntaxRef getClassName() const
+   {
+      return getRequiredChild(Cursor::ClassName);
+   }
+
+   std::optional<SyntaxRef> getCtorArgsClause() const
+   {
+      return getChild(Cursor::CtorArgsClause);
+   }
+};
+
+class AnonymousInstanceCreateExprSyntaxRef final : public TypedSyntaxRef<AnonymousInstanceCreateExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getNewToken() const
+   {
+      return getRequiredChild(Cursor::NewToken);
+   }
+
+   SyntaxRef getAnonymousClassDef() const
+   {
+      return getRequiredChild(Cursor::AnonymousClassDef);
+   }
+};
+
+class ClassicLambdaExprSyntaxRef final : public TypedSyntaxRef<ClassicLambdaExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFuncToken() const
+   {
+      return getRequiredChild(Cursor::FuncToken);
+   }
+
+   std::optional<SyntaxRef> getReturnRefToken() const
+   {
+      return getChild(Cursor::ReturnRefToken);
+   }
+
+   SyntaxRef getParameterListClause() const
+   {
+      return getRequiredChild(Cursor::ParameterListClause);
+   }
+
+   std::optional<SyntaxRef> getLexicalVarsClause() const
+   {
+      return getChild(Cursor::LexicalVarsClause);
+   }
+
+   std::optional<SyntaxRef> getReturnType() const
+   {
+      return getChild(Cursor::ReturnType);
+   }
+
+   SyntaxRef getBody() const
+   {
+      return getRequiredChild(Cursor::Body);
+   }
+};
+
+class SimplifiedLambdaExprSyntaxRef final : public TypedSyntaxRef<SimplifiedLambdaExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFnToken() const
+   {
+      return getRequiredChild(Cursor::FnToken);
+   }
+
+   std::optional<SyntaxRef> getReturnRefToken() const
+   {
+      return getChild(Cursor::ReturnRefToken);
+   }
+
+   SyntaxRef getParameterListClause() const
+   {
+      return getRequiredChild(Cursor::ParameterListClause);
+   }
+
+   std::optional<SyntaxRef> getReturnType() const
+   {
+      return getChild(Cursor::ReturnType);
+   }
+
+   SyntaxRef getDoubleArrowToken() const
+   {
+      return getRequiredChild(Cursor::DoubleArrowToken);
+   }
+
+   SyntaxRef getBody() const
+   {
+      return getRequiredChild(Cursor::Body);
+   }
+};
+
+class LambdaExprSyntaxRef final : public TypedSyntaxRef<LambdaExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getStaticToken() const
+   {
+      return getChild(Cursor::StaticToken);
+   }
+
+   SyntaxRef getLambdaExpr() const
+   {
+      return getRequiredChild(Cursor::LambdaExpr);
+   }
+};
+
+class InstanceCreateExprSyntaxRef final : public TypedSyntaxRef<InstanceCreateExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getCreateExpr() const
+   {
+      return getRequiredChild(Cursor::CreateExpr);
+   }
+};
+
+class ScalarExprSyntaxRef final : public TypedSyntaxRef<ScalarExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getValue() const
+   {
+      return getRequiredChild(Cursor::Value);
+   }
+};
+
+class ClassRefParentExprSyntaxRef final : public TypedSyntaxRef<ClassRefParentExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getParentKeyword() const
+   {
+      return getRequiredChild(Cursor::ParentKeyword);
+   }
+};
+
+class ClassRefSelfExprSyntaxRef final : public TypedSyntaxRef<ClassRefSelfExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getSelfKeyword() const
+   {
+      return getRequiredChild(Cursor::SelfKeyword);
+   }
+};
+
+class ClassRefStaticExprSyntaxRef final : public TypedSyntaxRef<ClassRefStaticExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getStaticKeyword() const
+   {
+      return getRequiredChild(Cursor::StaticKeyword);
+   }
+};
+
+class IntegerLiteralExprSyntaxRef final : public TypedSyntaxRef<IntegerLiteralExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDigits() const
+   {
+      return getRequiredChild(Cursor::Digits);
+   }
+};
+
+class FloatLiteralExprSyntaxRef final : public TypedSyntaxRef<FloatLiteralExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFloatDigits() const
+   {
+      return getRequiredChild(Cursor::FloatDigits);
+   }
+};
+
+class StringLiteralExprSyntaxRef final : public TypedSyntaxRef<StringLiteralExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftQuote() const
+   {
+      return getRequiredChild(Cursor::LeftQuote);
+   }
+
+   SyntaxRef getText() const
+   {
+      return getRequiredChild(Cursor::Text);
+   }
+
+   SyntaxRef getRightQuote() const
+   {
+      return getRequiredChild(Cursor::RightQuote);
+   }
+};
+
+class BooleanLiteralExprSyntaxRef final : public TypedSyntaxRef<BooleanLiteralExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getBooleanValue() const
+   {
+      return getRequiredChild(Cursor::Boolean);
+   }
+};
+
+class IssetVariableSyntaxRef final : public TypedSyntaxRef<IssetVariableSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+};
+
+class IssetVariableListItemSyntaxRef final : public TypedSyntaxRef<IssetVariableListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+};
+
+class IssetVariablesClauseSyntaxRef final : public TypedSyntaxRef<IssetVariablesClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   SyntaxRef getIsSetVariablesList() const
+   {
+      return getRequiredChild(Cursor::IsSetVariablesList);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+};
+
+class IssetFuncExprSyntaxRef final : public TypedSyntaxRef<IssetFuncExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getIssetToken() const
+   {
+      return getRequiredChild(Cursor::IssetToken);
+   }
+
+   SyntaxRef getIssetVariablesClause() const
+   {
+      return getRequiredChild(Cursor::IssetVariablesClause);
+   }
+};
+
+class EmptyFuncExprSyntaxRef final : public TypedSyntaxRef<EmptyFuncExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getEmptyToken() const
+   {
+      return getRequiredChild(Cursor::EmptyToken);
+   }
+
+   SyntaxRef getArgumentsClause() const
+   {
+      return getRequiredChild(Cursor::ArgumentsClause);
+   }
+};
+
+class IncludeExprSyntaxRef final : public TypedSyntaxRef<IncludeExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getIncludeToken() const
+   {
+      return getRequiredChild(Cursor::IncludeToken);
+   }
+
+   SyntaxRef getArgExpr() const
+   {
+      return getRequiredChild(Cursor::ArgExpr);
+   }
+};
+
+class RequireExprSyntaxRef final : public TypedSyntaxRef<RequireExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getRequireToken() const
+   {
+      return getRequiredChild(Cursor::RequireToken);
+   }
+
+   SyntaxRef getArgExpr() const
+   {
+      return getRequiredChild(Cursor::ArgExpr);
+   }
+};
+
+class EvalFuncExprSyntaxRef final : public TypedSyntaxRef<EvalFuncExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getEvalToken() const
+   {
+      return getRequiredChild(Cursor::EvalToken);
+   }
+
+   SyntaxRef getArgumentsClause() const
+   {
+      return getRequiredChild(Cursor::ArgumentsClause);
+   }
+};
+
+class PrintFuncExprSyntaxRef final : public TypedSyntaxRef<PrintFuncExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getPrintToken() const
+   {
+      return getRequiredChild(Cursor::PrintToken);
+   }
+
+   SyntaxRef getArgsExpr() const
+   {
+      return getRequiredChild(Cursor::ArgsExpr);
+   }
+};
+
+class FuncLikeExprSyntaxRef final : public TypedSyntaxRef<FuncLikeExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFuncLikeExpr() const
+   {
+      return getRequiredChild(Cursor::FuncLikeExpr);
+   }
+};
+
+class ArrayStructureAssignmentExprSyntaxRef final : public TypedSyntaxRef<ArrayStructureAssignmentExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getArrayStructure() const
+   {
+      return getRequiredChild(Cursor::ArrayStructure);
+   }
+
+   SyntaxRef getEqualToken() const
+   {
+      return getRequiredChild(Cursor::EqualToken);
+   }
+
+   SyntaxRef getValueExpr() const
+   {
+      return getRequiredChild(Cursor::ValueExpr);
+   }
+};
+
+class ListStructureClauseSyntaxRef final : public TypedSyntaxRef<ListStructureClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getListToken() const
+   {
+      return getRequiredChild(Cursor::ListToken);
+   }
+
+   SyntaxRef getLeftParen() const
+   {
+      return getRequiredChild(Cursor::LeftParen);
+   }
+
+   SyntaxRef getPairItemList() const
+   {
+      return getRequiredChild(Cursor::PairItemList);
+   }
+
+   SyntaxRef getRightParen() const
+   {
+      return getRequiredChild(Cursor::RightParen);
+   }
+};
+
+class ListStructureAssignmentExprSyntaxRef final : public TypedSyntaxRef<ListStructureAssignmentExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getListStrcuture() const
+   {
+      return getRequiredChild(Cursor::ListStrcuture);
+   }
+
+   SyntaxRef getEqualToken() const
+   {
+      return getRequiredChild(Cursor::EqualToken);
+   }
+
+   SyntaxRef getValueExpr() const
+   {
+      return getRequiredChild(Cursor::ValueExpr);
+   }
+};
+
+class AssignmentExprSyntaxRef final : public TypedSyntaxRef<AssignmentExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getTarget() const
+   {
+      return getRequiredChild(Cursor::Target);
+   }
+
+   SyntaxRef getValueExpr() const
+   {
+      return getRequiredChild(Cursor::ValueExpr);
+   }
+};
+
+class CompoundAssignmentExprSyntaxRef final : public TypedSyntaxRef<CompoundAssignmentExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getTarget() const
+   {
+      return getRequiredChild(Cursor::Target);
+   }
+
+   SyntaxRef getCompoundAssignToken() const
+   {
+      return getRequiredChild(Cursor::CompoundAssignToken);
+   }
+
+   SyntaxRef getValueExpr() const
+   {
+      return getRequiredChild(Cursor::ValueExpr);
+   }
+};
+
+class LogicalExprSyntaxRef final : public TypedSyntaxRef<LogicalExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLhs() const
+   {
+      return getRequiredChild(Cursor::Lhs);
+   }
+
+   SyntaxRef getLogicalOperator() const
+   {
+      return getRequiredChild(Cursor::LogicalOperator);
+   }
+
+   SyntaxRef getRhs() const
+   {
+      return getRequiredChild(Cursor::Rhs);
+   }
+};
+
+class BitLogicalExprSyntaxRef final : public TypedSyntaxRef<BitLogicalExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLhs() const
+   {
+      return getRequiredChild(Cursor::Lhs);
+   }
+
+   SyntaxRef getBitLogicalOperator() const
+   {
+      return getRequiredChild(Cursor::BitLogicalOperator);
+   }
+
+   SyntaxRef getRhs() const
+   {
+      return getRequiredChild(Cursor::Rhs);
+   }
+};
+
+class RelationExprSyntaxRef final : public TypedSyntaxRef<RelationExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getRelationOperator() const
+   {
+      return getRequiredChild(Cursor::RelationOperator);
+   }
+
+   SyntaxRef getRhs() const
+   {
+      return getRequiredChild(Cursor::Rhs);
+   }
+};
+
+class CastExprSyntaxRef final : public TypedSyntaxRef<CastExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getCastOperator() const
+   {
+      return getRequiredChild(Cursor::CastOperator);
+   }
+
+   SyntaxRef getValueExpr() const
+   {
+      return getRequiredChild(Cursor::ValueExpr);
+   }
+};
+
+class ExitExprArgClauseSyntaxRef final : public TypedSyntaxRef<ExitExprArgClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   std::optional<SyntaxRef> getExpr() const
+   {
+      return getChild(Cursor::Expr);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+};
+
+class ExitExprSyntaxRef final : public TypedSyntaxRef<ExitExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getExitToken() const
+   {
+      return getRequiredChild(Cursor::ExitToken);
+   }
+
+   std::optional<SyntaxRef> getArgClause() const
+   {
+      return getChild(Cursor::ArgClause);
+   }
+};
+
+class YieldExprSyntaxRef final : public TypedSyntaxRef<YieldExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getYieldToken() const
+   {
+      return getRequiredChild(Cursor::YieldToken);
+   }
+
+   std::optional<SyntaxRef> getKeyExpr() const
+   {
+      return getChild(Cursor::KeyExpr);
+   }
+
+   std::optional<SyntaxRef> getDoubleArrowToken() const
+   {
+      return getChild(Cursor::DoubleArrowToken);
+   }
+
+   std::optional<SyntaxRef> getValueExpr() const
+   {
+      return getChild(Cursor::ValueExpr);
+   }
+};
+
+class YieldFromExprSyntaxRef final : public TypedSyntaxRef<YieldFromExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getYieldFromToken() const
+   {
+      return getRequiredChild(Cursor::YieldFromToken);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+};
+
+class CloneExprSyntaxRef final : public TypedSyntaxRef<CloneExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getCloneTokenToken() const
+   {
+      return getRequiredChild(Cursor::CloneToken);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+};
+
+class EncapsVariableOffsetSyntaxRef final : public TypedSyntaxRef<EncapsVariableOffsetSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getMinusSign() const
+   {
+      return getChild(Cursor::MinusSign);
+   }
+
+   SyntaxRef getOffset() const
+   {
+      return getRequiredChild(Cursor::Offset);
+   }
+};
+
+class EncapsArrayVarSyntaxRef final : public TypedSyntaxRef<EncapsArrayVarSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVarToken() const
+   {
+      return getRequiredChild(Cursor::VarToken);
+   }
+
+   SyntaxRef getLeftSquareBracket() const
+   {
+      return getRequiredChild(Cursor::LeftSquareBracket);
+   }
+
+   SyntaxRef getOffset() const
+   {
+      return getRequiredChild(Cursor::Offset);
+   }
+
+   SyntaxRef getRightSquareBracket() const
+   {
+      return getRequiredChild(Cursor::RightSquareBracket);
+   }
+};
+
+class EncapsObjPropSyntaxRef final : public TypedSyntaxRef<EncapsObjPropSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVarToken() const
+   {
+      return getRequiredChild(Cursor::VarToken);
+   }
+
+   SyntaxRef getObjOperatorToken() const
+   {
+      return getRequiredChild(Cursor::ObjOperatorToken);
+   }
+
+   SyntaxRef getIdentifierToken() const
+   {
+      return getRequiredChild(Cursor::IdentifierToken);
+   }
+};
+
+class EncapsDollarCurlyExprSyntaxRef final : public TypedSyntaxRef<EncapsDollarCurlyExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDollarOpenCurlyToken() const
+   {
+      return getRequiredChild(Cursor::DollarOpenCurlyToken);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+
+   SyntaxRef getCloseCurlyToken() const
+   {
+      return getRequiredChild(Cursor::CloseCurlyToken);
+   }
+};
+
+class EncapsDollarCurlyVarSyntaxRef final : public TypedSyntaxRef<EncapsDollarCurlyVarSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDollarOpenCurlyToken() const
+   {
+      return getRequiredChild(Cursor::DollarOpenCurlyToken);
+   }
+
+   SyntaxRef getVarname() const
+   {
+      return getRequiredChild(Cursor::Varname);
+   }
+
+   SyntaxRef getCloseCurlyToken() const
+   {
+      return getRequiredChild(Cursor::CloseCurlyToken);
+   }
+};
+
+class EncapsDollarCurlyArraySyntaxRef final : public TypedSyntaxRef<EncapsDollarCurlyArraySyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDollarOpenCurlyToken() const
+   {
+      return getRequiredChild(Cursor::DollarOpenCurlyToken);
+   }
+
+   SyntaxRef getVarname() const
+   {
+      return getRequiredChild(Cursor::Varname);
+   }
+
+   SyntaxRef getLeftSquareBracketToken() const
+   {
+      return getRequiredChild(Cursor::LeftSquareBracketToken);
+   }
+
+   SyntaxRef getIndexExpr() const
+   {
+      return getRequiredChild(Cursor::IndexExpr);
+   }
+
+   SyntaxRef getRightSquareBracketToken() const
+   {
+      return getRequiredChild(Cursor::RightSquareBracketToken);
+   }
+
+   SyntaxRef getCloseCurlyToken() const
+   {
+      return getRequiredChild(Cursor::CloseCurlyToken);
+   }
+};
+
+class EncapsCurlyVariableSyntaxRef final : public TypedSyntaxRef<EncapsCurlyVariableSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getCurlyOpen() const
+   {
+      return getRequiredChild(Cursor::CurlyOpen);
+   }
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+
+   SyntaxRef getCloseCurlyToken() const
+   {
+      return getRequiredChild(Cursor::CloseCurlyToken);
+   }
+};
+
+class EncapsVariableSyntaxRef final : public TypedSyntaxRef<EncapsVariableSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Var);
+   }
+};
+
+class EncapsListItemSyntaxRef final : public TypedSyntaxRef<EncapsListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getStrLiteral() const
+   {
+      return getChild(Cursor::StrLiteral);
+   }
+
+   std::optional<SyntaxRef> getEncapsVariable() const
+   {
+      return getChild(Cursor::EncapsVariable);
+   }
+};
+
+class BackticksClauseSyntaxRef final : public TypedSyntaxRef<BackticksClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getBackticks() const
+   {
+      return getRequiredChild(Cursor::Backticks);
+   }
+};
+
+class HeredocExprSyntaxRef final : public TypedSyntaxRef<HeredocExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getStartHeredocToken() const
+   {
+      return getRequiredChild(Cursor::StartHeredocToken);
+   }
+
+   std::optional<SyntaxRef> getTextClause() const
+   {
+      return getChild(Cursor::TextClause);
+   }
+
+   SyntaxRef getEndHeredocToken() const
+   {
+      return getRequiredChild(Cursor::EndHeredocToken);
+   }
+};
+
+class EncapsListStringExprSyntaxRef final : public TypedSyntaxRef<EncapsListStringExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftQuoteToken() const
+   {
+      return getRequiredChild(Cursor::LeftQuoteToken);
+   }
+
+   SyntaxRef getEncapsList() const
+   {
+      return getRequiredChild(Cursor::EncapsList);
+   }
+
+   SyntaxRef getRightQuoteToken() const
+   {
+      return getRequiredChild(Cursor::RightQuoteToken);
+   }
+};
+
+class TernaryExprSyntaxRef final : public TypedSyntaxRef<TernaryExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getConditionExpr() const
+   {
+      return getRequiredChild(Cursor::ConditionExpr);
+   }
+
+   SyntaxRef getQuestionMark() const
+   {
+      return getRequiredChild(Cursor::QuestionMark);
+   }
+
+   std::optional<SyntaxRef> getFirstChoice() const
+   {
+      return getChild(Cursor::FirstChoice);
+   }
+
+   SyntaxRef getColonMark() const
+   {
+      return getRequiredChild(Cursor::ColonMark);
+   }
+
+   SyntaxRef getSecondChoice() const
+   {
+      return getRequiredChild(Cursor::SecondChoice);
+   }
+};
+
+class SequenceExprSyntaxRef final : public TypedSyntaxRef<SequenceExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getElements() const
+   {
+      return getRequiredChild(Cursor::Elements);
+   }
+};
+
+class PrefixOperatorExprSyntaxRef final : public TypedSyntaxRef<PrefixOperatorExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getOperatorToken() const
+   {
+      return getChild(Cursor::OperatorToken);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+};
+
+class PostfixOperatorExprSyntaxRef final : public TypedSyntaxRef<PostfixOperatorExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+
+   SyntaxRef getOperatorToken() const
+   {
+      return getRequiredChild(Cursor::OperatorToken);
+   }
+};
+
+class BinaryOperatorExprSyntaxRef final : public TypedSyntaxRef<BinaryOperatorExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getOperatorToken() const
+   {
+      return getRequiredChild(Cursor::OperatorToken);
+   }
+};
+
+class InstanceofExprSyntaxRef final : public TypedSyntaxRef<InstanceofExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getInstanceExpr() const
+   {
+      return getRequiredChild(Cursor::InstanceExpr);
+   }
+
+   SyntaxRef getInstanceofToken() const
+   {
+      return getRequiredChild(Cursor::InstanceofToken);
+   }
+
+   SyntaxRef getClassNameRef() const
+   {
+      return getRequiredChild(Cursor::ClassNameRef);
+   }
+};
+
+class ShellCmdExprSyntaxRef final : public TypedSyntaxRef<ShellCmdExprSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftBacktick() const
+   {
+      return getRequiredChild(Cursor::LeftBacktick);
+   }
+
+   std::optional<SyntaxRef> getBackticksExpr() const
+   {
+      return getChild(Cursor::BackticksExpr);
+   }
+
+   SyntaxRef getRightBacktick() const
+   {
+      return getRequiredChild(Cursor::RightBacktick);
+   }
+};
+
+class UseLexicalVariableClauseSyntaxRef final : public TypedSyntaxRef<UseLexicalVariableClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getUseToken() const
+   {
+      return getRequiredChild(Cursor::UseToken);
+   }
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   SyntaxRef getLexicalVars() const
+   {
+      return getRequiredChild(Cursor::LexicalVars);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+};
+
+class LexicalVariableSyntaxRef final : public TypedSyntaxRef<LexicalVariableSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getReferenceToken() const
+   {
+      return getChild(Cursor::ReferenceToken);
+   }
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+};
+
+class LexicalVariableListItemSyntaxRef final : public TypedSyntaxRef<LexicalVariableListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::Comma);
+   }
+
+   SyntaxRef getLexicalVariable() const
+   {
+      return getRequiredChild(Cursor::LexicalVariable);
+   }
+};
+
+//===----------------------------------------------------------------------===//
+// Statement nodes
+//===----------------------------------------------------------------------===//
+
+class EmptyStmtSyntaxRef final : public TypedSyntaxRef<EmptyStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class NestStmtSyntaxRef final : public TypedSyntaxRef<NestStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBraceToken);
+   }
+
+   SyntaxRef getStatements() const
+   {
+      return getRequiredChild(Cursor::Statements);
+   }
+
+   SyntaxRef getRightBrace() const
+   {
+      return getRequiredChild(Cursor::RightBraceToken);
+   }
+};
+
+class ExprStmtSyntaxRef final : public TypedSyntaxRef<ExprStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class InnerStmtSyntaxRef final : public TypedSyntaxRef<InnerStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getStmt() const
+   {
+      return getRequiredChild(Cursor::Stmt);
+   }
+};
+
+class InnerCodeBlockStmtSyntaxRef final : public TypedSyntaxRef<InnerCodeBlockStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+
+   SyntaxRef getStatements() const
+   {
+      return getRequiredChild(Cursor::Statements);
+   }
+
+   SyntaxRef getRightBrace() const
+   {
+      return getRequiredChild(Cursor::RightBrace);
+   }
+};
+
+class TopStmtSyntaxRef final : public TypedSyntaxRef<TopStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getStmt() const
+   {
+      return getRequiredChild(Cursor::Stmt);
+   }
+};
+
+class TopCodeBlockStmtSyntaxRef final : public TypedSyntaxRef<TopCodeBlockStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+
+   SyntaxRef getStatements() const
+   {
+      return getRequiredChild(Cursor::Statements);
+   }
+
+   SyntaxRef getRightBrace() const
+   {
+      return getRequiredChild(Cursor::RightBrace);
+   }
+};
+
+class DeclareStmtSyntaxRef final : public TypedSyntaxRef<DeclareStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDeclareToken() const
+   {
+      return getRequiredChild(Cursor::DeclareToken);
+   }
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   SyntaxRef getConstList() const
+   {
+      return getRequiredChild(Cursor::ConstList);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+
+   SyntaxRef getStmt() const
+   {
+      return getRequiredChild(Cursor::Stmt);
+   }
+};
+
+class GotoStmtSyntaxRef final : public TypedSyntaxRef<GotoStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getGotoToken() const
+   {
+      return getRequiredChild(Cursor::GotoToken);
+   }
+
+   SyntaxRef getTarget() const
+   {
+      return getRequiredChild(Cursor::Target);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class UnsetVariableSyntaxRef final : public TypedSyntaxRef<UnsetVariableSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+};
+
+class UnsetVariableListItemSyntaxRef final : public TypedSyntaxRef<UnsetVariableListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+};
+
+class UnsetStmtSyntaxRef final : public TypedSyntaxRef<UnsetStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getUnsetToken() const
+   {
+      return getRequiredChild(Cursor::UnsetToken);
+   }
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   SyntaxRef getUnsetVariables() const
+   {
+      return getRequiredChild(Cursor::UnsetVariables);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class LabelStmtSyntaxRef final : public TypedSyntaxRef<LabelStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+
+   SyntaxRef getColon() const
+   {
+      return getRequiredChild(Cursor::Colon);
+   }
+};
+
+class ConditionElementSyntaxRef final : public TypedSyntaxRef<ConditionElementSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getCondition() const
+   {
+      return getRequiredChild(Cursor::Condition);
+   }
+
+   std::optional<SyntaxRef> getTrailingComma() const
+   {
+      return getChild(Cursor::TrailingComma);
+   }
+};
+
+class ContinueStmtSyntaxRef final : public TypedSyntaxRef<ContinueStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getContinueKeyword() const
+   {
+      return getRequiredChild(Cursor::ContinueKeyword);
+   }
+
+   std::optional<SyntaxRef> getExpr() const
+   {
+      return getChild(Cursor::Expr);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class BreakStmtSyntaxRef final : public TypedSyntaxRef<BreakStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getBreakKeyword() const
+   {
+      return getRequiredChild(Cursor::BreakKeyword);
+   }
+
+   std::optional<SyntaxRef> getExpr() const
+   {
+      return getChild(Cursor::Expr);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class FallthroughStmtSyntaxRef final : public TypedSyntaxRef<FallthroughStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFallthroughKeyword() const
+   {
+      return getRequiredChild(Cursor::FallthroughKeyword);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class ElseIfClauseSyntaxRef final : public TypedSyntaxRef<ElseIfClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getElseIfKeyword() const
+   {
+      return getRequiredChild(Cursor::ElseIfKeyword);
+   }
+
+   SyntaxRef getLeftParen() const
+   {
+      return getRequiredChild(Cursor::LeftParen);
+   }
+
+   SyntaxRef getCondition() const
+   {
+      return getRequiredChild(Cursor::Condition);
+   }
+
+   SyntaxRef getRightParen() const
+   {
+      return getRequiredChild(Cursor::RightParen);
+   }
+
+   SyntaxRef getBody() const
+   {
+      return getRequiredChild(Cursor::Body);
+   }
+};
+
+class IfStmtSyntaxRef final : public TypedSyntaxRef<IfStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getLabelName() const
+   {
+      return getChild(Cursor::LabelName);
+   }
+
+   std::optional<SyntaxRef> getLabelColon() const
+   {
+      return getChild(Cursor::LabelColon);
+   }
+
+   SyntaxRef getIfKeyword() const
+   {
+      return getRequiredChild(Cursor::IfKeyword);
+   }
+
+   SyntaxRef getLeftParen() const
+   {
+      return getRequiredChild(Cursor::LeftParen);
+   }
+
+   SyntaxRef getCondition() const
+   {
+      return getRequiredChild(Cursor::Condition);
+   }
+
+   SyntaxRef getRightParen() const
+   {
+      return getRequiredChild(Cursor::RightParen);
+   }
+
+   SyntaxRef getBody() const
+   {
+      return getRequiredChild(Cursor::Body);
+   }
+
+   std::optional<SyntaxRef> getElseIfClauses() const
+   {
+      return getChild(Cursor::ElseIfClauses);
+   }
+
+   std::optional<SyntaxRef> getElseKeyword() const
+   {
+      return getChild(Cursor::ElseKeyword);
+   }
+
+   std::optional<SyntaxRef> getElseBody() const
+   {
+      return getChild(Cursor::ElseBody);
+   }
+};
+
+class WhileStmtSyntaxRef final : public TypedSyntaxRef<WhileStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getLabelName() const
+   {
+      return getChild(Cursor::LabelName);
+   }
+
+   std::optional<SyntaxRef> getLabelColon() const
+   {
+      return getChild(Cursor::LabelColon);
+   }
+
+   SyntaxRef getWhileKeyword() const
+   {
+      return getRequiredChild(Cursor::WhileKeyword);
+   }
+
+   SyntaxRef getConditionsClause() const
+   {
+      return getRequiredChild(Cursor::ConditionsClause);
+   }
+
+   SyntaxRef getBody() const
+   {
+      return getRequiredChild(Cursor::Body);
+   }
+};
+
+class DoWhileStmtSyntaxRef final : public TypedSyntaxRef<DoWhileStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getLabelName() const
+   {
+      return getChild(Cursor::LabelName);
+   }
+
+   std::optional<SyntaxRef> getLabelColon() const
+   {
+      return getChild(Cursor::LabelColon);
+   }
+
+   SyntaxRef getDoKeyword() const
+   {
+      return getRequiredChild(Cursor::DoKeyword);
+   }
+
+   SyntaxRef getBody() const
+   {
+      return getRequiredChild(Cursor::Body);
+   }
+
+   SyntaxRef getWhileKeyword() const
+   {
+      return getRequiredChild(Cursor::WhileKeyword);
+   }
+
+   SyntaxRef getConditionsClause() const
+   {
+      return getRequiredChild(Cursor::ConditionsClause);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class ForStmtSyntaxRef final : public TypedSyntaxRef<ForStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getForToken() const
+   {
+      return getRequiredChild(Cursor::ForToken);
+   }
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   std::optional<SyntaxRef> getInitializedExprs() const
+   {
+      return getChild(Cursor::InitializedExprs);
+   }
+
+   SyntaxRef getInitializedSemicolonToken() const
+   {
+      return getRequiredChild(Cursor::InitializedSemicolonToken);
+   }
+
+   std::optional<SyntaxRef> getConditionalExprs() const
+   {
+      return getChild(Cursor::ConditionalExprs);
+   }
+
+   SyntaxRef getConditionalSemicolonToken() const
+   {
+      return getRequiredChild(Cursor::ConditionalSemicolonToken);
+   }
+
+   std::optional<SyntaxRef> getOperationalExprs() const
+   {
+      return getChild(Cursor::OperationalExprs);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+
+   SyntaxRef getStmt() const
+   {
+      return getRequiredChild(Cursor::Stmt);
+   }
+};
+
+class ForeachVariableSyntaxRef final : public TypedSyntaxRef<ForeachVariableSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+};
+
+class ForeachStmtSyntaxRef final : public TypedSyntaxRef<ForeachStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getForeachToken() const
+   {
+      return getRequiredChild(Cursor::ForeachToken);
+   }
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   SyntaxRef getIterableExpr() const
+   {
+      return getRequiredChild(Cursor::IterableExpr);
+   }
+
+   SyntaxRef getAsToken() const
+   {
+      return getRequiredChild(Cursor::AsToken);
+   }
+
+   std::optional<SyntaxRef> getKeyVariable() const
+   {
+      return getChild(Cursor::KeyVariable);
+   }
+
+   std::optional<SyntaxRef> getDoubleArrowToken() const
+   {
+      return getChild(Cursor::DoubleArrowToken);
+   }
+
+   SyntaxRef getValueVariable() const
+   {
+      return getRequiredChild(Cursor::ValueVariable);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+
+   SyntaxRef getStmt() const
+   {
+      return getRequiredChild(Cursor::Stmt);
+   }
+};
+
+class SwitchDefaultLabelSyntaxRef final : public TypedSyntaxRef<SwitchDefaultLabelSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDefaultKeyword() const
+   {
+      return getRequiredChild(Cursor::DefaultKeyword);
+   }
+
+   SyntaxRef getColon() const
+   {
+      return getRequiredChild(Cursor::Colon);
+   }
+};
+
+class SwitchCaseLabelSyntaxRef final : public TypedSyntaxRef<SwitchCaseLabelSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getCaseKeyword() const
+   {
+      return getRequiredChild(Cursor::CaseKeyword);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+
+   SyntaxRef getColon() const
+   {
+      return getRequiredChild(Cursor::Colon);
+   }
+};
+
+class SwitchCaseListClauseSyntaxRef final : public TypedSyntaxRef<SwitchCaseListClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLeftBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+
+   SyntaxRef getSwitchCaseList() const
+   {
+      return getRequiredChild(Cursor::SwitchCaseList);
+   }
+
+   SyntaxRef getRightBrace() const
+   {
+      return getRequiredChild(Cursor::RightBrace);
+   }
+};
+
+class SwitchCaseSyntaxRef final : public TypedSyntaxRef<SwitchCaseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getLabel() const
+   {
+      return getRequiredChild(Cursor::Label);
+   }
+
+   SyntaxRef getStatements() const
+   {
+      return getRequiredChild(Cursor::Statements);
+   }
+};
+
+class SwitchStmtSyntaxRef final : public TypedSyntaxRef<SwitchStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getLabelName() const
+   {
+      return getChild(Cursor::LabelName);
+   }
+
+   std::optional<SyntaxRef> getLabelColon() const
+   {
+      return getChild(Cursor::LabelColon);
+   }
+
+   SyntaxRef getSwitchKeyword() const
+   {
+      return getRequiredChild(Cursor::SwitchKeyword);
+   }
+
+   SyntaxRef getLeftParen() const
+   {
+      return getRequiredChild(Cursor::LeftParen);
+   }
+
+   SyntaxRef getConditionExpr() const
+   {
+      return getRequiredChild(Cursor::ConditionExpr);
+   }
+
+   SyntaxRef getRightParen() const
+   {
+      return getRequiredChild(Cursor::RightParen);
+   }
+
+   SyntaxRef getSwitchCaseListClause() const
+   {
+      return getRequiredChild(Cursor::SwitchCaseListClause);
+   }
+};
+
+class DeferStmtSyntaxRef final : public TypedSyntaxRef<DeferStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getDeferKeyword() const
+   {
+      return getRequiredChild(Cursor::DeferKeyword);
+   }
+
+   SyntaxRef getBody() const
+   {
+      return getRequiredChild(Cursor::Body);
+   }
+};
+
+class ThrowStmtSyntaxRef final : public TypedSyntaxRef<ThrowStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getThrowKeyword() const
+   {
+      return getRequiredChild(Cursor::ThrowKeyword);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class TryStmtSyntaxRef final : public TypedSyntaxRef<TryStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getTryToken() const
+   {
+      return getRequiredChild(Cursor::TryToken);
+   }
+
+   SyntaxRef getCodeBlock() const
+   {
+      return getRequiredChild(Cursor::CodeBlock);
+   }
+
+   SyntaxRef getCatchList() const
+   {
+      return getRequiredChild(Cursor::CatchList);
+   }
+
+   std::optional<SyntaxRef> getFinallyClause() const
+   {
+      return getChild(Cursor::FinallyClause);
+   }
+};
+
+class FinallyClauseSyntaxRef final : public TypedSyntaxRef<FinallyClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFinallyToken() const
+   {
+      return getRequiredChild(Cursor::FinallyToken);
+   }
+
+   SyntaxRef getCodeBlock() const
+   {
+      return getRequiredChild(Cursor::CodeBlock);
+   }
+};
+
+class CatchArgTypeHintItemSyntaxRef final : public TypedSyntaxRef<CatchArgTypeHintItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getSeparator() const
+   {
+      return getChild(Cursor::Separator);
+   }
+
+   SyntaxRef getTypeName() const
+   {
+      return getRequiredChild(Cursor::TypeName);
+   }
+};
+
+class CatchListItemClauseSyntaxRef final : public TypedSyntaxRef<CatchListItemClauseSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getCatchToken() const
+   {
+      return getRequiredChild(Cursor::CatchToken);
+   }
+
+   SyntaxRef getLeftParenToken() const
+   {
+      return getRequiredChild(Cursor::LeftParenToken);
+   }
+
+   SyntaxRef getCatchArgTypeHintList() const
+   {
+      return getRequiredChild(Cursor::CatchArgTypeHintList);
+   }
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+
+   SyntaxRef getRightParenToken() const
+   {
+      return getRequiredChild(Cursor::RightParenToken);
+   }
+
+   SyntaxRef getCodeBlock() const
+   {
+      return getRequiredChild(Cursor::CodeBlock);
+   }
+};
+
+class ReturnStmtSyntaxRef final : public TypedSyntaxRef<ReturnStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getReturnKeyword() const
+   {
+      return getRequiredChild(Cursor::ReturnKeyword);
+   }
+
+   SyntaxRef getExpr() const
+   {
+      return getRequiredChild(Cursor::Expr);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class EchoStmtSyntaxRef final : public TypedSyntaxRef<EchoStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getEchoToken() const
+   {
+      return getRequiredChild(Cursor::EchoToken);
+   }
+
+   SyntaxRef getExprListClause() const
+   {
+      return getRequiredChild(Cursor::ExprListClause);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class HaltCompilerStmtSyntaxRef final : public TypedSyntaxRef<HaltCompilerStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getHaltCompilerToken() const
+   {
+      return getRequiredChild(Cursor::HaltCompilerToken);
+   }
+
+   SyntaxRef getLeftParen() const
+   {
+      return getRequiredChild(Cursor::LeftParen);
+   }
+
+   SyntaxRef getRightParen() const
+   {
+      return getRequiredChild(Cursor::RightParen);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class GlobalVariableSyntaxRef final : public TypedSyntaxRef<GlobalVariableSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+};
+
+class GlobalVariableListItemSyntaxRef final : public TypedSyntaxRef<GlobalVariableListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::Comma);
+   }
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+};
+
+class GlobalVariableDeclarationsStmtSyntaxRef final : public TypedSyntaxRef<GlobalVariableDeclarationsStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getGlobalToken() const
+   {
+      return getRequiredChild(Cursor::GlobalToken);
+   }
+
+   SyntaxRef getVariables() const
+   {
+      return getRequiredChild(Cursor::Variables);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class StaticVariableDeclareSyntaxRef final : public TypedSyntaxRef<StaticVariableDeclareSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getVariable() const
+   {
+      return getRequiredChild(Cursor::Variable);
+   }
+
+   std::optional<SyntaxRef> getEqualToken() const
+   {
+      return getChild(Cursor::EqualToken);
+   }
+
+   std::optional<SyntaxRef> getValueExpr() const
+   {
+      return getChild(Cursor::ValueExpr);
+   }
+};
+
+class StaticVariableListItemSyntaxRef final : public TypedSyntaxRef<StaticVariableListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::Comma);
+   }
+
+   SyntaxRef getDeclaration() const
+   {
+      return getRequiredChild(Cursor::Declaration);
+   }
+};
+
+class StaticVariableDeclarationsStmtSyntaxRef final : public TypedSyntaxRef<StaticVariableDeclarationsStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getStaticToken() const
+   {
+      return getRequiredChild(Cursor::StaticToken);
+   }
+
+   SyntaxRef getVariables() const
+   {
+      return getRequiredChild(Cursor::Variables);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class NamespaceUseTypeSyntaxRef final : public TypedSyntaxRef<NamespaceUseTypeSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getTypeToken() const
+   {
+      return getRequiredChild(Cursor::TypeToken);
+   }
+};
+
+class NamespaceUnprefixedUseDeclarationSyntaxRef final : public TypedSyntaxRef<NamespaceUnprefixedUseDeclarationSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getNamespace() const
+   {
+      return getRequiredChild(Cursor::Namespace);
+   }
+
+   std::optional<SyntaxRef> getAsToken() const
+   {
+      return getChild(Cursor::AsToken);
+   }
+
+   std::optional<SyntaxRef> getIdentifierToken() const
+   {
+      return getChild(Cursor::IdentifierToken);
+   }
+};
+
+class NamespaceUnprefixedUseDeclarationListItemSyntaxRef final : public TypedSyntaxRef<NamespaceUnprefixedUseDeclarationListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getCommaToken() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   SyntaxRef getNamespaceUseDeclaration() const
+   {
+      return getRequiredChild(Cursor::NamespaceUseDeclaration);
+   }
+};
+
+class NamespaceUseDeclarationSyntaxRef final : public TypedSyntaxRef<NamespaceUseDeclarationSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getNsSeparator() const
+   {
+      return getChild(Cursor::NsSeparator);
+   }
+
+   SyntaxRef getUnprefixedUseDeclaration() const
+   {
+      return getRequiredChild(Cursor::UnprefixedUseDeclaration);
+   }
+};
+
+class NamespaceUseDeclarationListItemSyntaxRef final : public TypedSyntaxRef<NamespaceUseDeclarationListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   SyntaxRef getNamespaceUseDeclaration() const
+   {
+      return getRequiredChild(Cursor::NamespaceUseDeclaration);
+   }
+};
+
+class NamespaceInlineUseDeclarationSyntaxRef final : public TypedSyntaxRef<NamespaceInlineUseDeclarationSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getUseType() const
+   {
+      return getChild(Cursor::UseType);
+   }
+
+   SyntaxRef getUnprefixedUseDeclaration() const
+   {
+      return getRequiredChild(Cursor::UnprefixedUseDeclaration);
+   }
+};
+
+class NamespaceInlineUseDeclarationListItemSyntaxRef final : public TypedSyntaxRef<NamespaceInlineUseDeclarationListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getCommaToken() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   SyntaxRef getNamespaceUseDeclaration() const
+   {
+      return getRequiredChild(Cursor::NamespaceUseDeclaration);
+   }
+};
+
+class NamespaceGroupUseDeclarationSyntaxRef final : public TypedSyntaxRef<NamespaceGroupUseDeclarationSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getFirstNsSeparator() const
+   {
+      return getChild(Cursor::FirstNsSeparator);
+   }
+
+   SyntaxRef getNamespace() const
+   {
+      return getRequiredChild(Cursor::Namespace);
+   }
+
+   SyntaxRef getSecondNsSeparator() const
+   {
+      return getRequiredChild(Cursor::SecondNsSeparator);
+   }
+
+   SyntaxRef getLeftBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+
+   SyntaxRef getUnprefixedUseDeclarations() const
+   {
+      return getRequiredChild(Cursor::UnprefixedUseDeclarations);
+   }
+
+   std::optional<SyntaxRef> getCommaToken() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   SyntaxRef getRightBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+};
+
+class NamespaceMixedGroupUseDeclarationSyntaxRef final : public TypedSyntaxRef<NamespaceMixedGroupUseDeclarationSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getFirstNsSeparator() const
+   {
+      return getChild(Cursor::FirstNsSeparator);
+   }
+
+   SyntaxRef getNamespace() const
+   {
+      return getRequiredChild(Cursor::Namespace);
+   }
+
+   SyntaxRef getSecondNsSeparator() const
+   {
+      return getRequiredChild(Cursor::SecondNsSeparator);
+   }
+
+   SyntaxRef getLeftBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+
+   SyntaxRef getInlineUseDeclarations() const
+   {
+      return getRequiredChild(Cursor::InlineUseDeclarations);
+   }
+
+   std::optional<SyntaxRef> getCommaToken() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   SyntaxRef getRightBrace() const
+   {
+      return getRequiredChild(Cursor::LeftBrace);
+   }
+};
+
+class NamespaceUseStmtSyntaxRef final : public TypedSyntaxRef<NamespaceUseStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getUseToken() const
+   {
+      return getRequiredChild(Cursor::UseToken);
+   }
+
+   std::optional<SyntaxRef> getUseType() const
+   {
+      return getChild(Cursor::UseType);
+   }
+
+   SyntaxRef getDeclarations() const
+   {
+      return getRequiredChild(Cursor::Declarations);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::SemicolonToken);
+   }
+};
+
+class NamespaceDefinitionStmtSyntaxRef final : public TypedSyntaxRef<NamespaceDefinitionStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getNamespaceToken() const
+   {
+      return getRequiredChild(Cursor::NamespaceToken);
+   }
+
+   SyntaxRef getNamespaceName() const
+   {
+      return getRequiredChild(Cursor::NamespaceName);
+   }
+
+   SyntaxRef getSemicolonToken() const
+   {
+      return getRequiredChild(Cursor::SemicolonToken);
+   }
+};
+
+class NamespaceBlockStmtSyntaxRef final : public TypedSyntaxRef<NamespaceBlockStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getNamespaceToken() const
+   {
+      return getRequiredChild(Cursor::NamespaceToken);
+   }
+
+   std::optional<SyntaxRef> getNamespaceName() const
+   {
+      return getChild(Cursor::NamespaceName);
+   }
+
+   SyntaxRef getCodeBlock() const
+   {
+      return getRequiredChild(Cursor::CodeBlock);
+   }
+};
+
+class ConstDeclareSyntaxRef final : public TypedSyntaxRef<ConstDeclareSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getName() const
+   {
+      return getRequiredChild(Cursor::Name);
+   }
+
+   SyntaxRef getInitializer() const
+   {
+      return getRequiredChild(Cursor::InitializerClause);
+   }
+};
+
+class ConstListItemSyntaxRef final : public TypedSyntaxRef<ConstListItemSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   std::optional<SyntaxRef> getComma() const
+   {
+      return getChild(Cursor::CommaToken);
+   }
+
+   SyntaxRef getDeclaration() const
+   {
+      return getRequiredChild(Cursor::Declaration);
+   }
+};
+
+class ConstDefinitionStmtSyntaxRef final : public TypedSyntaxRef<ConstDefinitionStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getConstToken() const
+   {
+      return getRequiredChild(Cursor::ConstToken);
+   }
+
+   SyntaxRef getDeclarations() const
+   {
+      return getRequiredChild(Cursor::Declarations);
+   }
+
+   SyntaxRef getSemicolon() const
+   {
+      return getRequiredChild(Cursor::Semicolon);
+   }
+};
+
+class ClassDefinitionStmtSyntaxRef final : public TypedSyntaxRef<ClassDefinitionStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getClassDefinition() const
+   {
+      return getRequiredChild(Cursor::ClassDefinition);
+   }
+};
+
+class InterfaceDefinitionStmtSyntaxRef final : public TypedSyntaxRef<InterfaceDefinitionStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getInterfaceDefinition() const
+   {
+      return getRequiredChild(Cursor::InterfaceDefinition);
+   }
+};
+
+class TraitDefinitionStmtSyntaxRef final : public TypedSyntaxRef<TraitDefinitionStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getTraitDefinition() const
+   {
+      return getRequiredChild(Cursor::TraitDefinition);
+   }
+};
+
+class FunctionDefinitionStmtSyntaxRef final : public TypedSyntaxRef<FunctionDefinitionStmtSyntax>
+{
+public:
+   using TypedSyntaxRef::TypedSyntaxRef;
+
+   SyntaxRef getFunctionDefinition() const
+   {
+      return getRequiredChild(Cursor::FunctionDefinition);
+   }
+};
+
+} // polar::syntax
+
+#endif // POLARPHP_SYNTAX_SYNTAX_REF_NODES_H
@@ -30,8 +30,21 @@
 #include "polarphp/syntax/UnknownSyntax.h"
 #include "polarphp/syntax/syntaxnode/CommonSyntaxNodes.h"
 
+#include <vector>
+
 namespace polar::syntax {
 
+/// Walks a syntax tree in source order.
+///
+/// The walk does not recurse on the native stack, so trees of any depth can
+/// be visited. While a walk is in progress \c visit and \c visitChildren
+/// only schedule nodes: once the visit method that scheduled them returns,
+/// they are visited in the order they were scheduled, before anything that
+/// was scheduled earlier. An override of \c visit(Syntax) may call
+/// \c visit for several children in any order it likes, but the children
+/// have not been visited yet when these calls return. Code that has to run
+/// after the children of a node, like leaving a scope entered for the node,
+/// belongs into \c visitPost.
 class SyntaxVisitor
 {
 public:
@@ -41,28 +54,60 @@ public:
    virtual void visit(TokenSyntax token)
    {}
 
+   /// Called before the children of \p node are visited by the default
+   /// traversal.
    virtual void visitPre(Syntax node)
    {}
 
+   /// Called after all children of \p node have been visited by the default
+   /// traversal. This is the place for post-order logic.
    virtual void visitPost(Syntax node)
    {}
 
+   /// Visit \p node with the default traversal: \c visitPre, the children,
+   /// then \c visitPost.
+   ///
+   /// Inside a walk this call is not synchronous. It schedules \p node and
+   /// returns right away, and the node and its children are visited after
+   /// the calling visit method returns. Code after
+   /// \c SyntaxVisitor::visit(node) in an override therefore runs before the
+   /// children of \p node, not after them. Move it into \c visitPost.
    virtual void visit(Syntax node);
 
-   void visitChildren(Syntax node)
-   {
-      for (unsigned i = 0, e = node.getNumChildren(); i != e; ++i) {
-         if (auto Child = node.getChild(i)) {
-            visit(*Child);
-         }
-      }
-   }
+   /// Visit the children of \p node, without calling \c visitPre and
+   /// \c visitPost for \p node itself. Inside a walk this only schedules
+   /// the children, like \c visit(Syntax).
+   void visitChildren(Syntax node);
 
    /// syntax node visit methods
    virtual void visit(UnknownSyntax node);
    virtual void visit(UnknownDeclSyntax node);
    virtual void visit(UnknownExprSyntax node);
    virtual void visit(UnknownStmtSyntax node);
+
+private:
+   struct WorkItem
+   {
+      enum Action
+      {
+         /// Call the virtual visit(Syntax) of the node.
+         Dispatch,
+         /// The default traversal of the node.
+         Enter,
+         /// Call visitPost of the node after its children.
+         Leave
+      };
+
+      Action action;
+      Syntax node;
+   };
+
+   void scheduleChildren(const Syntax &node, std::vector<WorkItem> &items);
+   void walk(std::vector<WorkItem> items);
+
+   /// During a walk, the items scheduled while processing the current one,
+   /// in the order they were scheduled.
+   std::vector<WorkItem> *m_scheduled = nullptr;
 };
 
 } // polar::syntax
@@ -699,6 +699,16 @@ struct WrapperTypeTraits<syntax::TriviaKind>
       return polar::as_integer<TriviaKind>(kind);
    }
 
+   /// Map a value produced by \c numericValue back to its kind. Returns
+   /// \c std::nullopt if \p value does not name a known kind.
+   static std::optional<syntax::TriviaKind> fromNumericValue(uint8_t value)
+   {
+      if (value > polar::as_integer<TriviaKind>(TriviaKind::GarbageText)) {
+         return std::nullopt;
+      }
+      return static_cast<syntax::TriviaKind>(value);
+   }
+
    static void write(ByteTreeWriter &writer, const syntax::TriviaKind &kind,
                      unsigned index)
    {
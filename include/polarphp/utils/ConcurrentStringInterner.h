@@ -0,0 +1,146 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/15.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file declares the ConcurrentStringInterner class, a string table that
+//  any number of threads can intern strings into at the same time.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_UTILS_CONCURRENT_STRING_INTERNER_H
+#define POLARPHP_UTILS_CONCURRENT_STRING_INTERNER_H
+
+#include "polarphp/basic/adt/FlatHashSet.h"
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/utils/Allocator.h"
+#include "polarphp/utils/InternedString.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace polar::utils {
+
+using polar::basic::StringRef;
+
+/// Interns strings for any number of threads, the parsers of all files of a
+/// project for instance, so every distinct string is stored once and later
+/// comparisons of names are pointer comparisons.
+///
+/// The table is split into shards by hash, each behind a reader-writer lock,
+/// so looking up a string that is interned already only takes a shared lock
+/// of one shard and threads rarely wait for each other. The strings are
+/// copied into an arena of the interning thread, which needs no locking, and
+/// are only released with the interner.
+class ConcurrentStringInterner
+{
+public:
+   struct Statistics
+   {
+      /// The calls of intern().
+      uint64_t internCalls = 0;
+      /// The length of all strings passed to intern().
+      uint64_t internedBytes = 0;
+      /// The distinct strings in the table.
+      uint64_t uniqueStrings = 0;
+      /// The arena memory the distinct strings take, with their headers.
+      uint64_t storedBytes = 0;
+   };
+
+   ConcurrentStringInterner();
+   ~ConcurrentStringInterner();
+
+   ConcurrentStringInterner(const ConcurrentStringInterner &) = delete;
+   ConcurrentStringInterner &operator=(const ConcurrentStringInterner &) = delete;
+
+   InternedString intern(StringRef str);
+
+   /// Intern \p str, whose StringMapImpl::hash() is \p hash.
+   InternedString intern(StringRef str, uint32_t hash);
+
+   /// Return the handle of \p str, or an empty handle if it was not interned.
+   InternedString find(StringRef str) const;
+
+   /// The number of distinct strings.
+   size_t getSize() const;
+
+   Statistics getStatistics() const;
+
+private:
+   /// Looks up the strings of a shard by their text.
+   struct LookupKey
+   {
+      StringRef str;
+      uint32_t hash;
+   };
+
+   struct KeyInfo
+   {
+      static unsigned getHashValue(const InternedString &str)
+      {
+         return str.getHash();
+      }
+
+      static unsigned getHashValue(const LookupKey &key)
+      {
+         return key.hash;
+      }
+
+      static bool isEqual(const InternedString &lhs, const InternedString &rhs)
+      {
+         return lhs == rhs;
+      }
+
+      static bool isEqual(const LookupKey &lhs, const InternedString &rhs)
+      {
+         return lhs.hash == rhs.getHash() && lhs.str == rhs.getStr();
+      }
+   };
+
+   static constexpr unsigned sm_shardBits = 6;
+
+   /// Aligned to keep the locks of neighbouring shards off one cache line.
+   struct alignas(64) Shard
+   {
+      mutable std::shared_mutex lock;
+      polar::basic::FlatHashSet<InternedString, KeyInfo> strings;
+      std::atomic<uint64_t> internCalls{0};
+      std::atomic<uint64_t> internedBytes{0};
+      uint64_t storedBytes = 0;
+   };
+
+   Shard &getShard(uint32_t hash) const
+   {
+      return m_shards[hash >> (32 - sm_shardBits)];
+   }
+
+   /// The arena of the calling thread.
+   BumpPtrAllocator &getThreadArena();
+
+private:
+   std::unique_ptr<Shard[]> m_shards;
+   /// Tells the interners apart in the per-thread arena cache, addresses may
+   /// be reused.
+   const uint64_t m_id;
+   std::mutex m_arenaLock;
+   std::vector<std::unique_ptr<BumpPtrAllocator>> m_arenas;
+   std::unordered_map<std::thread::id, BumpPtrAllocator *> m_threadArenas;
+};
+
+} // polar::utils
+
+#endif // POLARPHP_UTILS_CONCURRENT_STRING_INTERNER_H
@@ -18,10 +18,62 @@
 
 #pragma once
 
+#include "polarphp/basic/adt/ArrayRef.h"
 #include "polarphp/basic/adt/StringRef.h"
 
+#include <cstddef>
+#include <cstdint>
+
 namespace polar::utils {
+using polar::basic::ArrayRef;
 using polar::basic::StringRef;
-/// zlib independent CRC32 calculation.
-uint32_t crc32(uint32_t crc, StringRef str);
+
+class ThreadPool;
+
+/// zlib independent CRC32 calculation. \p crc is the CRC of the preceding
+/// data, or 0 to start, so a buffer may be checksummed in pieces.
+uint32_t crc32(uint32_t crc, ArrayRef<uint8_t> data);
+
+inline uint32_t crc32(uint32_t crc, StringRef str)
+{
+   return crc32(crc, ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(str.getData()),
+                                       str.getSize()));
+}
+
+/// CRC32C (Castagnoli) calculation, chained the same way as crc32().
+uint32_t crc32c(uint32_t crc, ArrayRef<uint8_t> data);
+
+inline uint32_t crc32c(uint32_t crc, StringRef str)
+{
+   return crc32c(crc, ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(str.getData()),
+                                        str.getSize()));
+}
+
+/// The CRC32 of A followed by B, given crc1 = crc32(0, A), crc2 = crc32(0, B)
+/// and the length of B. Pieces of a large buffer can be checksummed on
+/// separate threads and combined afterwards.
+uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, uint64_t length2);
+
+/// The CRC32C counterpart of crc32_combine().
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t length2);
+
+/// crc32() of \p data, checksummed in pieces of \p chunkSize bytes on the
+/// threads of \p pool and joined with crc32_combine(). The calling thread
+/// takes the first piece and blocks until the others are done, so this must
+/// not be called from a task running on \p pool itself. Data of at most one
+/// piece is checksummed on the calling thread alone.
+uint32_t crc32_parallel(uint32_t crc, ArrayRef<uint8_t> data, ThreadPool &pool,
+                        size_t chunkSize = 1 << 20);
+
+/// The CRC32C counterpart of crc32_parallel().
+uint32_t crc32c_parallel(uint32_t crc, ArrayRef<uint8_t> data, ThreadPool &pool,
+                         size_t chunkSize = 1 << 20);
+
+namespace internal {
+/// The table-driven kernels that crc32() and crc32c() fall back to without
+/// PCLMUL or SSE4.2, callable directly so tests cover them on any host.
+uint32_t crc32_slicing_by_8(uint32_t crc, ArrayRef<uint8_t> data);
+uint32_t crc32c_slicing_by_8(uint32_t crc, ArrayRef<uint8_t> data);
+} // internal
+
 } // polar::utils
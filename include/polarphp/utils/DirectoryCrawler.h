@@ -0,0 +1,170 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/14.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file declares the DirectoryCrawler class, which finds the files below
+//  a set of directories on several threads and streams them to a CrawlQueue.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_UTILS_DIRECTORY_CRAWLER_H
+#define POLARPHP_UTILS_DIRECTORY_CRAWLER_H
+
+#include "polarphp/basic/adt/ArrayRef.h"
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/utils/Error.h"
+#include "polarphp/utils/FileSystem.h"
+#include "polarphp/utils/GlobPattern.h"
+#include "polarphp/utils/ThreadPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace polar::utils {
+
+class SpecialCaseList;
+
+using polar::basic::ArrayRef;
+using polar::basic::StringRef;
+using polar::fs::FileType;
+
+/// A file found by the crawler, or a directory that could not be read, in
+/// which case \c error is set.
+struct CrawlEntry
+{
+   std::string path;
+   FileType type;
+   std::error_code error;
+};
+
+/// The queue a crawl streams its results to. The crawler threads push the
+/// files of a directory at once, any number of consumers can pop them.
+class CrawlQueue
+{
+public:
+   /// Waits for the next entry. Returns false once the crawl is finished and
+   /// all entries have been taken.
+   bool pop(CrawlEntry &entry);
+
+   /// Waits for entries and appends all that are available to \p entries.
+   /// Returns false once the crawl is finished and all entries have been
+   /// taken.
+   bool popAll(std::vector<CrawlEntry> &entries);
+
+private:
+   friend class DirectoryCrawler;
+
+   void push(std::vector<CrawlEntry> &entries);
+   void open();
+   void close();
+
+private:
+   std::mutex m_lock;
+   std::condition_variable m_condition;
+   std::deque<CrawlEntry> m_entries;
+   bool m_closed = false;
+};
+
+/// Finds the files below a set of root directories on a pool of threads.
+///
+/// Every directory is read by one task, which on Linux reads the entries in
+/// large batches with getdents64 and takes their types from \c d_type, so
+/// entries are only stat'ed if the file system does not report a type or a
+/// symbolic link has to be followed. Subdirectories are read in parallel.
+///
+/// Paths are matched relative to their root with '/' as separator. A path
+/// that matches an exclude pattern, or a "src" entry in the given section of
+/// a special case list, is skipped, and an excluded directory is not
+/// entered. If there are include patterns a file is only reported if it
+/// matches one of them. The filters must not be changed while a crawl runs.
+class DirectoryCrawler
+{
+public:
+   /// Crawl on \p threadCount threads, zero uses one per hardware thread.
+   explicit DirectoryCrawler(unsigned threadCount = 0);
+
+   /// Waits for a running crawl to finish.
+   ~DirectoryCrawler();
+
+   Error addIncludePattern(StringRef pattern);
+   Error addExcludePattern(StringRef pattern);
+
+   /// Skip the paths listed as "src" in \p section of \p list, which has to
+   /// outlive the crawler.
+   void setSpecialCaseList(const SpecialCaseList *list, StringRef section);
+
+   /// Skip files and directories whose name starts with a dot.
+   void setSkipHiddenEntries(bool skip)
+   {
+      m_skipHidden = skip;
+   }
+
+   /// Enter symbolic links to directories and report links to files with
+   /// the type of their target. Every directory is read once, so cycles of
+   /// links end. By default links are reported as links and not entered.
+   void setFollowSymlinks(bool follow)
+   {
+      m_followSymlinks = follow;
+   }
+
+   /// Enter the subdirectories of the roots, which is the default. If not,
+   /// only the roots are read and their subdirectories are reported as
+   /// entries of their own.
+   void setRecursive(bool recursive)
+   {
+      m_recursive = recursive;
+   }
+
+   /// Start crawling \p roots and return. The entries are pushed to
+   /// \p queue, which is closed when the crawl is finished.
+   void start(ArrayRef<std::string> roots, CrawlQueue &queue);
+
+   /// Wait for the running crawl to finish.
+   void wait();
+
+   /// Crawl \p roots and return the entries sorted by path.
+   std::vector<CrawlEntry> crawl(ArrayRef<std::string> roots);
+
+private:
+   void crawlDirectory(std::string path, std::string relativePath, CrawlQueue &queue);
+   void schedule(std::string path, std::string relativePath, CrawlQueue &queue);
+   bool isExcluded(StringRef relativePath) const;
+   bool isIncluded(StringRef relativePath) const;
+   /// Returns false if the directory with \p status was read already.
+   bool markVisited(const polar::fs::FileStatus &status);
+
+private:
+   ThreadPool m_pool;
+   /// The pattern texts, the patterns refer to them.
+   std::deque<std::string> m_patternTexts;
+   std::vector<GlobPattern> m_includes;
+   std::vector<GlobPattern> m_excludes;
+   const SpecialCaseList *m_specialCaseList = nullptr;
+   std::string m_specialCaseSection;
+   bool m_skipHidden = false;
+   bool m_followSymlinks = false;
+   bool m_recursive = true;
+   /// The directories that are not read completely yet.
+   std::atomic<size_t> m_pendingDirs{0};
+   std::mutex m_visitedLock;
+   std::set<polar::fs::UniqueId> m_visitedDirs;
+};
+
+} // polar::utils
+
+#endif // POLARPHP_UTILS_DIRECTORY_CRAWLER_H
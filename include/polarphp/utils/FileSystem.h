@@ -1298,6 +1298,14 @@ public:
       priv ///< May modify via data, but changes are lost on destruction.
    };
 
+   /// How the mapped memory is going to be accessed, see \c advise.
+   enum AccessAdvice {
+      normal, ///< No particular access pattern.
+      sequential, ///< Read once front to back, read ahead aggressively.
+      willneed, ///< Accessed soon, start reading the pages in.
+      dontneed ///< Not accessed for a while, the pages may be dropped.
+   };
+
 private:
    /// Platform-specific mapping state.
    size_t m_size;
@@ -1332,6 +1340,12 @@ public:
 
    /// \returns The minimum alignment offset must be.
    static int getAlignment();
+
+   /// Tell the system how the mapping is going to be accessed. Dropping the
+   /// pages of a readonly or readwrite mapping keeps its address and content,
+   /// they are read back from the file on the next access. A priv mapping
+   /// would lose its modifications, so \c dontneed is refused for it.
+   std::error_code advise(AccessAdvice advice) const;
 };
 
 /// Return the path to the main executable, given the value of argv[0] from
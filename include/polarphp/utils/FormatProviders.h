@@ -322,11 +322,12 @@ struct FormatProvider<bool>
 ///   | F / f   | Fixed point          |   1.0  |  1.00   |
 ///   |   E     | Exponential with E   | 100000 | 1.0E+05 |
 ///   |   e     | Exponential with e   | 100000 | 1.0e+05 |
+///   | S / s   | Shortest round trip  |   0.1  |  0.1    |
 ///   | (empty) | Same as F / f        |        |         |
 ///   =====================================================
 ///
 /// The default precision is 6 for exponential (E / e) and 2 for everything
-/// else.
+/// else. The shortest style (S / s) ignores the precision.
 
 template <typename T>
 struct FormatProvider<
@@ -344,6 +345,8 @@ struct FormatProvider<
          fstyle = FloatStyle::ExponentUpper;
       } else if (style.consumeFront("e")) {
          fstyle = FloatStyle::Exponent;
+      } else if (style.consumeFront("S") || style.consumeFront("s")) {
+         fstyle = FloatStyle::Shortest;
       } else {
          fstyle = FloatStyle::Fixed;
       }
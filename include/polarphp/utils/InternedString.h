@@ -0,0 +1,145 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/15.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file declares InternedString, the handle of a string interned by a
+//  ConcurrentStringInterner. It is kept apart from the interner so that
+//  classes which only store handles, tokens for instance, do not pull in the
+//  interner's tables and locks.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_UTILS_INTERNED_STRING_H
+#define POLARPHP_UTILS_INTERNED_STRING_H
+
+#include "polarphp/basic/adt/DenseMapInfo.h"
+#include "polarphp/basic/adt/StringRef.h"
+
+#include <cassert>
+#include <cstdint>
+
+namespace polar::utils {
+
+using polar::basic::StringRef;
+
+class ConcurrentStringInterner;
+
+/// A string interned by a ConcurrentStringInterner. Two handles from the same
+/// interner are equal exactly if their strings are, so comparing them is a
+/// pointer comparison. The handle is valid as long as the interner lives.
+class InternedString
+{
+public:
+   InternedString() = default;
+
+   StringRef getStr() const
+   {
+      assert(m_header && "empty InternedString");
+      return StringRef(getData(), m_header->length);
+   }
+
+   /// The characters, followed by a null character.
+   const char *getData() const
+   {
+      assert(m_header && "empty InternedString");
+      return reinterpret_cast<const char *>(m_header + 1);
+   }
+
+   size_t getSize() const
+   {
+      assert(m_header && "empty InternedString");
+      return m_header->length;
+   }
+
+   /// The hash of the string, which is StringMapImpl::hash() of it.
+   uint32_t getHash() const
+   {
+      assert(m_header && "empty InternedString");
+      return m_header->hash;
+   }
+
+   explicit operator bool() const
+   {
+      return m_header != nullptr;
+   }
+
+   bool operator==(const InternedString &other) const
+   {
+      return m_header == other.m_header;
+   }
+
+   bool operator!=(const InternedString &other) const
+   {
+      return m_header != other.m_header;
+   }
+
+   const void *getAsOpaquePtr() const
+   {
+      return m_header;
+   }
+
+   static InternedString getFromOpaquePtr(const void *ptr)
+   {
+      return InternedString(static_cast<const Header *>(ptr));
+   }
+
+private:
+   friend class ConcurrentStringInterner;
+
+   /// Precedes the characters in the arena.
+   struct Header
+   {
+      uint32_t length;
+      uint32_t hash;
+   };
+
+   explicit InternedString(const Header *header)
+      : m_header(header)
+   {}
+
+private:
+   const Header *m_header = nullptr;
+};
+
+} // polar::utils
+
+namespace polar::basic {
+
+template <>
+struct DenseMapInfo<polar::utils::InternedString>
+{
+   using InternedString = polar::utils::InternedString;
+
+   static InternedString getEmptyKey()
+   {
+      return InternedString::getFromOpaquePtr(DenseMapInfo<const void *>::getEmptyKey());
+   }
+
+   static InternedString getTombstoneKey()
+   {
+      return InternedString::getFromOpaquePtr(DenseMapInfo<const void *>::getTombstoneKey());
+   }
+
+   static unsigned getHashValue(const InternedString &str)
+   {
+      return DenseMapInfo<const void *>::getHashValue(str.getAsOpaquePtr());
+   }
+
+   static bool isEqual(const InternedString &lhs, const InternedString &rhs)
+   {
+      return lhs == rhs;
+   }
+};
+
+} // polar::basic
+
+#endif // POLARPHP_UTILS_INTERNED_STRING_H
@@ -171,6 +171,15 @@ public:
    /// MemoryBuffer.
    virtual BufferKind getBufferKind() const = 0;
    MemoryBufferRef getMemBufferRef() const;
+
+   /// Tell the system how the buffer is going to be accessed. Only buffers
+   /// that map a file act on it, the data pointers stay valid in any case.
+   /// Returns true if the advice was applied.
+   virtual bool advise(fs::MappedFileRegion::AccessAdvice advice) const
+   {
+      (void)advice;
+      return false;
+   }
 };
 
 /// This class is an extension of MemoryBuffer, which allows copy-on-write
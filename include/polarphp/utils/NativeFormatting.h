@@ -30,7 +30,10 @@ enum class FloatStyle
    Exponent,
    ExponentUpper,
    Fixed,
-   Percent
+   Percent,
+   /// As few digits as read back as the same double, see
+   /// format_shortest_double(). The precision is ignored.
+   Shortest
 };
 
 enum class IntegerStyle
@@ -68,6 +71,35 @@ void write_hex(RawOutStream &outStream, uint64_t size, HexPrintStyle style,
 void write_double(RawOutStream &outStream, double D, FloatStyle style,
                   std::optional<size_t> precision = std::nullopt);
 
+/// A non-negative double as digits * 10^exponent.
+struct DecimalDouble
+{
+   uint64_t digits;
+   int exponent;
+};
+
+/// Returns the decimal with the fewest digits that reads back as the magnitude
+/// of \p value, the one closest to it if there are several. \p value must be
+/// finite. The digits have no trailing zeros, zero is returned as 0 * 10^0.
+///
+/// This is the Ryu algorithm of Ulf Adams, which is exact and needs nothing
+/// but 64x128-bit multiplications with a table of powers of five.
+DecimalDouble to_shortest_decimal(double value);
+
+/// The most characters format_shortest_double() writes, "-1.2345678901234567E-308".
+constexpr size_t sg_maxShortestDoubleLength = 24;
+
+/// Writes the shortest representation of \p value that reads back as the
+/// same double into \p buffer, which must have room for
+/// sg_maxShortestDoubleLength characters, and returns its length. No null
+/// character is appended.
+///
+/// The layout is the one PHP uses for precision -1: positional notation
+/// unless the number is below 1e-4 or has more than 17 integer digits,
+/// "1.0E+25" otherwise, "NAN", "INF" and "-INF" for the special values. The
+/// output does not depend on the locale.
+size_t format_shortest_double(double value, char *buffer);
+
 } // polar::utils
 
 #endif // POLARPHP_SUPPORT_NATIVE_FORMATTING_H
@@ -0,0 +1,66 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#ifndef POLARPHP_UTILS_RAW_XXH3_OUT_STREAM_H
+#define POLARPHP_UTILS_RAW_XXH3_OUT_STREAM_H
+
+#include "polarphp/utils/Xxh3.h"
+#include "polarphp/utils/RawOutStream.h"
+
+namespace polar::utils {
+
+/// A RawOutStream that hashes the content using XXH3, so an artifact can be
+/// hashed while it is serialized.
+class RawXxh3OutStream : public RawOutStream
+{
+   Xxh3 m_state;
+
+   /// See RawOutStream::writeImpl.
+   void writeImpl(const char *ptr, size_t size) override
+   {
+      m_state.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(ptr), size));
+   }
+
+public:
+   explicit RawXxh3OutStream(uint64_t seed = 0)
+      : m_state(seed)
+   {}
+
+   /// Return the current 64-bit hash for the content of the stream.
+   uint64_t getHash64()
+   {
+      flush();
+      return m_state.getHash64();
+   }
+
+   /// Return the current 128-bit hash for the content of the stream.
+   Hash128 getHash128()
+   {
+      flush();
+      return m_state.getHash128();
+   }
+
+   /// Reset the internal state to start over from scratch.
+   void resetHash(uint64_t seed = 0)
+   {
+      flush();
+      m_state.init(seed);
+   }
+
+   uint64_t getCurrentPos() const override
+   {
+      return m_state.getTotalLength();
+   }
+};
+
+} // polar::utils
+
+#endif // POLARPHP_UTILS_RAW_XXH3_OUT_STREAM_H
@@ -27,6 +27,7 @@
 #include "polarphp/utils/MemoryBuffer.h"
 #include "polarphp/utils/SourceLocation.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <string>
@@ -69,29 +70,57 @@ private:
       /// The memory buffer for the file.
       std::unique_ptr<MemoryBuffer> m_buffer;
 
+      /// The line endings of Buffer: the offsets of all '\n' bytes, at which
+      /// a new line starts, and of all '\r' bytes, at which a new column
+      /// starts without a new line. Both are sorted, so they can be
+      /// binary-searched for the line and the start of the column of an
+      /// offset. Once populated, the '\n' that marks the end of line number
+      /// N from [1..] is at Buffer[newlines[N-1]].
+      template <typename T>
+      struct LineTable
+      {
+         std::vector<T> newlines;
+         std::vector<T> carriageReturns;
+      };
+
       /// Helper type for OffsetCache below: since we're storing many offsets
       /// into relatively small files (often smaller than 2^8 or 2^16 bytes),
-      /// we select the offset vector element type dynamically based on the
-      /// size of Buffer.
-      using VariableSizeOffsets = PointerUnion4<std::vector<uint8_t> *,
-      std::vector<uint16_t> *,
-      std::vector<uint32_t> *,
-      std::vector<uint64_t> *>;
-
-      /// Vector of offsets into Buffer at which there are line-endings
-      /// (lazily populated). Once populated, the '\n' that marks the end of
-      /// line number N from [1..] is at Buffer[OffsetCache[N-1]]. Since
-      /// these offsets are in sorted (ascending) order, they can be
-      /// binary-searched for the first one after any given offset (eg. an
-      /// offset corresponding to a particular SMLoc).
+      /// we select the offset element type dynamically based on the size of
+      /// Buffer.
+      using VariableSizeOffsets = PointerUnion4<LineTable<uint8_t> *,
+      LineTable<uint16_t> *,
+      LineTable<uint32_t> *,
+      LineTable<uint64_t> *>;
+
+      /// The line table of Buffer (lazily populated).
       mutable VariableSizeOffsets m_offsetCache;
 
-      /// Populate \c OffsetCache and look up a given \p Ptr in it, assuming
-      /// it points somewhere into \c Buffer. The static type parameter \p T
-      /// must be an unsigned integer type from uint{8,16,32,64}_t large
-      /// enough to store offsets inside \c Buffer.
+      /// The number of UTF-8 code points in front of every block of the
+      /// buffer (lazily populated by the first UTF-8 column query). Counting
+      /// the code points in front of an offset only needs to look at the
+      /// bytes of one block, no matter how long its line is.
+      mutable std::unique_ptr<std::vector<uint32_t>> m_utf8Index;
+
+      /// Populate \c OffsetCache if needed and return it. The static type
+      /// parameter \p T must be an unsigned integer type from
+      /// uint{8,16,32,64}_t large enough to store offsets inside \c Buffer.
+      template<typename T>
+      const LineTable<T> &getLineTable() const;
+
+      /// Look up the line number of \p ptr and the offset at which its
+      /// column 1 starts.
+      template<typename T>
+      std::pair<unsigned, size_t> getLineAndColumnStart(const char *ptr) const;
+
+      /// Same as \c getLineAndColumnStart for sorted \p ptrs in a single
+      /// merged pass over the line table.
       template<typename T>
-      unsigned getLineNumber(const char *ptr) const;
+      void getLinesAndColumnStarts(ArrayRef<const char *> ptrs,
+                                   SmallVectorImpl<std::pair<unsigned, size_t>> &result) const;
+
+      /// Returns the number of UTF-8 code points in front of \p offset.
+      size_t countUtf8CodePoints(size_t offset) const;
+
       /// This is the location of the parent include, or null if at the top level.
       SMLocation m_includeLoc;
       SrcBuffer() = default;
@@ -101,9 +130,34 @@ private:
       ~SrcBuffer();
    };
 
+   /// The address range of a buffer in the lookup index.
+   struct BufferRange
+   {
+      const char *start;
+      const char *end;
+      /// The largest end of this range and all ranges before it in the
+      /// index. A lookup walking backwards from the last range starting at or
+      /// before a location can stop as soon as this is below the location.
+      const char *maxEnd;
+      unsigned bufferID;
+   };
+
    /// This is all of the buffers that we are reading from.
    std::vector<SrcBuffer> m_buffers;
 
+   /// The address ranges of all buffers sorted by their start, maintained by
+   /// addNewSourceBuffer.
+   std::vector<BufferRange> m_bufferIndex;
+
+   /// Whether the address ranges of any two buffers overlap or touch, e.g.
+   /// because one buffer aliases the memory of another one. Otherwise a
+   /// location is in at most one buffer.
+   bool m_hasOverlappingBuffers = false;
+
+   /// The buffer found by the last lookup. Locations are usually looked up in
+   /// runs from the same buffer. Lookups may be done from several threads.
+   mutable std::atomic<unsigned> m_lastLookupBufferID{0};
+
    // This is the list of directories we should search for include files in.
    std::vector<std::string> m_includeDirectories;
 
@@ -115,12 +169,16 @@ private:
       return i && i <= m_buffers.size();
    }
 
+   /// Find the buffer containing \p location with a binary search in the
+   /// buffer index, preferring the buffer added last if \p preferLast is set.
+   unsigned lookUpBuffer(SMLocation location, bool preferLast) const;
+
 public:
    SourceMgr() = default;
    SourceMgr(const SourceMgr &) = delete;
    SourceMgr &operator=(const SourceMgr &) = delete;
-   SourceMgr(SourceMgr &&) = default;
-   SourceMgr &operator=(SourceMgr &&) = default;
+   SourceMgr(SourceMgr &&other);
+   SourceMgr &operator=(SourceMgr &&other);
    ~SourceMgr() = default;
 
    void setIncludeDirs(const std::vector<std::string> &dirs)
@@ -178,14 +236,7 @@ public:
    /// Add a new source buffer to this source manager. This takes ownership of
    /// the memory buffer.
    unsigned addNewSourceBuffer(std::unique_ptr<MemoryBuffer> buffer,
-                               SMLocation includeLoc)
-   {
-      SrcBuffer sbuffer;
-      sbuffer.m_buffer = std::move(buffer);
-      sbuffer.m_includeLoc = includeLoc;
-      m_buffers.push_back(std::move(sbuffer));
-      return m_buffers.size();
-   }
+                               SMLocation includeLoc);
 
    /// Search for a file with the specified name in the current directory or in
    /// one of the IncludeDirs.
@@ -198,8 +249,19 @@ public:
 
    /// Return the ID of the buffer containing the specified location.
    ///
-   /// 0 is returned if the buffer is not found.
-   unsigned findBufferContainingLoc(SMLocation location) const;
+   /// 0 is returned if the buffer is not found. If several buffers contain
+   /// the location, the one added first is returned.
+   unsigned findBufferContainingLoc(SMLocation location) const
+   {
+      return lookUpBuffer(location, false);
+   }
+
+   /// Like \c findBufferContainingLoc, but returns the buffer added last if
+   /// several buffers contain the location.
+   unsigned findLastBufferContainingLoc(SMLocation location) const
+   {
+      return lookUpBuffer(location, true);
+   }
 
    /// Find the line number for the specified location in the specified file.
    /// This is not a fast method.
@@ -209,10 +271,23 @@ public:
    }
 
    /// Find the line and column number for the specified location in the
-   /// specified file. This is not a fast method.
+   /// specified file. The column counts bytes. Both are looked up in the
+   /// line table of the file, which is built on the first query.
    std::pair<unsigned, unsigned> getLineAndColumn(SMLocation location,
                                                   unsigned bufferID = 0) const;
 
+   /// Like \c getLineAndColumn, but the column counts UTF-8 code points.
+   std::pair<unsigned, unsigned> getLineAndUtf8Column(SMLocation location,
+                                                      unsigned bufferID = 0) const;
+
+   /// Find the line and column numbers of many locations at once. The
+   /// \p locations have to be sorted and all be in the buffer \p bufferID;
+   /// they are converted in a single pass over the line table. The columns
+   /// count UTF-8 code points if \p utf8Columns is set and bytes otherwise.
+   void getLinesAndColumns(ArrayRef<SMLocation> locations, unsigned bufferID,
+                           SmallVectorImpl<std::pair<unsigned, unsigned>> &result,
+                           bool utf8Columns = false) const;
+
    /// Emit a message about the specified location with the specified string.
    ///
    /// \param ShowColors Display colored messages if output is a terminal and
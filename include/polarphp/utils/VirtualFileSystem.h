@@ -42,10 +42,13 @@
 #include "polarphp/utils/Path.h"
 #include "polarphp/utils/SourceMgr.h"
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <string>
 #include <system_error>
@@ -559,6 +562,96 @@ private:
    IntrusiveRefCountPtr<FileSystem> m_fs;
 };
 
+/// A file system that remembers the results of \c getStatus and \c dirBegin
+/// of the file system it wraps, including the failures. This is meant for
+/// include and autoload resolution, which probe many paths that do not
+/// exist, again and again.
+///
+/// Failed opens that report a missing file are remembered like a failed
+/// status, and any path known not to exist fails to open without asking the
+/// wrapped file system. Successful opens are not cached, the file content is
+/// always read from the wrapped file system.
+///
+/// Relative paths are cached under the working directory that was set
+/// through this file system. Entries stay valid until they are invalidated
+/// explicitly or, if a time to live is set, until they expire. The caches
+/// are split into shards with their own locks, so the file system can be
+/// used from many threads at once.
+class CachingFileSystem : public ProxyFileSystem
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   /// The hit and miss counts of the caches. A hit was answered from the
+   /// cache, a miss went to the wrapped file system.
+   struct Statistics
+   {
+      uint64_t statusHits = 0;
+      uint64_t statusMisses = 0;
+      /// The status hits that found a path that does not exist.
+      uint64_t negativeStatusHits = 0;
+      /// The opens that failed because the path is known not to exist.
+      uint64_t openHits = 0;
+      uint64_t openMisses = 0;
+      uint64_t directoryHits = 0;
+      uint64_t directoryMisses = 0;
+   };
+
+   explicit CachingFileSystem(IntrusiveRefCountPtr<FileSystem> fs,
+                              Clock::duration timeToLive = Clock::duration::zero());
+   ~CachingFileSystem() override;
+
+   OptionalError<Status> getStatus(const Twine &path) override;
+   OptionalError<std::unique_ptr<File>> openFileForRead(const Twine &path) override;
+   DirectoryIterator dirBegin(const Twine &dir, std::error_code &errorCode) override;
+   OptionalError<std::string> getCurrentWorkingDirectory() const override;
+   std::error_code setCurrentWorkingDirectory(const Twine &path) override;
+
+   /// Cached entries older than \p timeToLive are looked up again. Zero, the
+   /// default, keeps them until they are invalidated.
+   void setTimeToLive(Clock::duration timeToLive)
+   {
+      m_timeToLive = timeToLive.count();
+   }
+
+   Clock::duration getTimeToLive() const
+   {
+      return Clock::duration(m_timeToLive.load(std::memory_order_relaxed));
+   }
+
+   /// Forget what is known about \p path and the listing of its parent
+   /// directory, for example after the file was created or removed.
+   void invalidate(const Twine &path);
+
+   /// Forget everything that is cached.
+   void invalidateAll();
+
+   Statistics getStatistics() const;
+
+private:
+   struct Shard;
+
+   /// Makes \p path absolute against the cached working directory.
+   void makeCacheKey(const Twine &path, SmallVectorImpl<char> &key) const;
+   Shard &getShard(StringRef key) const;
+   bool isExpired(Clock::time_point cachedAt) const;
+
+private:
+   static constexpr unsigned sm_numShards = 16;
+   std::unique_ptr<Shard[]> m_shards;
+   std::atomic<Clock::rep> m_timeToLive;
+   mutable std::mutex m_workingDirLock;
+   std::string m_workingDir;
+
+   std::atomic<uint64_t> m_statusHits{0};
+   std::atomic<uint64_t> m_statusMisses{0};
+   std::atomic<uint64_t> m_negativeStatusHits{0};
+   std::atomic<uint64_t> m_openHits{0};
+   std::atomic<uint64_t> m_openMisses{0};
+   std::atomic<uint64_t> m_directoryHits{0};
+   std::atomic<uint64_t> m_directoryMisses{0};
+};
+
 namespace internal {
 
 class InMemoryDirectory;
@@ -0,0 +1,148 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+/*
+   xxHash - Extremely Fast Hash algorithm
+   Copyright (C) 2012-2020 Yann Collet
+   BSD 2-Clause License (https://www.opensource.org/licenses/bsd-license.php)
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   You can contact the author at :
+   - xxHash source repository : https://github.com/Cyan4973/xxHash
+*/
+
+//===----------------------------------------------------------------------===//
+//
+//  This file declares the XXH3 64-bit and 128-bit hashes, a non-cryptographic
+//  hash for cache keys and change detection. The one-shot functions and the
+//  streaming Xxh3 class produce the same values as XXH3_64bits_withSeed and
+//  XXH3_128bits_withSeed of xxHash 0.8.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLARPHP_UTILS_XXH3_H
+#define POLARPHP_UTILS_XXH3_H
+
+#include "polarphp/basic/adt/ArrayRef.h"
+#include "polarphp/basic/adt/SmallString.h"
+#include "polarphp/basic/adt/StringRef.h"
+
+#include <cstdint>
+
+namespace polar::utils {
+
+using polar::basic::ArrayRef;
+using polar::basic::SmallString;
+using polar::basic::StringRef;
+
+/// A 128-bit XXH3 hash value.
+struct Hash128
+{
+   uint64_t low64;
+   uint64_t high64;
+
+   /// The hash as 32 hexadecimal digits, high half first, the way xxhsum
+   /// prints it.
+   SmallString<32> getDigest() const;
+};
+
+inline bool operator==(const Hash128 &lhs, const Hash128 &rhs)
+{
+   return lhs.low64 == rhs.low64 && lhs.high64 == rhs.high64;
+}
+
+inline bool operator!=(const Hash128 &lhs, const Hash128 &rhs)
+{
+   return !(lhs == rhs);
+}
+
+uint64_t xxh3_hash64(ArrayRef<uint8_t> data, uint64_t seed = 0);
+uint64_t xxh3_hash64(StringRef data, uint64_t seed = 0);
+Hash128 xxh3_hash128(ArrayRef<uint8_t> data, uint64_t seed = 0);
+Hash128 xxh3_hash128(StringRef data, uint64_t seed = 0);
+
+/// Incrementally computes the XXH3 hash of data fed in any number of
+/// pieces. Both the 64-bit and the 128-bit hash can be read at any point
+/// without disturbing the state, so hashing may continue afterwards.
+class Xxh3
+{
+public:
+   explicit Xxh3(uint64_t seed = 0)
+   {
+      init(seed);
+   }
+
+   /// Start over with \p seed.
+   void init(uint64_t seed = 0);
+
+   /// Digest more data.
+   void update(ArrayRef<uint8_t> data);
+
+   /// Digest more data.
+   void update(StringRef str)
+   {
+      update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(str.getData()),
+                               str.getSize()));
+   }
+
+   /// The 64-bit hash of all the data seen since the last init().
+   uint64_t getHash64() const;
+
+   /// The 128-bit hash of all the data seen since the last init().
+   Hash128 getHash128() const;
+
+   /// The number of bytes seen since the last init().
+   uint64_t getTotalLength() const
+   {
+      return m_totalLength;
+   }
+
+private:
+   enum { SECRET_SIZE = 192 };
+   enum { BUFFER_SIZE = 256 };
+
+   const uint8_t *getSecret() const;
+   void digestLong(uint64_t *acc) const;
+
+   alignas(64) uint64_t m_acc[8];
+   /// The secret derived from the seed, unused when the seed is 0.
+   alignas(64) uint8_t m_customSecret[SECRET_SIZE];
+   /// Input not yet accumulated. Once more than BUFFER_SIZE bytes have been
+   /// seen the buffer always keeps at least the last stripe, which the
+   /// final round needs.
+   alignas(64) uint8_t m_buffer[BUFFER_SIZE];
+   uint64_t m_seed;
+   uint64_t m_totalLength;
+   size_t m_bufferedSize;
+   size_t m_stripesSoFar;
+};
+
+} // polar::utils
+
+#endif // POLARPHP_UTILS_XXH3_H
@@ -0,0 +1,112 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/13.
+
+#include "polarphp/ast/BufferedDiagnostics.h"
+#include "polarphp/ast/DiagnosticEngine.h"
+
+namespace polar::ast {
+
+void BufferingDiagnosticConsumer::handleDiagnostic(
+      SourceManager &, SourceLoc loc, DiagnosticKind kind, StringRef,
+      ArrayRef<DiagnosticArgument> formatArgs, const DiagnosticInfo &info)
+{
+   m_hadAnyError |= kind == DiagnosticKind::Error;
+   m_diagnostics.add(kind, loc, info.id, formatArgs, info.ranges, info.fixIts);
+}
+
+void BufferingDiagnosticConsumer::flushTo(ArrayRef<DiagnosticConsumer *> consumers,
+                                          SourceManager &sourceMgr)
+{
+   for (DiagnosticConsumer *consumer : consumers) {
+      m_diagnostics.replay(*consumer, sourceMgr);
+   }
+   m_diagnostics.clear();
+}
+
+OrderedDiagnosticMerger::OrderedDiagnosticMerger(DiagnosticEngine &target,
+                                                 SourceManager &sourceMgr,
+                                                 size_t numFiles)
+   : m_target(target),
+     m_sourceMgr(sourceMgr)
+{
+   m_files.reserve(numFiles);
+   for (size_t index = 0; index < numFiles; ++index) {
+      m_files.push_back(std::make_unique<FileState>(m_sourceMgr));
+   }
+}
+
+OrderedDiagnosticMerger::~OrderedDiagnosticMerger()
+{
+   assert(isComplete() && "files left unfinished, their diagnostics are lost");
+}
+
+std::shared_ptr<DiagnosticEngine> OrderedDiagnosticMerger::makeFileEngine(size_t fileIndex)
+{
+   assert(fileIndex < m_files.size() && "file index out of range");
+   auto engine = std::make_shared<DiagnosticEngine>(m_sourceMgr);
+   {
+      // The settings of the target may be changed between files.
+      std::lock_guard<std::mutex> guard(m_lock);
+      engine->inheritSettingsFrom(m_target);
+   }
+   engine->addConsumer(m_files[fileIndex]->buffer);
+   return engine;
+}
+
+void OrderedDiagnosticMerger::finishFile(size_t fileIndex)
+{
+   assert(fileIndex < m_files.size() && "file index out of range");
+   {
+      std::lock_guard<std::mutex> guard(m_lock);
+      assert(!m_files[fileIndex]->finished && "file finished twice");
+      m_files[fileIndex]->finished = true;
+      if (!m_files[m_nextFile]->finished) {
+         // The file waited for is still running, whoever finishes it emits
+         // this file too.
+         return;
+      }
+   }
+   // Take the files whose turn has come and emit them with only the flush
+   // lock held, so that other files can finish in the meantime. A file that
+   // becomes ready meanwhile is taken by the next holder of the flush lock.
+   std::lock_guard<std::mutex> flushGuard(m_flushLock);
+   std::vector<FileState *> ready;
+   {
+      std::lock_guard<std::mutex> guard(m_lock);
+      while (m_nextFile < m_files.size() && m_files[m_nextFile]->finished) {
+         ready.push_back(m_files[m_nextFile].get());
+         m_hadAnyError |= ready.back()->buffer.hadAnyError();
+         ++m_nextFile;
+      }
+   }
+   for (FileState *file : ready) {
+      // Finished files are not touched by their workers any more.
+      if (file->buffer.hadAnyError()) {
+         m_target.setHadAnyError();
+      }
+      file->buffer.flushTo(m_target.getConsumers(), m_sourceMgr);
+   }
+}
+
+bool OrderedDiagnosticMerger::isComplete() const
+{
+   std::lock_guard<std::mutex> flushGuard(m_flushLock);
+   std::lock_guard<std::mutex> guard(m_lock);
+   return m_nextFile == m_files.size();
+}
+
+bool OrderedDiagnosticMerger::hadAnyError() const
+{
+   std::lock_guard<std::mutex> guard(m_lock);
+   return m_hadAnyError;
+}
+
+} // polar::ast
@@ -37,6 +37,7 @@
 
 namespace polar::ast {
 
+using polar::parser::Lexer;
 using polar::parser::SourceManager;
 using polar::utils::RawSvectorOutStream;
 
@@ -122,7 +123,8 @@ DiagnosticState::DiagnosticState()
 
 static CharSourceRange to_char_source_range(SourceManager &sourceMgr, SourceRange sourceRange)
 {
-   //   return CharSourceRange(sourceMgr, SR.Start, Lexer::getLocForEndOfToken(sourceMgr, SR.End));
+   return CharSourceRange(sourceMgr, sourceRange.m_start,
+                          Lexer::getLocForEndOfToken(sourceMgr, sourceRange.m_end));
 }
 
 static CharSourceRange to_char_source_range(SourceManager &sourceMgr, SourceLoc start,
@@ -179,8 +181,12 @@ InFlightDiagnostic &InFlightDiagnostic::highlightChars(SourceLoc start,
 InFlightDiagnostic &InFlightDiagnostic::fixItInsertAfter(SourceLoc loc,
                                                          StringRef str)
 {
-   //  loc = Lexer::getLocForEndOfToken(m_engine->m_sourceMgr, loc);
-   //  return fixItInsert(loc, str);
+   assert(m_isActive && "Cannot modify an inactive diagnostic");
+   if (!m_engine) {
+      return *this;
+   }
+   loc = Lexer::getLocForEndOfToken(m_engine->m_sourceMgr, loc);
+   return fixItInsert(loc, str);
 }
 
 /// Add a token-based removal fix-it to the currently-active
@@ -352,7 +358,7 @@ skip_to_delimiter(StringRef &text, char delim, bool *foundDelim = nullptr)
 static void formatSelectionArgument(StringRef modifierArguments,
                                     ArrayRef<DiagnosticArgument> args,
                                     unsigned selectedIndex,
-                                    DiagnosticFormatOptions formatOpts,
+                                    const DiagnosticFormatOptions &formatOpts,
                                     RawOutStream &out)
 {
    bool foundPipe = false;
@@ -375,7 +381,7 @@ static void format_diagnostic_argument(StringRef modifier,
                                        StringRef modifierArguments,
                                        ArrayRef<DiagnosticArgument> args,
                                        unsigned argIndex,
-                                       DiagnosticFormatOptions formatOpts,
+                                       const DiagnosticFormatOptions &formatOpts,
                                        RawOutStream &out)
 {
 //   const DiagnosticArgument &arg = args[argIndex];
@@ -504,7 +510,7 @@ static void format_diagnostic_argument(StringRef modifier,
 /// buffer.
 void DiagnosticEngine::formatDiagnosticText(
       RawOutStream &out, StringRef inText, ArrayRef<DiagnosticArgument> args,
-      DiagnosticFormatOptions formatOpts)
+      const DiagnosticFormatOptions &formatOpts)
 {
    while (!inText.empty())
    {
@@ -668,25 +674,47 @@ void DiagnosticEngine::flushActiveDiagnostic()
    if (m_transactionCount == 0) {
       emitDiagnostic(*m_activeDiagnostic);
    } else {
-      m_tentativeDiagnostics.emplace_back(std::move(*m_activeDiagnostic));
+      // The behavior is only determined once the transaction commits.
+      m_tentativeDiagnostics.add(getDeclaredDiagnosticKind(m_activeDiagnostic->getID()),
+                                 *m_activeDiagnostic);
    }
    m_activeDiagnostic.reset();
 }
 
 void DiagnosticEngine::emitTentativeDiagnostics()
 {
-   for (auto &diag : m_tentativeDiagnostics) {
-      emitDiagnostic(diag);
+   SmallVector<DiagnosticArgument, 4> args;
+   for (size_t index = 0, count = m_tentativeDiagnostics.size(); index < count; ++index) {
+      const StoredDiagnosticList::Entry &entry = m_tentativeDiagnostics[index];
+      args.clear();
+      m_tentativeDiagnostics.getArgs(index, args);
+      DiagnosticInfo info;
+      info.id = entry.id;
+      info.ranges = m_tentativeDiagnostics.getRanges(index);
+      info.fixIts = m_tentativeDiagnostics.getFixIts(index);
+      emitDiagnostic(entry.loc, entry.id, args, info);
    }
    m_tentativeDiagnostics.clear();
 }
 
+void DiagnosticEngine::emitDiagnostic(SourceLoc loc, DiagID id,
+                                      ArrayRef<DiagnosticArgument> args,
+                                      const DiagnosticInfo &info)
+{
+   auto behavior = m_state.determineBehavior(id);
+   if (behavior == DiagnosticState::Behavior::Ignore) {
+      return;
+   }
+   // Consumers get the unformatted message and the arguments, only the ones
+   // that need the message text format it.
+   for (auto &consumer : m_consumers) {
+      consumer->handleDiagnostic(m_sourceMgr, loc, toDiagnosticKind(behavior),
+                                 diagnosticStringFor(id), args, info);
+   }
+}
+
 void DiagnosticEngine::emitDiagnostic(const Diagnostic &diagnostic)
 {
-//   auto behavior = m_state.determineBehavior(diagnostic.getID());
-//   if (behavior == DiagnosticState::Behavior::Ignore) {
-//      return;
-//   }
 //   // Figure out the source location.
 //   SourceLoc loc = diagnostic.getLoc();
 //   if (loc.isInvalid() && diagnostic.getDecl()) {
@@ -804,17 +832,12 @@ void DiagnosticEngine::emitDiagnostic(const Diagnostic &diagnostic)
 //      }
 //   }
 
-//   // Pass the diagnostic off to the consumer.
-//   DiagnosticInfo Info;
-//   Info.id = diagnostic.getID();
-//   Info.ranges = diagnostic.getRanges();
-//   Info.fixIts = diagnostic.getFixIts();
-//   for (auto &consumer : m_consumers)
-//   {
-//      consumer->handleDiagnostic(m_sourceMgr, loc, toDiagnosticKind(behavior),
-//                                 diagnosticStringFor(Info.id),
-//                                 diagnostic.getArgs(), Info);
-//   }
+   // Pass the diagnostic off to the consumer.
+   DiagnosticInfo info;
+   info.id = diagnostic.getID();
+   info.ranges = diagnostic.getRanges();
+   info.fixIts = diagnostic.getFixIts();
+   emitDiagnostic(diagnostic.getLoc(), diagnostic.getID(), diagnostic.getArgs(), info);
 }
 
 const char *DiagnosticEngine::diagnosticStringFor(const DiagID id)
@@ -822,6 +845,11 @@ const char *DiagnosticEngine::diagnosticStringFor(const DiagID id)
    return diagnosticStrings[(unsigned)id];
 }
 
+DiagnosticKind DiagnosticEngine::getDeclaredDiagnosticKind(const DiagID id)
+{
+   return storedDiagnosticInfos[(unsigned)id].kind;
+}
+
 DiagnosticSuppression::DiagnosticSuppression(DiagnosticEngine &diags)
    : m_diags(diags)
 {
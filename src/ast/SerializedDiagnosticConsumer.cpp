@@ -0,0 +1,161 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/12.
+
+#include "polarphp/ast/SerializedDiagnosticConsumer.h"
+#include "polarphp/ast/DiagnosticEngine.h"
+#include "polarphp/ast/StoredDiagnostic.h"
+#include "polarphp/parser/SourceMgr.h"
+#include "polarphp/utils/Leb128.h"
+#include "polarphp/utils/RawOutStream.h"
+
+namespace polar::ast {
+
+using polar::utils::RawFdOutStream;
+
+SerializedDiagnosticConsumer::SerializedDiagnosticConsumer(RawOutStream &outStream)
+   : m_outStream(outStream)
+{
+   writeHeader();
+}
+
+SerializedDiagnosticConsumer::SerializedDiagnosticConsumer(
+      std::unique_ptr<RawFdOutStream> file)
+   : m_file(std::move(file)),
+     m_outStream(*m_file)
+{
+   writeHeader();
+}
+
+SerializedDiagnosticConsumer::~SerializedDiagnosticConsumer()
+{}
+
+std::unique_ptr<SerializedDiagnosticConsumer>
+SerializedDiagnosticConsumer::create(StringRef outputPath, std::error_code &errorCode)
+{
+   auto file = std::make_unique<RawFdOutStream>(outputPath, errorCode);
+   if (errorCode) {
+      return nullptr;
+   }
+   return std::unique_ptr<SerializedDiagnosticConsumer>(
+            new SerializedDiagnosticConsumer(std::move(file)));
+}
+
+void SerializedDiagnosticConsumer::writeHeader()
+{
+   m_outStream << "PDIA";
+   m_outStream << static_cast<char>(sm_formatVersion);
+}
+
+void SerializedDiagnosticConsumer::writeULEB128(uint64_t value)
+{
+   polar::utils::encode_uleb128(value, m_outStream);
+}
+
+void SerializedDiagnosticConsumer::writeString(StringRef text)
+{
+   writeULEB128(text.size());
+   m_outStream << text;
+}
+
+unsigned SerializedDiagnosticConsumer::getFileID(SourceManager &sourceMgr, SourceLoc loc)
+{
+   if (loc.isInvalid()) {
+      return 0;
+   }
+   unsigned bufferID = sourceMgr.findBufferContainingLoc(loc);
+   auto iter = m_fileIDs.find(bufferID);
+   if (iter != m_fileIDs.end()) {
+      return iter->second;
+   }
+   unsigned fileID = m_fileIDs.size() + 1;
+   m_fileIDs.insert({bufferID, fileID});
+   m_outStream << static_cast<char>(BufferRecord);
+   writeULEB128(fileID);
+   writeString(sourceMgr.getIdentifierForBuffer(bufferID));
+   return fileID;
+}
+
+void SerializedDiagnosticConsumer::writeLocation(SourceManager &sourceMgr, SourceLoc loc)
+{
+   unsigned fileID = getFileID(sourceMgr, loc);
+   writeULEB128(fileID);
+   if (fileID == 0) {
+      return;
+   }
+   unsigned bufferID = sourceMgr.findBufferContainingLoc(loc);
+   unsigned line;
+   unsigned column;
+   std::tie(line, column) = sourceMgr.getLineAndColumn(loc, bufferID);
+   writeULEB128(line);
+   writeULEB128(column);
+   writeULEB128(sourceMgr.getLocOffsetInBuffer(loc, bufferID));
+}
+
+void SerializedDiagnosticConsumer::handleDiagnostic(
+      SourceManager &sourceMgr, SourceLoc loc, DiagnosticKind kind,
+      StringRef formatString, ArrayRef<DiagnosticArgument> formatArgs,
+      const DiagnosticInfo &info)
+{
+   // Buffer and message records have to come before the diagnostic that
+   // refers to them, so they are written up front; the diagnostic record
+   // itself is then streamed out without any interruption.
+   unsigned id = static_cast<unsigned>(info.id);
+   if (id >= m_writtenMessages.size()) {
+      m_writtenMessages.resize(id + 1);
+   }
+   if (!m_writtenMessages[id]) {
+      m_writtenMessages[id] = true;
+      m_outStream << static_cast<char>(MessageRecord);
+      writeULEB128(id);
+      writeString(formatString);
+   }
+   getFileID(sourceMgr, loc);
+   for (CharSourceRange range : info.ranges) {
+      getFileID(sourceMgr, range.getStart());
+      getFileID(sourceMgr, range.getEnd());
+   }
+   for (const DiagnosticInfo::FixIt &fixIt : info.fixIts) {
+      getFileID(sourceMgr, fixIt.getRange().getStart());
+      getFileID(sourceMgr, fixIt.getRange().getEnd());
+   }
+
+   m_outStream << static_cast<char>(DiagnosticRecord);
+   writeULEB128(id);
+   m_outStream << static_cast<char>(kind);
+   writeLocation(sourceMgr, loc);
+   writeULEB128(info.ranges.size());
+   for (CharSourceRange range : info.ranges) {
+      writeLocation(sourceMgr, range.getStart());
+      writeLocation(sourceMgr, range.getEnd());
+   }
+   writeULEB128(info.fixIts.size());
+   for (const DiagnosticInfo::FixIt &fixIt : info.fixIts) {
+      writeLocation(sourceMgr, fixIt.getRange().getStart());
+      writeLocation(sourceMgr, fixIt.getRange().getEnd());
+      writeString(fixIt.getText());
+   }
+   m_argBytes.clear();
+   pack_diagnostic_arguments(formatArgs, m_argBytes);
+   writeULEB128(m_argBytes.size());
+   m_outStream.write(reinterpret_cast<const char *>(m_argBytes.data()), m_argBytes.size());
+}
+
+bool SerializedDiagnosticConsumer::finishProcessing()
+{
+   m_outStream.flush();
+   if (m_file && m_file->hasError()) {
+      m_file->clearError();
+      return true;
+   }
+   return false;
+}
+
+} // polar::ast
@@ -0,0 +1,323 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/12.
+
+#include "polarphp/ast/StoredDiagnostic.h"
+#include "polarphp/ast/DiagnosticEngine.h"
+#include "polarphp/parser/SourceMgr.h"
+#include "polarphp/utils/ErrorHandling.h"
+#include "polarphp/utils/Leb128.h"
+
+#include <limits>
+
+namespace polar::ast {
+
+using polar::utils::decode_sleb128;
+using polar::utils::decode_uleb128;
+using polar::utils::encode_sleb128;
+using polar::utils::encode_uleb128;
+
+namespace {
+
+enum VersionComponents : uint8_t
+{
+   HasMinor = 1 << 0,
+   HasSubminor = 1 << 1,
+   HasBuild = 1 << 2
+};
+
+void append_uleb128(uint64_t value, SmallVectorImpl<uint8_t> &bytes)
+{
+   uint8_t buffer[16];
+   unsigned length = encode_uleb128(value, buffer);
+   bytes.append(buffer, buffer + length);
+}
+
+void append_sleb128(int64_t value, SmallVectorImpl<uint8_t> &bytes)
+{
+   uint8_t buffer[16];
+   unsigned length = encode_sleb128(value, buffer);
+   bytes.append(buffer, buffer + length);
+}
+
+/// Reads the packed arguments front to back. The encoding is produced by
+/// this file only, so malformed input is a programming error.
+class PackedArgsReader
+{
+public:
+   explicit PackedArgsReader(ArrayRef<uint8_t> bytes)
+      : m_current(bytes.begin()),
+        m_end(bytes.end())
+   {}
+
+   bool atEnd() const
+   {
+      return m_current == m_end;
+   }
+
+   uint8_t readByte()
+   {
+      assert(m_current < m_end && "packed diagnostic arguments truncated");
+      return *m_current++;
+   }
+
+   uint64_t readULEB128()
+   {
+      unsigned length;
+      uint64_t value = decode_uleb128(m_current, &length, m_end);
+      m_current += length;
+      return value;
+   }
+
+   int64_t readSLEB128()
+   {
+      unsigned length;
+      int64_t value = decode_sleb128(m_current, &length, m_end);
+      m_current += length;
+      return value;
+   }
+
+   StringRef readString()
+   {
+      size_t length = readULEB128();
+      assert(length <= static_cast<size_t>(m_end - m_current) &&
+             "packed diagnostic arguments truncated");
+      StringRef text(reinterpret_cast<const char *>(m_current), length);
+      m_current += length;
+      return text;
+   }
+
+private:
+   const uint8_t *m_current;
+   const uint8_t *m_end;
+};
+
+uint32_t checked_uint32(size_t value)
+{
+   assert(value <= std::numeric_limits<uint32_t>::max() &&
+          "too many stored diagnostics");
+   return static_cast<uint32_t>(value);
+}
+
+} // anonymous namespace
+
+void pack_diagnostic_arguments(ArrayRef<DiagnosticArgument> args,
+                               SmallVectorImpl<uint8_t> &bytes)
+{
+   for (const DiagnosticArgument &arg : args) {
+      bytes.push_back(static_cast<uint8_t>(arg.getKind()));
+      switch (arg.getKind()) {
+      case DiagnosticArgumentKind::String: {
+         StringRef text = arg.getAsString();
+         append_uleb128(text.size(), bytes);
+         bytes.append(text.getBytesBegin(), text.getBytesEnd());
+         break;
+      }
+      case DiagnosticArgumentKind::Integer:
+         append_sleb128(arg.getAsInteger(), bytes);
+         break;
+      case DiagnosticArgumentKind::Unsigned:
+         append_uleb128(arg.getAsUnsigned(), bytes);
+         break;
+      case DiagnosticArgumentKind::StaticSpellingKind:
+         bytes.push_back(static_cast<uint8_t>(arg.getAsStaticSpellingKind()));
+         break;
+      case DiagnosticArgumentKind::DescriptiveDeclKind:
+         bytes.push_back(static_cast<uint8_t>(arg.getAsDescriptiveDeclKind()));
+         break;
+      case DiagnosticArgumentKind::VersionTuple: {
+         VersionTuple version = arg.getAsVersionTuple();
+         std::optional<unsigned> minor = version.getMinor();
+         std::optional<unsigned> subminor = version.getSubminor();
+         std::optional<unsigned> build = version.getBuild();
+         bytes.push_back((minor ? HasMinor : 0) | (subminor ? HasSubminor : 0) |
+                         (build ? HasBuild : 0));
+         append_uleb128(version.getMajor(), bytes);
+         for (std::optional<unsigned> component : {minor, subminor, build}) {
+            if (component) {
+               append_uleb128(*component, bytes);
+            }
+         }
+         break;
+      }
+      case DiagnosticArgumentKind::Identifier:
+      case DiagnosticArgumentKind::ValueDecl:
+      case DiagnosticArgumentKind::Type:
+      case DiagnosticArgumentKind::TypeRepr:
+      case DiagnosticArgumentKind::ReferenceOwnership:
+      case DiagnosticArgumentKind::DeclAttribute:
+         polar_unreachable("diagnostic argument kind cannot be stored");
+      }
+   }
+}
+
+void unpack_diagnostic_arguments(ArrayRef<uint8_t> bytes,
+                                 SmallVectorImpl<DiagnosticArgument> &args)
+{
+   PackedArgsReader reader(bytes);
+   while (!reader.atEnd()) {
+      switch (static_cast<DiagnosticArgumentKind>(reader.readByte())) {
+      case DiagnosticArgumentKind::String:
+         args.push_back(DiagnosticArgument(reader.readString()));
+         break;
+      case DiagnosticArgumentKind::Integer:
+         args.push_back(DiagnosticArgument(static_cast<int>(reader.readSLEB128())));
+         break;
+      case DiagnosticArgumentKind::Unsigned:
+         args.push_back(DiagnosticArgument(static_cast<unsigned>(reader.readULEB128())));
+         break;
+      case DiagnosticArgumentKind::StaticSpellingKind:
+         args.push_back(DiagnosticArgument(static_cast<StaticSpellingKind>(reader.readByte())));
+         break;
+      case DiagnosticArgumentKind::DescriptiveDeclKind:
+         args.push_back(DiagnosticArgument(static_cast<DescriptiveDeclKind>(reader.readByte())));
+         break;
+      case DiagnosticArgumentKind::VersionTuple: {
+         uint8_t components = reader.readByte();
+         unsigned major = reader.readULEB128();
+         VersionTuple version(major);
+         if (components & HasBuild) {
+            unsigned minor = reader.readULEB128();
+            unsigned subminor = reader.readULEB128();
+            version = VersionTuple(major, minor, subminor, reader.readULEB128());
+         } else if (components & HasSubminor) {
+            unsigned minor = reader.readULEB128();
+            version = VersionTuple(major, minor, reader.readULEB128());
+         } else if (components & HasMinor) {
+            version = VersionTuple(major, reader.readULEB128());
+         }
+         args.push_back(DiagnosticArgument(version));
+         break;
+      }
+      default:
+         polar_unreachable("malformed packed diagnostic arguments");
+      }
+   }
+}
+
+void StoredDiagnosticList::add(DiagnosticKind kind, SourceLoc loc, DiagID id,
+                               ArrayRef<DiagnosticArgument> args,
+                               ArrayRef<CharSourceRange> ranges,
+                               ArrayRef<FixIt> fixIts)
+{
+   unsigned bufferID = 0;
+   if (m_sourceMgr && loc.isValid()) {
+      bufferID = m_sourceMgr->findBufferContainingLoc(loc);
+      m_sourceMgr->retainBuffer(bufferID);
+   }
+   m_entries.push_back(Entry{id, kind, loc, bufferID, checked_uint32(m_argBytes.size()),
+                             checked_uint32(m_ranges.size()),
+                             checked_uint32(m_fixIts.size())});
+   SmallVector<uint8_t, 32> bytes;
+   pack_diagnostic_arguments(args, bytes);
+   m_argBytes.insert(m_argBytes.end(), bytes.begin(), bytes.end());
+   m_ranges.insert(m_ranges.end(), ranges.begin(), ranges.end());
+   m_fixIts.insert(m_fixIts.end(), fixIts.begin(), fixIts.end());
+}
+
+void StoredDiagnosticList::add(DiagnosticKind kind, const Diagnostic &diagnostic)
+{
+   add(kind, diagnostic.getLoc(), diagnostic.getID(), diagnostic.getArgs(),
+       diagnostic.getRanges(), diagnostic.getFixIts());
+}
+
+ArrayRef<uint8_t> StoredDiagnosticList::getPackedArgs(size_t index) const
+{
+   size_t end = index + 1 < size() ? m_entries[index + 1].argsBegin : m_argBytes.size();
+   return ArrayRef<uint8_t>(m_argBytes).slice(m_entries[index].argsBegin,
+                                              end - m_entries[index].argsBegin);
+}
+
+void StoredDiagnosticList::getArgs(size_t index,
+                                   SmallVectorImpl<DiagnosticArgument> &args) const
+{
+   unpack_diagnostic_arguments(getPackedArgs(index), args);
+}
+
+ArrayRef<CharSourceRange> StoredDiagnosticList::getRanges(size_t index) const
+{
+   size_t end = index + 1 < size() ? m_entries[index + 1].rangesBegin : m_ranges.size();
+   return ArrayRef<CharSourceRange>(m_ranges).slice(m_entries[index].rangesBegin,
+                                                    end - m_entries[index].rangesBegin);
+}
+
+ArrayRef<StoredDiagnosticList::FixIt> StoredDiagnosticList::getFixIts(size_t index) const
+{
+   size_t end = index + 1 < size() ? m_entries[index + 1].fixItsBegin : m_fixIts.size();
+   return ArrayRef<FixIt>(m_fixIts).slice(m_entries[index].fixItsBegin,
+                                          end - m_entries[index].fixItsBegin);
+}
+
+void StoredDiagnosticList::formatMessage(size_t index, RawOutStream &outStream) const
+{
+   formatMessage(index, outStream, DiagnosticFormatOptions());
+}
+
+void StoredDiagnosticList::formatMessage(size_t index, RawOutStream &outStream,
+                                         const DiagnosticFormatOptions &formatOpts) const
+{
+   SmallVector<DiagnosticArgument, 4> args;
+   getArgs(index, args);
+   DiagnosticEngine::formatDiagnosticText(
+            outStream, DiagnosticEngine::diagnosticStringFor(m_entries[index].id),
+            args, formatOpts);
+}
+
+void StoredDiagnosticList::replay(size_t begin, size_t end, DiagnosticConsumer &consumer,
+                                  SourceManager &sourceMgr) const
+{
+   assert(begin <= end && end <= size() && "diagnostic range out of bounds");
+   SmallVector<DiagnosticArgument, 4> args;
+   for (size_t index = begin; index < end; ++index) {
+      const Entry &entry = m_entries[index];
+      args.clear();
+      getArgs(index, args);
+      DiagnosticInfo info;
+      info.id = entry.id;
+      info.ranges = getRanges(index);
+      info.fixIts = getFixIts(index);
+      consumer.handleDiagnostic(sourceMgr, entry.loc, entry.kind,
+                                DiagnosticEngine::diagnosticStringFor(entry.id),
+                                args, info);
+   }
+}
+
+void StoredDiagnosticList::truncate(size_t size)
+{
+   if (size >= this->size()) {
+      return;
+   }
+   if (m_sourceMgr) {
+      for (size_t index = size; index < m_entries.size(); ++index) {
+         if (m_entries[index].bufferID != 0) {
+            m_sourceMgr->releaseBuffer(m_entries[index].bufferID);
+         }
+      }
+   }
+   const Entry &first = m_entries[size];
+   m_argBytes.resize(first.argsBegin);
+   m_ranges.erase(m_ranges.begin() + first.rangesBegin, m_ranges.end());
+   m_fixIts.erase(m_fixIts.begin() + first.fixItsBegin, m_fixIts.end());
+   m_entries.resize(size);
+}
+
+size_t StoredDiagnosticList::getMemoryUsage() const
+{
+   size_t usage = m_entries.capacity() * sizeof(Entry) +
+         m_argBytes.capacity() +
+         m_ranges.capacity() * sizeof(CharSourceRange) +
+         m_fixIts.capacity() * sizeof(FixIt);
+   for (const FixIt &fixIt : m_fixIts) {
+      usage += fixIt.getText().size();
+   }
+   return usage;
+}
+
+} // polar::ast
@@ -0,0 +1,243 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/04.
+
+#include "polarphp/basic/SegmentedAppendingBinaryByteStream.h"
+#include "polarphp/global/Global.h"
+#include "polarphp/utils/BinaryStreamError.h"
+#include "polarphp/utils/FileOutputBuffer.h"
+#include "polarphp/utils/MathExtras.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+#if defined(POLAR_HAVE_UNISTD_H)
+# include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+# include <io.h>
+#else
+# include <climits>
+# include <sys/uio.h>
+#endif
+
+namespace polar::basic {
+
+using polar::utils::BinaryStreamError;
+using polar::utils::StreamErrorCode;
+using polar::utils::Error;
+
+SegmentedAppendingBinaryByteStream::SegmentedAppendingBinaryByteStream(
+      polar::utils::Endianness endian, uint32_t chunkSize)
+   : m_chunkShift(polar::utils::log2_32(chunkSize)),
+     m_chunkMask(chunkSize - 1),
+     m_endian(endian)
+{
+   assert(polar::utils::is_power_of_two32(chunkSize) &&
+          "chunk size must be a power of two");
+}
+
+void SegmentedAppendingBinaryByteStream::ensureCapacity(uint64_t size)
+{
+   size_t requiredChunks = (size + m_chunkMask) >> m_chunkShift;
+   if (requiredChunks <= m_chunks.size()) {
+      return;
+   }
+   m_chunks.reserve(requiredChunks);
+   while (m_chunks.size() < requiredChunks) {
+      m_chunks.emplace_back(new uint8_t[getChunkSize()]);
+   }
+}
+
+void SegmentedAppendingBinaryByteStream::reserve(size_t size)
+{
+   ensureCapacity(size);
+}
+
+ArrayRef<uint8_t> SegmentedAppendingBinaryByteStream::getChunk(size_t index) const
+{
+   assert(index < getNumChunks() && "chunk index out of range");
+   uint64_t chunkStart = uint64_t(index) << m_chunkShift;
+   uint64_t chunkLength = std::min<uint64_t>(getChunkSize(), m_length - chunkStart);
+   return ArrayRef<uint8_t>(m_chunks[index].get(), chunkLength);
+}
+
+Error SegmentedAppendingBinaryByteStream::readBytes(
+      uint32_t offset, uint32_t size, ArrayRef<uint8_t> &buffer)
+{
+   if (auto error = checkOffsetForRead(offset, size)) {
+      return error;
+   }
+   uint32_t chunkOffset = offset & m_chunkMask;
+   if (size == 0 || chunkOffset + uint64_t(size) <= getChunkSize()) {
+      buffer = ArrayRef<uint8_t>(m_chunks[offset >> m_chunkShift].get() + chunkOffset,
+                                 size);
+      return Error::getSuccess();
+   }
+
+   // The requested range spans several chunks, so it has to be made
+   // contiguous.
+   uint8_t *copy = m_readCache.allocate<uint8_t>(size);
+   uint32_t copied = 0;
+   while (copied < size) {
+      uint32_t current = offset + copied;
+      uint32_t currentChunkOffset = current & m_chunkMask;
+      uint32_t length = std::min(size - copied, getChunkSize() - currentChunkOffset);
+      ::memcpy(copy + copied, m_chunks[current >> m_chunkShift].get() + currentChunkOffset,
+               length);
+      copied += length;
+   }
+   buffer = ArrayRef<uint8_t>(copy, size);
+   return Error::getSuccess();
+}
+
+Error SegmentedAppendingBinaryByteStream::readLongestContiguousChunk(
+      uint32_t offset, ArrayRef<uint8_t> &buffer)
+{
+   if (auto error = checkOffsetForRead(offset, 0)) {
+      return error;
+   }
+   if (offset == m_length) {
+      buffer = ArrayRef<uint8_t>();
+      return Error::getSuccess();
+   }
+   uint32_t chunkOffset = offset & m_chunkMask;
+   ArrayRef<uint8_t> chunk = getChunk(offset >> m_chunkShift);
+   buffer = chunk.dropFront(chunkOffset);
+   return Error::getSuccess();
+}
+
+Error SegmentedAppendingBinaryByteStream::writeBytes(
+      uint32_t offset, ArrayRef<uint8_t> buffer)
+{
+   if (buffer.empty()) {
+      return Error::getSuccess();
+   }
+
+   if (auto error = checkOffsetForWrite(offset, buffer.size())) {
+      return error;
+   }
+
+   uint64_t requiredSize = uint64_t(offset) + buffer.size();
+   if (requiredSize > UINT32_MAX) {
+      return polar::utils::make_error<BinaryStreamError>(
+               StreamErrorCode::invalid_offset,
+               "segmented stream is limited to 4GB");
+   }
+   ensureCapacity(requiredSize);
+
+   const uint8_t *source = buffer.data();
+   size_t remaining = buffer.size();
+   uint32_t current = offset;
+   while (remaining > 0) {
+      uint32_t chunkOffset = current & m_chunkMask;
+      size_t length = std::min<size_t>(remaining, getChunkSize() - chunkOffset);
+      ::memcpy(m_chunks[current >> m_chunkShift].get() + chunkOffset, source, length);
+      source += length;
+      current += length;
+      remaining -= length;
+   }
+   if (requiredSize > m_length) {
+      m_length = requiredSize;
+   }
+   return Error::getSuccess();
+}
+
+Error SegmentedAppendingBinaryByteStream::writeToFileDescriptor(int fd) const
+{
+#if !defined(_WIN32)
+   size_t numChunks = getNumChunks();
+   size_t chunkIndex = 0;
+   // Offset into the first chunk of the current batch that has already been
+   // written by an earlier, partial writev.
+   size_t written = 0;
+   struct iovec vectors[IOV_MAX];
+   while (chunkIndex < numChunks) {
+      int numVectors = 0;
+      for (size_t index = chunkIndex; index < numChunks && numVectors < IOV_MAX;
+           ++index, ++numVectors) {
+         ArrayRef<uint8_t> chunk = getChunk(index);
+         size_t skip = index == chunkIndex ? written : 0;
+         vectors[numVectors].iov_base = const_cast<uint8_t *>(chunk.data()) + skip;
+         vectors[numVectors].iov_len = chunk.size() - skip;
+      }
+      ssize_t result = ::writev(fd, vectors, numVectors);
+      if (result < 0) {
+         if (errno == EINTR || errno == EAGAIN) {
+            continue;
+         }
+         return polar::utils::error_code_to_error(
+                  std::error_code(errno, std::generic_category()));
+      }
+      // Advance past everything the kernel accepted, which may end in the
+      // middle of a chunk.
+      size_t remaining = result;
+      while (remaining > 0) {
+         size_t chunkRemaining = getChunk(chunkIndex).size() - written;
+         if (remaining < chunkRemaining) {
+            written += remaining;
+            break;
+         }
+         remaining -= chunkRemaining;
+         written = 0;
+         ++chunkIndex;
+      }
+   }
+   return Error::getSuccess();
+#else
+   for (size_t index = 0, numChunks = getNumChunks(); index < numChunks; ++index) {
+      ArrayRef<uint8_t> chunk = getChunk(index);
+      size_t written = 0;
+      while (written < chunk.size()) {
+         int result = ::_write(fd, chunk.data() + written, chunk.size() - written);
+         if (result < 0) {
+            return polar::utils::error_code_to_error(
+                     std::error_code(errno, std::generic_category()));
+         }
+         written += result;
+      }
+   }
+   return Error::getSuccess();
+#endif
+}
+
+Error SegmentedAppendingBinaryByteStream::writeToOutputBuffer(
+      FileOutputBuffer &buffer) const
+{
+   if (buffer.getBufferSize() < m_length) {
+      return polar::utils::make_error<BinaryStreamError>(
+               StreamErrorCode::stream_too_short,
+               "output buffer is smaller than the stream");
+   }
+   uint8_t *target = buffer.getBufferStart();
+   for (size_t index = 0, numChunks = getNumChunks(); index < numChunks; ++index) {
+      ArrayRef<uint8_t> chunk = getChunk(index);
+      ::memcpy(target, chunk.data(), chunk.size());
+      target += chunk.size();
+   }
+   return Error::getSuccess();
+}
+
+Error SegmentedAppendingBinaryByteStream::writeToFile(StringRef filePath) const
+{
+   auto bufferOrError = FileOutputBuffer::create(filePath, m_length);
+   if (!bufferOrError) {
+      return bufferOrError.takeError();
+   }
+   std::unique_ptr<FileOutputBuffer> buffer = std::move(*bufferOrError);
+   if (auto error = writeToOutputBuffer(*buffer)) {
+      return error;
+   }
+   return buffer->commit();
+}
+
+} // polar::basic
@@ -34,6 +34,7 @@
 #include "polarphp/utils/Debug.h"
 #include "polarphp/utils/ErrorHandling.h"
 #include "polarphp/utils/MathExtras.h"
+#include "polarphp/utils/NativeFormatting.h"
 #include "polarphp/utils/RawOutStream.h"
 #include <cstring>
 #include <limits.h>
@@ -42,6 +43,8 @@ namespace polar {
 namespace basic {
 
 using polar::utils::next_power_of_two;
+using polar::utils::to_shortest_decimal;
+using polar::utils::DecimalDouble;
 using polar::debug_stream;
 
 #define ApFloat_DISPATCH_ON_SEMANTICS(METHOD_CALL)                             \
@@ -3614,6 +3617,121 @@ void adjust_to_precision(SmallVectorImpl<char> &buffer,
    exp += firstSignificant;
    buffer.erase(&buffer[0], &buffer[firstSignificant]);
 }
+
+/// Lays out the digits of \p buffer, least significant first, times 10^exp
+/// for IEEEFloat::toString().
+void append_decimal(SmallVectorImpl<char> &str, const SmallVectorImpl<char> &buffer,
+                    int exp, unsigned formatPrecision, unsigned formatMaxPadding,
+                    bool truncateZero)
+{
+   unsigned NDigits = buffer.getSize();
+
+   // Check whether we should use scientific notation.
+   bool formatScientific;
+   if (!formatMaxPadding) {
+      formatScientific = true;
+   } else {
+      if (exp >= 0) {
+         // 765e3 --> 765000
+         //              ^^^
+         // But we shouldn't make the number look more precise than it is.
+         formatScientific = ((unsigned) exp > formatMaxPadding ||
+                             NDigits + (unsigned) exp > formatPrecision);
+      } else {
+         // Power of the most significant digit.
+         int msd = exp + (int) (NDigits - 1);
+         if (msd >= 0) {
+            // 765e-2 == 7.65
+            formatScientific = false;
+         } else {
+            // 765e-5 == 0.00765
+            //           ^ ^^
+            formatScientific = ((unsigned) -msd) > formatMaxPadding;
+         }
+      }
+   }
+
+   // Scientific formatting is pretty straightforward.
+   if (formatScientific) {
+      exp += (NDigits - 1);
+
+      str.push_back(buffer[NDigits-1]);
+      str.push_back('.');
+      if (NDigits == 1 && truncateZero) {
+         str.push_back('0');
+      } else {
+         for (unsigned index = 1; index != NDigits; ++index) {
+            str.push_back(buffer[NDigits-1-index]);
+         }
+      }
+
+      // Fill with zeros up to FormatPrecision.
+      if (!truncateZero && formatPrecision > NDigits - 1) {
+         str.append(formatPrecision - NDigits + 1, '0');
+      }
+
+      // For !TruncateZero we use lower 'e'.
+      str.push_back(truncateZero ? 'E' : 'e');
+
+      str.push_back(exp >= 0 ? '+' : '-');
+      if (exp < 0) {
+         exp = -exp;
+      }
+      SmallVector<char, 6> expbuf;
+      do {
+         expbuf.push_back((char) ('0' + (exp % 10)));
+         exp /= 10;
+      } while (exp);
+      // Exponent always at least two digits if we do not truncate zeros.
+      if (!truncateZero && expbuf.getSize() < 2) {
+         expbuf.push_back('0');
+      }
+
+      for (unsigned index = 0, end = expbuf.getSize(); index != end; ++index) {
+         str.push_back(expbuf[end - 1 - index]);
+      }
+
+      return;
+   }
+
+   // Non-scientific, positive exponents.
+   if (exp >= 0) {
+      for (unsigned index = 0; index != NDigits; ++index) {
+         str.push_back(buffer[NDigits-1-index]);
+      }
+
+      for (unsigned index = 0; index != (unsigned) exp; ++index) {
+         str.push_back('0');
+      }
+
+      return;
+   }
+
+   // Non-scientific, negative exponents.
+
+   // The number of digits to the left of the decimal point.
+   int nWholeDigits = exp + (int) NDigits;
+
+   unsigned index = 0;
+   if (nWholeDigits > 0) {
+      for (; index != (unsigned) nWholeDigits; ++index) {
+         str.push_back(buffer[NDigits-index-1]);
+      }
+      str.push_back('.');
+   } else {
+      unsigned nZeros = 1 + (unsigned) - nWholeDigits;
+
+      str.push_back('0');
+      str.push_back('.');
+      for (unsigned zero = 1; zero != nZeros; ++zero) {
+         str.push_back('0');
+      }
+   }
+
+   for (; index != NDigits; ++index) {
+      str.push_back(buffer[NDigits - index - 1]);
+   }
+}
 } // anonymous namespace
 
 void IEEEFloat::toString(SmallVectorImpl<char> &str, unsigned formatPrecision,
@@ -3751,113 +3869,30 @@ void IEEEFloat::toString(SmallVectorImpl<char> &str, unsigned formatPrecision,
    // TODO: don't do more precise calculations above than are required.
    adjust_to_precision(buffer, exp, formatPrecision);
 
-   unsigned NDigits = buffer.getSize();
-
-   // Check whether we should use scientific notation.
-   bool formatScientific;
-   if (!formatMaxPadding) {
-      formatScientific = true;
-   } else {
-      if (exp >= 0) {
-         // 765e3 --> 765000
-         //              ^^^
-         // But we shouldn't make the number look more precise than it is.
-         formatScientific = ((unsigned) exp > formatMaxPadding ||
-                             NDigits + (unsigned) exp > formatPrecision);
-      } else {
-         // Power of the most significant digit.
-         int msd = exp + (int) (NDigits - 1);
-         if (msd >= 0) {
-            // 765e-2 == 7.65
-            formatScientific = false;
-         } else {
-            // 765e-5 == 0.00765
-            //           ^ ^^
-            formatScientific = ((unsigned) -msd) > formatMaxPadding;
-         }
-      }
-   }
-
-   // Scientific formatting is pretty straightforward.
-   if (formatScientific) {
-      exp += (NDigits - 1);
-
-      str.push_back(buffer[NDigits-1]);
-      str.push_back('.');
-      if (NDigits == 1 && truncateZero) {
-         str.push_back('0');
-      } else {
-         for (unsigned index = 1; index != NDigits; ++index) {
-            str.push_back(buffer[NDigits-1-index]);
-         }
-      }
-
-      // Fill with zeros up to FormatPrecision.
-      if (!truncateZero && formatPrecision > NDigits - 1) {
-         str.append(formatPrecision - NDigits + 1, '0');
-      }
-
-      // For !TruncateZero we use lower 'e'.
-      str.push_back(truncateZero ? 'E' : 'e');
-
-      str.push_back(exp >= 0 ? '+' : '-');
-      if (exp < 0) {
-         exp = -exp;
-      }
-      SmallVector<char, 6> expbuf;
-      do {
-         expbuf.push_back((char) ('0' + (exp % 10)));
-         exp /= 10;
-      } while (exp);
-      // Exponent always at least two digits if we do not truncate zeros.
-      if (!truncateZero && expbuf.getSize() < 2) {
-         expbuf.push_back('0');
-      }
-
-      for (unsigned index = 0, end = expbuf.getSize(); index != end; ++index) {
-         str.push_back(expbuf[end - 1 - index]);
-      }
-
-      return;
-   }
-
-   // Non-scientific, positive exponents.
-   if (exp >= 0) {
-      for (unsigned index = 0; index != NDigits; ++index) {
-         str.push_back(buffer[NDigits-1-index]);
-      }
-
-      for (unsigned index = 0; index != (unsigned) exp; ++index) {
-         str.push_back('0');
-      }
+   append_decimal(str, buffer, exp, formatPrecision, formatMaxPadding, truncateZero);
+}
 
-      return;
+void IEEEFloat::toShortestString(SmallVectorImpl<char> &str,
+                                 unsigned formatMaxPadding) const
+{
+   // Only doubles have a shortest conversion, the other formats print as many
+   // digits as toString() does by default.
+   if (m_semantics != &sg_semIEEEdouble || m_category != FltCategory::fcNormal) {
+      return toString(str, 0, formatMaxPadding);
    }
-
-   // Non-scientific, negative exponents.
-
-   // The number of digits to the left of the decimal point.
-   int nWholeDigits = exp + (int) NDigits;
-
-   unsigned index = 0;
-   if (nWholeDigits > 0) {
-      for (; index != (unsigned) nWholeDigits; ++index) {
-         str.push_back(buffer[NDigits-index-1]);
-      }
-      str.push_back('.');
-   } else {
-      unsigned nZeros = 1 + (unsigned) - nWholeDigits;
-
-      str.push_back('0');
-      str.push_back('.');
-      for (unsigned zero = 1; zero != nZeros; ++zero) {
-         str.push_back('0');
-      }
+   if (isNegative()) {
+      str.push_back('-');
    }
-
-   for (; index != NDigits; ++index) {
-      str.push_back(buffer[NDigits - index - 1]);
+   DecimalDouble decimal = to_shortest_decimal(convertToDouble());
+   SmallVector<char, 20> buffer;
+   for (uint64_t digits = decimal.digits; digits != 0; digits /= 10) {
+      buffer.push_back(static_cast<char>('0' + digits % 10));
    }
+   // Choose between positional and scientific notation as toString() does
+   // with its default precision.
+   unsigned formatPrecision = 2 + m_semantics->m_precision * 59 / 196;
+   append_decimal(str, buffer, decimal.exponent, formatPrecision, formatMaxPadding,
+                  true);
 }
 
 bool IEEEFloat::getExactInverse(ApFloat *inv) const
@@ -4696,6 +4731,14 @@ bool DoubleApFloat::isInteger() const
    return m_floats[0].isInteger() && m_floats[1].isInteger();
 }
 
+void DoubleApFloat::toShortestString(SmallVectorImpl<char> &str,
+                                     unsigned formatMaxPadding) const
+{
+   assert(m_semantics == &sg_semPPCDoubleDouble && "Unexpected Semantics");
+   ApFloat(sg_semPPCDoubleDoubleLegacy, bitcastToApInt())
+         .toShortestString(str, formatMaxPadding);
+}
+
 void DoubleApFloat::toString(SmallVectorImpl<char> &str,
                              unsigned formatPrecision,
                              unsigned formatMaxPadding,
@@ -63,6 +63,25 @@ inline uint64_t *get_memory(unsigned numWords)
    return new uint64_t[numWords];
 }
 
+/// Operands of at least this many words are multiplied with the Karatsuba
+/// method, smaller ones with the schoolbook method.
+constexpr unsigned sg_karatsubaThreshold = 48;
+
+#if defined(__SIZEOF_INT128__)
+using UInt128 = unsigned __int128;
+
+inline UInt128 load_uint128(const uint64_t *words)
+{
+   return UInt128(words[1]) << 64 | words[0];
+}
+
+inline void store_uint128(uint64_t *words, UInt128 value)
+{
+   words[0] = uint64_t(value);
+   words[1] = uint64_t(value >> 64);
+}
+#endif
+
 /// A utility function that converts a character to a digit.
 inline unsigned get_digit(char cdigit, uint8_t radix)
 {
@@ -88,15 +107,187 @@ inline unsigned get_digit(char cdigit, uint8_t radix)
    }
    return -1U;
 }
+
+/// Numbers of at least this many chunks of digits, or words, are converted
+/// from and to strings by splitting them in halves.
+constexpr unsigned sg_radixSplitThreshold = 16;
+
+/// The powers of a radix that radix conversions split numbers at. The
+/// conversions go a chunk of digits, as many as fit a word, at a time, and
+/// split numbers at the power for the chunks << level digits.
+class RadixPowers
+{
+public:
+   explicit RadixPowers(unsigned radix)
+      : m_radix(radix),
+        m_chunkDigits(0),
+        m_chunkPower(1)
+   {
+      while (m_chunkPower <= UINT64_MAX / radix) {
+         m_chunkPower *= radix;
+         ++m_chunkDigits;
+      }
+   }
+
+   unsigned getRadix() const
+   {
+      return m_radix;
+   }
+
+   /// The digits of a chunk.
+   unsigned getChunkDigits() const
+   {
+      return m_chunkDigits;
+   }
+
+   /// radix ^ getChunkDigits().
+   uint64_t getChunkPower() const
+   {
+      return m_chunkPower;
+   }
+
+   /// Enough bits for \p numDigits digits.
+   unsigned getBitsFor(size_t numDigits) const
+   {
+      return (numDigits + m_chunkDigits - 1) / m_chunkDigits * ApInt::APINT_BITS_PER_WORD;
+   }
+
+   /// radix ^ (getChunkDigits() << level), with no leading zero words.
+   const ApInt &getPower(unsigned level)
+   {
+      if (m_powers.empty()) {
+         m_powers.push_back(ApInt(ApInt::APINT_BITS_PER_WORD, m_chunkPower));
+      }
+      while (m_powers.size() <= level) {
+         const ApInt &last = m_powers.back();
+         unsigned numWords = last.getNumWords();
+         SmallVector<uint64_t, 16> square(2 * numWords);
+         ApInt::tcFullMultiply(square.getData(), last.getRawData(), last.getRawData(),
+                               numWords, numWords);
+         while (square.back() == 0) {
+            square.pop_back();
+         }
+         m_powers.push_back(ApInt(square.getSize() * ApInt::APINT_BITS_PER_WORD, square));
+      }
+      return m_powers[level];
+   }
+
+private:
+   unsigned m_radix;
+   unsigned m_chunkDigits;
+   uint64_t m_chunkPower;
+   SmallVector<ApInt, 8> m_powers;
+};
+
+/// Parse \p digits, which have no sign, into an ApInt of
+/// powers.getBitsFor(digits.size()) bits.
+ApInt parse_radix_digits(StringRef digits, RadixPowers &powers)
+{
+   unsigned chunkDigits = powers.getChunkDigits();
+   unsigned numBits = powers.getBitsFor(digits.size());
+   if (digits.size() < size_t(chunkDigits) * sg_radixSplitThreshold) {
+      ApInt value(numBits, 0);
+      // The first chunk takes the digits that do not fill a whole chunk.
+      size_t chunkSize = digits.size() % chunkDigits;
+      if (chunkSize == 0) {
+         chunkSize = chunkDigits;
+      }
+      for (size_t start = 0; start < digits.size(); start += chunkSize, chunkSize = chunkDigits) {
+         uint64_t chunk = 0;
+         uint64_t chunkPower = 1;
+         for (char digit : digits.substr(start, chunkSize)) {
+            unsigned digitValue = get_digit(digit, powers.getRadix());
+            assert(digitValue < powers.getRadix() && "Invalid character in digit string");
+            chunk = chunk * powers.getRadix() + digitValue;
+            chunkPower *= powers.getRadix();
+         }
+         value *= chunkPower;
+         value += chunk;
+      }
+      return value;
+   }
+   // Split off the largest power of two chunks of low digits, which leaves
+   // at most as many high digits.
+   unsigned level = 0;
+   while ((size_t(chunkDigits) << (level + 1)) < digits.size()) {
+      ++level;
+   }
+   size_t lowDigits = size_t(chunkDigits) << level;
+   ApInt high = parse_radix_digits(digits.dropBack(lowDigits), powers);
+   ApInt low = parse_radix_digits(digits.takeBack(lowDigits), powers);
+   const ApInt &power = powers.getPower(level);
+   unsigned highWords = high.getNumWords();
+   unsigned powerWords = power.getNumWords();
+   SmallVector<uint64_t, 64> product(highWords + powerWords);
+   ApInt::tcFullMultiply(product.getData(), high.getRawData(), power.getRawData(),
+                         highWords, powerWords);
+   // The product has at most as many words as the value, any extra words
+   // are zero.
+   ApInt value(numBits, product);
+   value += low.zext(numBits);
+   return value;
+}
+
+/// \p value with the fewest whole words it fits.
+ApInt shrink_to_words(const ApInt &value)
+{
+   unsigned numBits = std::max(value.getActiveBits(), 1u);
+   numBits = ApInt::getNumWords(numBits) * ApInt::APINT_BITS_PER_WORD;
+   return numBits < value.getBitWidth() ? value.trunc(numBits) : value;
+}
+
+/// Append the digits of \p value to \p str, least significant first and
+/// padded with zeros to \p minDigits digits.
+void append_radix_digits(SmallVectorImpl<char> &str, const ApInt &value,
+                         RadixPowers &powers, size_t minDigits)
+{
+   static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+   unsigned radix = powers.getRadix();
+   unsigned chunkDigits = powers.getChunkDigits();
+   size_t startSize = str.getSize();
+   if (value.getNumWords() < sg_radixSplitThreshold) {
+      ApInt rest(value);
+      while (rest.getBoolValue()) {
+         uint64_t chunk;
+         ApInt::udivrem(rest, powers.getChunkPower(), rest, chunk);
+         // Every chunk but the most significant one has all its digits.
+         unsigned chunkSize = rest.getBoolValue() ? chunkDigits : 0;
+         for (unsigned i = 0; chunk != 0 || i < chunkSize; ++i) {
+            str.push_back(digits[chunk % radix]);
+            chunk /= radix;
+         }
+      }
+   } else {
+      // Split at a power with about half the bits of the value.
+      unsigned level = 0;
+      while (powers.getPower(level + 1).getActiveBits() * 2 <= value.getActiveBits()) {
+         ++level;
+      }
+      size_t lowDigits = size_t(chunkDigits) << level;
+      ApInt high;
+      ApInt low;
+      ApInt::udivrem(value, powers.getPower(level).zextOrSelf(value.getBitWidth()), high, low);
+      append_radix_digits(str, shrink_to_words(low), powers, lowDigits);
+      append_radix_digits(str, shrink_to_words(high), powers, 0);
+   }
+   while (str.getSize() - startSize < minDigits) {
+      str.push_back('0');
+   }
+}
 } // anonymous namespace
 
 void ApInt::initSlowCase(uint64_t value, bool isSigned)
 {
-   m_intValue.m_pValue = get_cleared_memory(getNumWords());
-   m_intValue.m_pValue[0] = value;
+   if (isInline()) {
+      memset(m_intValue.m_inlineValues, 0, sizeof(m_intValue.m_inlineValues));
+   } else {
+      m_intValue.m_pValue = get_cleared_memory(getNumWords());
+   }
+   uint64_t *words = getWords();
+   words[0] = value;
    if (isSigned && int64_t(value) < 0) {
       for (unsigned i = 1; i < getNumWords(); ++i) {
-         m_intValue.m_pValue[i] = WORDTYPE_MAX;
+         words[i] = WORDTYPE_MAX;
       }
    }
    clearUnusedBits();
@@ -104,8 +295,10 @@ void ApInt::initSlowCase(uint64_t value, bool isSigned)
 
 void ApInt::initSlowCase(const ApInt& other)
 {
-   m_intValue.m_pValue = get_memory(getNumWords());
-   memcpy(m_intValue.m_pValue, other.m_intValue.m_pValue, getNumWords() * APINT_WORD_SIZE);
+   if (!isInline()) {
+      m_intValue.m_pValue = get_memory(getNumWords());
+   }
+   memcpy(getWords(), other.getWords(), getNumWords() * APINT_WORD_SIZE);
 }
 
 void ApInt::initFromArray(ArrayRef<uint64_t> bigVal)
@@ -116,11 +309,15 @@ void ApInt::initFromArray(ArrayRef<uint64_t> bigVal)
       m_intValue.m_value = bigVal[0];
    } else {
       // Get memory, cleared to 0
-      m_intValue.m_pValue = get_cleared_memory(getNumWords());
+      if (isInline()) {
+         memset(m_intValue.m_inlineValues, 0, sizeof(m_intValue.m_inlineValues));
+      } else {
+         m_intValue.m_pValue = get_cleared_memory(getNumWords());
+      }
       // Calculate the number of words to copy
       unsigned words = std::min<unsigned>(bigVal.getSize(), getNumWords());
       // Copy the words from bigVal to pVal
-      memcpy(m_intValue.m_pValue, bigVal.getData(), words * APINT_WORD_SIZE);
+      memcpy(getWords(), bigVal.getData(), words * APINT_WORD_SIZE);
    }
    // Make sure unused high bits are cleared
    clearUnusedBits();
@@ -153,13 +350,13 @@ void ApInt::reallocate(unsigned newm_bitWidth)
       return;
    }
    // If we have an allocation, delete it.
-   if (!isSingleWord()) {
+   if (needsCleanup()) {
       delete [] m_intValue.m_pValue;
    }
    // Update m_bitWidth.
    m_bitWidth = newm_bitWidth;
    // If we are supposed to have an allocation, create it.
-   if (!isSingleWord()) {
+   if (needsCleanup()) {
       m_intValue.m_pValue = get_memory(getNumWords());
    }
 }
@@ -176,7 +373,7 @@ void ApInt::assignSlowCase(const ApInt& other)
    if (isSingleWord()) {
       m_intValue.m_value = other.m_intValue.m_value;
    } else {
-      memcpy(m_intValue.m_pValue, other.m_intValue.m_pValue, getNumWords() * APINT_WORD_SIZE);
+      memcpy(getWords(), other.getWords(), getNumWords() * APINT_WORD_SIZE);
    }
 }
 
@@ -190,7 +387,7 @@ void ApInt::profile(FoldingSetNodeId& id) const
    }
    unsigned numWords = getNumWords();
    for (unsigned i = 0; i < numWords; ++i) {
-      id.addInteger(m_intValue.m_pValue[i]);
+      id.addInteger(getWords()[i]);
    }
 }
 
@@ -200,7 +397,7 @@ ApInt& ApInt::operator++()
    if (isSingleWord()) {
       ++m_intValue.m_value;
    } else {
-      tcIncrement(m_intValue.m_pValue, getNumWords());
+      tcIncrement(getWords(), getNumWords());
    }
    return clearUnusedBits();
 }
@@ -211,7 +408,7 @@ ApInt& ApInt::operator--()
    if (isSingleWord()) {
       --m_intValue.m_value;
    } else {
-      tcDecrement(m_intValue.m_pValue, getNumWords());
+      tcDecrement(getWords(), getNumWords());
    }
    return clearUnusedBits();
 }
@@ -225,7 +422,7 @@ ApInt& ApInt::operator+=(const ApInt& other)
    if (isSingleWord()) {
       m_intValue.m_value += other.m_intValue.m_value;
    } else {
-      tcAdd(m_intValue.m_pValue, other.m_intValue.m_pValue, 0, getNumWords());
+      tcAdd(getWords(), other.getWords(), 0, getNumWords());
    }
    return clearUnusedBits();
 }
@@ -235,7 +432,7 @@ ApInt& ApInt::operator+=(uint64_t other)
    if (isSingleWord()) {
       m_intValue.m_value += other;
    } else {
-      tcAddPart(m_intValue.m_pValue, other, getNumWords());
+      tcAddPart(getWords(), other, getNumWords());
    }
    return clearUnusedBits();
 }
@@ -249,7 +446,7 @@ ApInt& ApInt::operator-=(const ApInt& other)
    if (isSingleWord()) {
       m_intValue.m_value -= other.m_intValue.m_value;
    } else {
-      tcSubtract(m_intValue.m_pValue, other.m_intValue.m_pValue, 0, getNumWords());
+      tcSubtract(getWords(), other.getWords(), 0, getNumWords());
    }
    return clearUnusedBits();
 }
@@ -259,7 +456,7 @@ ApInt& ApInt::operator-=(uint64_t other)
    if (isSingleWord()) {
       m_intValue.m_value -= other;
    } else {
-      tcSubtractPart(m_intValue.m_pValue, other, getNumWords());
+      tcSubtractPart(getWords(), other, getNumWords());
    }
    return clearUnusedBits();
 }
@@ -270,25 +467,42 @@ ApInt ApInt::operator*(const ApInt& other) const
    if (isSingleWord()) {
       return ApInt(m_bitWidth, m_intValue.m_value * other.m_intValue.m_value);
    }
-   ApInt result(get_memory(getNumWords()), getBitWidth());
-   tcMultiply(result.m_intValue.m_pValue, m_intValue.m_pValue, other.m_intValue.m_pValue, getNumWords());
+   unsigned numWords = getNumWords();
+   ApInt result(getBitWidth(), UninitializedTag());
+#if defined(__SIZEOF_INT128__)
+   if (numWords == 2) {
+      store_uint128(result.getWords(), load_uint128(getWords()) * load_uint128(other.getWords()));
+      result.clearUnusedBits();
+      return result;
+   }
+#endif
+   if (numWords >= 2 * sg_karatsubaThreshold) {
+      // The Karatsuba method only computes full products, which pays off
+      // against the schoolbook method computing the low half only at about
+      // twice the size.
+      SmallVector<WordType, 128> product(2 * numWords);
+      tcFullMultiply(product.getData(), getWords(), other.getWords(), numWords, numWords);
+      tcAssign(result.getWords(), product.getData(), numWords);
+   } else {
+      tcMultiply(result.getWords(), getWords(), other.getWords(), numWords);
+   }
    result.clearUnusedBits();
    return result;
 }
 
 void ApInt::andAssignSlowCase(const ApInt &other)
 {
-   tcAnd(m_intValue.m_pValue, other.m_intValue.m_pValue, getNumWords());
+   tcAnd(getWords(), other.getWords(), getNumWords());
 }
 
 void ApInt::orAssignSlowCase(const ApInt &other)
 {
-   tcOr(m_intValue.m_pValue, other.m_intValue.m_pValue, getNumWords());
+   tcOr(getWords(), other.getWords(), getNumWords());
 }
 
 void ApInt::xorAssignSlowCase(const ApInt &other)
 {
-   tcXor(m_intValue.m_pValue, other.m_intValue.m_pValue, getNumWords());
+   tcXor(getWords(), other.getWords(), getNumWords());
 }
 
 ApInt& ApInt::operator*=(const ApInt& other)
@@ -304,14 +518,14 @@ ApInt& ApInt::operator*=(uint64_t other)
       m_intValue.m_value *= other;
    } else {
       unsigned numWords = getNumWords();
-      tcMultiplyPart(m_intValue.m_pValue, m_intValue.m_pValue, other, 0, numWords, numWords, false);
+      tcMultiplyPart(getWords(), getWords(), other, 0, numWords, numWords, false);
    }
    return clearUnusedBits();
 }
 
 bool ApInt::equalSlowCase(const ApInt& other) const
 {
-   return std::equal(m_intValue.m_pValue, m_intValue.m_pValue + getNumWords(), other.m_intValue.m_pValue);
+   return std::equal(getWords(), getWords() + getNumWords(), other.getWords());
 }
 
 int ApInt::compare(const ApInt &other) const
@@ -320,7 +534,7 @@ int ApInt::compare(const ApInt &other) const
    if (isSingleWord()) {
       return m_intValue.m_value < other.m_intValue.m_value ? -1 : m_intValue.m_value > other.m_intValue.m_value;
    }
-   return tcCompare(m_intValue.m_pValue, other.m_intValue.m_pValue, getNumWords());
+   return tcCompare(getWords(), other.getWords(), getNumWords());
 }
 
 int ApInt::compareSigned(const ApInt& other) const
@@ -339,7 +553,7 @@ int ApInt::compareSigned(const ApInt& other) const
    }
    // Otherwise we can just use an unsigned comparison, because even negative
    // numbers compare correctly this way if both have the same signed-ness.
-   return tcCompare(m_intValue.m_pValue, other.m_intValue.m_pValue, getNumWords());
+   return tcCompare(getWords(), other.getWords(), getNumWords());
 }
 
 void ApInt::setBitsSlowCase(unsigned loBit, unsigned hiBit)
@@ -358,21 +572,21 @@ void ApInt::setBitsSlowCase(unsigned loBit, unsigned hiBit)
       if (hiWord == loWord) {
          loMask &= hiMask;
       } else {
-         m_intValue.m_pValue[hiWord] |= hiMask;
+         getWords()[hiWord] |= hiMask;
       }
    }
    // Apply the mask to the low word.
-   m_intValue.m_pValue[loWord] |= loMask;
+   getWords()[loWord] |= loMask;
    // Fill any words between loWord and hiWord with all ones.
    for (unsigned word = loWord + 1; word < hiWord; ++word) {
-      m_intValue.m_pValue[word] = WORDTYPE_MAX;
+      getWords()[word] = WORDTYPE_MAX;
    }
 }
 
 /// @brief Toggle every bit to its opposite value.
 void ApInt::flipAllBitsSlowCase()
 {
-   tcComplement(m_intValue.m_pValue, getNumWords());
+   tcComplement(getWords(), getNumWords());
    clearUnusedBits();
 }
 
@@ -411,22 +625,22 @@ void ApInt::insertBits(const ApInt &subBits, unsigned bitPosition)
    // Insertion within a single word can be done as a direct bitmask.
    if (loWord == hi1Word) {
       uint64_t mask = WORDTYPE_MAX >> (APINT_BITS_PER_WORD - subm_bitWidth);
-      m_intValue.m_pValue[loWord] &= ~(mask << loBit);
-      m_intValue.m_pValue[loWord] |= (subBits.m_intValue.m_value << loBit);
+      getWords()[loWord] &= ~(mask << loBit);
+      getWords()[loWord] |= (subBits.m_intValue.m_value << loBit);
       return;
    }
    // Insert on word boundaries.
    if (loBit == 0) {
       // Direct copy whole words.
       unsigned numWholeSubWords = subm_bitWidth / APINT_BITS_PER_WORD;
-      memcpy(m_intValue.m_pValue + loWord, subBits.getRawData(),
+      memcpy(getWords() + loWord, subBits.getRawData(),
              numWholeSubWords * APINT_WORD_SIZE);
       // Mask+insert remaining bits.
       unsigned remainingBits = subm_bitWidth % APINT_BITS_PER_WORD;
       if (remainingBits != 0) {
          uint64_t mask = WORDTYPE_MAX >> (APINT_BITS_PER_WORD - remainingBits);
-         m_intValue.m_pValue[hi1Word] &= ~mask;
-         m_intValue.m_pValue[hi1Word] |= subBits.getWord(subm_bitWidth - 1);
+         getWords()[hi1Word] &= ~mask;
+         getWords()[hi1Word] |= subBits.getWord(subm_bitWidth - 1);
       }
       return;
    }
@@ -455,22 +669,22 @@ ApInt ApInt::extractBits(unsigned numBits, unsigned bitPosition) const
    unsigned hiWord = whichWord(bitPosition + numBits - 1);
    // Single word result extracting bits from a single word source.
    if (loWord == hiWord) {
-      return ApInt(numBits, m_intValue.m_pValue[loWord] >> loBit);
+      return ApInt(numBits, getWords()[loWord] >> loBit);
    }
    // Extracting bits that start on a source word boundary can be done
    // as a fast memory copy.
    if (loBit == 0) {
-      return ApInt(numBits, make_array_ref(m_intValue.m_pValue + loWord, 1 + hiWord - loWord));
+      return ApInt(numBits, make_array_ref(getWords() + loWord, 1 + hiWord - loWord));
    }
    // General case - shift + copy source words directly into place.
    ApInt result(numBits, 0);
    unsigned numSrcWords = getNumWords();
    unsigned numDstWords = result.getNumWords();
-   uint64_t *destPtr = result.isSingleWord() ? &result.m_intValue.m_value : result.m_intValue.m_pValue;
+   uint64_t *destPtr = result.isSingleWord() ? &result.m_intValue.m_value : result.getWords();
    for (unsigned word = 0; word < numDstWords; ++word) {
-      uint64_t w0 = m_intValue.m_pValue[loWord + word];
+      uint64_t w0 = getWords()[loWord + word];
       uint64_t w1 =
-            (loWord + word + 1) < numSrcWords ? m_intValue.m_pValue[loWord + word + 1] : 0;
+            (loWord + word + 1) < numSrcWords ? getWords()[loWord + word + 1] : 0;
       destPtr[word] = (w0 >> loBit) | (w1 << (APINT_BITS_PER_WORD - loBit));
    }
    return result.clearUnusedBits();
@@ -533,7 +747,7 @@ HashCode hash_value(const ApInt &arg)
    if (arg.isSingleWord()) {
       return hash_combine(arg.m_intValue.m_value);
    }
-   return hash_combine_range(arg.m_intValue.m_pValue, arg.m_intValue.m_pValue + arg.getNumWords());
+   return hash_combine_range(arg.getWords(), arg.getWords() + arg.getNumWords());
 }
 
 bool ApInt::isSplat(unsigned splatSizeInBits) const
@@ -574,7 +788,7 @@ unsigned ApInt::countLeadingZerosSlowCase() const
 {
    unsigned count = 0;
    for (int i = getNumWords()-1; i >= 0; --i) {
-      uint64_t value = m_intValue.m_pValue[i];
+      uint64_t value = getWords()[i];
       if (value == 0) {
          count += APINT_BITS_PER_WORD;
       } else {
@@ -599,13 +813,13 @@ unsigned ApInt::countLeadingOnesSlowCase() const
       shift = APINT_BITS_PER_WORD - highWordBits;
    }
    int i = getNumWords() - 1;
-   unsigned count = count_leading_ones(m_intValue.m_pValue[i] << shift);
+   unsigned count = count_leading_ones(getWords()[i] << shift);
    if (count == highWordBits) {
       for (i--; i >= 0; --i) {
-         if (m_intValue.m_pValue[i] == WORDTYPE_MAX) {
+         if (getWords()[i] == WORDTYPE_MAX) {
             count += APINT_BITS_PER_WORD;
          } else {
-            count += count_leading_ones(m_intValue.m_pValue[i]);
+            count += count_leading_ones(getWords()[i]);
             break;
          }
       }
@@ -617,11 +831,11 @@ unsigned ApInt::countTrailingZerosSlowCase() const
 {
    unsigned count = 0;
    unsigned i = 0;
-   for (; i < getNumWords() && m_intValue.m_pValue[i] == 0; ++i) {
+   for (; i < getNumWords() && getWords()[i] == 0; ++i) {
       count += APINT_BITS_PER_WORD;
    }
    if (i < getNumWords()) {
-      count += count_trailing_zeros(m_intValue.m_pValue[i]);
+      count += count_trailing_zeros(getWords()[i]);
    }
    return std::min(count, m_bitWidth);
 }
@@ -630,11 +844,11 @@ unsigned ApInt::countTrailingOnesSlowCase() const
 {
    unsigned count = 0;
    unsigned i = 0;
-   for (; i < getNumWords() && m_intValue.m_pValue[i] == WORDTYPE_MAX; ++i) {
+   for (; i < getNumWords() && getWords()[i] == WORDTYPE_MAX; ++i) {
       count += APINT_BITS_PER_WORD;
    }
    if (i < getNumWords()) {
-      count += count_trailing_ones(m_intValue.m_pValue[i]);
+      count += count_trailing_ones(getWords()[i]);
    }
    assert(count <= m_bitWidth);
    return count;
@@ -644,7 +858,7 @@ unsigned ApInt::countPopulationSlowCase() const
 {
    unsigned count = 0;
    for (unsigned i = 0; i < getNumWords(); ++i) {
-      count += count_population(m_intValue.m_pValue[i]);
+      count += count_population(getWords()[i]);
    }
    return count;
 }
@@ -652,7 +866,7 @@ unsigned ApInt::countPopulationSlowCase() const
 bool ApInt::intersectsSlowCase(const ApInt &other) const
 {
    for (unsigned i = 0, e = getNumWords(); i != e; ++i) {
-      if ((m_intValue.m_pValue[i] & other.m_intValue.m_pValue[i]) != 0) {
+      if ((getWords()[i] & other.getWords()[i]) != 0) {
          return true;
       }
    }
@@ -662,7 +876,7 @@ bool ApInt::intersectsSlowCase(const ApInt &other) const
 bool ApInt::isSubsetOfSlowCase(const ApInt &other) const
 {
    for (unsigned i = 0, e = getNumWords(); i != e; ++i) {
-      if ((m_intValue.m_pValue[i] & ~other.m_intValue.m_pValue[i]) != 0) {
+      if ((getWords()[i] & ~other.getWords()[i]) != 0) {
          return false;
       }
    }
@@ -690,7 +904,7 @@ ApInt ApInt::byteSwap() const
    }
    ApInt result(getNumWords() * APINT_BITS_PER_WORD, 0);
    for (unsigned index = 0, num = getNumWords(); index != num; ++index) {
-      result.m_intValue.m_pValue[index] = byte_swap64(m_intValue.m_pValue[num - index - 1]);
+      result.getWords()[index] = byte_swap64(getWords()[num - index - 1]);
    }
    if (result.m_bitWidth != m_bitWidth) {
       result.lshrInPlace(result.m_bitWidth - m_bitWidth);
@@ -840,13 +1054,13 @@ double ApInt::roundToDouble(bool isSigned) const
    uint64_t mantissa;
    unsigned hiWord = whichWord(n-1);
    if (hiWord == 0) {
-      mantissa = temp.m_intValue.m_pValue[0];
+      mantissa = temp.getWords()[0];
       if (n > 52)
          mantissa >>= n - 52; // shift down, we want the top 52 bits.
    } else {
       assert(hiWord > 0 && "huh?");
-      uint64_t hibits = temp.m_intValue.m_pValue[hiWord] << (52 - n % APINT_BITS_PER_WORD);
-      uint64_t lobits = temp.m_intValue.m_pValue[hiWord-1] >> (11 + n % APINT_BITS_PER_WORD);
+      uint64_t hibits = temp.getWords()[hiWord] << (52 - n % APINT_BITS_PER_WORD);
+      uint64_t lobits = temp.getWords()[hiWord-1] >> (11 + n % APINT_BITS_PER_WORD);
       mantissa = hibits | lobits;
    }
    // The leading bit of mantissa is implicit, so get rid of it.
@@ -864,16 +1078,16 @@ ApInt ApInt::trunc(unsigned width) const
    if (width <= APINT_BITS_PER_WORD) {
       return ApInt(width, getRawData()[0]);
    }
-   ApInt result(get_memory(getNumWords(width)), width);
+   ApInt result(width, UninitializedTag());
    // Copy full words.
    unsigned i;
    for (i = 0; i != width / APINT_BITS_PER_WORD; i++) {
-      result.m_intValue.m_pValue[i] = m_intValue.m_pValue[i];
+      result.getWords()[i] = getWords()[i];
    }
    // Truncate and copy any partial word.
    unsigned bits = (0 - width) % APINT_BITS_PER_WORD;
    if (bits != 0) {
-      result.m_intValue.m_pValue[i] = m_intValue.m_pValue[i] << bits >> bits;
+      result.getWords()[i] = getWords()[i] << bits >> bits;
    }
    return result;
 }
@@ -885,15 +1099,15 @@ ApInt ApInt::sext(unsigned width) const
    if (width <= APINT_BITS_PER_WORD) {
       return ApInt(width, sign_extend64(m_intValue.m_value, m_bitWidth));
    }
-   ApInt result(get_memory(getNumWords(width)), width);
+   ApInt result(width, UninitializedTag());
    // Copy words.
-   std::memcpy(result.m_intValue.m_pValue, getRawData(), getNumWords() * APINT_WORD_SIZE);
+   std::memcpy(result.getWords(), getRawData(), getNumWords() * APINT_WORD_SIZE);
    // Sign extend the last word since there may be unused bits in the input.
-   result.m_intValue.m_pValue[getNumWords() - 1] =
-         sign_extend64(result.m_intValue.m_pValue[getNumWords() - 1],
+   result.getWords()[getNumWords() - 1] =
+         sign_extend64(result.getWords()[getNumWords() - 1],
          ((m_bitWidth - 1) % APINT_BITS_PER_WORD) + 1);
    // Fill with sign bits.
-   std::memset(result.m_intValue.m_pValue + getNumWords(), isNegative() ? -1 : 0,
+   std::memset(result.getWords() + getNumWords(), isNegative() ? -1 : 0,
                (result.getNumWords() - getNumWords()) * APINT_WORD_SIZE);
    result.clearUnusedBits();
    return result;
@@ -906,11 +1120,11 @@ ApInt ApInt::zext(unsigned width) const
    if (width <= APINT_BITS_PER_WORD) {
       return ApInt(width, m_intValue.m_value);
    }
-   ApInt result(get_memory(getNumWords(width)), width);
+   ApInt result(width, UninitializedTag());
    // Copy words.
-   std::memcpy(result.m_intValue.m_pValue, getRawData(), getNumWords() * APINT_WORD_SIZE);
+   std::memcpy(result.getWords(), getRawData(), getNumWords() * APINT_WORD_SIZE);
    // Zero remaining words.
-   std::memset(result.m_intValue.m_pValue + getNumWords(), 0,
+   std::memset(result.getWords() + getNumWords(), 0,
                (result.getNumWords() - getNumWords()) * APINT_WORD_SIZE);
    return result;
 }
@@ -976,25 +1190,25 @@ void ApInt::ashrSlowCase(unsigned shiftAmt)
    unsigned wordsToMove = getNumWords() - wordShift;
    if (wordsToMove != 0) {
       // Sign extend the last word to fill in the unused bits.
-      m_intValue.m_pValue[getNumWords() - 1] = sign_extend64(
-               m_intValue.m_pValue[getNumWords() - 1], ((m_bitWidth - 1) % APINT_BITS_PER_WORD) + 1);
+      getWords()[getNumWords() - 1] = sign_extend64(
+               getWords()[getNumWords() - 1], ((m_bitWidth - 1) % APINT_BITS_PER_WORD) + 1);
       // Fastpath for moving by whole words.
       if (bitShift == 0) {
-         std::memmove(m_intValue.m_pValue, m_intValue.m_pValue + wordShift, wordsToMove * APINT_WORD_SIZE);
+         std::memmove(getWords(), getWords() + wordShift, wordsToMove * APINT_WORD_SIZE);
       } else {
          // Move the words containing significant bits.
          for (unsigned i = 0; i != wordsToMove - 1; ++i)
-            m_intValue.m_pValue[i] = (m_intValue.m_pValue[i + wordShift] >> bitShift) |
-                  (m_intValue.m_pValue[i + wordShift + 1] << (APINT_BITS_PER_WORD - bitShift));
+            getWords()[i] = (getWords()[i + wordShift] >> bitShift) |
+                  (getWords()[i + wordShift + 1] << (APINT_BITS_PER_WORD - bitShift));
          // Handle the last word which has no high bits to copy.
-         m_intValue.m_pValue[wordsToMove - 1] = m_intValue.m_pValue[wordShift + wordsToMove - 1] >> bitShift;
+         getWords()[wordsToMove - 1] = getWords()[wordShift + wordsToMove - 1] >> bitShift;
          // Sign extend one more time.
-         m_intValue.m_pValue[wordsToMove - 1] =
-               sign_extend64(m_intValue.m_pValue[wordsToMove - 1], APINT_BITS_PER_WORD - bitShift);
+         getWords()[wordsToMove - 1] =
+               sign_extend64(getWords()[wordsToMove - 1], APINT_BITS_PER_WORD - bitShift);
       }
    }
    // Fill in the remainder based on the original sign.
-   std::memset(m_intValue.m_pValue + wordsToMove, negative ? -1 : 0,
+   std::memset(getWords() + wordsToMove, negative ? -1 : 0,
                wordShift * APINT_WORD_SIZE);
    clearUnusedBits();
 }
@@ -1010,7 +1224,7 @@ void ApInt::lshrInPlace(const ApInt &shiftAmt)
 /// @brief Logical right-shift function.
 void ApInt::lshrSlowCase(unsigned shiftAmt)
 {
-   tcShiftRight(m_intValue.m_pValue, getNumWords(), shiftAmt);
+   tcShiftRight(getWords(), getNumWords(), shiftAmt);
 }
 
 /// Left-shift this ApInt by shiftAmt.
@@ -1024,7 +1238,7 @@ ApInt &ApInt::operator<<=(const ApInt &shiftAmt)
 
 void ApInt::shlSlowCase(unsigned shiftAmt)
 {
-   tcShiftLeft(m_intValue.m_pValue, getNumWords(), shiftAmt);
+   tcShiftLeft(getWords(), getNumWords(), shiftAmt);
    clearUnusedBits();
 }
 
@@ -1095,7 +1309,7 @@ ApInt ApInt::sqrt() const
          /* 21-30 */ 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
          /*    31 */ 6
       };
-      return ApInt(m_bitWidth, results[ (isSingleWord() ? m_intValue.m_value : m_intValue.m_pValue[0]) ]);
+      return ApInt(m_bitWidth, results[ (isSingleWord() ? m_intValue.m_value : getWords()[0]) ]);
    }
    // If the magnitude of the value fits in less than 52 bits (the precision of
    // an IEEE double precision floating point value), then we can use the
@@ -1104,7 +1318,7 @@ ApInt ApInt::sqrt() const
    if (magnitude < 52) {
       return ApInt(m_bitWidth,
                    uint64_t(::round(::sqrt(double(isSingleWord() ? m_intValue.m_value
-                                                                 : m_intValue.m_pValue[0])))));
+                                                                 : getWords()[0])))));
    }
    // Okay, all the short cuts are exhausted. We must compute it. The following
    // is a classical Babylonian method for computing the square root. This code
@@ -1596,11 +1810,18 @@ ApInt ApInt::udiv(const ApInt &other) const
    }
    if (lhsWords == 1) {// rhsWords is 1 if lhsWords is 1.
       // All high words are zero, just use native divide
-      return ApInt(m_bitWidth, this->m_intValue.m_pValue[0] / other.m_intValue.m_pValue[0]);
+      return ApInt(m_bitWidth, this->getWords()[0] / other.getWords()[0]);
    }
+#if defined(__SIZEOF_INT128__)
+   if (lhsWords == 2) {
+      uint64_t quotient[2];
+      store_uint128(quotient, load_uint128(getWords()) / load_uint128(other.getWords()));
+      return ApInt(m_bitWidth, quotient);
+   }
+#endif
    // We have to compute it the hard way. Invoke the Knuth divide algorithm.
    ApInt quotient(m_bitWidth, 0); // to hold result.
-   divide(m_intValue.m_pValue, lhsWords, other.m_intValue.m_pValue, rhsWords, quotient.m_intValue.m_pValue, nullptr);
+   divide(getWords(), lhsWords, other.getWords(), rhsWords, quotient.getWords(), nullptr);
    return quotient;
 }
 
@@ -1632,11 +1853,11 @@ ApInt ApInt::udiv(uint64_t other) const
    }
    if (lhsWords == 1) { // rhsWords is 1 if lhsWords is 1.
       // All high words are zero, just use native divide
-      return ApInt(m_bitWidth, this->m_intValue.m_pValue[0] / other);
+      return ApInt(m_bitWidth, this->getWords()[0] / other);
    }
    // We have to compute it the hard way. Invoke the Knuth divide algorithm.
    ApInt quotient(m_bitWidth, 0); // to hold result.
-   divide(m_intValue.m_pValue, lhsWords, &other, 1, quotient.m_intValue.m_pValue, nullptr);
+   divide(getWords(), lhsWords, &other, 1, quotient.getWords(), nullptr);
    return quotient;
 }
 
@@ -1700,11 +1921,18 @@ ApInt ApInt::urem(const ApInt &other) const
    }
    if (lhsWords == 1) {
       // All high words are zero, just use native remainder
-      return ApInt(m_bitWidth, m_intValue.m_pValue[0] % other.m_intValue.m_pValue[0]);
+      return ApInt(m_bitWidth, getWords()[0] % other.getWords()[0]);
+   }
+#if defined(__SIZEOF_INT128__)
+   if (lhsWords == 2) {
+      uint64_t remainder[2];
+      store_uint128(remainder, load_uint128(getWords()) % load_uint128(other.getWords()));
+      return ApInt(m_bitWidth, remainder);
    }
+#endif
    // We have to compute it the hard way. Invoke the Knuth divide algorithm.
    ApInt remainder(m_bitWidth, 0);
-   divide(m_intValue.m_pValue, lhsWords, other.m_intValue.m_pValue, rhsWords, nullptr, remainder.m_intValue.m_pValue);
+   divide(getWords(), lhsWords, other.getWords(), rhsWords, nullptr, remainder.getWords());
    return remainder;
 }
 
@@ -1735,11 +1963,11 @@ uint64_t ApInt::urem(uint64_t rhs) const
    }
    if (lhsWords == 1) {
       // All high words are zero, just use native remainder
-      return m_intValue.m_pValue[0] % rhs;
+      return getWords()[0] % rhs;
    }
    // We have to compute it the hard way. Invoke the Knuth divide algorithm.
    uint64_t remainder;
-   divide(m_intValue.m_pValue, lhsWords, &rhs, 1, nullptr, &remainder);
+   divide(getWords(), lhsWords, &rhs, 1, nullptr, &remainder);
    return remainder;
 }
 
@@ -1818,19 +2046,32 @@ void ApInt::udivrem(const ApInt &lhs, const ApInt &rhs,
    remainder.reallocate(bitWidth);
    if (lhsWords == 1) { // rhsWords is 1 if lhsWords is 1.
       // There is only one word to consider so use the native versions.
-      uint64_t lhsValue = lhs.m_intValue.m_pValue[0];
-      uint64_t rhsValue = rhs.m_intValue.m_pValue[0];
+      uint64_t lhsValue = lhs.getWords()[0];
+      uint64_t rhsValue = rhs.getWords()[0];
       quotient = lhsValue / rhsValue;
       remainder = lhsValue % rhsValue;
       return;
    }
+#if defined(__SIZEOF_INT128__)
+   if (lhsWords == 2) {
+      UInt128 lhsValue = load_uint128(lhs.getWords());
+      UInt128 rhsValue = load_uint128(rhs.getWords());
+      uint64_t quotientWords[2];
+      uint64_t remainderWords[2];
+      store_uint128(quotientWords, lhsValue / rhsValue);
+      store_uint128(remainderWords, lhsValue % rhsValue);
+      quotient = ApInt(bitWidth, quotientWords);
+      remainder = ApInt(bitWidth, remainderWords);
+      return;
+   }
+#endif
    // Okay, lets do it the long way
-   divide(lhs.m_intValue.m_pValue, lhsWords, rhs.m_intValue.m_pValue, rhsWords, quotient.m_intValue.m_pValue,
-          remainder.m_intValue.m_pValue);
+   divide(lhs.getWords(), lhsWords, rhs.getWords(), rhsWords, quotient.getWords(),
+          remainder.getWords());
    // Clear the rest of the quotient and remainder.
-   std::memset(quotient.m_intValue.m_pValue + lhsWords, 0,
+   std::memset(quotient.getWords() + lhsWords, 0,
                (getNumWords(bitWidth) - lhsWords) * APINT_WORD_SIZE);
-   std::memset(remainder.m_intValue.m_pValue + rhsWords, 0,
+   std::memset(remainder.getWords() + rhsWords, 0,
                (getNumWords(bitWidth) - rhsWords) * APINT_WORD_SIZE);
 }
 
@@ -1873,15 +2114,15 @@ void ApInt::udivrem(const ApInt &lhs, uint64_t rhs, ApInt &quotient,
    quotient.reallocate(bitWidth);
    if (lhsWords == 1) { // rhsWords is 1 if lhsWords is 1.
       // There is only one word to consider so use the native versions.
-      uint64_t lhsValue = lhs.m_intValue.m_pValue[0];
+      uint64_t lhsValue = lhs.getWords()[0];
       quotient = lhsValue / rhs;
       remainder = lhsValue % rhs;
       return;
    }
    // Okay, lets do it the long way
-   divide(lhs.m_intValue.m_pValue, lhsWords, &rhs, 1, quotient.m_intValue.m_pValue, &remainder);
+   divide(lhs.getWords(), lhsWords, &rhs, 1, quotient.getWords(), &remainder);
    // Clear the rest of the quotient.
-   std::memset(quotient.m_intValue.m_pValue + lhsWords, 0,
+   std::memset(quotient.getWords() + lhsWords, 0,
                (getNumWords(bitWidth) - lhsWords) * APINT_WORD_SIZE);
 }
 
@@ -2083,25 +2324,36 @@ void ApInt::fromString(unsigned numbits, StringRef str, uint8_t radix)
    // Allocate memory if needed
    if (isSingleWord()) {
       m_intValue.m_value = 0;
+   } else if (isInline()) {
+      memset(m_intValue.m_inlineValues, 0, sizeof(m_intValue.m_inlineValues));
    } else {
       m_intValue.m_pValue = get_cleared_memory(getNumWords());
    }
+   StringRef digits(p, str.end() - p);
    // Figure out if we can shift instead of multiply
    unsigned shift = (radix == 16 ? 4 : radix == 8 ? 3 : radix == 2 ? 1 : 0);
-   // Enter digit traversal loop
-   for (StringRef::iterator e = str.end(); p != e; ++p) {
-      unsigned digit = get_digit(*p, radix);
-      assert(digit < radix && "Invalid character in digit string");
-      // Shift or multiply the value by the radix
-      if (slen > 1) {
-         if (shift) {
-            *this <<= shift;
-         } else {
-            *this *= radix;
+   if (shift) {
+      // Every digit is a group of bits, set them from the last digit on.
+      uint64_t *words = isSingleWord() ? &m_intValue.m_value : getWords();
+      unsigned numWords = getNumWords();
+      unsigned bitPosition = 0;
+      for (size_t i = digits.size(); i-- > 0; bitPosition += shift) {
+         unsigned digit = get_digit(digits[i], radix);
+         assert(digit < radix && "Invalid character in digit string");
+         unsigned word = whichWord(bitPosition);
+         if (word >= numWords) {
+            break;
+         }
+         unsigned offset = whichBit(bitPosition);
+         words[word] |= uint64_t(digit) << offset;
+         if (offset + shift > APINT_BITS_PER_WORD && word + 1 < numWords) {
+            words[word + 1] |= uint64_t(digit) >> (APINT_BITS_PER_WORD - offset);
          }
       }
-      // Add in the digit we just interpreted
-      *this += digit;
+      clearUnusedBits();
+   } else {
+      RadixPowers powers(radix);
+      *this = parse_radix_digits(digits, powers).zextOrTrunc(numbits);
    }
    // If its negative, put it in two's complement form
    if (isNeg) {
@@ -2189,21 +2441,26 @@ void ApInt::toString(SmallVectorImpl<char> &str, unsigned radix,
    // because the number of bits per digit (1, 3 and 4 respectively) divides
    // equally.  We just shift until the value is zero.
    if (radix == 2 || radix == 8 || radix == 16) {
-      // Just shift tmp right for each digit width until it becomes zero
+      // Every digit is a group of bits, read them from the lowest on.
       unsigned shiftAmt = (radix == 16 ? 4 : (radix == 8 ? 3 : 1));
       unsigned maskAmt = radix - 1;
-      while (temp.getBoolValue()) {
-         unsigned digit = unsigned(temp.getRawData()[0]) & maskAmt;
-         str.push_back(digits[digit]);
-         temp.lshrInPlace(shiftAmt);
+      const uint64_t *words = temp.getRawData();
+      unsigned numWords = temp.getNumWords();
+      unsigned activeBits = temp.getActiveBits();
+      for (unsigned bitPosition = 0; bitPosition < activeBits; bitPosition += shiftAmt) {
+         unsigned word = whichWord(bitPosition);
+         unsigned offset = whichBit(bitPosition);
+         uint64_t digit = words[word] >> offset;
+         if (offset + shiftAmt > APINT_BITS_PER_WORD && word + 1 < numWords) {
+            digit |= words[word + 1] << (APINT_BITS_PER_WORD - offset);
+         }
+         str.push_back(digits[digit & maskAmt]);
       }
    } else {
-      while (temp.getBoolValue()) {
-         uint64_t digit;
-         udivrem(temp, radix, temp, digit);
-         assert(digit < radix && "divide failed");
-         str.push_back(digits[digit]);
-      }
+      // Divide off as many digits as fit a word at a time, and split large
+      // values in halves first.
+      RadixPowers powers(radix);
+      append_radix_digits(str, temp, powers, 0);
    }
    // Reverse the digits before returning.
    std::reverse(str.begin()+startDig, str.end());
@@ -2277,6 +2534,81 @@ unsigned part_lsb(ApInt::WordType value)
 {
    return find_first_set(value, ZeroBehavior::ZB_Max);
 }
+
+/// dst[0, lhsParts + rhsParts) = lhs * rhs with the schoolbook method.
+void schoolbook_multiply(ApInt::WordType *dst, const ApInt::WordType *lhs, unsigned lhsParts,
+                         const ApInt::WordType *rhs, unsigned rhsParts)
+{
+   ApInt::tcSet(dst, 0, rhsParts);
+   for (unsigned i = 0; i < lhsParts; i++) {
+      ApInt::tcMultiplyPart(&dst[i], rhs, lhs[i], 0, rhsParts, rhsParts + 1, true);
+   }
+}
+
+/// The scratch words karatsuba_multiply() needs for operands of \p parts
+/// words.
+unsigned karatsuba_scratch_size(unsigned parts)
+{
+   if (parts < sg_karatsubaThreshold) {
+      return 0;
+   }
+   unsigned high = parts - parts / 2;
+   return 4 * (high + 1) + karatsuba_scratch_size(high + 1);
+}
+
+/// dst[0, 2 * parts) = lhs * rhs, where both operands have \p parts words.
+///
+/// With the operands split into halves, lhs = lhsHigh * B + lhsLow and
+/// rhs = rhsHigh * B + rhsLow, the product is
+///
+///   high * B^2 + (middle - high - low) * B + low
+///
+/// where low = lhsLow * rhsLow, high = lhsHigh * rhsHigh and
+/// middle = (lhsLow + lhsHigh) * (rhsLow + rhsHigh), three multiplications of
+/// half the size instead of four.
+void karatsuba_multiply(ApInt::WordType *dst, const ApInt::WordType *lhs,
+                        const ApInt::WordType *rhs, unsigned parts,
+                        ApInt::WordType *scratch)
+{
+   if (parts < sg_karatsubaThreshold) {
+      schoolbook_multiply(dst, lhs, parts, rhs, parts);
+      return;
+   }
+   unsigned lowParts = parts / 2;
+   unsigned highParts = parts - lowParts;
+   karatsuba_multiply(dst, lhs, rhs, lowParts, scratch);
+   karatsuba_multiply(dst + 2 * lowParts, lhs + lowParts, rhs + lowParts, highParts, scratch);
+
+   ApInt::WordType *lhsSum = scratch;
+   ApInt::WordType *rhsSum = lhsSum + highParts + 1;
+   ApInt::WordType *middle = rhsSum + highParts + 1;
+   unsigned middleParts = 2 * (highParts + 1);
+   auto add_halves = [lowParts, highParts](ApInt::WordType *sum, const ApInt::WordType *operand) {
+      ApInt::tcAssign(sum, operand + lowParts, highParts);
+      sum[highParts] = 0;
+      if (ApInt::tcAdd(sum, operand, 0, lowParts)) {
+         ApInt::tcAddPart(sum + lowParts, 1, highParts + 1 - lowParts);
+      }
+   };
+   add_halves(lhsSum, lhs);
+   add_halves(rhsSum, rhs);
+   karatsuba_multiply(middle, lhsSum, rhsSum, highParts + 1, middle + middleParts);
+
+   // The subtractions cannot borrow out of middle, it is at least low + high.
+   if (ApInt::tcSubtract(middle, dst, 0, 2 * lowParts)) {
+      ApInt::tcSubtractPart(middle + 2 * lowParts, 1, middleParts - 2 * lowParts);
+   }
+   if (ApInt::tcSubtract(middle, dst + 2 * lowParts, 0, 2 * highParts)) {
+      ApInt::tcSubtractPart(middle + 2 * highParts, 1, middleParts - 2 * highParts);
+   }
+   // The top words of middle are zero where they would reach past dst.
+   unsigned addParts = std::min(middleParts, 2 * parts - lowParts);
+   assert((addParts == middleParts || ApInt::tcIsZero(middle + addParts, middleParts - addParts)) &&
+          "Karatsuba product too wide");
+   if (ApInt::tcAdd(dst + lowParts, middle, 0, addParts) && lowParts + addParts < 2 * parts) {
+      ApInt::tcAddPart(dst + lowParts + addParts, 1, 2 * parts - lowParts - addParts);
+   }
+}
 } // anonymous namespace
 
 /* Sets the least significant part of a bignum to the input value, and
@@ -2494,6 +2826,12 @@ int ApInt::tcMultiplyPart(WordType *dst, const WordType *src,
          (n - 1) * (n - 1) + 2 (n - 1) = (n - 1) * (n + 1)
          which is less than n^2.  */
       srcPart = src[i];
+#if defined(__SIZEOF_INT128__)
+      (void) mid;
+      UInt128 product = UInt128(srcPart) * multiplier + carry;
+      low = WordType(product);
+      high = WordType(product >> APINT_BITS_PER_WORD);
+#else
       if (multiplier == 0 || srcPart == 0) {
          low = carry;
          high = 0;
@@ -2519,6 +2857,7 @@ int ApInt::tcMultiplyPart(WordType *dst, const WordType *src,
          }
          low += carry;
       }
+#endif
       if (add) {
          /* And now DST[i], and store the new low part there.  */
          if (low + dst[i] < low) {
@@ -2581,9 +2920,26 @@ void ApInt::tcFullMultiply(WordType *dst, const WordType *lhs,
       return tcFullMultiply (dst, rhs, lhs, rhsParts, lhsParts);
    }
    assert(dst != lhs && dst != rhs);
-   tcSet(dst, 0, rhsParts);
-   for (unsigned i = 0; i < lhsParts; i++) {
-      tcMultiplyPart(&dst[i], rhs, lhs[i], 0, rhsParts, rhsParts + 1, true);
+   if (lhsParts < sg_karatsubaThreshold) {
+      schoolbook_multiply(dst, lhs, lhsParts, rhs, rhsParts);
+      return;
+   }
+   // Multiply lhs by pieces of rhs as long as lhs, the last one may be
+   // shorter, and add up the products.
+   SmallVector<WordType, 256> scratch(2 * lhsParts + karatsuba_scratch_size(lhsParts));
+   WordType *product = scratch.getData();
+   tcSet(dst, 0, lhsParts + rhsParts);
+   for (unsigned offset = 0; offset < rhsParts; offset += lhsParts) {
+      unsigned pieceParts = std::min(lhsParts, rhsParts - offset);
+      if (pieceParts == lhsParts) {
+         karatsuba_multiply(product, lhs, rhs + offset, lhsParts, product + 2 * lhsParts);
+      } else {
+         tcFullMultiply(product, lhs, rhs + offset, lhsParts, pieceParts);
+      }
+      unsigned productParts = lhsParts + pieceParts;
+      if (tcAdd(dst + offset, product, 0, productParts)) {
+         tcAddPart(dst + offset + productParts, 1, rhsParts - offset - pieceParts);
+      }
    }
 }
 
@@ -0,0 +1,247 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "polarphp/basic/adt/BitVectorKernels.h"
+
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define POLAR_BIT_VECTOR_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace polar::basic::internal {
+
+namespace {
+
+// The generic kernels are plain loops, which the compiler vectorizes for the
+// baseline instruction set, SSE2 on x86-64.
+
+bool generic_or(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   BitVectorWord changed = 0;
+   for (size_t i = 0; i != count; ++i) {
+      changed |= src[i] & ~dest[i];
+      dest[i] |= src[i];
+   }
+   return changed != 0;
+}
+
+bool generic_and(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   BitVectorWord changed = 0;
+   for (size_t i = 0; i != count; ++i) {
+      changed |= dest[i] & ~src[i];
+      dest[i] &= src[i];
+   }
+   return changed != 0;
+}
+
+bool generic_and_not(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   BitVectorWord changed = 0;
+   for (size_t i = 0; i != count; ++i) {
+      changed |= dest[i] & src[i];
+      dest[i] &= ~src[i];
+   }
+   return changed != 0;
+}
+
+void generic_xor(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   for (size_t i = 0; i != count; ++i) {
+      dest[i] ^= src[i];
+   }
+}
+
+size_t generic_count_population(const BitVectorWord *words, size_t count)
+{
+   size_t numBits = 0;
+   for (size_t i = 0; i != count; ++i) {
+      numBits += polar::utils::count_population(words[i]);
+   }
+   return numBits;
+}
+
+size_t generic_find_non_zero(const BitVectorWord *words, size_t count)
+{
+   size_t i = 0;
+   // Test a cache line's worth of words at a time.
+   for (; i + 8 <= count; i += 8) {
+      if ((words[i] | words[i + 1] | words[i + 2] | words[i + 3] |
+           words[i + 4] | words[i + 5] | words[i + 6] | words[i + 7]) != 0) {
+         break;
+      }
+   }
+   while (i != count && words[i] == 0) {
+      ++i;
+   }
+   return i;
+}
+
+const BitVectorKernels sg_genericKernels = {
+   generic_or,
+   generic_and,
+   generic_and_not,
+   generic_xor,
+   generic_count_population,
+   generic_find_non_zero
+};
+
+#ifdef POLAR_BIT_VECTOR_X86_KERNELS
+
+constexpr size_t sg_wordsPerVector = sizeof(__m256i) / sizeof(BitVectorWord);
+
+#define POLAR_AVX2 __attribute__((target("avx2")))
+
+POLAR_AVX2 inline __m256i load_vector(const BitVectorWord *words)
+{
+   return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words));
+}
+
+POLAR_AVX2 inline void store_vector(BitVectorWord *words, __m256i value)
+{
+   _mm256_storeu_si256(reinterpret_cast<__m256i *>(words), value);
+}
+
+POLAR_AVX2 bool avx2_or(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   __m256i changed = _mm256_setzero_si256();
+   size_t i = 0;
+   for (; i + sg_wordsPerVector <= count; i += sg_wordsPerVector) {
+      __m256i lhs = load_vector(dest + i);
+      __m256i rhs = load_vector(src + i);
+      changed = _mm256_or_si256(changed, _mm256_andnot_si256(lhs, rhs));
+      store_vector(dest + i, _mm256_or_si256(lhs, rhs));
+   }
+   bool tailChanged = generic_or(dest + i, src + i, count - i);
+   return tailChanged || !_mm256_testz_si256(changed, changed);
+}
+
+POLAR_AVX2 bool avx2_and(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   __m256i changed = _mm256_setzero_si256();
+   size_t i = 0;
+   for (; i + sg_wordsPerVector <= count; i += sg_wordsPerVector) {
+      __m256i lhs = load_vector(dest + i);
+      __m256i rhs = load_vector(src + i);
+      changed = _mm256_or_si256(changed, _mm256_andnot_si256(rhs, lhs));
+      store_vector(dest + i, _mm256_and_si256(lhs, rhs));
+   }
+   bool tailChanged = generic_and(dest + i, src + i, count - i);
+   return tailChanged || !_mm256_testz_si256(changed, changed);
+}
+
+POLAR_AVX2 bool avx2_and_not(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   __m256i changed = _mm256_setzero_si256();
+   size_t i = 0;
+   for (; i + sg_wordsPerVector <= count; i += sg_wordsPerVector) {
+      __m256i lhs = load_vector(dest + i);
+      __m256i rhs = load_vector(src + i);
+      changed = _mm256_or_si256(changed, _mm256_and_si256(lhs, rhs));
+      store_vector(dest + i, _mm256_andnot_si256(rhs, lhs));
+   }
+   bool tailChanged = generic_and_not(dest + i, src + i, count - i);
+   return tailChanged || !_mm256_testz_si256(changed, changed);
+}
+
+POLAR_AVX2 void avx2_xor(BitVectorWord *dest, const BitVectorWord *src, size_t count)
+{
+   size_t i = 0;
+   for (; i + sg_wordsPerVector <= count; i += sg_wordsPerVector) {
+      store_vector(dest + i, _mm256_xor_si256(load_vector(dest + i), load_vector(src + i)));
+   }
+   generic_xor(dest + i, src + i, count - i);
+}
+
+/// Counts the bits of every nibble with a table lookup and sums the bytes
+/// with vpsadbw. Each byte of the per-nibble sums grows by at most 8 per
+/// vector, so the sums are folded into the 64-bit totals every 8 vectors.
+POLAR_AVX2 size_t avx2_count_population(const BitVectorWord *words, size_t count)
+{
+   const __m256i lookup = _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+   const __m256i lowMask = _mm256_set1_epi8(0x0f);
+   __m256i totals = _mm256_setzero_si256();
+   size_t i = 0;
+   while (i + sg_wordsPerVector <= count) {
+      __m256i sums = _mm256_setzero_si256();
+      for (unsigned block = 0; block < 8 && i + sg_wordsPerVector <= count;
+           ++block, i += sg_wordsPerVector) {
+         __m256i value = load_vector(words + i);
+         __m256i low = _mm256_and_si256(value, lowMask);
+         __m256i high = _mm256_and_si256(_mm256_srli_epi16(value, 4), lowMask);
+         sums = _mm256_add_epi8(sums, _mm256_shuffle_epi8(lookup, low));
+         sums = _mm256_add_epi8(sums, _mm256_shuffle_epi8(lookup, high));
+      }
+      totals = _mm256_add_epi64(totals, _mm256_sad_epu8(sums, _mm256_setzero_si256()));
+   }
+   alignas(32) uint64_t lanes[4];
+   _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), totals);
+   size_t numBits = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+   return numBits + generic_count_population(words + i, count - i);
+}
+
+POLAR_AVX2 size_t avx2_find_non_zero(const BitVectorWord *words, size_t count)
+{
+   size_t i = 0;
+   for (; i + 4 * sg_wordsPerVector <= count; i += 4 * sg_wordsPerVector) {
+      __m256i value = _mm256_or_si256(
+               _mm256_or_si256(load_vector(words + i),
+                               load_vector(words + i + sg_wordsPerVector)),
+               _mm256_or_si256(load_vector(words + i + 2 * sg_wordsPerVector),
+                               load_vector(words + i + 3 * sg_wordsPerVector)));
+      if (!_mm256_testz_si256(value, value)) {
+         break;
+      }
+   }
+   return i + generic_find_non_zero(words + i, count - i);
+}
+
+#undef POLAR_AVX2
+
+const BitVectorKernels sg_avx2Kernels = {
+   avx2_or,
+   avx2_and,
+   avx2_and_not,
+   avx2_xor,
+   avx2_count_population,
+   avx2_find_non_zero
+};
+
+#endif // POLAR_BIT_VECTOR_X86_KERNELS
+
+const BitVectorKernels &select_kernels()
+{
+#ifdef POLAR_BIT_VECTOR_X86_KERNELS
+   if (__builtin_cpu_supports("avx2")) {
+      return sg_avx2Kernels;
+   }
+#endif
+   return sg_genericKernels;
+}
+
+} // anonymous namespace
+
+const BitVectorKernels &get_bit_vector_kernels()
+{
+   static const BitVectorKernels &kernels = select_kernels();
+   return kernels;
+}
+
+const BitVectorKernels &get_generic_bit_vector_kernels()
+{
+   return sg_genericKernels;
+}
+
+} // polar::basic::internal
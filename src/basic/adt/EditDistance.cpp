@@ -0,0 +1,206 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+//===----------------------------------------------------------------------===//
+//
+// Bit-parallel Levenshtein distance, after G. Myers, "A fast bit-vector
+// algorithm for approximate string matching based on dynamic programming",
+// JACM 46(3), 1999, and H. Hyyrö, "A bit-vector algorithm for computing
+// Levenshtein and Damerau edit distances", 2003.
+//
+// A column of the DP matrix, one cell per pattern character, is kept as the
+// vertical deltas between adjacent cells, in two bit vectors for +1 and -1.
+// Each text character advances the whole column with a handful of word
+// operations. Patterns longer than 64 characters are split into blocks of
+// 64 rows, carrying the horizontal delta of the last row of a block into the
+// next one.
+//
+//===----------------------------------------------------------------------===//
+
+#include "polarphp/basic/adt/EditDistance.h"
+
+#include <cstring>
+
+namespace polar::basic {
+
+namespace {
+
+constexpr size_t sg_blockBits = 64;
+constexpr size_t sg_alphabetSize = 256;
+
+/// Advances a 64-row block by one text character. \p match is the bit mask
+/// of the rows equal to the character and \p carryIn the horizontal delta
+/// entering the first row. Returns the horizontal delta leaving the row
+/// \p lastRow.
+inline int advance_block(uint64_t &positive, uint64_t &negative, uint64_t match,
+                         int carryIn, uint64_t lastRow)
+{
+   uint64_t vertical = match | negative;
+   if (carryIn < 0) {
+      match |= 1;
+   }
+   uint64_t horizontal = (((match & positive) + positive) ^ positive) | match;
+   uint64_t horizontalPositive = negative | ~(horizontal | positive);
+   uint64_t horizontalNegative = positive & horizontal;
+   int carryOut = 0;
+   if (horizontalPositive & lastRow) {
+      carryOut = 1;
+   } else if (horizontalNegative & lastRow) {
+      carryOut = -1;
+   }
+   horizontalPositive <<= 1;
+   horizontalNegative <<= 1;
+   if (carryIn < 0) {
+      horizontalNegative |= 1;
+   } else if (carryIn > 0) {
+      horizontalPositive |= 1;
+   }
+   positive = horizontalNegative | ~(vertical | horizontalPositive);
+   negative = horizontalPositive & vertical;
+   return carryOut;
+}
+
+inline unsigned cap_distance(size_t distance, unsigned maxEditDistance)
+{
+   if (maxEditDistance && distance > maxEditDistance) {
+      return maxEditDistance + 1;
+   }
+   return static_cast<unsigned>(distance);
+}
+
+/// The distance between a pattern of \p length characters, given by its
+/// match masks, and \p text.
+unsigned bit_parallel_distance(const uint64_t *matchMasks, size_t length, size_t blocks,
+                               StringRef text, unsigned maxEditDistance)
+{
+   size_t textLength = text.size();
+   if (length == 0 || textLength == 0) {
+      return cap_distance(length + textLength, maxEditDistance);
+   }
+   size_t lengthDifference = length > textLength ? length - textLength : textLength - length;
+   if (maxEditDistance && lengthDifference > maxEditDistance) {
+      return maxEditDistance + 1;
+   }
+   const uint8_t *chars = reinterpret_cast<const uint8_t *>(text.data());
+   uint64_t lastRow = uint64_t(1) << ((length - 1) % sg_blockBits);
+   size_t distance = length;
+   if (blocks == 1) {
+      uint64_t positive = ~uint64_t(0);
+      uint64_t negative = 0;
+      for (size_t column = 0; column != textLength; ++column) {
+         distance += advance_block(positive, negative, matchMasks[chars[column]], 1, lastRow);
+         // Each remaining column moves the distance by at most one.
+         if (maxEditDistance && distance > maxEditDistance + (textLength - column - 1)) {
+            return maxEditDistance + 1;
+         }
+      }
+      return cap_distance(distance, maxEditDistance);
+   }
+   constexpr uint64_t highRow = uint64_t(1) << (sg_blockBits - 1);
+   uint64_t smallState[2 * 4];
+   std::unique_ptr<uint64_t[]> allocated;
+   uint64_t *state = smallState;
+   if (blocks > 4) {
+      allocated.reset(new uint64_t[2 * blocks]);
+      state = allocated.get();
+   }
+   for (size_t block = 0; block != blocks; ++block) {
+      state[2 * block] = ~uint64_t(0);
+      state[2 * block + 1] = 0;
+   }
+   for (size_t column = 0; column != textLength; ++column) {
+      const uint64_t *masks = matchMasks + chars[column] * blocks;
+      int carry = 1;
+      for (size_t block = 0; block + 1 < blocks; ++block) {
+         carry = advance_block(state[2 * block], state[2 * block + 1], masks[block],
+                               carry, highRow);
+      }
+      distance += advance_block(state[2 * blocks - 2], state[2 * blocks - 1],
+                                masks[blocks - 1], carry, lastRow);
+      if (maxEditDistance && distance > maxEditDistance + (textLength - column - 1)) {
+         return maxEditDistance + 1;
+      }
+   }
+   return cap_distance(distance, maxEditDistance);
+}
+
+inline uint8_t fold_case(uint8_t c)
+{
+   return (c >= 'A' && c <= 'Z') ? c | 0x20 : c;
+}
+
+void build_match_masks(uint64_t *matchMasks, StringRef pattern, size_t blocks, bool ignoreCase)
+{
+   for (size_t i = 0, e = pattern.size(); i != e; ++i) {
+      uint8_t c = static_cast<uint8_t>(pattern[i]);
+      uint64_t bit = uint64_t(1) << (i % sg_blockBits);
+      size_t block = i / sg_blockBits;
+      matchMasks[c * blocks + block] |= bit;
+      if (ignoreCase && ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')) {
+         matchMasks[(c ^ 0x20) * blocks + block] |= bit;
+      }
+   }
+}
+
+unsigned string_edit_distance_impl(StringRef from, StringRef to, unsigned maxEditDistance,
+                                   bool ignoreCase)
+{
+   auto equal = [ignoreCase](char lhs, char rhs) {
+      return ignoreCase ? fold_case(lhs) == fold_case(rhs) : lhs == rhs;
+   };
+   // A common prefix or suffix never takes part in an optimal alignment.
+   while (!from.empty() && !to.empty() && equal(from.front(), to.front())) {
+      from = from.dropFront();
+      to = to.dropFront();
+   }
+   while (!from.empty() && !to.empty() && equal(from.back(), to.back())) {
+      from = from.dropBack();
+      to = to.dropBack();
+   }
+   // The distance is symmetric, the shorter string makes the pattern.
+   if (from.size() > to.size()) {
+      std::swap(from, to);
+   }
+   if (from.size() <= sg_blockBits) {
+      uint64_t matchMasks[sg_alphabetSize];
+      std::memset(matchMasks, 0, sizeof(matchMasks));
+      build_match_masks(matchMasks, from, 1, ignoreCase);
+      return bit_parallel_distance(matchMasks, from.size(), 1, to, maxEditDistance);
+   }
+   return LevenshteinMatcher(from, ignoreCase).getDistance(to, maxEditDistance);
+}
+
+} // anonymous namespace
+
+unsigned string_edit_distance(StringRef from, StringRef to, unsigned maxEditDistance)
+{
+   return string_edit_distance_impl(from, to, maxEditDistance, false);
+}
+
+unsigned string_edit_distance_lower(StringRef from, StringRef to, unsigned maxEditDistance)
+{
+   return string_edit_distance_impl(from, to, maxEditDistance, true);
+}
+
+LevenshteinMatcher::LevenshteinMatcher(StringRef pattern, bool ignoreCase)
+   : m_length(pattern.size()),
+     m_blocks(std::max<size_t>(1, (pattern.size() + sg_blockBits - 1) / sg_blockBits))
+{
+   m_matchMasks.reset(new uint64_t[sg_alphabetSize * m_blocks]());
+   build_match_masks(m_matchMasks.get(), pattern, m_blocks, ignoreCase);
+}
+
+unsigned LevenshteinMatcher::getDistance(StringRef text, unsigned maxEditDistance) const
+{
+   return bit_parallel_distance(m_matchMasks.get(), m_length, m_blocks, text, maxEditDistance);
+}
+
+} // polar::basic
@@ -0,0 +1,154 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "polarphp/basic/adt/EditDistanceIndex.h"
+#include "polarphp/basic/adt/EditDistance.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace polar::basic {
+
+namespace {
+
+/// One bit per character class: the letters regardless of case, the digits
+/// and '_' get a bit each, every other byte shares one of the remaining 27.
+/// Sharing a bit only weakens the bound computed from it.
+uint64_t compute_signature(StringRef str)
+{
+   uint64_t signature = 0;
+   for (char c : str) {
+      uint8_t byte = static_cast<uint8_t>(c);
+      unsigned bit;
+      if ((byte | 0x20) >= 'a' && (byte | 0x20) <= 'z') {
+         bit = (byte | 0x20) - 'a';
+      } else if (byte >= '0' && byte <= '9') {
+         bit = 26 + (byte - '0');
+      } else if (byte == '_') {
+         bit = 36;
+      } else {
+         bit = 37 + byte % 27;
+      }
+      signature |= uint64_t(1) << bit;
+   }
+   return signature;
+}
+
+/// Whether either signature has more than \p radius classes the other lacks,
+/// which puts the strings more than \p radius edits apart. Clears the lowest
+/// bit \p radius times rather than relying on a popcount instruction.
+inline bool exceeds_radius(uint64_t lhs, uint64_t rhs, unsigned radius)
+{
+   uint64_t lhsOnly = lhs & ~rhs;
+   uint64_t rhsOnly = rhs & ~lhs;
+   for (unsigned i = 0; i != radius; ++i) {
+      lhsOnly &= lhsOnly - 1;
+      rhsOnly &= rhsOnly - 1;
+   }
+   return (lhsOnly | rhsOnly) != 0;
+}
+
+bool match_less(const EditDistanceMatch &lhs, const EditDistanceMatch &rhs)
+{
+   if (lhs.distance != rhs.distance) {
+      return lhs.distance < rhs.distance;
+   }
+   return lhs.key < rhs.key;
+}
+
+} // anonymous namespace
+
+EditDistanceIndex::EditDistanceIndex(bool ignoreCase)
+   : m_ignoreCase(ignoreCase)
+{}
+
+bool EditDistanceIndex::insert(StringRef key)
+{
+   std::string folded;
+   if (m_ignoreCase) {
+      folded = key.toLower();
+   }
+   auto result = m_keys.tryEmplace(m_ignoreCase ? StringRef(folded) : key);
+   if (!result.second) {
+      return false;
+   }
+   StringRef spelling = result.first->getKey();
+   if (m_ignoreCase && spelling != key) {
+      char *copy = static_cast<char *>(m_allocator.allocate(key.size(), 1));
+      std::memcpy(copy, key.data(), key.size());
+      spelling = StringRef(copy, key.size());
+   }
+   if (m_buckets.size() <= key.size()) {
+      m_buckets.resize(key.size() + 1);
+   }
+   Bucket &bucket = m_buckets[key.size()];
+   bucket.signatures.push_back(compute_signature(key));
+   bucket.keys.push_back(spelling);
+   return true;
+}
+
+SmallVector<EditDistanceMatch, 4> EditDistanceIndex::findNearest(StringRef query,
+                                                                 unsigned maxDistance,
+                                                                 size_t limit) const
+{
+   SmallVector<EditDistanceMatch, 4> matches;
+   LevenshteinMatcher matcher(query, m_ignoreCase);
+   uint64_t querySignature = compute_signature(query);
+   unsigned radius = maxDistance;
+   auto scan_bucket = [&](const Bucket &bucket) {
+      for (size_t i = 0, e = bucket.keys.size(); i != e; ++i) {
+         if (exceeds_radius(bucket.signatures[i], querySignature, radius)) {
+            continue;
+         }
+         unsigned distance = matcher.getDistance(bucket.keys[i], radius);
+         if (distance > radius) {
+            continue;
+         }
+         matches.push_back({bucket.keys[i], distance});
+         if (limit && matches.size() >= limit) {
+            // Only keys at least as close as the limit-th match can still
+            // make the cut. Dropping the rest keeps this step O(limit) when
+            // many keys tie at the cutoff distance.
+            std::nth_element(matches.begin(), matches.begin() + (limit - 1), matches.end(),
+                             match_less);
+            matches.resize(limit);
+            radius = matches.back().distance;
+         }
+      }
+   };
+   // Lengths closest to the query's first, so that with a limit the radius
+   // shrinks before the buckets that need many edits are reached.
+   size_t length = query.size();
+   for (size_t delta = 0; delta <= radius; ++delta) {
+      if (delta <= length && length - delta < m_buckets.size()) {
+         scan_bucket(m_buckets[length - delta]);
+      }
+      if (delta != 0 && length + delta < m_buckets.size()) {
+         scan_bucket(m_buckets[length + delta]);
+      }
+   }
+   std::sort(matches.begin(), matches.end(), match_less);
+   size_t count = 0;
+   while (count != matches.size() && matches[count].distance <= radius &&
+          (!limit || count < limit)) {
+      ++count;
+   }
+   matches.resize(count);
+   return matches;
+}
+
+bool EditDistanceIndex::contains(StringRef key) const
+{
+   return m_keys.count(m_ignoreCase ? StringRef(key.toLower()) : key) != 0;
+}
+
+} // polar::basic
@@ -18,8 +18,10 @@
 
 #include "polarphp/basic/adt/StringMap.h"
 #include "polarphp/basic/adt/StringExtras.h"
+#include "polarphp/utils/FastHash.h"
 #include "polarphp/utils/MathExtras.h"
 #include <cassert>
+#include <cstring>
 
 namespace polar::basic {
 
@@ -35,8 +37,66 @@ unsigned get_min_bucket_to_reserve_for_entries(unsigned numEntries) {
    // For example if NumEntries is 48, we need to return 401.
    return polar::utils::next_power_of_two(numEntries * 4 / 3 + 1);
 }
+
+uint64_t read64(const char *data)
+{
+   uint64_t value;
+   std::memcpy(&value, data, sizeof(value));
+   return value;
+}
+
+uint64_t read32(const char *data)
+{
+   uint32_t value;
+   std::memcpy(&value, data, sizeof(value));
+   return value;
+}
+
+/// Folds the 128-bit product of \p lhs and \p rhs to 64 bits.
+uint64_t multiply_fold(uint64_t lhs, uint64_t rhs)
+{
+#if defined(__SIZEOF_INT128__)
+   __uint128_t product = static_cast<__uint128_t>(lhs) * rhs;
+   return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+   uint64_t lhsHigh = lhs >> 32;
+   uint64_t lhsLow = lhs & 0xFFFFFFFF;
+   uint64_t rhsHigh = rhs >> 32;
+   uint64_t rhsLow = rhs & 0xFFFFFFFF;
+   uint64_t cross = (lhsLow * rhsLow >> 32) + (lhsHigh * rhsLow & 0xFFFFFFFF) + lhsLow * rhsHigh;
+   uint64_t high = lhsHigh * rhsHigh + (lhsHigh * rhsLow >> 32) + (cross >> 32);
+   return (lhs * rhs) ^ high;
+#endif
+}
+
 } // anonympous namespace
 
+/// Most keys are identifiers of a few bytes, which are read with at most two
+/// overlapping loads and mixed with one wide multiplication, in the manner of
+/// wyhash. Longer keys go to xxHash.
+uint32_t StringMapImpl::hash(StringRef key)
+{
+   const char *data = key.getData();
+   size_t length = key.getSize();
+   if (length > 16) {
+      return static_cast<uint32_t>(polar::utils::fast_hash64(key));
+   }
+   uint64_t first = 0;
+   uint64_t second = 0;
+   if (length >= 8) {
+      first = read64(data);
+      second = read64(data + length - 8);
+   } else if (length >= 4) {
+      first = (read32(data) << 32) | read32(data + length - 4);
+   } else if (length > 0) {
+      first = (uint64_t(static_cast<unsigned char>(data[0])) << 16) |
+            (uint64_t(static_cast<unsigned char>(data[length >> 1])) << 8) |
+            static_cast<unsigned char>(data[length - 1]);
+   }
+   return static_cast<uint32_t>(multiply_fold(first ^ 0xA0761D6478BD642FULL,
+                                              second ^ 0xE7037ED1A0B428DBULL ^ length));
+}
+
 StringMapImpl::StringMapImpl(unsigned initSize, unsigned itemSize)
 {
    m_itemSize = itemSize;
@@ -81,14 +141,14 @@ void StringMapImpl::init(unsigned initSize)
 /// specified bucket will be non-null.  Otherwise, it will be null.  In either
 /// case, the fullHashValue field of the bucket will be set to the hash value
 /// of the string.
-unsigned StringMapImpl::lookupBucketFor(StringRef name)
+unsigned StringMapImpl::lookupBucketFor(StringRef name, uint32_t fullHashValue)
 {
+   assert(fullHashValue == hash(name) && "precomputed hash does not match the key");
    unsigned htSize = m_numBuckets;
    if (htSize == 0) {  // Hash table unallocated so far?
       init(16);
       htSize = m_numBuckets;
    }
-   unsigned fullHashValue = hash_string(name);
    unsigned bucketNo = fullHashValue & (htSize-1);
    unsigned *hashTable = (unsigned *)(m_theTable + m_numBuckets + 1);
    unsigned probeAmt = 1;
@@ -135,13 +195,13 @@ unsigned StringMapImpl::lookupBucketFor(StringRef name)
 /// FindKey - Look up the bucket that contains the specified key. If it exists
 /// in the map, return the bucket number of the key.  Otherwise return -1.
 /// This does not modify the map.
-int StringMapImpl::findKey(StringRef key) const
+int StringMapImpl::findKey(StringRef key, uint32_t fullHashValue) const
 {
+   assert(fullHashValue == hash(key) && "precomputed hash does not match the key");
    unsigned htSize = m_numBuckets;
    if (htSize == 0) {
       return -1;  // Really empty table?
    }
-   unsigned fullHashValue = hash_string(key);
    unsigned bucketNo = fullHashValue & (htSize-1);
    unsigned *hashTable = (unsigned *)(m_theTable + m_numBuckets + 1);
    unsigned probeAmt = 1;
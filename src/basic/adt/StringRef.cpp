@@ -123,6 +123,9 @@ unsigned StringRef::editDistance(StringRef other,
                                  bool allowReplacements,
                                  unsigned maxEditDistance) const
 {
+   if (allowReplacements) {
+      return string_edit_distance(*this, other, maxEditDistance);
+   }
    return compute_edit_distance(
             make_array_ref(getData(), getSize()),
             make_array_ref(other.getData(), other.getSize()),
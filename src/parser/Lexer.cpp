@@ -18,6 +18,7 @@
 #include "polarphp/basic/adt/SmallString.h"
 #include "polarphp/basic/CharInfo.h"
 #include "polarphp/syntax/Trivia.h"
+#include "polarphp/utils/ConcurrentStringInterner.h"
 #include "polarphp/utils/MathExtras.h"
 #include "polarphp/kernel/LangOptions.h"
 #include "polarphp/kernel/Exceptions.h"
@@ -75,6 +76,7 @@ Lexer::Lexer(Lexer &parent, LexerState beginState, LexerState endState)
             parent.m_bufferId, parent.m_diags, parent.m_commentRetention,
             parent.m_triviaRetention)
 {
+    m_stringInterner = parent.m_stringInterner;
     assert(m_bufferId == m_sourceMgr.findBufferContainingLoc(beginState.m_loc) &&
            "LexerState for the wrong buffer");
     assert(m_bufferId == m_sourceMgr.findBufferContainingLoc(endState.m_loc) &&
@@ -184,19 +186,27 @@ void Lexer::formToken(syntax::TokenKindType kind, const unsigned char *tokenStar
 void Lexer::formVariableToken(const unsigned char *tokenStart)
 {
     formToken(TokenKindType::T_VARIABLE, tokenStart);
-    m_nextToken.setValue(StringRef(reinterpret_cast<const char *>(tokenStart + 1), m_yyLength - 1));
+    setNameValue(StringRef(reinterpret_cast<const char *>(tokenStart + 1), m_yyLength - 1));
 }
 
 void Lexer::formIdentifierToken(const unsigned char *tokenStart)
 {
     formToken(TokenKindType::T_IDENTIFIER_STRING, tokenStart);
-    m_nextToken.setValue(StringRef(reinterpret_cast<const char *>(tokenStart), m_yyLength));
+    setNameValue(StringRef(reinterpret_cast<const char *>(tokenStart), m_yyLength));
 }
 
 void Lexer::formStringVariableToken(const unsigned char *tokenStart)
 {
     formToken(TokenKindType::T_STRING_VARNAME, tokenStart);
-    m_nextToken.setValue(StringRef(reinterpret_cast<const char *>(tokenStart), m_yyLength));
+    setNameValue(StringRef(reinterpret_cast<const char *>(tokenStart), m_yyLength));
+}
+
+void Lexer::setNameValue(StringRef name)
+{
+    m_nextToken.setValue(name);
+    if (m_stringInterner) {
+        m_nextToken.setInternedValue(m_stringInterner->intern(name));
+    }
 }
 
 void Lexer::formErrorToken(const unsigned char *tokenStart)
@@ -22,11 +22,14 @@
 
 #include "polarphp/parser/ParsedTrivia.h"
 #include "polarphp/syntax/Trivia.h"
+#include "polarphp/syntax/CompactTrivia.h"
 #include "polarphp/parser/SourceMgr.h"
 
 namespace polar::parser {
 
 using polar::syntax::TriviaPiece;
+using polar::syntax::CompactTrivia;
+using polar::syntax::CompactTriviaPiece;
 
 Trivia
 ParsedTriviaPiece::convertToSyntaxTrivia(ArrayRef<ParsedTriviaPiece> pieces,
@@ -52,4 +55,21 @@ ParsedTrivia::convertToSyntaxTrivia(SourceLoc loc, const SourceManager &sourceMg
    return ParsedTriviaPiece::convertToSyntaxTrivia(pieces, loc, sourceMgr, bufferID);
 }
 
+CompactTrivia
+ParsedTriviaPiece::convertToCompactTrivia(ArrayRef<ParsedTriviaPiece> pieces,
+                                          polar::utils::BumpPtrAllocator &allocator)
+{
+   SmallVector<CompactTriviaPiece, 4> compactPieces;
+   for (const auto &piece : pieces) {
+      compactPieces.push_back(CompactTriviaPiece{piece.getKind(), piece.getLength()});
+   }
+   return CompactTrivia::make(compactPieces, allocator);
+}
+
+CompactTrivia
+ParsedTrivia::convertToCompactTrivia(polar::utils::BumpPtrAllocator &allocator) const
+{
+   return ParsedTriviaPiece::convertToCompactTrivia(pieces, allocator);
+}
+
 } // polar::parser
@@ -47,7 +47,8 @@ bool Parser::parse()
 
 void Parser::setParsedAst(RefCountPtr<RawSyntax> ast)
 {
-   m_ast = ast;
+   // The tree keeps its source buffer resident as long as it lives.
+   m_ast = m_sourceMgr.retainBufferForSyntaxTree(m_lexer->getBufferId(), ast);
 }
 
 RefCountPtr<RawSyntax> Parser::getSyntaxTree()
@@ -26,6 +26,8 @@
 
 #include "polarphp/parser/SourceLoc.h"
 #include "polarphp/parser/SourceMgr.h"
+#include "polarphp/syntax/RawSyntax.h"
+#include "polarphp/syntax/SyntaxArena.h"
 #include "polarphp/utils/MemoryBuffer.h"
 #include "polarphp/utils/PrettyStackTrace.h"
 #include "polarphp/utils/RawOutStream.h"
@@ -34,6 +36,8 @@
 
 namespace polar::parser {
 
+using polar::fs::MappedFileRegion;
+using polar::syntax::SyntaxArena;
 using polar::utils::PrettyStackTraceString;
 using polar::utils::SMLocation;
 
@@ -88,11 +92,136 @@ SourceManager::addNewSourceBuffer(std::unique_ptr<MemoryBuffer> buffer)
 {
    assert(buffer);
    StringRef bufIdentifier = buffer->getBufferIdentifier();
+   const MemoryBuffer *bufferPtr = buffer.get();
    auto id = m_sourceMgr.addNewSourceBuffer(std::move(buffer), SMLocation());
    m_bufIdentIDMap[bufIdentifier] = id;
+   if (bufferPtr->getBufferKind() == MemoryBuffer::BufferKind::MemoryBuffer_MMap) {
+      // The lexer reads a new buffer once from front to back.
+      bufferPtr->advise(MappedFileRegion::sequential);
+      std::lock_guard<std::mutex> guard(m_residencyLock);
+      m_residentBuffers.push_front(id);
+      BufferResidency &state = m_residency[id];
+      state.buffer = bufferPtr;
+      state.lruPos = m_residentBuffers.begin();
+      m_residentBufferBytes += bufferPtr->getBufferSize();
+      evictBuffers();
+   }
    return id;
 }
 
+void SourceManager::setResidentBufferLimit(size_t bytes)
+{
+   std::lock_guard<std::mutex> guard(m_residencyLock);
+   m_residentBufferLimit.store(bytes, std::memory_order_relaxed);
+   evictBuffers();
+}
+
+size_t SourceManager::getResidentBufferBytes() const
+{
+   std::lock_guard<std::mutex> guard(m_residencyLock);
+   return m_residentBufferBytes;
+}
+
+bool SourceManager::isBufferResident(unsigned bufferID) const
+{
+   std::lock_guard<std::mutex> guard(m_residencyLock);
+   auto iter = m_residency.find(bufferID);
+   return iter == m_residency.end() || iter->second.resident;
+}
+
+void SourceManager::retainBuffer(unsigned bufferID)
+{
+   std::lock_guard<std::mutex> guard(m_residencyLock);
+   auto iter = m_residency.find(bufferID);
+   if (iter == m_residency.end()) {
+      return;
+   }
+   ++iter->second.retainCount;
+   markBufferUsed(bufferID, iter->second);
+}
+
+void SourceManager::releaseBuffer(unsigned bufferID)
+{
+   std::lock_guard<std::mutex> guard(m_residencyLock);
+   auto iter = m_residency.find(bufferID);
+   if (iter == m_residency.end()) {
+      return;
+   }
+   assert(iter->second.retainCount > 0 && "buffer released more often than retained");
+   --iter->second.retainCount;
+   evictBuffers();
+}
+
+IntrusiveRefCountPtr<RawSyntax>
+SourceManager::retainBufferForSyntaxTree(unsigned bufferID,
+                                         const IntrusiveRefCountPtr<RawSyntax> &root)
+{
+   assert(!root->isToken() && "the root of a tree is a layout node");
+   // The copy of the root is the only node in the arena, the arena and with
+   // it the retain are released when the copy is destroyed.
+   IntrusiveRefCountPtr<SyntaxArena> arena(new SyntaxArena);
+   retainBuffer(bufferID);
+   arena->addCleanup([this, bufferID]() {
+      releaseBuffer(bufferID);
+   });
+   return RawSyntax::make(root->getKind(), root->getLayout(), root->getPresence(),
+                          arena, root->getId());
+}
+
+void SourceManager::touchBuffer(unsigned bufferID) const
+{
+   // Without a limit nothing is ever dropped, so the order does not matter.
+   if (m_residentBufferLimit.load(std::memory_order_relaxed) == 0) {
+      return;
+   }
+   std::lock_guard<std::mutex> guard(m_residencyLock);
+   auto iter = m_residency.find(bufferID);
+   if (iter != m_residency.end()) {
+      markBufferUsed(bufferID, iter->second);
+   }
+}
+
+void SourceManager::markBufferUsed(unsigned bufferID, BufferResidency &state) const
+{
+   if (state.resident) {
+      m_residentBuffers.splice(m_residentBuffers.begin(), m_residentBuffers, state.lruPos);
+      return;
+   }
+   state.buffer->advise(MappedFileRegion::willneed);
+   state.resident = true;
+   m_residentBuffers.push_front(bufferID);
+   state.lruPos = m_residentBuffers.begin();
+   m_residentBufferBytes += state.buffer->getBufferSize();
+   evictBuffers();
+}
+
+void SourceManager::evictBuffers() const
+{
+   size_t limit = m_residentBufferLimit.load(std::memory_order_relaxed);
+   if (limit == 0) {
+      return;
+   }
+   // Walk from the least recently used buffer, the most recently used one is
+   // always kept because it is about to be accessed.
+   auto iter = m_residentBuffers.end();
+   while (m_residentBufferBytes > limit) {
+      --iter;
+      if (iter == m_residentBuffers.begin()) {
+         break;
+      }
+      BufferResidency &state = m_residency.find(*iter)->second;
+      if (state.retainCount > 0) {
+         continue;
+      }
+      // If the system ignores the advice the pages simply stay, the buffer
+      // is still counted as dropped so it is not tried again and again.
+      state.buffer->advise(MappedFileRegion::dontneed);
+      state.resident = false;
+      m_residentBufferBytes -= state.buffer->getBufferSize();
+      iter = m_residentBuffers.erase(iter);
+   }
+}
+
 unsigned SourceManager::addMemBufferCopy(MemoryBuffer *buffer)
 {
    return addMemBufferCopy(buffer->getBuffer(), buffer->getBufferIdentifier());
@@ -229,6 +358,7 @@ unsigned SourceManager::getByteDistance(SourceLoc start, SourceLoc end) const
 }
 
 StringRef SourceManager::getEntireTextForBuffer(unsigned bufferID) const {
+   touchBuffer(bufferID);
    return m_sourceMgr.getMemoryBuffer(bufferID)->getBuffer();
 }
 
@@ -240,6 +370,7 @@ StringRef SourceManager::extractText(CharSourceRange range,
    if (!bufferID) {
       bufferID = findBufferContainingLoc(range.getStart());
    }
+   touchBuffer(*bufferID);
    StringRef buffer = m_sourceMgr.getMemoryBuffer(*bufferID)->getBuffer();
    return buffer.substr(getLocOffsetInBuffer(range.getStart(), *bufferID),
                         range.getByteLength());
@@ -248,16 +379,9 @@ StringRef SourceManager::extractText(CharSourceRange range,
 unsigned SourceManager::findBufferContainingLoc(SourceLoc loc) const
 {
    assert(loc.isValid());
-   // Search the buffers back-to front, so later alias buffers are
-   // visited first.
-   auto less_equal = std::less_equal<const char *>();
-   for (unsigned i = m_sourceMgr.getNumBuffers(), e = 1; i >= e; --i) {
-      auto buffer = m_sourceMgr.getMemoryBuffer(i);
-      if (less_equal(buffer->getBufferStart(), loc.m_loc.getPointer()) &&
-          // Use <= here so that a pointer to the null at the end of the buffer
-          // is included as part of the buffer.
-          less_equal(loc.m_loc.getPointer(), buffer->getBufferEnd()))
-         return i;
+   // Prefer the buffer added last, so later alias buffers win.
+   if (unsigned bufferID = m_sourceMgr.findLastBufferContainingLoc(loc.m_loc)) {
+      return bufferID;
    }
    polar_unreachable("no buffer containing location found");
 }
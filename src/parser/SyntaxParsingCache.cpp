@@ -83,25 +83,34 @@ std::optional<Syntax> SyntaxParsingCache::lookUpFrom(const Syntax &node,
                                                      size_t position,
                                                      SyntaxKind kind)
 {
-   if (nodeCanBeReused(node, nodeStart, position, kind)) {
-      return node;
-   }
-
-   // Compute the child's position on the fly
-   size_t childStart = nodeStart;
-   for (size_t I = 0, E = node.getNumChildren(); I < E; ++I) {
-      std::optional<Syntax> child = node.getChild(I);
-      if (!child.has_value() || child->isMissing()) {
-         continue;
+   // Descend towards position iteratively, deeply nested trees would
+   // overflow the stack otherwise.
+   std::optional<Syntax> current = node;
+   size_t currentStart = nodeStart;
+   while (!nodeCanBeReused(*current, currentStart, position, kind)) {
+      // Compute the child's position on the fly
+      std::optional<Syntax> next;
+      size_t childStart = currentStart;
+      for (size_t I = 0, E = current->getNumChildren(); I < E; ++I) {
+         std::optional<Syntax> child = current->getChild(I);
+         if (!child.has_value() || child->isMissing()) {
+            continue;
+         }
+         auto childEnd = childStart + child->getTextLength();
+         if (childStart <= position && position < childEnd) {
+            next.emplace(*child);
+            break;
+         }
+         // The next child starts where the previous child ended
+         childStart = childEnd;
       }
-      auto childEnd = childStart + child->getTextLength();
-      if (childStart <= position && position < childEnd) {
-         return lookUpFrom(child.value(), childStart, position, kind);
+      if (!next.has_value()) {
+         return std::nullopt;
       }
-      // The next child starts where the previous child ended
-      childStart = childEnd;
+      current.emplace(*next);
+      currentStart = childStart;
    }
-   return std::nullopt;
+   return current;
 }
 
 std::optional<size_t>
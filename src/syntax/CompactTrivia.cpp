@@ -0,0 +1,164 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/08.
+
+#include "polarphp/syntax/CompactTrivia.h"
+#include "polarphp/basic/adt/SmallVector.h"
+
+namespace polar::syntax {
+
+using polar::basic::SmallVector;
+
+static_assert(static_cast<unsigned>(TriviaKind::GarbageText) < 16,
+              "trivia kinds have to fit into 4 bits");
+
+void CompactTrivia::encodePiece(const CompactTriviaPiece &piece,
+                                SmallVectorImpl<uint8_t> &bytes)
+{
+   uint32_t length = piece.length;
+   uint8_t head = static_cast<uint8_t>(piece.kind) | ((length & 7) << 4);
+   length >>= 3;
+   if (length == 0) {
+      bytes.push_back(head);
+      return;
+   }
+   bytes.push_back(head | 0x80);
+   while (length >= 0x80) {
+      bytes.push_back(static_cast<uint8_t>(length & 0x7f) | 0x80);
+      length >>= 7;
+   }
+   bytes.push_back(static_cast<uint8_t>(length));
+}
+
+CompactTrivia CompactTrivia::getIndentation(uint32_t newlines, uint32_t spaces)
+{
+   assert(newlines <= sm_maxIndentationCount && spaces <= sm_maxIndentationCount &&
+          "indentation too large");
+   if (newlines == 0 && spaces == 0) {
+      return CompactTrivia();
+   }
+   return CompactTrivia(static_cast<uint64_t>(StorageKind::Indentation) |
+                        (static_cast<uint64_t>(newlines) << 2) |
+                        (static_cast<uint64_t>(spaces) << 33));
+}
+
+CompactTrivia CompactTrivia::make(ArrayRef<CompactTriviaPiece> pieces,
+                                  polar::utils::BumpPtrAllocator &allocator)
+{
+   // Fast path for no trivia, spaces only and newlines followed by spaces.
+   if (pieces.empty()) {
+      return CompactTrivia();
+   }
+   if (pieces.size() <= 2) {
+      const CompactTriviaPiece &first = pieces.front();
+      const CompactTriviaPiece &last = pieces.back();
+      if (pieces.size() == 1 && first.kind == TriviaKind::Space &&
+          first.length <= sm_maxIndentationCount) {
+         return getIndentation(0, first.length);
+      }
+      if (first.kind == TriviaKind::Newline && first.length <= sm_maxIndentationCount &&
+          (pieces.size() == 1 ||
+           (last.kind == TriviaKind::Space && last.length <= sm_maxIndentationCount))) {
+         return getIndentation(first.length, pieces.size() == 1 ? 0 : last.length);
+      }
+   }
+
+   SmallVector<uint8_t, 16> bytes;
+   for (const CompactTriviaPiece &piece : pieces) {
+      encodePiece(piece, bytes);
+   }
+   if (bytes.size() <= sm_maxInlineBytes) {
+      uint64_t bits = static_cast<uint64_t>(StorageKind::Inline) |
+            (static_cast<uint64_t>(bytes.size()) << 2);
+      for (size_t index = 0; index < bytes.size(); ++index) {
+         bits |= static_cast<uint64_t>(bytes[index]) << (8 * (index + 1));
+      }
+      return CompactTrivia(bits);
+   }
+
+   uint32_t numBytes = bytes.size();
+   uint8_t *storage = static_cast<uint8_t *>(
+            allocator.allocate(sizeof(numBytes) + numBytes, alignof(uint32_t)));
+   ::memcpy(storage, &numBytes, sizeof(numBytes));
+   ::memcpy(storage + sizeof(numBytes), bytes.data(), numBytes);
+   return CompactTrivia(reinterpret_cast<uintptr_t>(storage) |
+                        static_cast<uint64_t>(StorageKind::External));
+}
+
+CompactTrivia CompactTrivia::make(const Trivia &trivia,
+                                  polar::utils::BumpPtrAllocator &allocator)
+{
+   SmallVector<CompactTriviaPiece, 4> pieces;
+   for (const TriviaPiece &piece : trivia) {
+      pieces.push_back(CompactTriviaPiece{piece.getKind(),
+                                          static_cast<uint32_t>(piece.getTextLength())});
+   }
+   return make(pieces, allocator);
+}
+
+size_t CompactTrivia::getTextLength() const
+{
+   if (getStorageKind() == StorageKind::Indentation) {
+      return static_cast<size_t>(getIndentationNewlines()) + getIndentationSpaces();
+   }
+   size_t length = 0;
+   forEachPiece([&](const CompactTriviaPiece &piece) {
+      length += piece.length;
+   });
+   return length;
+}
+
+void CompactTrivia::getPieces(SmallVectorImpl<CompactTriviaPiece> &pieces) const
+{
+   forEachPiece([&](const CompactTriviaPiece &piece) {
+      pieces.push_back(piece);
+   });
+}
+
+Trivia CompactTrivia::getTrivia(StringRef text) const
+{
+   assert(text.size() >= getTextLength() && "source text shorter than trivia");
+   Trivia trivia;
+   size_t offset = 0;
+   forEachPiece([&](const CompactTriviaPiece &piece) {
+      trivia.push_back(TriviaPiece::fromText(piece.kind,
+                                             text.substr(offset, piece.length)));
+      offset += piece.length;
+   });
+   return trivia;
+}
+
+StringRef CompactTrivia::getPieceText(StringRef text, size_t index) const
+{
+   size_t offset = 0;
+   size_t current = 0;
+   StringRef result;
+   forEachPiece([&](const CompactTriviaPiece &piece) {
+      if (current++ == index) {
+         result = text.substr(offset, piece.length);
+      }
+      offset += piece.length;
+   });
+   assert(current > index && "trivia piece index out of range");
+   return result;
+}
+
+bool CompactTrivia::operator==(const CompactTrivia &other) const
+{
+   // The encoding is canonical, so only lists stored outside of the object
+   // need to be compared byte by byte.
+   if (getStorageKind() != StorageKind::External ||
+       other.getStorageKind() != StorageKind::External) {
+      return m_bits == other.m_bits;
+   }
+   return getExternalBytes() == other.getExternalBytes();
+}
+
+} // polar::syntax
@@ -0,0 +1,304 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/09.
+
+#include "polarphp/syntax/FrozenSyntaxTree.h"
+#include "polarphp/syntax/Syntax.h"
+#include "polarphp/basic/adt/SmallVector.h"
+#include "polarphp/utils/RawOutStream.h"
+
+#include <limits>
+
+namespace polar::syntax {
+
+using polar::basic::SmallVector;
+using polar::utils::RawStringOutStream;
+
+namespace {
+
+/// Marks an absent child on the stack of finished children while freezing.
+constexpr uint32_t sg_absentChild = std::numeric_limits<uint32_t>::max();
+
+CompactTrivia make_compact_trivia(ArrayRef<TriviaPiece> trivia,
+                                  polar::utils::BumpPtrAllocator &allocator)
+{
+   SmallVector<CompactTriviaPiece, 4> pieces;
+   for (const TriviaPiece &piece : trivia) {
+      pieces.push_back(CompactTriviaPiece{piece.getKind(),
+                                          static_cast<uint32_t>(piece.getTextLength())});
+   }
+   return CompactTrivia::make(pieces, allocator);
+}
+
+uint32_t checked_uint32(size_t value)
+{
+   assert(value < std::numeric_limits<uint32_t>::max() &&
+          "syntax tree too large to be frozen");
+   return static_cast<uint32_t>(value);
+}
+
+} // anonymous namespace
+
+FrozenSyntaxTree FrozenSyntaxTree::freeze(const Syntax &root)
+{
+   return freeze(*root.getRaw());
+}
+
+FrozenSyntaxTree FrozenSyntaxTree::freeze(const RawSyntax &root)
+{
+   FrozenSyntaxTree tree;
+   // The spelling of missing tokens is collected separately and appended to
+   // the text pool once the source text is complete. Their text offsets are
+   // relative to the start of this buffer until then.
+   std::string missingText;
+   std::vector<size_t> missingTokens;
+
+   struct Frame
+   {
+      const RawSyntax *node;
+      size_t nextChild;
+      size_t offset;
+      size_t childrenBegin;
+   };
+   // The explicit stack keeps freezing very deep trees from overflowing the
+   // native stack. Finished children are collected on a second stack until
+   // their parent is done.
+   std::vector<Frame> stack;
+   std::vector<uint32_t> finishedChildren;
+   stack.push_back(Frame{&root, 0, 0, 0});
+   while (!stack.empty()) {
+      Frame &frame = stack.back();
+      const RawSyntax *node = frame.node;
+      if (!node->isToken() && frame.nextChild < node->getNumChildren()) {
+         const RefCountPtr<RawSyntax> &child = node->getChild(frame.nextChild++);
+         if (child) {
+            stack.push_back(Frame{child.get(), 0, tree.m_text.size(), finishedChildren.size()});
+         } else {
+            finishedChildren.push_back(sg_absentChild);
+         }
+         continue;
+      }
+
+      uint32_t index = checked_uint32(tree.m_kinds.size());
+      uint8_t flags = node->isMissing() ? MissingFlag : 0;
+      if (node->isToken()) {
+         flags |= TokenFlag;
+         tree.m_kinds.push_back(static_cast<uint16_t>(node->getTokenKind()));
+         tree.m_payloads.push_back(checked_uint32(tree.m_tokens.size()));
+         std::string &buffer = node->isMissing() ? missingText : tree.m_text;
+         if (node->isMissing()) {
+            missingTokens.push_back(tree.m_tokens.size());
+         }
+         TokenRecord token;
+         token.textOffset = checked_uint32(buffer.size());
+         token.tokenLength = checked_uint32(node->getTokenText().size());
+         token.leadingTrivia = make_compact_trivia(node->getLeadingTrivia(),
+                                                   tree.m_triviaAllocator);
+         token.trailingTrivia = make_compact_trivia(node->getTrailingTrivia(),
+                                                    tree.m_triviaAllocator);
+         tree.m_tokens.push_back(token);
+         RawStringOutStream outStream(buffer);
+         for (const TriviaPiece &piece : node->getLeadingTrivia()) {
+            piece.print(outStream);
+         }
+         outStream << node->getTokenText();
+         for (const TriviaPiece &piece : node->getTrailingTrivia()) {
+            piece.print(outStream);
+         }
+         outStream.flush();
+      } else {
+         tree.m_kinds.push_back(static_cast<uint16_t>(node->getKind()));
+         tree.m_payloads.push_back(checked_uint32(tree.m_children.size()));
+         tree.m_children.push_back(checked_uint32(node->getNumChildren()));
+         for (size_t pos = frame.childrenBegin; pos < finishedChildren.size(); ++pos) {
+            uint32_t child = finishedChildren[pos];
+            tree.m_children.push_back(child == sg_absentChild ? 0 : index - child);
+         }
+         finishedChildren.resize(frame.childrenBegin);
+      }
+      tree.m_flags.push_back(flags);
+      tree.m_offsets.push_back(checked_uint32(frame.offset));
+      tree.m_lengths.push_back(checked_uint32(tree.m_text.size() - frame.offset));
+      stack.pop_back();
+      finishedChildren.push_back(index);
+   }
+
+   tree.m_sourceLength = tree.m_text.size();
+   for (size_t token : missingTokens) {
+      tree.m_tokens[token].textOffset += checked_uint32(tree.m_sourceLength);
+   }
+   tree.m_text += missingText;
+   checked_uint32(tree.m_text.size());
+   return tree;
+}
+
+size_t FrozenSyntaxTree::getMemoryUsage() const
+{
+   return m_kinds.capacity() * sizeof(uint16_t) +
+         m_flags.capacity() * sizeof(uint8_t) +
+         m_offsets.capacity() * sizeof(uint32_t) +
+         m_lengths.capacity() * sizeof(uint32_t) +
+         m_payloads.capacity() * sizeof(uint32_t) +
+         m_children.capacity() * sizeof(uint32_t) +
+         m_tokens.capacity() * sizeof(TokenRecord) +
+         m_text.capacity() + m_triviaAllocator.getTotalMemory();
+}
+
+SyntaxKind FrozenSyntaxNode::getKind() const
+{
+   if (isToken()) {
+      return SyntaxKind::Token;
+   }
+   return static_cast<SyntaxKind>(m_tree->m_kinds[m_index]);
+}
+
+bool FrozenSyntaxNode::isToken() const
+{
+   return m_tree->m_flags[m_index] & FrozenSyntaxTree::TokenFlag;
+}
+
+bool FrozenSyntaxNode::isMissing() const
+{
+   return m_tree->m_flags[m_index] & FrozenSyntaxTree::MissingFlag;
+}
+
+TokenKindType FrozenSyntaxNode::getTokenKind() const
+{
+   assert(isToken() && "not a token");
+   return static_cast<TokenKindType>(m_tree->m_kinds[m_index]);
+}
+
+StringRef FrozenSyntaxNode::getTokenText() const
+{
+   assert(isToken() && "not a token");
+   const FrozenSyntaxTree::TokenRecord &token = m_tree->m_tokens[m_tree->m_payloads[m_index]];
+   return StringRef(m_tree->m_text).substr(
+            token.textOffset + token.leadingTrivia.getTextLength(), token.tokenLength);
+}
+
+CompactTrivia FrozenSyntaxNode::getCompactLeadingTrivia() const
+{
+   assert(isToken() && "not a token");
+   return m_tree->m_tokens[m_tree->m_payloads[m_index]].leadingTrivia;
+}
+
+CompactTrivia FrozenSyntaxNode::getCompactTrailingTrivia() const
+{
+   assert(isToken() && "not a token");
+   return m_tree->m_tokens[m_tree->m_payloads[m_index]].trailingTrivia;
+}
+
+Trivia FrozenSyntaxNode::getLeadingTrivia() const
+{
+   assert(isToken() && "not a token");
+   const FrozenSyntaxTree::TokenRecord &token = m_tree->m_tokens[m_tree->m_payloads[m_index]];
+   return token.leadingTrivia.getTrivia(StringRef(m_tree->m_text).substr(token.textOffset));
+}
+
+Trivia FrozenSyntaxNode::getTrailingTrivia() const
+{
+   assert(isToken() && "not a token");
+   const FrozenSyntaxTree::TokenRecord &token = m_tree->m_tokens[m_tree->m_payloads[m_index]];
+   size_t offset = token.textOffset + token.leadingTrivia.getTextLength() + token.tokenLength;
+   return token.trailingTrivia.getTrivia(StringRef(m_tree->m_text).substr(offset));
+}
+
+size_t FrozenSyntaxNode::getNumChildren() const
+{
+   if (isToken()) {
+      return 0;
+   }
+   return m_tree->m_children[m_tree->m_payloads[m_index]];
+}
+
+std::optional<FrozenSyntaxNode> FrozenSyntaxNode::getChild(size_t index) const
+{
+   assert(index < getNumChildren() && "child index out of range");
+   uint32_t distance = m_tree->m_children[m_tree->m_payloads[m_index] + 1 + index];
+   if (distance == 0) {
+      return std::nullopt;
+   }
+   return FrozenSyntaxNode(m_tree, m_index - distance);
+}
+
+size_t FrozenSyntaxNode::getAbsoluteOffsetBeforeLeadingTrivia() const
+{
+   return m_tree->m_offsets[m_index];
+}
+
+size_t FrozenSyntaxNode::getAbsoluteOffset() const
+{
+   // The first present token of the subtree is the first one in post-order.
+   for (NodeIndex index = getSubtreeBegin(); index <= m_index; ++index) {
+      FrozenSyntaxNode node(m_tree, index);
+      if (node.isToken() && node.isPresent()) {
+         return node.getAbsoluteOffsetBeforeLeadingTrivia() +
+               node.getCompactLeadingTrivia().getTextLength();
+      }
+   }
+   return getAbsoluteOffsetBeforeLeadingTrivia();
+}
+
+size_t FrozenSyntaxNode::getTextLength() const
+{
+   return m_tree->m_lengths[m_index];
+}
+
+StringRef FrozenSyntaxNode::getText() const
+{
+   return StringRef(m_tree->m_text).substr(getAbsoluteOffsetBeforeLeadingTrivia(),
+                                           getTextLength());
+}
+
+FrozenSyntaxNode::NodeIndex FrozenSyntaxNode::getSubtreeBegin() const
+{
+   // Children come before their parent, so the subtree starts at its
+   // leftmost descendant.
+   FrozenSyntaxNode node = *this;
+   for (;;) {
+      std::optional<FrozenSyntaxNode> first;
+      for (size_t index = 0, count = node.getNumChildren(); index < count && !first; ++index) {
+         first = node.getChild(index);
+      }
+      if (!first) {
+         return node.m_index;
+      }
+      node = *first;
+   }
+}
+
+RefCountPtr<RawSyntax> FrozenSyntaxNode::thaw() const
+{
+   // Every child is thawed before its parent when walking the subtree in
+   // post-order, so no recursion is needed.
+   NodeIndex begin = getSubtreeBegin();
+   std::vector<RefCountPtr<RawSyntax>> nodes(m_index - begin + 1);
+   std::vector<RefCountPtr<RawSyntax>> layout;
+   for (NodeIndex index = begin; index <= m_index; ++index) {
+      FrozenSyntaxNode node(m_tree, index);
+      SourcePresence presence = node.isMissing() ? SourcePresence::Missing
+                                                 : SourcePresence::Present;
+      if (node.isToken()) {
+         nodes[index - begin] = RawSyntax::make(
+                  node.getTokenKind(), OwnedString::makeRefCounted(node.getTokenText()),
+                  node.getLeadingTrivia().pieces, node.getTrailingTrivia().pieces, presence);
+         continue;
+      }
+      layout.clear();
+      for (size_t child = 0, count = node.getNumChildren(); child < count; ++child) {
+         std::optional<FrozenSyntaxNode> childNode = node.getChild(child);
+         layout.push_back(childNode ? nodes[childNode->m_index - begin] : nullptr);
+      }
+      nodes[index - begin] = RawSyntax::make(node.getKind(), layout, presence);
+   }
+   return nodes.back();
+}
+
+} // polar::syntax
@@ -0,0 +1,157 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/10.
+
+#include "polarphp/syntax/ParallelSyntaxTraversal.h"
+#include "polarphp/utils/ThreadPool.h"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace polar::syntax {
+
+using polar::utils::ThreadPool;
+
+namespace {
+
+/// The block of task indices [begin, end) still owned by one worker. The
+/// owner takes tasks from the front, thieves take the back half.
+struct WorkerQueue
+{
+   std::mutex lock;
+   size_t begin = 0;
+   size_t end = 0;
+
+   bool pop(size_t &task)
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      if (begin == end) {
+         return false;
+      }
+      task = begin++;
+      return true;
+   }
+
+   /// Move the back half of the remaining tasks to \p thief.
+   bool stealInto(WorkerQueue &thief)
+   {
+      size_t stolenBegin;
+      size_t stolenEnd;
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         if (begin == end) {
+            return false;
+         }
+         stolenEnd = end;
+         end -= (end - begin + 1) / 2;
+         stolenBegin = end;
+      }
+      std::lock_guard<std::mutex> guard(thief.lock);
+      thief.begin = stolenBegin;
+      thief.end = stolenEnd;
+      return true;
+   }
+};
+
+void run_worker(std::vector<WorkerQueue> &queues, size_t self,
+                polar::basic::FunctionRef<void(size_t)> task)
+{
+   WorkerQueue &queue = queues[self];
+   for (;;) {
+      size_t index;
+      while (queue.pop(index)) {
+         task(index);
+      }
+      // No tasks are created while running, so once no other worker has
+      // anything left to steal all tasks have been started.
+      bool stolen = false;
+      for (size_t offset = 1; offset < queues.size() && !stolen; ++offset) {
+         stolen = queues[(self + offset) % queues.size()].stealInto(queue);
+      }
+      if (!stolen) {
+         return;
+      }
+   }
+}
+
+} // anonymous namespace
+
+ParallelSyntaxTraversal::ParallelSyntaxTraversal(ThreadPool &pool, unsigned numWorkers)
+   : m_pool(pool),
+     m_numWorkers(numWorkers ? numWorkers : std::max(1u, std::thread::hardware_concurrency()))
+{}
+
+std::vector<Syntax> ParallelSyntaxTraversal::partition(const Syntax &root) const
+{
+   // Computing the text length of the root caches the text lengths of all
+   // layout nodes below it, so that the workers only ever read them.
+   size_t totalLength = root.getTextLength();
+   size_t grainSize = m_grainSize;
+   if (grainSize == 0) {
+      grainSize = std::max(sm_minGrainSize, totalLength / (m_numWorkers * 16));
+   }
+   std::vector<Syntax> tasks;
+   std::vector<Syntax> pending;
+   pending.push_back(root);
+   while (!pending.empty()) {
+      Syntax node = pending.back();
+      pending.pop_back();
+      // The nodes are reached in source order, so every position is one
+      // step from the cached position of the node before it. With the
+      // positions of the tasks and their ancestors known, a worker asking
+      // for a position only fills in the caches of its own task.
+      node.getAbsolutePositionBeforeLeadingTrivia();
+      if (node.isToken() || node.getNumChildren() == 0 ||
+          node.getTextLength() <= grainSize) {
+         tasks.push_back(node);
+         continue;
+      }
+      for (size_t index = node.getNumChildren(); index > 0; --index) {
+         if (std::optional<Syntax> child = node.getChild(index - 1)) {
+            pending.push_back(*child);
+         }
+      }
+   }
+   return tasks;
+}
+
+void ParallelSyntaxTraversal::run(size_t numTasks,
+                                  polar::basic::FunctionRef<void(size_t)> task) const
+{
+   size_t numWorkers = std::min<size_t>(m_numWorkers, numTasks);
+   if (numWorkers <= 1) {
+      for (size_t index = 0; index < numTasks; ++index) {
+         task(index);
+      }
+      return;
+   }
+   // Neighbouring tasks usually touch neighbouring memory, so every worker
+   // starts with a contiguous block.
+   std::vector<WorkerQueue> queues(numWorkers);
+   for (size_t worker = 0; worker < numWorkers; ++worker) {
+      queues[worker].begin = numTasks * worker / numWorkers;
+      queues[worker].end = numTasks * (worker + 1) / numWorkers;
+   }
+   std::vector<std::shared_future<void>> futures;
+   for (size_t worker = 1; worker < numWorkers; ++worker) {
+      futures.push_back(m_pool.async([&queues, worker, task]() {
+         run_worker(queues, worker, task);
+      }));
+   }
+   run_worker(queues, 0, task);
+   for (std::shared_future<void> &future : futures) {
+      future.wait();
+   }
+}
+
+} // polar::syntax
@@ -11,9 +11,12 @@
 
 #include "polarphp/syntax/RawSyntax.h"
 #include "polarphp/basic/ColorUtils.h"
+#include "polarphp/basic/adt/SmallVector.h"
 
 namespace polar::syntax {
 
+using polar::basic::SmallVector;
+
 namespace {
 
 bool is_trivial_syntax_kind(SyntaxKind kind)
@@ -113,16 +116,16 @@ RawSyntax::RawSyntax(TokenKindType tokenKind, OwnedString text,
 RawSyntax::RawSyntax(TokenKindType tokenKind, OwnedString text, std::int64_t value, ArrayRef<TriviaPiece> leadingTrivia,
           ArrayRef<TriviaPiece> trailingTrivia, SourcePresence presence,
           const RefCountPtr<SyntaxArena> &arena, std::optional<SyntaxNodeId> nodeId)
+   : RawSyntax(tokenKind, text, leadingTrivia, trailingTrivia, presence, arena, nodeId)
 {
-   RawSyntax(tokenKind, text, leadingTrivia, trailingTrivia, presence, arena, nodeId);
    *getTrailingObjects<std::int64_t>() = value;
 }
 
 RawSyntax::RawSyntax(TokenKindType tokenKind, OwnedString text, double value, ArrayRef<TriviaPiece> leadingTrivia,
           ArrayRef<TriviaPiece> trailingTrivia, SourcePresence presence,
           const RefCountPtr<SyntaxArena> &arena, std::optional<SyntaxNodeId> nodeId)
+   : RawSyntax(tokenKind, text, leadingTrivia, trailingTrivia, presence, arena, nodeId)
 {
-   RawSyntax(tokenKind, text, leadingTrivia, trailingTrivia, presence, arena, nodeId);
    *getTrailingObjects<double>() = value;
 }
 
@@ -144,6 +147,19 @@ RawSyntax::~RawSyntax()
    }
 }
 
+void RawSyntax::destroy(const RawSyntax *node)
+{
+   if (node->arena) {
+      // The node was allocated inside a SyntaxArena and thus doesn't own its
+      // own memory region. Hence we cannot free it. It will be deleted once
+      // the last RawSyntax node allocated with it will release its reference
+      // to the arena.
+      node->~RawSyntax();
+   } else {
+      delete node;
+   }
+}
+
 RefCountPtr<RawSyntax> RawSyntax::make(SyntaxKind kind, ArrayRef<RefCountPtr<RawSyntax>> layout,
                                        SourcePresence presence,
                                        const RefCountPtr<SyntaxArena> &arena,
@@ -164,8 +180,10 @@ RefCountPtr<RawSyntax> RawSyntax::make(TokenKindType tokenKind, OwnedString text
                                        const RefCountPtr<SyntaxArena> &arena,
                                        std::optional<unsigned> nodeId)
 {
+   // Token nodes always reserve the integer and double value slots since
+   // getNumTrailingObjects() accounts for both of them.
    auto size = totalSizeToAlloc<RefCountPtr<RawSyntax>, OwnedString, std::int64_t, double, TriviaPiece>(
-            0, 1, 0, 0, leadingTrivia.size() + trailingTrivia.size());
+            0, 1, 1, 1, leadingTrivia.size() + trailingTrivia.size());
    void *data = arena ? arena->allocate(size, alignof(RawSyntax))
                       : ::operator new(size);
    return RefCountPtr<RawSyntax>(new (data) RawSyntax(tokenKind, text, leadingTrivia,
@@ -182,7 +200,7 @@ RefCountPtr<RawSyntax> RawSyntax::make(TokenKindType tokenKind, OwnedString text
                                        std::optional<unsigned> nodeId)
 {
    auto size = totalSizeToAlloc<RefCountPtr<RawSyntax>, OwnedString, std::int64_t, double, TriviaPiece>(
-            0, 1, 1, 0, leadingTrivia.size() + trailingTrivia.size());
+            0, 1, 1, 1, leadingTrivia.size() + trailingTrivia.size());
    void *data = arena ? arena->allocate(size, alignof(RawSyntax))
                       : ::operator new(size);
    return RefCountPtr<RawSyntax>(new (data) RawSyntax(tokenKind, text, value, leadingTrivia,
@@ -200,7 +218,7 @@ RefCountPtr<RawSyntax> RawSyntax::make(TokenKindType tokenKind, OwnedString text
                                        std::optional<unsigned> nodeId)
 {
    auto size = totalSizeToAlloc<RefCountPtr<RawSyntax>, OwnedString, std::int64_t, double, TriviaPiece>(
-            0, 1, 0, 1, leadingTrivia.size() + trailingTrivia.size());
+            0, 1, 1, 1, leadingTrivia.size() + trailingTrivia.size());
    void *data = arena ? arena->allocate(size, alignof(RawSyntax))
                       : ::operator new(size);
    return RefCountPtr<RawSyntax>(new (data) RawSyntax(tokenKind, text, value, leadingTrivia,
@@ -240,27 +258,34 @@ std::optional<AbsolutePosition>
 RawSyntax::accumulateAbsolutePosition(AbsolutePosition &pos) const
 {
    std::optional<AbsolutePosition> ret;
-   if (isToken()) {
-      if (isMissing()) {
-         return std::nullopt;
-      }
-      for (auto &leader : getLeadingTrivia()) {
-         leader.accumulateAbsolutePosition(pos);
-      }
-      ret = pos;
-      pos.addText(getTokenText());
-      for (auto &trailer : getTrailingTrivia()) {
-         trailer.accumulateAbsolutePosition(pos);
-      }
-   } else {
-      for (auto &child : getLayout()) {
-         if (!child) {
+   // Visit the tokens in source order with an explicit stack, the depth of
+   // machine generated trees is not bounded.
+   SmallVector<std::pair<const RawSyntax *, size_t>, 16> stack;
+   stack.push_back({this, 0});
+   while (!stack.empty()) {
+      const RawSyntax *node = stack.back().first;
+      if (node->isToken()) {
+         stack.pop_back();
+         if (node->isMissing()) {
             continue;
          }
-         auto result = child->accumulateAbsolutePosition(pos);
-         if (!ret && result) {
-            ret = result;
+         for (auto &leader : node->getLeadingTrivia()) {
+            leader.accumulateAbsolutePosition(pos);
+         }
+         if (!ret) {
+            ret = pos;
          }
+         pos.addText(node->getTokenText());
+         for (auto &trailer : node->getTrailingTrivia()) {
+            trailer.accumulateAbsolutePosition(pos);
+         }
+         continue;
+      }
+      size_t index = stack.back().second++;
+      if (index == node->getNumChildren()) {
+         stack.pop_back();
+      } else if (const RawSyntax *child = node->getChild(index).get()) {
+         stack.push_back({child, 0});
       }
    }
    return ret;
@@ -268,24 +293,64 @@ RawSyntax::accumulateAbsolutePosition(AbsolutePosition &pos) const
 
 bool RawSyntax::accumulateLeadingTrivia(AbsolutePosition &pos) const
 {
-   if (isToken()) {
-      if (!isMissing()) {
-         for (auto &leader: getLeadingTrivia()) {
+   SmallVector<std::pair<const RawSyntax *, size_t>, 16> stack;
+   stack.push_back({this, 0});
+   while (!stack.empty()) {
+      const RawSyntax *node = stack.back().first;
+      if (node->isToken()) {
+         if (node->isMissing()) {
+            stack.pop_back();
+            continue;
+         }
+         for (auto &leader: node->getLeadingTrivia()) {
             leader.accumulateAbsolutePosition(pos);
          }
          return true;
       }
-   } else {
-      for (auto &child: getLayout()) {
-         if (!child || child->isMissing()) {
-            continue;
+      size_t index = stack.back().second++;
+      if (index == node->getNumChildren()) {
+         stack.pop_back();
+         continue;
+      }
+      const RawSyntax *child = node->getChild(index).get();
+      if (child && !child->isMissing()) {
+         stack.push_back({child, 0});
+      }
+   }
+   return false;
+}
+
+size_t RawSyntax::computeTextLength()
+{
+   // Compute the lengths of all layout nodes below this one that are not
+   // cached yet in post-order, so that every node only sums up the lengths
+   // of its direct children.
+   size_t textLength = 0;
+   SmallVector<std::pair<RawSyntax *, size_t>, 16> stack;
+   stack.push_back({this, 0});
+   while (!stack.empty()) {
+      RawSyntax *node = stack.back().first;
+      size_t index = stack.back().second++;
+      if (index < node->getNumChildren()) {
+         RawSyntax *child = node->getChild(index).get();
+         if (child && !child->isMissing() && !child->isToken() &&
+             child->m_bits.layout.textLength == UINT32_MAX) {
+            stack.push_back({child, 0});
          }
-         if (child->accumulateLeadingTrivia(pos)) {
-            return true;
+         continue;
+      }
+      textLength = 0;
+      for (auto &childNode : node->getLayout()) {
+         if (childNode && !childNode->isMissing()) {
+            textLength += childNode->getTextLength();
          }
       }
+      stack.pop_back();
+      if (node != this) {
+         node->m_bits.layout.textLength = textLength;
+      }
    }
-   return false;
+   return textLength;
 }
 
 void RawSyntax::print(RawOutStream &outStream, SyntaxPrintOptions opts) const
@@ -0,0 +1,440 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/02.
+
+#include "polarphp/syntax/SyntaxByteTreeSerialization.h"
+#include "polarphp/basic/ByteTreeDeserialization.h"
+#include "polarphp/basic/adt/SmallVector.h"
+#include "polarphp/utils/MemoryBuffer.h"
+
+namespace polar::syntax {
+
+using polar::basic::SmallVector;
+using polar::basic::SmallVectorImpl;
+using polar::basic::bytetree::ByteTreeReader;
+using polar::basic::bytetree::WrapperTypeTraits;
+using polar::utils::BinaryStreamError;
+using polar::utils::BinaryStreamWriter;
+using polar::utils::StreamErrorCode;
+using polar::utils::Error;
+using polar::utils::make_error;
+
+namespace {
+
+Error make_malformed_error(StringRef context)
+{
+   return make_error<BinaryStreamError>(StreamErrorCode::unspecified, context);
+}
+
+class SyntaxTreeDeserializer
+{
+public:
+   SyntaxTreeDeserializer(StringRef data, const RefCountPtr<SyntaxArena> &arena)
+      : m_reader(data),
+        m_arena(arena)
+   {}
+
+   Expected<RefCountPtr<RawSyntax>> deserialize()
+   {
+      uint32_t version;
+      if (auto error = m_reader.readProtocolVersion(version)) {
+         return error;
+      }
+      if (version != SyntaxByteTreeProtocolVersion) {
+         return make_malformed_error("unsupported syntax tree protocol version");
+      }
+      RefCountPtr<RawSyntax> root;
+      if (auto error = readTree(root)) {
+         return error;
+      }
+      if (!root) {
+         return make_malformed_error("serialized syntax tree has no root");
+      }
+      return root;
+   }
+
+private:
+   /// A layout node whose children are still being read.
+   struct PendingLayout
+   {
+      SyntaxKind kind;
+      SourcePresence presence;
+      SyntaxNodeId nodeId;
+      uint32_t numChildren;
+      /// Fields after the layout that this reader does not know.
+      uint32_t numExtraFields;
+      std::vector<RefCountPtr<RawSyntax>> children;
+   };
+
+   /// Read the tree with an explicit stack of the layouts being read, so
+   /// that the nesting depth of the tree is not limited by the native stack.
+   Error readTree(RefCountPtr<RawSyntax> &root)
+   {
+      std::vector<PendingLayout> pending;
+      while (true) {
+         RefCountPtr<RawSyntax> node;
+         PendingLayout layout;
+         bool isLayout = false;
+         if (auto error = readNodeStart(node, layout, isLayout)) {
+            return error;
+         }
+         if (isLayout) {
+            if (layout.numChildren != 0) {
+               pending.push_back(std::move(layout));
+               continue;
+            }
+            if (auto error = finishLayout(node, layout)) {
+               return error;
+            }
+         }
+         // Hand the complete node to its parent, which completes every
+         // parent whose last child it is.
+         while (true) {
+            if (pending.empty()) {
+               root = std::move(node);
+               return Error::getSuccess();
+            }
+            PendingLayout &parent = pending.back();
+            parent.children.push_back(std::move(node));
+            if (parent.children.size() < parent.numChildren) {
+               break;
+            }
+            PendingLayout done = std::move(parent);
+            pending.pop_back();
+            if (auto error = finishLayout(node, done)) {
+               return error;
+            }
+         }
+      }
+   }
+
+   /// Read a RawSyntax object up to its children, or an empty object that
+   /// stands for an absent child. Tokens and absent children are read
+   /// completely and returned in \p node, which is \c nullptr for the
+   /// latter. For a layout node \p isLayout is set and \p layout describes
+   /// the children that follow.
+   Error readNodeStart(RefCountPtr<RawSyntax> &node, PendingLayout &layout,
+                       bool &isLayout)
+   {
+      uint32_t numFields;
+      if (auto error = m_reader.readObjectHeader(numFields)) {
+         return error;
+      }
+      if (numFields == 0) {
+         node = nullptr;
+         return Error::getSuccess();
+      }
+      if (numFields < 4) {
+         return make_malformed_error("syntax node has too few fields");
+      }
+      uint8_t isPresent;
+      uint32_t nodeId;
+      uint16_t kindValue;
+      if (auto error = m_reader.readRaw(isPresent)) {
+         return error;
+      }
+      if (auto error = m_reader.readRaw(nodeId)) {
+         return error;
+      }
+      if (auto error = m_reader.readRaw(kindValue)) {
+         return error;
+      }
+      std::optional<SyntaxKind> kind =
+            WrapperTypeTraits<SyntaxKind>::fromNumericValue(kindValue);
+      if (!kind) {
+         return make_malformed_error("unknown syntax kind");
+      }
+      SourcePresence presence = isPresent ? SourcePresence::Present
+                                          : SourcePresence::Missing;
+      if (*kind == SyntaxKind::Token) {
+         if (auto error = readToken(node, presence, nodeId, numFields)) {
+            return error;
+         }
+         return m_reader.skip(numFields - 7);
+      }
+      uint32_t numChildren;
+      if (auto error = m_reader.readObjectHeader(numChildren)) {
+         return error;
+      }
+      isLayout = true;
+      layout.kind = *kind;
+      layout.presence = presence;
+      layout.nodeId = nodeId;
+      layout.numChildren = numChildren;
+      layout.numExtraFields = numFields - 4;
+      layout.children.reserve(numChildren);
+      return Error::getSuccess();
+   }
+
+   /// Make the node of \p layout once all its children are read.
+   Error finishLayout(RefCountPtr<RawSyntax> &node, PendingLayout &layout)
+   {
+      node = RawSyntax::make(layout.kind, layout.children, layout.presence, m_arena,
+                             layout.nodeId);
+      return m_reader.skip(layout.numExtraFields);
+   }
+
+   Error readToken(RefCountPtr<RawSyntax> &node, SourcePresence presence,
+                   SyntaxNodeId nodeId, uint32_t numFields)
+   {
+      if (numFields < 7) {
+         return make_malformed_error("token node has too few fields");
+      }
+      uint16_t tokenKind;
+      StringRef text;
+      if (auto error = m_reader.readRaw(tokenKind)) {
+         return error;
+      }
+      if (auto error = m_reader.readScalar(text)) {
+         return error;
+      }
+      SmallVector<TriviaPiece, 4> leadingTrivia;
+      SmallVector<TriviaPiece, 4> trailingTrivia;
+      if (auto error = readTrivia(leadingTrivia)) {
+         return error;
+      }
+      if (auto error = readTrivia(trailingTrivia)) {
+         return error;
+      }
+      node = RawSyntax::make(static_cast<TokenKindType>(tokenKind),
+                             OwnedString::makeUnowned(text), leadingTrivia,
+                             trailingTrivia, presence, m_arena, nodeId);
+      return Error::getSuccess();
+   }
+
+   Error readTrivia(SmallVectorImpl<TriviaPiece> &pieces)
+   {
+      uint32_t numPieces;
+      if (auto error = m_reader.readObjectHeader(numPieces)) {
+         return error;
+      }
+      pieces.reserve(numPieces);
+      for (uint32_t index = 0; index < numPieces; ++index) {
+         uint32_t numFields;
+         if (auto error = m_reader.readObjectHeader(numFields)) {
+            return error;
+         }
+         if (numFields < 2) {
+            return make_malformed_error("trivia piece has too few fields");
+         }
+         uint8_t kindValue;
+         if (auto error = m_reader.readRaw(kindValue)) {
+            return error;
+         }
+         std::optional<TriviaKind> kind =
+               WrapperTypeTraits<TriviaKind>::fromNumericValue(kindValue);
+         if (!kind) {
+            return make_malformed_error("unknown trivia kind");
+         }
+         if (is_comment_trivia_kind(*kind) || *kind == TriviaKind::GarbageText) {
+            StringRef text;
+            if (auto error = m_reader.readScalar(text)) {
+               return error;
+            }
+            pieces.push_back(makeTextTrivia(*kind, text));
+         } else {
+            uint32_t count;
+            if (auto error = m_reader.readRaw(count)) {
+               return error;
+            }
+            pieces.push_back(makeCountedTrivia(*kind, count));
+         }
+         if (auto error = m_reader.skip(numFields - 2)) {
+            return error;
+         }
+      }
+      return Error::getSuccess();
+   }
+
+   static TriviaPiece makeTextTrivia(TriviaKind kind, StringRef text)
+   {
+      OwnedString unowned = OwnedString::makeUnowned(text);
+      switch (kind) {
+      case TriviaKind::LineComment:
+         return TriviaPiece::getLineComment(unowned);
+      case TriviaKind::BlockComment:
+         return TriviaPiece::getBlockComment(unowned);
+      case TriviaKind::DocLineComment:
+         return TriviaPiece::getDocLineComment(unowned);
+      case TriviaKind::DocBlockComment:
+         return TriviaPiece::getDocBlockComment(unowned);
+      case TriviaKind::GarbageText:
+         return TriviaPiece::getGarbageText(unowned);
+      default:
+         polar_unreachable("not a text trivia kind");
+      }
+   }
+
+   static TriviaPiece makeCountedTrivia(TriviaKind kind, unsigned count)
+   {
+      switch (kind) {
+      case TriviaKind::Space:
+         return TriviaPiece::getSpaces(count);
+      case TriviaKind::Tab:
+         return TriviaPiece::getTabs(count);
+      case TriviaKind::VerticalTab:
+         return TriviaPiece::getVerticalTabs(count);
+      case TriviaKind::Formfeed:
+         return TriviaPiece::getFormfeeds(count);
+      case TriviaKind::Newline:
+         return TriviaPiece::getNewlines(count);
+      case TriviaKind::CarriageReturn:
+         return TriviaPiece::getCarriageReturns(count);
+      case TriviaKind::CarriageReturnLineFeed:
+         return TriviaPiece::getCarriageReturnLineFeeds(count);
+      case TriviaKind::Backtick:
+         return TriviaPiece::getBackticks(count);
+      default:
+         polar_unreachable("not a counted trivia kind");
+      }
+   }
+
+   ByteTreeReader m_reader;
+   RefCountPtr<SyntaxArena> m_arena;
+};
+
+/// Writes the same bytes as ByteTreeWriter with the ObjectTraits of
+/// RawSyntax, but keeps the layouts being written on an explicit stack
+/// instead of nesting one writer per tree level, so that the nesting depth
+/// of the tree is not limited by the native stack.
+template <typename StreamType>
+class SyntaxTreeSerializer
+{
+public:
+   explicit SyntaxTreeSerializer(StreamType &stream)
+      : m_stream(stream),
+        m_writer(stream)
+   {}
+
+   void serialize(const RawSyntax &root)
+   {
+      writeRaw(SyntaxByteTreeProtocolVersion);
+      struct PendingLayout
+      {
+         const RawSyntax *node;
+         size_t nextChild;
+      };
+      std::vector<PendingLayout> pending;
+      if (writeNodeStart(root)) {
+         pending.push_back({&root, 0});
+      }
+      while (!pending.empty()) {
+         PendingLayout &top = pending.back();
+         if (top.nextChild == top.node->getNumChildren()) {
+            pending.pop_back();
+            continue;
+         }
+         const RefCountPtr<RawSyntax> &child = top.node->getChild(top.nextChild++);
+         if (!child) {
+            // An absent child is an object without fields.
+            writeObjectHeader(0);
+         } else if (writeNodeStart(*child)) {
+            pending.push_back({child.get(), 0});
+         }
+      }
+   }
+
+private:
+   template <typename T>
+   void writeRaw(T value)
+   {
+      auto error = m_stream.writeRaw(m_writer.getOffset(), value);
+      (void)error;
+      assert(!error);
+      m_writer.setOffset(m_writer.getOffset() + sizeof(T));
+   }
+
+   void writeObjectHeader(uint32_t numFields)
+   {
+      // The most significant bit tells objects from scalars.
+      writeRaw(numFields | (uint32_t(1) << 31));
+   }
+
+   template <typename T>
+   void writeScalar(T value)
+   {
+      writeRaw(static_cast<uint32_t>(sizeof(T)));
+      writeRaw(value);
+   }
+
+   void writeScalar(StringRef text)
+   {
+      writeRaw(static_cast<uint32_t>(text.size()));
+      auto error = m_writer.writeFixedString(text);
+      (void)error;
+      assert(!error);
+   }
+
+   void writeTrivia(ArrayRef<TriviaPiece> pieces)
+   {
+      writeObjectHeader(pieces.size());
+      for (const TriviaPiece &piece : pieces) {
+         writeObjectHeader(2);
+         writeScalar(WrapperTypeTraits<TriviaKind>::numericValue(piece.getKind()));
+         if (is_comment_trivia_kind(piece.getKind()) ||
+             piece.getKind() == TriviaKind::GarbageText) {
+            writeScalar(piece.getText());
+         } else {
+            writeScalar(static_cast<uint32_t>(piece.getCount()));
+         }
+      }
+   }
+
+   /// Write \p node up to its children. Returns true if it is a layout node
+   /// whose children still have to be written.
+   bool writeNodeStart(const RawSyntax &node)
+   {
+      writeObjectHeader(node.isToken() ? 7 : 4);
+      writeScalar(static_cast<uint8_t>(node.isPresent()));
+      writeScalar(static_cast<uint32_t>(node.getId()));
+      writeScalar(WrapperTypeTraits<SyntaxKind>::numericValue(node.getKind()));
+      if (node.isToken()) {
+         writeScalar(WrapperTypeTraits<TokenKindType>::numericValue(node.getTokenKind()));
+         writeScalar(node.getTokenText());
+         writeTrivia(node.getLeadingTrivia());
+         writeTrivia(node.getTrailingTrivia());
+         return false;
+      }
+      writeObjectHeader(node.getNumChildren());
+      return true;
+   }
+
+   StreamType &m_stream;
+   BinaryStreamWriter m_writer;
+};
+
+} // anonymous namespace
+
+void serialize_syntax_tree(ExponentialGrowthAppendingBinaryByteStream &stream,
+                           const RawSyntax &root)
+{
+   SyntaxTreeSerializer<ExponentialGrowthAppendingBinaryByteStream>(stream).serialize(root);
+}
+
+void serialize_syntax_tree(SegmentedAppendingBinaryByteStream &stream,
+                           const RawSyntax &root)
+{
+   SyntaxTreeSerializer<SegmentedAppendingBinaryByteStream>(stream).serialize(root);
+}
+
+Expected<RefCountPtr<RawSyntax>>
+deserialize_syntax_tree(StringRef data, const RefCountPtr<SyntaxArena> &arena)
+{
+   return SyntaxTreeDeserializer(data, arena).deserialize();
+}
+
+Expected<RefCountPtr<RawSyntax>>
+deserialize_syntax_tree(const MemoryBuffer &buffer,
+                        const RefCountPtr<SyntaxArena> &arena)
+{
+   return deserialize_syntax_tree(buffer.getBuffer(), arena);
+}
+
+} // polar::syntax
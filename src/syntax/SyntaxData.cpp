@@ -10,9 +10,12 @@
 // Created by polarboy on 2019/05/12.
 
 #include "polarphp/syntax/SyntaxData.h"
+#include "polarphp/basic/adt/SmallVector.h"
 
 namespace polar::syntax {
 
+using polar::basic::SmallVector;
+
 RefCountPtr<SyntaxData> SyntaxData::make(RefCountPtr<RawSyntax> raw,
                                          const SyntaxData *parent,
                                          CursorIndex indexInParent)
@@ -55,32 +58,33 @@ void SyntaxData::dump() const
 
 RefCountPtr<SyntaxData> SyntaxData::getPreviousNode() const
 {
-   if (size_t end = getIndexInParent()) {
-      if (hasParent()) {
-         for (size_t index = end - 1; ; index--) {
-            if (auto C = getParent()->getChild(index)) {
-               if (C->getRaw()->isPresent() && C->getFirstToken())
-                  return C;
+   // Walk up the ancestors instead of recursing into the parent, the depth of
+   // machine generated trees is not bounded.
+   for (const SyntaxData *node = this; node->hasParent(); node = node->getParent()) {
+      const SyntaxData *parent = node->getParent();
+      for (size_t index = node->getIndexInParent(); index > 0; --index) {
+         if (auto child = parent->getChild(index - 1)) {
+            if (child->getRaw()->isPresent() && child->getFirstToken()) {
+               return child;
             }
-            if (index == 0)
-               break;
          }
       }
    }
-   return hasParent() ? m_parent->getPreviousNode() : nullptr;
+   return nullptr;
 }
 
 RefCountPtr<SyntaxData> SyntaxData::getNextNode() const
 {
-   if (hasParent()) {
-      for (size_t index = getIndexInParent() + 1, end = m_parent->getNumChildren();
-           index != end; index++) {
-         if (auto C = getParent()->getChild(index)) {
-            if (C->getRaw()->isPresent() && C->getFirstToken())
-               return C;
+   for (const SyntaxData *node = this; node->hasParent(); node = node->getParent()) {
+      const SyntaxData *parent = node->getParent();
+      for (size_t index = node->getIndexInParent() + 1, end = parent->getNumChildren();
+           index != end; ++index) {
+         if (auto child = parent->getChild(index)) {
+            if (child->getRaw()->isPresent() && child->getFirstToken()) {
+               return child;
+            }
          }
       }
-      return m_parent->getNextNode();
    }
    return nullptr;
 }
@@ -93,34 +97,79 @@ RefCountPtr<SyntaxData> SyntaxData::getFirstToken() const
       return getParent()->getChild(getIndexInParent());
    }
 
-   for (size_t index = 0, end = getNumChildren(); index < end; ++index) {
-      if (auto child = getChild(index)) {
-         if (child->getRaw()->isMissing())
-            continue;
-         if (child->getRaw()->isToken()) {
-            return child;
-         } else if (auto Token = child->getFirstToken()) {
-            return Token;
-         }
+   // Depth first search with an explicit stack. The realized children are
+   // kept alive by the child caches of their parents.
+   SmallVector<std::pair<const SyntaxData *, size_t>, 16> stack;
+   stack.push_back({this, 0});
+   while (!stack.empty()) {
+      const SyntaxData *node = stack.back().first;
+      size_t index = stack.back().second++;
+      if (index == node->getNumChildren()) {
+         stack.pop_back();
+         continue;
+      }
+      auto child = node->getChild(index);
+      if (!child || child->getRaw()->isMissing()) {
+         continue;
       }
+      if (child->getRaw()->isToken()) {
+         return child;
+      }
+      stack.push_back({child.get(), 0});
    }
    return nullptr;
 }
 
+bool SyntaxData::getCachedPosition(AbsolutePosition &position) const
+{
+   if (m_positionState.load(std::memory_order_acquire) != PositionKnown) {
+      return false;
+   }
+   position = m_positionCache;
+   return true;
+}
+
+void SyntaxData::cachePosition(const AbsolutePosition &position) const
+{
+   uint8_t expected = PositionUnknown;
+   if (!m_positionState.compare_exchange_strong(expected, PositionWriting,
+                                                std::memory_order_relaxed)) {
+      // Another thread caches the same position.
+      return;
+   }
+   m_positionCache = position;
+   m_positionState.store(PositionKnown, std::memory_order_release);
+}
+
 AbsolutePosition SyntaxData::getAbsolutePositionBeforeLeadingTrivia() const
 {
-   if (m_positionCache.has_value()) {
-      return *m_positionCache;
+   AbsolutePosition position;
+   if (getCachedPosition(position)) {
+      return position;
    }
-   if (auto prev = getPreviousNode()) {
-      auto result = prev->getAbsolutePositionBeforeLeadingTrivia();
-      prev->getRaw()->accumulateAbsolutePosition(result);
-      // FIXME: avoid using const_cast.
-      const_cast<SyntaxData*>(this)->m_positionCache = result;
-   } else {
-      const_cast<SyntaxData*>(this)->m_positionCache = AbsolutePosition();
+   // The position of a node is the end of its previous node. Collect the
+   // chain of previous nodes up to the first one with a known position and
+   // fill in their caches front to back, so that long chains of uncached
+   // nodes do not turn into deep recursion.
+   SmallVector<const SyntaxData *, 16> chain;
+   const SyntaxData *previous = nullptr;
+   for (const SyntaxData *node = this; node; ) {
+      if (node->getCachedPosition(position)) {
+         previous = node;
+         break;
+      }
+      chain.push_back(node);
+      // The previous node is kept alive by the child cache of its parent.
+      node = node->getPreviousNode().get();
+   }
+   for (size_t index = chain.size(); index > 0; --index) {
+      if (previous) {
+         previous->getRaw()->accumulateAbsolutePosition(position);
+      }
+      previous = chain[index - 1];
+      previous->cachePosition(position);
    }
-   return *m_positionCache;
+   return position;
 }
 
 AbsolutePosition SyntaxData::getAbsolutePosition() const
@@ -0,0 +1,93 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/06.
+
+#include "polarphp/syntax/SyntaxEditBatch.h"
+
+#include <algorithm>
+
+namespace polar::syntax {
+
+void SyntaxEditBatch::replace(const Syntax &node, RefCountPtr<RawSyntax> replacement)
+{
+   assert(node.getRoot().getDataPointer() == m_root.getDataPointer() &&
+          "node belongs to a different tree");
+   Edit edit;
+   for (const SyntaxData *data = node.getDataPointer(); data->hasParent();
+        data = data->getParent()) {
+      edit.path.push_back(data->getIndexInParent());
+   }
+   std::reverse(edit.path.begin(), edit.path.end());
+   edit.replacement = std::move(replacement);
+   edit.sequence = m_edits.size();
+   m_edits.push_back(std::move(edit));
+}
+
+void SyntaxEditBatch::replace(const SyntaxRef &node, RefCountPtr<RawSyntax> replacement)
+{
+   assert(node.getRoot().getRaw() == m_root.getDataPointer()->getRaw().get() &&
+          "node belongs to a different tree");
+   Edit edit;
+   node.getPathFromRoot(edit.path);
+   edit.replacement = std::move(replacement);
+   edit.sequence = m_edits.size();
+   m_edits.push_back(std::move(edit));
+}
+
+RefCountPtr<RawSyntax> SyntaxEditBatch::applyRaw()
+{
+   RefCountPtr<RawSyntax> root = m_root.getDataPointer()->getRaw();
+   if (m_edits.empty()) {
+      return root;
+   }
+   // Sorting by path puts the edits of every subtree next to each other,
+   // with an edit of a node itself in front of the edits of its descendants.
+   std::sort(m_edits.begin(), m_edits.end(), [](const Edit &lhs, const Edit &rhs) {
+      if (lhs.path != rhs.path) {
+         return std::lexicographical_compare(lhs.path.begin(), lhs.path.end(),
+                                             rhs.path.begin(), rhs.path.end());
+      }
+      return lhs.sequence < rhs.sequence;
+   });
+   RefCountPtr<RawSyntax> result = rebuild(root, m_edits.begin(), m_edits.end(), 0);
+   m_edits.clear();
+   return result;
+}
+
+RefCountPtr<RawSyntax> SyntaxEditBatch::rebuild(const RefCountPtr<RawSyntax> &node,
+                                                EditIterator begin, EditIterator end,
+                                                size_t depth)
+{
+   if (begin->path.size() == depth) {
+      // The node itself is replaced, which makes the edits of its descendants
+      // meaningless. Of several replacements of the node the last one wins.
+      EditIterator last = begin;
+      while (last + 1 != end && last[1].path.size() == depth) {
+         ++last;
+      }
+      return last->replacement;
+   }
+
+   assert(node && "edit path leads through an absent child");
+   ArrayRef<RefCountPtr<RawSyntax>> layout = node->getLayout();
+   std::vector<RefCountPtr<RawSyntax>> newLayout(layout.begin(), layout.end());
+   for (EditIterator groupBegin = begin; groupBegin != end;) {
+      CursorIndex index = groupBegin->path[depth];
+      EditIterator groupEnd = std::find_if(groupBegin, end, [&](const Edit &edit) {
+         return edit.path[depth] != index;
+      });
+      assert(index < newLayout.size() && "edit path does not match the tree");
+      newLayout[index] = rebuild(newLayout[index], groupBegin, groupEnd, depth + 1);
+      groupBegin = groupEnd;
+   }
+   return RawSyntax::make(node->getKind(), newLayout, node->getPresence());
+}
+
+} // polar::syntax
@@ -28,16 +28,68 @@ namespace polar::syntax {
 
 void SyntaxVisitor::visit(Syntax node)
 {
-  visitPre(node);
-  POLAR_DEFER { visitPost(node); };
-  switch (node.getKind()) {
-  case SyntaxKind::Token:
-    visit(node.castTo<TokenSyntax>());
+  if (m_scheduled) {
+    m_scheduled->push_back(WorkItem{WorkItem::Enter, node});
     return;
-  default:
-    visitChildren(node);
+  }
+  walk({WorkItem{WorkItem::Enter, node}});
+}
+
+void SyntaxVisitor::visitChildren(Syntax node)
+{
+  if (m_scheduled) {
+    scheduleChildren(node, *m_scheduled);
     return;
   }
+  std::vector<WorkItem> items;
+  scheduleChildren(node, items);
+  walk(std::move(items));
+}
+
+void SyntaxVisitor::scheduleChildren(const Syntax &node, std::vector<WorkItem> &items)
+{
+  for (size_t index = 0, count = node.getNumChildren(); index < count; ++index) {
+    if (auto child = node.getChild(index)) {
+      items.push_back(WorkItem{WorkItem::Dispatch, *child});
+    }
+  }
+}
+
+void SyntaxVisitor::walk(std::vector<WorkItem> items)
+{
+  // The work list is a stack, the next item to process is at the back.
+  std::vector<WorkItem> worklist(items.rbegin(), items.rend());
+  std::vector<WorkItem> scheduled;
+  m_scheduled = &scheduled;
+  POLAR_DEFER { m_scheduled = nullptr; };
+  while (!worklist.empty()) {
+    WorkItem item = worklist.back();
+    worklist.pop_back();
+    switch (item.action) {
+    case WorkItem::Dispatch:
+      visit(item.node);
+      break;
+    case WorkItem::Enter:
+      visitPre(item.node);
+      if (item.node.getKind() == SyntaxKind::Token) {
+        visit(item.node.castTo<TokenSyntax>());
+        visitPost(item.node);
+      } else {
+        worklist.push_back(WorkItem{WorkItem::Leave, item.node});
+        scheduleChildren(item.node, scheduled);
+      }
+      break;
+    case WorkItem::Leave:
+      visitPost(item.node);
+      break;
+    }
+    // Whatever processing the item asked for comes next, in the order in
+    // which it was asked for.
+    for (auto iter = scheduled.rbegin(), end = scheduled.rend(); iter != end; ++iter) {
+      worklist.push_back(*iter);
+    }
+    scheduled.clear();
+  }
 }
 
 void Syntax::accept(SyntaxVisitor &visitor)
@@ -0,0 +1,170 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/05.
+
+#include "polarphp/syntax/SyntaxRef.h"
+#include "polarphp/syntax/Syntax.h"
+
+namespace polar::syntax {
+
+using polar::basic::SmallVector;
+using polar::basic::SmallVectorImpl;
+
+namespace {
+
+size_t get_text_length(const RawSyntax *raw)
+{
+   return raw->isMissing() ? 0 : const_cast<RawSyntax *>(raw)->getTextLength();
+}
+
+/// Collect the child indices leading from \p root to \p target.
+/// \p target is identified by its index in its parent and its offset besides
+/// its address, so the walk only descends into the children that cover the
+/// offset of \p target. It keeps its own stack of the nodes it descended
+/// into, so deep trees do not exhaust the native stack.
+bool find_path(const RawSyntax *root, const RawSyntax *target, CursorIndex targetIndex,
+               size_t targetOffset, SmallVectorImpl<CursorIndex> &path)
+{
+   struct Frame
+   {
+      const RawSyntax *node;
+      /// The index of the next child to look at.
+      size_t nextIndex;
+      /// The offset of the next child to look at.
+      size_t nextOffset;
+   };
+   SmallVector<Frame, 16> stack;
+   stack.push_back({root, 0, 0});
+   while (!stack.empty()) {
+      Frame &frame = stack.back();
+      ArrayRef<RefCountPtr<RawSyntax>> layout = frame.node->getLayout();
+      if (frame.nextIndex == layout.size() || frame.nextOffset > targetOffset) {
+         stack.pop_back();
+         continue;
+      }
+      size_t index = frame.nextIndex++;
+      const RawSyntax *child = layout[index].get();
+      if (!child) {
+         continue;
+      }
+      size_t childOffset = frame.nextOffset;
+      size_t childLength = get_text_length(child);
+      frame.nextOffset += childLength;
+      if (child == target && index == targetIndex && childOffset == targetOffset) {
+         // Every frame on the stack is looking at the child just after the
+         // one on the path.
+         for (const Frame &ancestor : stack) {
+            path.push_back(ancestor.nextIndex - 1);
+         }
+         return true;
+      }
+      // Zero length nodes may share their offset with their neighbours, so
+      // the end offset is inclusive.
+      if (!child->isToken() && targetOffset <= childOffset + childLength) {
+         stack.push_back({child, 0, childOffset});
+      }
+   }
+   return false;
+}
+
+} // anonymous namespace
+
+SyntaxRef::SyntaxRef(const Syntax &node)
+   : SyntaxRef(node.getRoot().getDataPointer()->getRaw().get(),
+               node.getDataPointer()->getRaw().get(),
+               node.getDataPointer()->hasParent()
+               ? node.getDataPointer()->getParent()->getRaw().get()
+               : nullptr,
+               node.getIndexInParent(),
+               node.getAbsolutePositionBeforeLeadingTrivia().getOffset())
+{}
+
+std::optional<SyntaxRef> SyntaxRef::getChild(size_t index) const
+{
+   ArrayRef<RefCountPtr<RawSyntax>> layout = m_raw->getLayout();
+   assert(index < layout.size() && "child index out of range");
+   const RawSyntax *child = layout[index].get();
+   if (!child) {
+      return std::nullopt;
+   }
+   size_t childOffset = m_offset;
+   for (size_t prevIndex = 0; prevIndex < index; ++prevIndex) {
+      if (const RawSyntax *prev = layout[prevIndex].get()) {
+         childOffset += get_text_length(prev);
+      }
+   }
+   return SyntaxRef(m_root, child, m_raw, index, childOffset);
+}
+
+std::optional<SyntaxRef> SyntaxRef::getPresentChild(const RawSyntax *root,
+                                                    const RawSyntax *parent,
+                                                    size_t index, size_t offset)
+{
+   // Children missing from the layout take no space, so the offset stays the
+   // same while skipping them.
+   ArrayRef<RefCountPtr<RawSyntax>> layout = parent->getLayout();
+   for (size_t size = layout.size(); index < size; ++index) {
+      if (const RawSyntax *child = layout[index].get()) {
+         return SyntaxRef(root, child, parent, index, offset);
+      }
+   }
+   return std::nullopt;
+}
+
+std::optional<SyntaxRef> SyntaxRef::getParent() const
+{
+   if (isRoot()) {
+      return std::nullopt;
+   }
+   if (m_parent == m_root) {
+      return getRoot();
+   }
+   SmallVector<CursorIndex, 16> path;
+   getPathFromRoot(path);
+   SyntaxRef parent = getRoot();
+   for (CursorIndex index : ArrayRef<CursorIndex>(path).dropBack()) {
+      parent = *parent.getChild(index);
+   }
+   assert(parent.m_raw == m_parent && "path does not lead to the parent");
+   return parent;
+}
+
+size_t SyntaxRef::getAbsoluteOffset() const
+{
+   AbsolutePosition pos;
+   m_raw->accumulateLeadingTrivia(pos);
+   return m_offset + pos.getOffset();
+}
+
+void SyntaxRef::getPathFromRoot(SmallVectorImpl<CursorIndex> &path) const
+{
+   path.clear();
+   if (isRoot()) {
+      return;
+   }
+   bool found = find_path(m_root, m_raw, m_indexInParent, m_offset, path);
+   (void) found;
+   assert(found && "node is not part of the tree of its root");
+}
+
+Syntax SyntaxRef::realize(const Syntax &root) const
+{
+   assert(root.getDataPointer()->getRaw().get() == m_root &&
+          "root belongs to a different tree");
+   SmallVector<CursorIndex, 16> path;
+   getPathFromRoot(path);
+   std::optional<Syntax> current = root;
+   for (CursorIndex index : path) {
+      current.emplace(*current->getChild(index));
+   }
+   return *current;
+}
+
+} // polar::syntax
@@ -0,0 +1,134 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/15.
+
+#include "polarphp/utils/ConcurrentStringInterner.h"
+#include "polarphp/basic/adt/StringMap.h"
+
+#include <cstring>
+#include <limits>
+
+namespace polar::utils {
+
+namespace {
+
+std::atomic<uint64_t> sg_nextInternerId{1};
+
+/// The arena the thread used last, and the interner it belongs to.
+struct ThreadArenaCache
+{
+   uint64_t internerId = 0;
+   BumpPtrAllocator *arena = nullptr;
+};
+
+thread_local ThreadArenaCache sg_threadArenaCache;
+
+} // anonymous namespace
+
+ConcurrentStringInterner::ConcurrentStringInterner()
+   : m_shards(new Shard[1 << sm_shardBits]),
+     m_id(sg_nextInternerId++)
+{}
+
+ConcurrentStringInterner::~ConcurrentStringInterner()
+{}
+
+InternedString ConcurrentStringInterner::intern(StringRef str)
+{
+   return intern(str, polar::basic::StringMapImpl::hash(str));
+}
+
+InternedString ConcurrentStringInterner::intern(StringRef str, uint32_t hash)
+{
+   assert(hash == polar::basic::StringMapImpl::hash(str) && "wrong precomputed hash");
+   assert(str.size() <= std::numeric_limits<uint32_t>::max() && "string too long");
+   Shard &shard = getShard(hash);
+   shard.internCalls.fetch_add(1, std::memory_order_relaxed);
+   shard.internedBytes.fetch_add(str.size(), std::memory_order_relaxed);
+   LookupKey key{str, hash};
+   {
+      std::shared_lock<std::shared_mutex> locker(shard.lock);
+      auto iter = shard.strings.findAs(key);
+      if (iter != shard.strings.end()) {
+         return *iter;
+      }
+   }
+   std::unique_lock<std::shared_mutex> locker(shard.lock);
+   // Another thread may have added the string since the shared lock was
+   // released.
+   auto iter = shard.strings.findAs(key);
+   if (iter != shard.strings.end()) {
+      return *iter;
+   }
+   size_t size = sizeof(InternedString::Header) + str.size() + 1;
+   void *memory = getThreadArena().allocate(size, alignof(InternedString::Header));
+   auto *header = new (memory) InternedString::Header{static_cast<uint32_t>(str.size()), hash};
+   char *data = reinterpret_cast<char *>(header + 1);
+   if (!str.empty()) {
+      std::memcpy(data, str.data(), str.size());
+   }
+   data[str.size()] = '\0';
+   InternedString interned(header);
+   shard.strings.insert(interned);
+   shard.storedBytes += size;
+   return interned;
+}
+
+InternedString ConcurrentStringInterner::find(StringRef str) const
+{
+   uint32_t hash = polar::basic::StringMapImpl::hash(str);
+   Shard &shard = getShard(hash);
+   std::shared_lock<std::shared_mutex> locker(shard.lock);
+   auto iter = shard.strings.findAs(LookupKey{str, hash});
+   return iter != shard.strings.end() ? *iter : InternedString();
+}
+
+size_t ConcurrentStringInterner::getSize() const
+{
+   size_t size = 0;
+   for (unsigned index = 0; index < (1u << sm_shardBits); ++index) {
+      std::shared_lock<std::shared_mutex> locker(m_shards[index].lock);
+      size += m_shards[index].strings.size();
+   }
+   return size;
+}
+
+ConcurrentStringInterner::Statistics ConcurrentStringInterner::getStatistics() const
+{
+   Statistics statistics;
+   for (unsigned index = 0; index < (1u << sm_shardBits); ++index) {
+      const Shard &shard = m_shards[index];
+      std::shared_lock<std::shared_mutex> locker(shard.lock);
+      statistics.internCalls += shard.internCalls.load(std::memory_order_relaxed);
+      statistics.internedBytes += shard.internedBytes.load(std::memory_order_relaxed);
+      statistics.uniqueStrings += shard.strings.size();
+      statistics.storedBytes += shard.storedBytes;
+   }
+   return statistics;
+}
+
+BumpPtrAllocator &ConcurrentStringInterner::getThreadArena()
+{
+   ThreadArenaCache &cache = sg_threadArenaCache;
+   if (cache.internerId == m_id) {
+      return *cache.arena;
+   }
+   std::lock_guard<std::mutex> locker(m_arenaLock);
+   BumpPtrAllocator *&arena = m_threadArenas[std::this_thread::get_id()];
+   if (!arena) {
+      m_arenas.push_back(std::make_unique<BumpPtrAllocator>());
+      arena = m_arenas.back().get();
+   }
+   cache.internerId = m_id;
+   cache.arena = arena;
+   return *arena;
+}
+
+} // polar::utils
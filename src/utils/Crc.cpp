@@ -16,62 +16,389 @@
 //
 // Created by polarboy on 2019/09/26.
 
+//===----------------------------------------------------------------------===//
+//
+// Both CRCs are computed on the bit-reflected register, without the initial
+// and final inversion, by one of:
+//
+//  - slicing-by-8 table lookup, the portable fallback;
+//  - the SSE4.2 crc32 instruction for CRC32C, running three independent
+//    streams to hide its latency and merging them with table-driven shifts;
+//  - carry-less multiplication (PCLMULQDQ) folding for CRC32, following
+//    Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+//    Instruction".
+//
+// The combine functions use zlib's multiply-modulo-P method. The parallel
+// functions checksum pieces of a buffer on a ThreadPool and combine them.
+//
+//===----------------------------------------------------------------------===//
+
 #include "polarphp/utils/Crc.h"
-#include <mutex>
+#include "polarphp/utils/Endian.h"
+#include "polarphp/utils/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define POLAR_CRC_X86_KERNELS 1
+#include <immintrin.h>
+#endif
 
 namespace polar::utils {
 
-//#if POLAR_ENABLE_ZLIB == 0 || !HAVE_ZLIB_H
-#ifndef HAVE_ZLIB_H
-using CRC32Table = std::array<uint32_t, 256>;
+namespace {
+
+constexpr uint32_t sg_crc32Poly = 0xEDB88320U;
+constexpr uint32_t sg_crc32cPoly = 0x82F63B78U;
+
+using SliceTables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr SliceTables make_slice_tables(uint32_t poly)
+{
+   SliceTables tables{};
+   for (uint32_t index = 0; index < 256; ++index) {
+      uint32_t value = index;
+      for (unsigned bit = 0; bit < 8; ++bit) {
+         value = (value & 1) ? (value >> 1) ^ poly : value >> 1;
+      }
+      tables[0][index] = value;
+   }
+   for (uint32_t index = 0; index < 256; ++index) {
+      for (unsigned slice = 1; slice < 8; ++slice) {
+         uint32_t previous = tables[slice - 1][index];
+         tables[slice][index] = (previous >> 8) ^ tables[0][previous & 0xFF];
+      }
+   }
+   return tables;
+}
+
+constexpr SliceTables sg_crc32Tables = make_slice_tables(sg_crc32Poly);
+constexpr SliceTables sg_crc32cTables = make_slice_tables(sg_crc32cPoly);
+
+/// Updates the CRC register with \p length bytes, eight at a time.
+uint32_t slice_by_8(const SliceTables &tables, uint32_t crc, const uint8_t *ptr, size_t length)
+{
+   while (length != 0 && (reinterpret_cast<uintptr_t>(ptr) & 7) != 0) {
+      crc = tables[0][(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
+      --length;
+   }
+   for (; length >= 8; length -= 8, ptr += 8) {
+      uint32_t low = endian::read32le(ptr) ^ crc;
+      uint32_t high = endian::read32le(ptr + 4);
+      crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^
+            tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+            tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^
+            tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+   }
+   while (length--) {
+      crc = tables[0][(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
+   }
+   return crc;
+}
+
+uint32_t generic_crc32(uint32_t crc, const uint8_t *ptr, size_t length)
+{
+   return slice_by_8(sg_crc32Tables, crc, ptr, length);
+}
+
+uint32_t generic_crc32c(uint32_t crc, const uint8_t *ptr, size_t length)
+{
+   return slice_by_8(sg_crc32cTables, crc, ptr, length);
+}
+
+/// a(x) * b(x) modulo p(x), in the reflected bit order, where the top bit
+/// holds the x^0 coefficient.
+constexpr uint32_t multiply_modulo(uint32_t lhs, uint32_t rhs, uint32_t poly)
+{
+   uint32_t product = 0;
+   for (uint32_t mask = 1U << 31; mask != 0; mask >>= 1) {
+      if (lhs & mask) {
+         product ^= rhs;
+      }
+      rhs = (rhs & 1) ? (rhs >> 1) ^ poly : rhs >> 1;
+   }
+   return product;
+}
+
+/// x^(8 * length) modulo p(x), the operator that appends \p length zero
+/// bytes to a CRC register.
+constexpr uint32_t zeros_operator(uint64_t length, uint32_t poly)
+{
+   // Start from x^8 and square it for every bit of the length.
+   uint32_t power = 1U << 23;
+   uint32_t result = 1U << 31;
+   while (length != 0) {
+      if (length & 1) {
+         result = multiply_modulo(power, result, poly);
+      }
+      power = multiply_modulo(power, power, poly);
+      length >>= 1;
+   }
+   return result;
+}
+
+uint32_t combine(uint32_t crc1, uint32_t crc2, uint64_t length2, uint32_t poly)
+{
+   // The inversions applied to the two CRCs cancel out, so the combination
+   // is the same for the raw registers and the finished values.
+   return multiply_modulo(zeros_operator(length2, poly), crc1, poly) ^ crc2;
+}
+
+#ifdef POLAR_CRC_X86_KERNELS
 
-static void init_crc32_table(CRC32Table *table) {
-   auto shuffle = [](uint32_t value) {
-      return (value & 1) ? (value >> 1) ^ 0xEDB88320U : value >> 1;
-   };
+/// Appends a fixed number of zero bytes to a CRC register with four table
+/// lookups, which is how the three CRC32C streams are merged.
+struct ZerosTable
+{
+   uint32_t table[4][256];
+
+   ZerosTable(size_t length, uint32_t poly)
+   {
+      uint32_t op = zeros_operator(length, poly);
+      for (unsigned slice = 0; slice < 4; ++slice) {
+         for (uint32_t index = 0; index < 256; ++index) {
+            table[slice][index] = multiply_modulo(op, index << (8 * slice), poly);
+         }
+      }
+   }
+
+   uint32_t shift(uint32_t crc) const
+   {
+      return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^
+            table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+   }
+};
+
+constexpr size_t sg_crc32cLongBlock = 8192;
+constexpr size_t sg_crc32cShortBlock = 256;
+
+#define POLAR_SSE42 __attribute__((target("sse4.2")))
 
-   for (size_t index = 0; index < table->size(); ++index) {
-      uint32_t value = shuffle(index);
-      value = shuffle(value);
-      value = shuffle(value);
-      value = shuffle(value);
-      value = shuffle(value);
-      value = shuffle(value);
-      value = shuffle(value);
-      (*table)[index] = shuffle(value);
+/// Runs the crc32 instruction over three consecutive blocks of \p block
+/// bytes at once and merges the results.
+POLAR_SSE42 inline uint32_t sse42_crc32c_blocks(uint32_t crc, const uint8_t *&ptr, size_t &length,
+                                                size_t block, const ZerosTable &zeros)
+{
+   while (length >= 3 * block) {
+      uint64_t crc0 = crc;
+      uint64_t crc1 = 0;
+      uint64_t crc2 = 0;
+      const uint8_t *end = ptr + block;
+      do {
+         crc0 = _mm_crc32_u64(crc0, endian::read64le(ptr));
+         crc1 = _mm_crc32_u64(crc1, endian::read64le(ptr + block));
+         crc2 = _mm_crc32_u64(crc2, endian::read64le(ptr + 2 * block));
+         ptr += 8;
+      } while (ptr != end);
+      crc = zeros.shift(static_cast<uint32_t>(crc0)) ^ static_cast<uint32_t>(crc1);
+      crc = zeros.shift(crc) ^ static_cast<uint32_t>(crc2);
+      ptr += 2 * block;
+      length -= 3 * block;
+   }
+   return crc;
+}
+
+POLAR_SSE42 uint32_t sse42_crc32c(uint32_t crc, const uint8_t *ptr, size_t length)
+{
+   static const ZerosTable longZeros(sg_crc32cLongBlock, sg_crc32cPoly);
+   static const ZerosTable shortZeros(sg_crc32cShortBlock, sg_crc32cPoly);
+   while (length != 0 && (reinterpret_cast<uintptr_t>(ptr) & 7) != 0) {
+      crc = _mm_crc32_u8(crc, *ptr++);
+      --length;
+   }
+   crc = sse42_crc32c_blocks(crc, ptr, length, sg_crc32cLongBlock, longZeros);
+   crc = sse42_crc32c_blocks(crc, ptr, length, sg_crc32cShortBlock, shortZeros);
+   uint64_t crc64 = crc;
+   for (; length >= 8; length -= 8, ptr += 8) {
+      crc64 = _mm_crc32_u64(crc64, endian::read64le(ptr));
+   }
+   crc = static_cast<uint32_t>(crc64);
+   while (length--) {
+      crc = _mm_crc32_u8(crc, *ptr++);
    }
+   return crc;
 }
 
-uint32_t crc32(uint32_t crc, StringRef str)
+#undef POLAR_SSE42
+
+#define POLAR_PCLMUL __attribute__((target("pclmul,sse4.1")))
+
+POLAR_PCLMUL inline __m128i load_block(const uint8_t *ptr)
+{
+   return _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+}
+
+/// Multiplies the two halves of \p value by the two fold constants and adds
+/// the block \p next.
+POLAR_PCLMUL inline __m128i fold_block(__m128i value, __m128i constants, __m128i next)
+{
+   __m128i low = _mm_clmulepi64_si128(value, constants, 0x00);
+   __m128i high = _mm_clmulepi64_si128(value, constants, 0x11);
+   return _mm_xor_si128(_mm_xor_si128(low, high), next);
+}
+
+/// Folds \p length bytes, a multiple of 16 and at least 64, into the CRC32
+/// register. The constants are x^n mod P(x) for the fold distances, bit
+/// reflected, and the Barrett reduction constants of P(x).
+POLAR_PCLMUL uint32_t pclmul_crc32_folds(uint32_t crc, const uint8_t *ptr, size_t length)
 {
-   static std::once_flag InitFlag;
-   static CRC32Table table;
-   std::call_once(InitFlag, init_crc32_table, &table);
+   const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+   const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+   const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+   const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+   const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
 
-   const uint8_t *ptr = reinterpret_cast<const uint8_t *>(str.data());
-   size_t len = str.size();
-   crc ^= 0xFFFFFFFFU;
-   for (; len >= 8; len -= 8) {
-      crc = table[(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
-      crc = table[(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
-      crc = table[(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
-      crc = table[(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
-      crc = table[(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
-      crc = table[(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
-      crc = table[(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
-      crc = table[(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
+   __m128i x1 = _mm_xor_si128(load_block(ptr), _mm_cvtsi32_si128(static_cast<int>(crc)));
+   __m128i x2 = load_block(ptr + 16);
+   __m128i x3 = load_block(ptr + 32);
+   __m128i x4 = load_block(ptr + 48);
+   ptr += 64;
+   length -= 64;
+   // Fold four 128-bit lanes 512 bits ahead at a time.
+   for (; length >= 64; length -= 64, ptr += 64) {
+      x1 = fold_block(x1, k1k2, load_block(ptr));
+      x2 = fold_block(x2, k1k2, load_block(ptr + 16));
+      x3 = fold_block(x3, k1k2, load_block(ptr + 32));
+      x4 = fold_block(x4, k1k2, load_block(ptr + 48));
    }
-   while (len--) {
-      crc = table[(crc ^ *ptr++) & 0xFF] ^ (crc >> 8);
+   // Fold the lanes into one, then the remaining 16-byte blocks.
+   x1 = fold_block(x1, k3k4, x2);
+   x1 = fold_block(x1, k3k4, x3);
+   x1 = fold_block(x1, k3k4, x4);
+   for (; length >= 16; length -= 16, ptr += 16) {
+      x1 = fold_block(x1, k3k4, load_block(ptr));
    }
-   return crc ^ 0xFFFFFFFFU;
+   // Fold 128 bits into 64.
+   x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+   x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+   x2 = _mm_srli_si128(x1, 4);
+   x1 = _mm_and_si128(x1, mask32);
+   x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2);
+   // Barrett reduction to 32 bits.
+   x2 = _mm_and_si128(x1, mask32);
+   x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+   x2 = _mm_and_si128(x2, mask32);
+   x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+   x1 = _mm_xor_si128(x1, x2);
+   return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
 }
-#else
-#include <zlib.h>
-uint32_t crc32(uint32_t crc, StringRef str)
+
+uint32_t pclmul_crc32(uint32_t crc, const uint8_t *ptr, size_t length)
+{
+   if (length >= 64) {
+      size_t folded = length & ~static_cast<size_t>(15);
+      crc = pclmul_crc32_folds(crc, ptr, folded);
+      ptr += folded;
+      length -= folded;
+   }
+   return slice_by_8(sg_crc32Tables, crc, ptr, length);
+}
+
+#undef POLAR_PCLMUL
+
+#endif // POLAR_CRC_X86_KERNELS
+
+using CrcFunc = uint32_t (*)(uint32_t crc, const uint8_t *ptr, size_t length);
+
+CrcFunc select_crc32()
 {
-   return ::crc32(crc, (const Bytef *)str.data(), str.size());
+#ifdef POLAR_CRC_X86_KERNELS
+   if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+      return pclmul_crc32;
+   }
+#endif
+   return generic_crc32;
 }
+
+CrcFunc select_crc32c()
+{
+#if defined(POLAR_CRC_X86_KERNELS) && defined(__x86_64__)
+   if (__builtin_cpu_supports("sse4.2")) {
+      return sse42_crc32c;
+   }
 #endif
+   return generic_crc32c;
+}
+
+using CrcChunkFunc = uint32_t (*)(uint32_t crc, ArrayRef<uint8_t> data);
+using CrcCombineFunc = uint32_t (*)(uint32_t crc1, uint32_t crc2, uint64_t length2);
+
+uint32_t parallel_crc(uint32_t crc, ArrayRef<uint8_t> data, ThreadPool &pool,
+                      size_t chunkSize, CrcChunkFunc chunkCrc, CrcCombineFunc combineCrcs)
+{
+   assert(chunkSize > 0 && "chunks must not be empty");
+   size_t numChunks = (data.getSize() + chunkSize - 1) / chunkSize;
+   if (numChunks <= 1) {
+      return chunkCrc(crc, data);
+   }
+   std::vector<uint32_t> chunkCrcs(numChunks);
+   std::vector<std::shared_future<void>> futures;
+   futures.reserve(numChunks - 1);
+   for (size_t index = 1; index < numChunks; ++index) {
+      futures.push_back(pool.async([&, index]() {
+         chunkCrcs[index] = chunkCrc(0, data.slice(index * chunkSize).takeFront(chunkSize));
+      }));
+   }
+   crc = chunkCrc(crc, data.takeFront(chunkSize));
+   for (size_t index = 1; index < numChunks; ++index) {
+      futures[index - 1].wait();
+      size_t length = std::min(chunkSize, data.getSize() - index * chunkSize);
+      crc = combineCrcs(crc, chunkCrcs[index], length);
+   }
+   return crc;
+}
+
+} // anonymous namespace
+
+uint32_t crc32(uint32_t crc, ArrayRef<uint8_t> data)
+{
+   static const CrcFunc impl = select_crc32();
+   return ~impl(~crc, data.getData(), data.getSize());
+}
+
+uint32_t crc32c(uint32_t crc, ArrayRef<uint8_t> data)
+{
+   static const CrcFunc impl = select_crc32c();
+   return ~impl(~crc, data.getData(), data.getSize());
+}
+
+namespace internal {
+
+uint32_t crc32_slicing_by_8(uint32_t crc, ArrayRef<uint8_t> data)
+{
+   return ~generic_crc32(~crc, data.getData(), data.getSize());
+}
+
+uint32_t crc32c_slicing_by_8(uint32_t crc, ArrayRef<uint8_t> data)
+{
+   return ~generic_crc32c(~crc, data.getData(), data.getSize());
+}
+
+} // internal
+
+uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, uint64_t length2)
+{
+   return combine(crc1, crc2, length2, sg_crc32Poly);
+}
+
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t length2)
+{
+   return combine(crc1, crc2, length2, sg_crc32cPoly);
+}
+
+uint32_t crc32_parallel(uint32_t crc, ArrayRef<uint8_t> data, ThreadPool &pool,
+                        size_t chunkSize)
+{
+   return parallel_crc(crc, data, pool, chunkSize, crc32, crc32_combine);
+}
+
+uint32_t crc32c_parallel(uint32_t crc, ArrayRef<uint8_t> data, ThreadPool &pool,
+                         size_t chunkSize)
+{
+   return parallel_crc(crc, data, pool, chunkSize, crc32c, crc32c_combine);
+}
 
 } // polar::utils
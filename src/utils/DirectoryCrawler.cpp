@@ -0,0 +1,368 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/14.
+
+#include "polarphp/utils/DirectoryCrawler.h"
+#include "polarphp/utils/SpecialCaseList.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <thread>
+#include <utility>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace polar::utils {
+
+namespace {
+
+using DirectoryListing = std::vector<std::pair<std::string, FileType>>;
+
+FileType file_type_from_dirent(unsigned char type)
+{
+   switch (type) {
+   case DT_DIR:
+      return FileType::directory_file;
+   case DT_REG:
+      return FileType::regular_file;
+   case DT_LNK:
+      return FileType::symlink_file;
+   case DT_BLK:
+      return FileType::block_file;
+   case DT_CHR:
+      return FileType::character_file;
+   case DT_FIFO:
+      return FileType::fifo_file;
+   case DT_SOCK:
+      return FileType::socket_file;
+   default:
+      return FileType::type_unknown;
+   }
+}
+
+bool is_dot_or_dot_dot(const char *name)
+{
+   return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+#if defined(__linux__) && defined(SYS_getdents64)
+
+/// The record getdents64 fills the buffer with, glibc does not declare it.
+struct LinuxDirent64
+{
+   uint64_t d_ino;
+   int64_t d_off;
+   unsigned short d_reclen;
+   unsigned char d_type;
+   char d_name[1];
+};
+
+/// Reads the entries of \p path without the stat calls of readdir based
+/// iteration, many entries per system call.
+std::error_code read_directory(const std::string &path, DirectoryListing &entries)
+{
+   int fd;
+   do {
+      fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+   } while (fd < 0 && errno == EINTR);
+   if (fd < 0) {
+      return std::error_code(errno, std::generic_category());
+   }
+   alignas(LinuxDirent64) char buffer[32 * 1024];
+   std::error_code errorCode;
+   while (true) {
+      long readBytes = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+      if (readBytes < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         errorCode = std::error_code(errno, std::generic_category());
+         break;
+      }
+      if (readBytes == 0) {
+         break;
+      }
+      for (long offset = 0; offset < readBytes;) {
+         auto *entry = reinterpret_cast<LinuxDirent64 *>(buffer + offset);
+         offset += entry->d_reclen;
+         if (!is_dot_or_dot_dot(entry->d_name)) {
+            entries.emplace_back(entry->d_name, file_type_from_dirent(entry->d_type));
+         }
+      }
+   }
+   ::close(fd);
+   return errorCode;
+}
+
+#else
+
+std::error_code read_directory(const std::string &path, DirectoryListing &entries)
+{
+   DIR *directory = ::opendir(path.c_str());
+   if (!directory) {
+      return std::error_code(errno, std::generic_category());
+   }
+   std::error_code errorCode;
+   while (true) {
+      errno = 0;
+      dirent *entry = ::readdir(directory);
+      if (!entry) {
+         if (errno != 0) {
+            errorCode = std::error_code(errno, std::generic_category());
+         }
+         break;
+      }
+      if (!is_dot_or_dot_dot(entry->d_name)) {
+         entries.emplace_back(entry->d_name, file_type_from_dirent(entry->d_type));
+      }
+   }
+   ::closedir(directory);
+   return errorCode;
+}
+
+#endif
+
+std::string join_path(StringRef parent, StringRef name)
+{
+   std::string path;
+   path.reserve(parent.size() + name.size() + 1);
+   path.append(parent.begin(), parent.end());
+   if (!path.empty() && path.back() != '/') {
+      path.push_back('/');
+   }
+   path.append(name.begin(), name.end());
+   return path;
+}
+
+} // anonymous namespace
+
+bool CrawlQueue::pop(CrawlEntry &entry)
+{
+   std::unique_lock<std::mutex> locker(m_lock);
+   m_condition.wait(locker, [this] { return !m_entries.empty() || m_closed; });
+   if (m_entries.empty()) {
+      return false;
+   }
+   entry = std::move(m_entries.front());
+   m_entries.pop_front();
+   return true;
+}
+
+bool CrawlQueue::popAll(std::vector<CrawlEntry> &entries)
+{
+   std::unique_lock<std::mutex> locker(m_lock);
+   m_condition.wait(locker, [this] { return !m_entries.empty() || m_closed; });
+   if (m_entries.empty()) {
+      return false;
+   }
+   std::move(m_entries.begin(), m_entries.end(), std::back_inserter(entries));
+   m_entries.clear();
+   return true;
+}
+
+void CrawlQueue::push(std::vector<CrawlEntry> &entries)
+{
+   {
+      std::lock_guard<std::mutex> locker(m_lock);
+      std::move(entries.begin(), entries.end(), std::back_inserter(m_entries));
+   }
+   entries.clear();
+   m_condition.notify_all();
+}
+
+void CrawlQueue::open()
+{
+   std::lock_guard<std::mutex> locker(m_lock);
+   m_closed = false;
+}
+
+void CrawlQueue::close()
+{
+   {
+      std::lock_guard<std::mutex> locker(m_lock);
+      m_closed = true;
+   }
+   m_condition.notify_all();
+}
+
+DirectoryCrawler::DirectoryCrawler(unsigned threadCount)
+   : m_pool(threadCount != 0 ? threadCount
+                             : std::max(1u, std::thread::hardware_concurrency()))
+{}
+
+DirectoryCrawler::~DirectoryCrawler()
+{
+   wait();
+}
+
+Error DirectoryCrawler::addIncludePattern(StringRef pattern)
+{
+   m_patternTexts.push_back(pattern.getStr());
+   Expected<GlobPattern> glob = GlobPattern::create(m_patternTexts.back());
+   if (!glob) {
+      return glob.takeError();
+   }
+   m_includes.push_back(std::move(*glob));
+   return Error::getSuccess();
+}
+
+Error DirectoryCrawler::addExcludePattern(StringRef pattern)
+{
+   m_patternTexts.push_back(pattern.getStr());
+   Expected<GlobPattern> glob = GlobPattern::create(m_patternTexts.back());
+   if (!glob) {
+      return glob.takeError();
+   }
+   m_excludes.push_back(std::move(*glob));
+   return Error::getSuccess();
+}
+
+void DirectoryCrawler::setSpecialCaseList(const SpecialCaseList *list, StringRef section)
+{
+   m_specialCaseList = list;
+   m_specialCaseSection = section.getStr();
+}
+
+bool DirectoryCrawler::isExcluded(StringRef relativePath) const
+{
+   for (const GlobPattern &pattern : m_excludes) {
+      if (pattern.match(relativePath)) {
+         return true;
+      }
+   }
+   return m_specialCaseList &&
+         m_specialCaseList->inSection(m_specialCaseSection, "src", relativePath);
+}
+
+bool DirectoryCrawler::isIncluded(StringRef relativePath) const
+{
+   if (m_includes.empty()) {
+      return true;
+   }
+   for (const GlobPattern &pattern : m_includes) {
+      if (pattern.match(relativePath)) {
+         return true;
+      }
+   }
+   return false;
+}
+
+bool DirectoryCrawler::markVisited(const polar::fs::FileStatus &status)
+{
+   std::lock_guard<std::mutex> locker(m_visitedLock);
+   return m_visitedDirs.insert(status.getUniqueId()).second;
+}
+
+void DirectoryCrawler::start(ArrayRef<std::string> roots, CrawlQueue &queue)
+{
+   queue.open();
+   if (roots.empty()) {
+      queue.close();
+      return;
+   }
+   {
+      std::lock_guard<std::mutex> locker(m_visitedLock);
+      m_visitedDirs.clear();
+   }
+   // Count all roots up front, so the first finished root cannot close the
+   // queue while the others are still being scheduled.
+   m_pendingDirs += roots.size();
+   for (const std::string &root : roots) {
+      m_pool.async([this, root, &queue] {
+         crawlDirectory(root, std::string(), queue);
+      });
+   }
+}
+
+void DirectoryCrawler::wait()
+{
+   m_pool.wait();
+}
+
+std::vector<CrawlEntry> DirectoryCrawler::crawl(ArrayRef<std::string> roots)
+{
+   CrawlQueue queue;
+   start(roots, queue);
+   std::vector<CrawlEntry> entries;
+   while (queue.popAll(entries)) {
+   }
+   wait();
+   std::sort(entries.begin(), entries.end(),
+             [](const CrawlEntry &lhs, const CrawlEntry &rhs) {
+      return lhs.path < rhs.path;
+   });
+   return entries;
+}
+
+void DirectoryCrawler::schedule(std::string path, std::string relativePath,
+                                CrawlQueue &queue)
+{
+   ++m_pendingDirs;
+   m_pool.async([this, path = std::move(path), relativePath = std::move(relativePath),
+                &queue]() mutable {
+      crawlDirectory(std::move(path), std::move(relativePath), queue);
+   });
+}
+
+void DirectoryCrawler::crawlDirectory(std::string path, std::string relativePath,
+                                      CrawlQueue &queue)
+{
+   std::vector<CrawlEntry> found;
+   DirectoryListing listing;
+   bool enter = true;
+   if (m_followSymlinks) {
+      polar::fs::FileStatus status;
+      enter = !polar::fs::status(path, status) && markVisited(status);
+   }
+   if (enter) {
+      if (std::error_code errorCode = read_directory(path, listing)) {
+         found.push_back(CrawlEntry{path, FileType::status_error, errorCode});
+      }
+   }
+   for (auto &entry : listing) {
+      const std::string &name = entry.first;
+      FileType type = entry.second;
+      if (m_skipHidden && name[0] == '.') {
+         continue;
+      }
+      std::string entryPath = join_path(path, name);
+      std::string entryRelativePath = join_path(relativePath, name);
+      if (isExcluded(entryRelativePath)) {
+         continue;
+      }
+      if (type == FileType::type_unknown ||
+          (type == FileType::symlink_file && m_followSymlinks)) {
+         polar::fs::FileStatus status;
+         if (!polar::fs::status(entryPath, status, m_followSymlinks)) {
+            type = status.getType();
+         }
+      }
+      if (type == FileType::directory_file && m_recursive) {
+         schedule(std::move(entryPath), std::move(entryRelativePath), queue);
+      } else if (isIncluded(entryRelativePath)) {
+         found.push_back(CrawlEntry{std::move(entryPath), type, std::error_code()});
+      }
+   }
+   if (!found.empty()) {
+      queue.push(found);
+   }
+   // The subdirectories were counted before, so this only reaches zero once
+   // everything is read.
+   if (--m_pendingDirs == 0) {
+      queue.close();
+   }
+}
+
+} // polar::utils
@@ -260,6 +260,11 @@ public:
    {
       return MemoryBuffer::BufferKind::MemoryBuffer_MMap;
    }
+
+   bool advise(MappedFileRegion::AccessAdvice advice) const override
+   {
+      return !m_mfr.advise(advice);
+   }
 };
 }
 
@@ -188,6 +188,12 @@ void write_hex(RawOutStream &outStream, uint64_t N, HexPrintStyle style,
 void write_double(RawOutStream &outStream, double N, FloatStyle style,
                   std::optional<size_t> precision)
 {
+   if (style == FloatStyle::Shortest) {
+      char buf[sg_maxShortestDoubleLength];
+      outStream.write(buf, format_shortest_double(N, buf));
+      return;
+   }
+
    size_t prec = precision.value_or(get_default_precision(style));
 
    if (std::isnan(N)) {
@@ -289,6 +295,8 @@ size_t get_default_precision(FloatStyle style)
    case FloatStyle::Fixed:
    case FloatStyle::Percent:
       return 2; // Number of decimal places.
+   case FloatStyle::Shortest:
+      return 0; // The digits needed to round trip.
    }
    POLAR_BUILTIN_UNREACHABLE;
 }
@@ -74,40 +74,143 @@ unsigned SourceMgr::addIncludeFile(const std::string &filename,
    return addNewSourceBuffer(std::move(*newBufOrErr), includeLoc);
 }
 
-unsigned SourceMgr::findBufferContainingLoc(SMLocation loc) const
+SourceMgr::SourceMgr(SourceMgr &&other)
+   : m_buffers(std::move(other.m_buffers)),
+     m_bufferIndex(std::move(other.m_bufferIndex)),
+     m_hasOverlappingBuffers(other.m_hasOverlappingBuffers),
+     m_lastLookupBufferID(other.m_lastLookupBufferID.load(std::memory_order_relaxed)),
+     m_includeDirectories(std::move(other.m_includeDirectories)),
+     m_diagHandler(other.m_diagHandler),
+     m_diagContext(other.m_diagContext)
 {
-   for (unsigned i = 0, e = m_buffers.size(); i != e; ++i) {
-      if (loc.getPointer() >= m_buffers[i].m_buffer->getBufferStart() &&
-          // Use <= here so that a pointer to the null at the end of the buffer
-          // is included as part of the buffer.
-          loc.getPointer() <= m_buffers[i].m_buffer->getBufferEnd()) {
-         return i + 1;
+   other.m_lastLookupBufferID.store(0, std::memory_order_relaxed);
+}
+
+SourceMgr &SourceMgr::operator=(SourceMgr &&other)
+{
+   m_buffers = std::move(other.m_buffers);
+   m_bufferIndex = std::move(other.m_bufferIndex);
+   m_hasOverlappingBuffers = other.m_hasOverlappingBuffers;
+   m_lastLookupBufferID.store(other.m_lastLookupBufferID.load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+   other.m_lastLookupBufferID.store(0, std::memory_order_relaxed);
+   m_includeDirectories = std::move(other.m_includeDirectories);
+   m_diagHandler = other.m_diagHandler;
+   m_diagContext = other.m_diagContext;
+   return *this;
+}
+
+unsigned SourceMgr::addNewSourceBuffer(std::unique_ptr<MemoryBuffer> buffer,
+                                       SMLocation includeLoc)
+{
+   BufferRange range;
+   range.start = buffer->getBufferStart();
+   range.end = buffer->getBufferEnd();
+   range.maxEnd = range.end;
+   range.bufferID = m_buffers.size() + 1;
+
+   SrcBuffer sbuffer;
+   sbuffer.m_buffer = std::move(buffer);
+   sbuffer.m_includeLoc = includeLoc;
+   m_buffers.push_back(std::move(sbuffer));
+
+   // Buffers are mostly allocated at increasing addresses, so the new range
+   // usually goes to the back and nothing has to be moved.
+   auto pos = std::upper_bound(m_bufferIndex.begin(), m_bufferIndex.end(), range.start,
+                               [](const char *start, const BufferRange &other) {
+      return start < other.start;
+   });
+   if ((pos != m_bufferIndex.begin() && (pos - 1)->maxEnd >= range.start) ||
+       (pos != m_bufferIndex.end() && pos->start <= range.end)) {
+      m_hasOverlappingBuffers = true;
+   }
+   size_t index = m_bufferIndex.insert(pos, range) - m_bufferIndex.begin();
+   // Recompute the running maximum of the ends behind the new range until
+   // it no longer changes.
+   for (; index < m_bufferIndex.size(); ++index) {
+      BufferRange &current = m_bufferIndex[index];
+      const char *maxEnd = current.end;
+      if (index > 0) {
+         maxEnd = std::max(maxEnd, m_bufferIndex[index - 1].maxEnd);
+      }
+      if (current.maxEnd == maxEnd && current.bufferID != range.bufferID) {
+         break;
       }
+      current.maxEnd = maxEnd;
    }
-   return 0;
+   return range.bufferID;
 }
 
-template <typename T>
-unsigned SourceMgr::SrcBuffer::getLineNumber(const char *ptr) const
+unsigned SourceMgr::lookUpBuffer(SMLocation loc, bool preferLast) const
 {
-   // Ensure m_offsetCache is allocated and populated with offsets of all the
-   // '\n' bytes.
-   std::vector<T> *offsets = nullptr;
-   if (m_offsetCache.isNull()) {
-      offsets = new std::vector<T>();
-      m_offsetCache = offsets;
-      size_t size = m_buffer->getBufferSize();
-      assert(size <= std::numeric_limits<T>::max());
-      StringRef str = m_buffer->getBuffer();
-      for (size_t N = 0; N < size; ++N) {
-         if (str[N] == '\n') {
-            offsets->push_back(static_cast<T>(N));
+   const char *ptr = loc.getPointer();
+   // Use <= for the end here and below so that a pointer to the null at the
+   // end of the buffer is included as part of the buffer.
+   if (!m_hasOverlappingBuffers) {
+      unsigned lastBufferID = m_lastLookupBufferID.load(std::memory_order_relaxed);
+      if (isValidBufferID(lastBufferID)) {
+         const MemoryBuffer *buffer = m_buffers[lastBufferID - 1].m_buffer.get();
+         if (ptr >= buffer->getBufferStart() && ptr <= buffer->getBufferEnd()) {
+            return lastBufferID;
          }
       }
-   } else {
-      offsets = m_offsetCache.get<std::vector<T> *>();
    }
+   // Walk backwards from the last range starting at or before the location
+   // until no earlier range can reach it. Without overlapping buffers the
+   // first candidate is the only one.
+   auto iter = std::upper_bound(m_bufferIndex.begin(), m_bufferIndex.end(), ptr,
+                                [](const char *location, const BufferRange &range) {
+      return location < range.start;
+   });
+   unsigned result = 0;
+   while (iter != m_bufferIndex.begin()) {
+      --iter;
+      if (iter->maxEnd < ptr) {
+         break;
+      }
+      if (ptr > iter->end) {
+         continue;
+      }
+      if (!m_hasOverlappingBuffers) {
+         result = iter->bufferID;
+         break;
+      }
+      if (result == 0 || (preferLast ? iter->bufferID > result : iter->bufferID < result)) {
+         result = iter->bufferID;
+      }
+   }
+   if (result != 0) {
+      m_lastLookupBufferID.store(result, std::memory_order_relaxed);
+   }
+   return result;
+}
 
+template <typename T>
+const SourceMgr::SrcBuffer::LineTable<T> &SourceMgr::SrcBuffer::getLineTable() const
+{
+   // Ensure m_offsetCache is allocated and populated with offsets of all the
+   // '\n' and '\r' bytes.
+   if (!m_offsetCache.isNull()) {
+      return *m_offsetCache.get<LineTable<T> *>();
+   }
+   LineTable<T> *table = new LineTable<T>();
+   m_offsetCache = table;
+   size_t size = m_buffer->getBufferSize();
+   assert(size <= std::numeric_limits<T>::max());
+   const char *data = m_buffer->getBufferStart();
+   for (const char *iter = data, *end = data + size;
+        (iter = std::find_if(iter, end, [](char c) { return c == '\n' || c == '\r'; })) != end;
+        ++iter) {
+      (*iter == '\n' ? table->newlines : table->carriageReturns)
+            .push_back(static_cast<T>(iter - data));
+   }
+   return *table;
+}
+
+template <typename T>
+std::pair<unsigned, size_t> SourceMgr::SrcBuffer::getLineAndColumnStart(const char *ptr) const
+{
+   const LineTable<T> &table = getLineTable<T>();
    const char *bufStart = m_buffer->getBufferStart();
    assert(ptr >= bufStart && ptr <= m_buffer->getBufferEnd());
    ptrdiff_t ptrDiff = ptr - bufStart;
@@ -115,13 +218,97 @@ unsigned SourceMgr::SrcBuffer::getLineNumber(const char *ptr) const
    T ptrOffset = static_cast<T>(ptrDiff);
 
    // polar::basic::lower_bound gives the number of EOL before PtrOffset. Add 1 to get
-   // the line number.
-   return polar::basic::lower_bound(*offsets, ptrOffset) - offsets->begin() + 1;
+   // the line number. The column starts after the last '\n' or '\r' in front
+   // of the offset.
+   size_t numNewlines = polar::basic::lower_bound(table.newlines, ptrOffset) -
+         table.newlines.begin();
+   size_t numCarriageReturns = polar::basic::lower_bound(table.carriageReturns, ptrOffset) -
+         table.carriageReturns.begin();
+   size_t columnStart = 0;
+   if (numNewlines > 0) {
+      columnStart = static_cast<size_t>(table.newlines[numNewlines - 1]) + 1;
+   }
+   if (numCarriageReturns > 0) {
+      columnStart = std::max(columnStart,
+                             static_cast<size_t>(table.carriageReturns[numCarriageReturns - 1]) + 1);
+   }
+   return std::make_pair(static_cast<unsigned>(numNewlines + 1), columnStart);
+}
+
+template <typename T>
+void SourceMgr::SrcBuffer::getLinesAndColumnStarts(
+      ArrayRef<const char *> ptrs,
+      SmallVectorImpl<std::pair<unsigned, size_t>> &result) const
+{
+   const LineTable<T> &table = getLineTable<T>();
+   const char *bufStart = m_buffer->getBufferStart();
+   size_t numNewlines = 0;
+   size_t numCarriageReturns = 0;
+   const char *prevPtr = bufStart;
+   for (const char *ptr : ptrs) {
+      assert(ptr >= bufStart && ptr <= m_buffer->getBufferEnd());
+      assert(ptr >= prevPtr && "locations have to be sorted");
+      prevPtr = ptr;
+      size_t ptrOffset = ptr - bufStart;
+      while (numNewlines < table.newlines.size() && table.newlines[numNewlines] < ptrOffset) {
+         ++numNewlines;
+      }
+      while (numCarriageReturns < table.carriageReturns.size() &&
+             table.carriageReturns[numCarriageReturns] < ptrOffset) {
+         ++numCarriageReturns;
+      }
+      size_t columnStart = 0;
+      if (numNewlines > 0) {
+         columnStart = static_cast<size_t>(table.newlines[numNewlines - 1]) + 1;
+      }
+      if (numCarriageReturns > 0) {
+         columnStart = std::max(columnStart,
+                                static_cast<size_t>(table.carriageReturns[numCarriageReturns - 1]) + 1);
+      }
+      result.push_back(std::make_pair(static_cast<unsigned>(numNewlines + 1), columnStart));
+   }
+}
+
+namespace {
+
+/// The number of bytes covered by one entry of the UTF-8 index.
+constexpr size_t sg_utf8IndexStride = 1024;
+
+size_t count_utf8_code_points(const char *begin, const char *end)
+{
+   // Every byte but the continuation bytes 10xxxxxx starts a code point.
+   size_t count = 0;
+   for (; begin != end; ++begin) {
+      count += (static_cast<unsigned char>(*begin) & 0xC0) != 0x80;
+   }
+   return count;
+}
+
+} // anonymous namespace
+
+size_t SourceMgr::SrcBuffer::countUtf8CodePoints(size_t offset) const
+{
+   const char *data = m_buffer->getBufferStart();
+   if (!m_utf8Index) {
+      size_t size = m_buffer->getBufferSize();
+      m_utf8Index = std::make_unique<std::vector<uint32_t>>();
+      m_utf8Index->reserve(size / sg_utf8IndexStride + 1);
+      size_t count = 0;
+      for (size_t blockStart = 0; blockStart <= size; blockStart += sg_utf8IndexStride) {
+         m_utf8Index->push_back(static_cast<uint32_t>(count));
+         count += count_utf8_code_points(data + blockStart,
+                                         data + std::min(size, blockStart + sg_utf8IndexStride));
+      }
+   }
+   size_t block = offset / sg_utf8IndexStride;
+   return (*m_utf8Index)[block] +
+         count_utf8_code_points(data + block * sg_utf8IndexStride, data + offset);
 }
 
 SourceMgr::SrcBuffer::SrcBuffer(SourceMgr::SrcBuffer &&other)
    : m_buffer(std::move(other.m_buffer)),
      m_offsetCache(other.m_offsetCache),
+     m_utf8Index(std::move(other.m_utf8Index)),
      m_includeLoc(other.m_includeLoc)
 {
    other.m_offsetCache = nullptr;
@@ -130,19 +317,39 @@ SourceMgr::SrcBuffer::SrcBuffer(SourceMgr::SrcBuffer &&other)
 SourceMgr::SrcBuffer::~SrcBuffer()
 {
    if (!m_offsetCache.isNull()) {
-      if (m_offsetCache.is<std::vector<uint8_t>*>()) {
-         delete m_offsetCache.get<std::vector<uint8_t>*>();
-      } else if (m_offsetCache.is<std::vector<uint16_t>*>()) {
-         delete m_offsetCache.get<std::vector<uint16_t>*>();
-      } else if (m_offsetCache.is<std::vector<uint32_t>*>()) {
-         delete m_offsetCache.get<std::vector<uint32_t>*>();
+      if (m_offsetCache.is<LineTable<uint8_t>*>()) {
+         delete m_offsetCache.get<LineTable<uint8_t>*>();
+      } else if (m_offsetCache.is<LineTable<uint16_t>*>()) {
+         delete m_offsetCache.get<LineTable<uint16_t>*>();
+      } else if (m_offsetCache.is<LineTable<uint32_t>*>()) {
+         delete m_offsetCache.get<LineTable<uint32_t>*>();
       } else {
-         delete m_offsetCache.get<std::vector<uint64_t>*>();
+         delete m_offsetCache.get<LineTable<uint64_t>*>();
       }
       m_offsetCache = nullptr;
    }
 }
 
+namespace {
+
+/// Call \p func with a zero value of the smallest offset type that can hold
+/// all offsets into a buffer of \p size bytes.
+template <typename Function>
+void dispatch_on_offset_type(size_t size, Function func)
+{
+   if (size <= std::numeric_limits<uint8_t>::max()) {
+      func(uint8_t());
+   } else if (size <= std::numeric_limits<uint16_t>::max()) {
+      func(uint16_t());
+   } else if (size <= std::numeric_limits<uint32_t>::max()) {
+      func(uint32_t());
+   } else {
+      func(uint64_t());
+   }
+}
+
+} // anonymous namespace
+
 std::pair<unsigned, unsigned>
 SourceMgr::getLineAndColumn(SMLocation loc, unsigned bufferID) const
 {
@@ -152,24 +359,59 @@ SourceMgr::getLineAndColumn(SMLocation loc, unsigned bufferID) const
    assert(bufferID && "Invalid Location!");
    auto &sb = getBufferInfo(bufferID);
    const char *ptr = loc.getPointer();
+   std::pair<unsigned, size_t> lineAndColumnStart;
+   dispatch_on_offset_type(sb.m_buffer->getBufferSize(), [&](auto offsetType) {
+      lineAndColumnStart = sb.getLineAndColumnStart<decltype(offsetType)>(ptr);
+   });
+   size_t ptrOffset = ptr - sb.m_buffer->getBufferStart();
+   return std::make_pair(lineAndColumnStart.first,
+                         static_cast<unsigned>(ptrOffset - lineAndColumnStart.second + 1));
+}
 
-   size_t size = sb.m_buffer->getBufferSize();
-   unsigned lineNo;
-   if (size <= std::numeric_limits<uint8_t>::max()) {
-      lineNo = sb.getLineNumber<uint8_t>(ptr);
-   } else if (size <= std::numeric_limits<uint16_t>::max()) {
-      lineNo = sb.getLineNumber<uint16_t>(ptr);
-   } else if (size <= std::numeric_limits<uint32_t>::max()) {
-      lineNo = sb.getLineNumber<uint32_t>(ptr);
-   } else {
-      lineNo = sb.getLineNumber<uint64_t>(ptr);
+std::pair<unsigned, unsigned>
+SourceMgr::getLineAndUtf8Column(SMLocation loc, unsigned bufferID) const
+{
+   if (!bufferID) {
+      bufferID = findBufferContainingLoc(loc);
+   }
+   assert(bufferID && "Invalid Location!");
+   auto &sb = getBufferInfo(bufferID);
+   const char *ptr = loc.getPointer();
+   std::pair<unsigned, size_t> lineAndColumnStart;
+   dispatch_on_offset_type(sb.m_buffer->getBufferSize(), [&](auto offsetType) {
+      lineAndColumnStart = sb.getLineAndColumnStart<decltype(offsetType)>(ptr);
+   });
+   size_t ptrOffset = ptr - sb.m_buffer->getBufferStart();
+   return std::make_pair(lineAndColumnStart.first,
+                         static_cast<unsigned>(sb.countUtf8CodePoints(ptrOffset) -
+                                               sb.countUtf8CodePoints(lineAndColumnStart.second) + 1));
+}
+
+void SourceMgr::getLinesAndColumns(ArrayRef<SMLocation> locations, unsigned bufferID,
+                                   SmallVectorImpl<std::pair<unsigned, unsigned>> &result,
+                                   bool utf8Columns) const
+{
+   auto &sb = getBufferInfo(bufferID);
+   SmallVector<const char *, 64> ptrs;
+   ptrs.reserve(locations.size());
+   for (SMLocation loc : locations) {
+      ptrs.push_back(loc.getPointer());
    }
+   SmallVector<std::pair<unsigned, size_t>, 64> lineAndColumnStarts;
+   lineAndColumnStarts.reserve(locations.size());
+   dispatch_on_offset_type(sb.m_buffer->getBufferSize(), [&](auto offsetType) {
+      sb.getLinesAndColumnStarts<decltype(offsetType)>(ptrs, lineAndColumnStarts);
+   });
    const char *bufStart = sb.m_buffer->getBufferStart();
-   size_t newlineOffs = StringRef(bufStart, ptr-bufStart).findLastOf("\n\r");
-   if (newlineOffs == StringRef::npos) {
-      newlineOffs = ~(size_t)0;
+   for (size_t index = 0; index < ptrs.size(); ++index) {
+      size_t ptrOffset = ptrs[index] - bufStart;
+      size_t columnStart = lineAndColumnStarts[index].second;
+      size_t column = utf8Columns
+            ? sb.countUtf8CodePoints(ptrOffset) - sb.countUtf8CodePoints(columnStart) + 1
+            : ptrOffset - columnStart + 1;
+      result.push_back(std::make_pair(lineAndColumnStarts[index].first,
+                                      static_cast<unsigned>(column)));
    }
-   return std::make_pair(lineNo, ptr-bufStart-newlineOffs);
 }
 
 void SourceMgr::printIncludeStack(SMLocation includeLoc, RawOutStream &outstream) const
@@ -24,6 +24,7 @@
 #include "polarphp/basic/adt/SmallString.h"
 #include "polarphp/basic/adt/SmallVector.h"
 #include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/basic/adt/StringMap.h"
 #include "polarphp/basic/adt/StringSet.h"
 #include "polarphp/basic/adt/Twine.h"
 #include "polarphp/basic/adt/IteratorRange.h"
@@ -631,6 +632,298 @@ DirectoryIterator OverlayFileSystem::dirBegin(const Twine &dir, std::error_code
 void ProxyFileSystem::anchor()
 {}
 
+namespace {
+
+/// The names and types of the entries of a directory.
+using DirectoryListing = std::vector<std::pair<std::string, FileType>>;
+
+bool is_missing_file_error(std::error_code errorCode)
+{
+   return errorCode == std::errc::no_such_file_or_directory ||
+         errorCode == std::errc::not_a_directory;
+}
+
+/// Iterates a cached directory listing. The entry paths are built from the
+/// directory as it was passed to dirBegin, like the real file system does.
+class CachedDirIterImpl : public internal::DirIterImpl
+{
+public:
+   CachedDirIterImpl(std::string dir, std::shared_ptr<const DirectoryListing> listing)
+      : m_dir(std::move(dir)),
+        m_listing(std::move(listing))
+   {
+      setCurrentEntry();
+   }
+
+   std::error_code increment() override
+   {
+      ++m_index;
+      setCurrentEntry();
+      return std::error_code();
+   }
+
+private:
+   void setCurrentEntry()
+   {
+      if (m_index == m_listing->size()) {
+         m_currentEntry = DirectoryEntry();
+         return;
+      }
+      const auto &entry = (*m_listing)[m_index];
+      SmallString<256> path(m_dir);
+      polar::fs::path::append(path, entry.first);
+      m_currentEntry = DirectoryEntry(path.getStr(), entry.second);
+   }
+
+private:
+   std::string m_dir;
+   std::shared_ptr<const DirectoryListing> m_listing;
+   size_t m_index = 0;
+};
+
+} // anonymous namespace
+
+struct CachingFileSystem::Shard
+{
+   struct CachedStatus
+   {
+      Status status;
+      /// Set if the status failed.
+      std::error_code error;
+      Clock::time_point cachedAt;
+   };
+
+   struct CachedDirectory
+   {
+      std::shared_ptr<const DirectoryListing> listing;
+      /// Set if the directory could not be opened.
+      std::error_code error;
+      Clock::time_point cachedAt;
+   };
+
+   std::mutex lock;
+   StringMap<CachedStatus> statuses;
+   StringMap<CachedDirectory> directories;
+};
+
+CachingFileSystem::CachingFileSystem(IntrusiveRefCountPtr<FileSystem> fs,
+                                     Clock::duration timeToLive)
+   : ProxyFileSystem(std::move(fs)),
+     m_shards(new Shard[sm_numShards]),
+     m_timeToLive(timeToLive.count())
+{
+   if (auto workingDir = getUnderlyingFs().getCurrentWorkingDirectory()) {
+      m_workingDir = std::move(*workingDir);
+   }
+}
+
+CachingFileSystem::~CachingFileSystem()
+{}
+
+void CachingFileSystem::makeCacheKey(const Twine &path, SmallVectorImpl<char> &key) const
+{
+   path.toVector(key);
+   if (polar::fs::path::is_absolute(key)) {
+      return;
+   }
+   std::lock_guard<std::mutex> guard(m_workingDirLock);
+   if (!m_workingDir.empty()) {
+      polar::fs::make_absolute(m_workingDir, key);
+   }
+}
+
+CachingFileSystem::Shard &CachingFileSystem::getShard(StringRef key) const
+{
+   return m_shards[static_cast<size_t>(hash_value(key)) % sm_numShards];
+}
+
+bool CachingFileSystem::isExpired(Clock::time_point cachedAt) const
+{
+   Clock::duration timeToLive = getTimeToLive();
+   return timeToLive != Clock::duration::zero() &&
+         Clock::now() - cachedAt > timeToLive;
+}
+
+OptionalError<Status> CachingFileSystem::getStatus(const Twine &path)
+{
+   SmallString<256> key;
+   makeCacheKey(path, key);
+   Shard &shard = getShard(key);
+   {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      auto iter = shard.statuses.find(key);
+      if (iter != shard.statuses.end() && !isExpired(iter->second.cachedAt)) {
+         ++m_statusHits;
+         if (iter->second.error) {
+            ++m_negativeStatusHits;
+            return iter->second.error;
+         }
+         return Status::copyWithNewName(iter->second.status, path);
+      }
+   }
+   ++m_statusMisses;
+   OptionalError<Status> result = getUnderlyingFs().getStatus(path);
+   // A transient failure, like running out of file descriptors, must not
+   // outlive the call that ran into it.
+   if (!result && !is_missing_file_error(result.getError())) {
+      return result;
+   }
+   std::lock_guard<std::mutex> guard(shard.lock);
+   Shard::CachedStatus &entry = shard.statuses[key];
+   entry.status = result ? *result : Status();
+   entry.error = result.getError();
+   entry.cachedAt = Clock::now();
+   return result;
+}
+
+OptionalError<std::unique_ptr<File>>
+CachingFileSystem::openFileForRead(const Twine &path)
+{
+   SmallString<256> key;
+   makeCacheKey(path, key);
+   Shard &shard = getShard(key);
+   {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      auto iter = shard.statuses.find(key);
+      if (iter != shard.statuses.end() && !isExpired(iter->second.cachedAt) &&
+          is_missing_file_error(iter->second.error)) {
+         ++m_openHits;
+         return iter->second.error;
+      }
+   }
+   ++m_openMisses;
+   OptionalError<std::unique_ptr<File>> result = getUnderlyingFs().openFileForRead(path);
+   // Other failures, like a denied permission, say nothing about the status.
+   if (!result && is_missing_file_error(result.getError())) {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      Shard::CachedStatus &entry = shard.statuses[key];
+      entry.status = Status();
+      entry.error = result.getError();
+      entry.cachedAt = Clock::now();
+   }
+   return result;
+}
+
+DirectoryIterator CachingFileSystem::dirBegin(const Twine &dir, std::error_code &errorCode)
+{
+   SmallString<256> key;
+   makeCacheKey(dir, key);
+   Shard &shard = getShard(key);
+   std::string dirPath = dir.getStr();
+   {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      auto iter = shard.directories.find(key);
+      if (iter != shard.directories.end() && !isExpired(iter->second.cachedAt)) {
+         ++m_directoryHits;
+         errorCode = iter->second.error;
+         if (errorCode) {
+            return DirectoryIterator();
+         }
+         return DirectoryIterator(std::make_shared<CachedDirIterImpl>(
+                                     std::move(dirPath), iter->second.listing));
+      }
+   }
+   ++m_directoryMisses;
+   DirectoryIterator dirIter = getUnderlyingFs().dirBegin(dirPath, errorCode);
+   if (errorCode) {
+      // Like getStatus, only remember that the directory is missing.
+      if (!is_missing_file_error(errorCode)) {
+         return dirIter;
+      }
+      std::lock_guard<std::mutex> guard(shard.lock);
+      Shard::CachedDirectory &entry = shard.directories[key];
+      entry.listing.reset();
+      entry.error = errorCode;
+      entry.cachedAt = Clock::now();
+      return dirIter;
+   }
+   auto listing = std::make_shared<DirectoryListing>();
+   std::error_code incrementError;
+   for (DirectoryIterator end; dirIter != end; dirIter.increment(incrementError)) {
+      if (incrementError) {
+         break;
+      }
+      listing->emplace_back(polar::fs::path::filename(dirIter->path()).getStr(),
+                            dirIter->type());
+   }
+   if (incrementError) {
+      // An incomplete listing is not cached, let the caller see the error
+      // where the wrapped file system reports it.
+      return getUnderlyingFs().dirBegin(dirPath, errorCode);
+   }
+   {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      Shard::CachedDirectory &entry = shard.directories[key];
+      entry.listing = listing;
+      entry.error = std::error_code();
+      entry.cachedAt = Clock::now();
+   }
+   return DirectoryIterator(std::make_shared<CachedDirIterImpl>(std::move(dirPath),
+                                                                std::move(listing)));
+}
+
+OptionalError<std::string> CachingFileSystem::getCurrentWorkingDirectory() const
+{
+   std::lock_guard<std::mutex> guard(m_workingDirLock);
+   return m_workingDir;
+}
+
+std::error_code CachingFileSystem::setCurrentWorkingDirectory(const Twine &path)
+{
+   if (std::error_code errorCode = getUnderlyingFs().setCurrentWorkingDirectory(path)) {
+      return errorCode;
+   }
+   OptionalError<std::string> workingDir = getUnderlyingFs().getCurrentWorkingDirectory();
+   std::lock_guard<std::mutex> guard(m_workingDirLock);
+   if (workingDir) {
+      m_workingDir = std::move(*workingDir);
+   } else {
+      m_workingDir.clear();
+   }
+   return std::error_code();
+}
+
+void CachingFileSystem::invalidate(const Twine &path)
+{
+   SmallString<256> key;
+   makeCacheKey(path, key);
+   {
+      Shard &shard = getShard(key);
+      std::lock_guard<std::mutex> guard(shard.lock);
+      shard.statuses.erase(key);
+      shard.directories.erase(key);
+   }
+   StringRef parent = polar::fs::path::parent_path(key);
+   if (!parent.empty()) {
+      Shard &shard = getShard(parent);
+      std::lock_guard<std::mutex> guard(shard.lock);
+      shard.directories.erase(parent);
+   }
+}
+
+void CachingFileSystem::invalidateAll()
+{
+   for (unsigned index = 0; index < sm_numShards; ++index) {
+      Shard &shard = m_shards[index];
+      std::lock_guard<std::mutex> guard(shard.lock);
+      shard.statuses.clear();
+      shard.directories.clear();
+   }
+}
+
+CachingFileSystem::Statistics CachingFileSystem::getStatistics() const
+{
+   Statistics stats;
+   stats.statusHits = m_statusHits.load(std::memory_order_relaxed);
+   stats.statusMisses = m_statusMisses.load(std::memory_order_relaxed);
+   stats.negativeStatusHits = m_negativeStatusHits.load(std::memory_order_relaxed);
+   stats.openHits = m_openHits.load(std::memory_order_relaxed);
+   stats.openMisses = m_openMisses.load(std::memory_order_relaxed);
+   stats.directoryHits = m_directoryHits.load(std::memory_order_relaxed);
+   stats.directoryMisses = m_directoryMisses.load(std::memory_order_relaxed);
+   return stats;
+}
+
 namespace internal {
 
 enum InMemoryNodeKind { IME_File, IME_Directory, IME_HardLink };
@@ -0,0 +1,818 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+/*
+*  xxHash - Fast Hash algorithm
+*  Copyright (C) 2012-2020 Yann Collet
+*
+*  BSD 2-Clause License (https://www.opensource.org/licenses/bsd-license.php)
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are
+*  met:
+*
+*  * Redistributions of source code must retain the above copyright
+*  notice, this list of conditions and the following disclaimer.
+*  * Redistributions in binary form must reproduce the above
+*  copyright notice, this list of conditions and the following disclaimer
+*  in the documentation and/or other materials provided with the
+*  distribution.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+*  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+*  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+*  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+*  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*  You can contact the author at :
+*  - xxHash homepage: https://www.xxhash.com
+*  - xxHash source repository : https://github.com/Cyan4973/xxHash
+*/
+
+/* based on xxHash 0.8.2, reduced to the default secret and seeded XXH3
+ * 64-bit and 128-bit hashes with their streaming variants. */
+
+#include "polarphp/utils/Xxh3.h"
+#include "polarphp/utils/Endian.h"
+#include "polarphp/utils/SwapByteOrder.h"
+
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define POLAR_XXH3_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace polar::utils {
+
+namespace {
+
+constexpr uint32_t sg_prime32_1 = 0x9E3779B1U;
+constexpr uint32_t sg_prime32_2 = 0x85EBCA77U;
+constexpr uint32_t sg_prime32_3 = 0xC2B2AE3DU;
+constexpr uint64_t sg_prime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t sg_prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t sg_prime64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t sg_prime64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t sg_prime64_5 = 0x27D4EB2F165667C5ULL;
+constexpr uint64_t sg_primeMx1 = 0x165667919E3779F9ULL;
+constexpr uint64_t sg_primeMx2 = 0x9FB21C651E98DF25ULL;
+
+constexpr size_t sg_stripeLength = 64;
+constexpr size_t sg_secretConsumeRate = 8;
+constexpr size_t sg_secretSizeMin = 136;
+constexpr size_t sg_secretSize = 192;
+constexpr size_t sg_secretLimit = sg_secretSize - sg_stripeLength;
+constexpr size_t sg_stripesPerBlock = sg_secretLimit / sg_secretConsumeRate;
+constexpr size_t sg_secretLastAccStart = 7;
+constexpr size_t sg_secretMergeAccsStart = 11;
+constexpr size_t sg_midSizeMax = 240;
+constexpr size_t sg_midSizeStartOffset = 3;
+constexpr size_t sg_midSizeLastOffset = 17;
+
+/// Pseudorandom secret taken directly from FARSH.
+alignas(64) const uint8_t sg_secret[sg_secretSize] = {
+   0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+   0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+   0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+   0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+   0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+   0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+   0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+   0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+   0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+   0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+   0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+   0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+inline uint64_t read64(const uint8_t *ptr)
+{
+   return endian::read64le(ptr);
+}
+
+inline uint32_t read32(const uint8_t *ptr)
+{
+   return endian::read32le(ptr);
+}
+
+inline uint64_t rotl64(uint64_t value, unsigned shift)
+{
+   return (value << shift) | (value >> (64 - shift));
+}
+
+inline uint32_t rotl32(uint32_t value, unsigned shift)
+{
+   return (value << shift) | (value >> (32 - shift));
+}
+
+inline uint64_t xorshift64(uint64_t value, unsigned shift)
+{
+   return value ^ (value >> shift);
+}
+
+inline Hash128 mult64to128(uint64_t lhs, uint64_t rhs)
+{
+#if defined(__SIZEOF_INT128__)
+   unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+   return {static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64)};
+#else
+   uint64_t loLo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+   uint64_t hiLo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+   uint64_t loHi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+   uint64_t hiHi = (lhs >> 32) * (rhs >> 32);
+   uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+   uint64_t upper = (hiLo >> 32) + (cross >> 32) + hiHi;
+   uint64_t lower = (cross << 32) | (loLo & 0xFFFFFFFF);
+   return {lower, upper};
+#endif
+}
+
+inline uint64_t mul128_fold64(uint64_t lhs, uint64_t rhs)
+{
+   Hash128 product = mult64to128(lhs, rhs);
+   return product.low64 ^ product.high64;
+}
+
+inline uint64_t xxh64_avalanche(uint64_t hash)
+{
+   hash ^= hash >> 33;
+   hash *= sg_prime64_2;
+   hash ^= hash >> 29;
+   hash *= sg_prime64_3;
+   hash ^= hash >> 32;
+   return hash;
+}
+
+inline uint64_t avalanche(uint64_t hash)
+{
+   hash = xorshift64(hash, 37);
+   hash *= sg_primeMx1;
+   return xorshift64(hash, 32);
+}
+
+inline uint64_t rrmxmx(uint64_t hash, uint64_t length)
+{
+   hash ^= rotl64(hash, 49) ^ rotl64(hash, 24);
+   hash *= sg_primeMx2;
+   hash ^= (hash >> 35) + length;
+   hash *= sg_primeMx2;
+   return xorshift64(hash, 28);
+}
+
+//===----------------------------------------------------------------------===//
+// Short inputs, up to 240 bytes
+//===----------------------------------------------------------------------===//
+
+uint64_t hash64_len_1to3(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   uint32_t combined = (static_cast<uint32_t>(input[0]) << 16) |
+         (static_cast<uint32_t>(input[length >> 1]) << 24) |
+         static_cast<uint32_t>(input[length - 1]) |
+         (static_cast<uint32_t>(length) << 8);
+   uint64_t bitflip = (read32(secret) ^ read32(secret + 4)) + seed;
+   return xxh64_avalanche(combined ^ bitflip);
+}
+
+uint64_t hash64_len_4to8(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   seed ^= static_cast<uint64_t>(swap_byte_order32(static_cast<uint32_t>(seed))) << 32;
+   uint32_t input1 = read32(input);
+   uint32_t input2 = read32(input + length - 4);
+   uint64_t bitflip = (read64(secret + 8) ^ read64(secret + 16)) - seed;
+   uint64_t input64 = input2 + (static_cast<uint64_t>(input1) << 32);
+   return rrmxmx(input64 ^ bitflip, length);
+}
+
+uint64_t hash64_len_9to16(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   uint64_t bitflip1 = (read64(secret + 24) ^ read64(secret + 32)) + seed;
+   uint64_t bitflip2 = (read64(secret + 40) ^ read64(secret + 48)) - seed;
+   uint64_t inputLow = read64(input) ^ bitflip1;
+   uint64_t inputHigh = read64(input + length - 8) ^ bitflip2;
+   uint64_t acc = length + swap_byte_order64(inputLow) + inputHigh +
+         mul128_fold64(inputLow, inputHigh);
+   return avalanche(acc);
+}
+
+uint64_t hash64_len_0to16(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   if (length > 8) {
+      return hash64_len_9to16(input, length, secret, seed);
+   }
+   if (length >= 4) {
+      return hash64_len_4to8(input, length, secret, seed);
+   }
+   if (length) {
+      return hash64_len_1to3(input, length, secret, seed);
+   }
+   return xxh64_avalanche(seed ^ (read64(secret + 56) ^ read64(secret + 64)));
+}
+
+inline uint64_t mix16(const uint8_t *input, const uint8_t *secret, uint64_t seed)
+{
+   return mul128_fold64(read64(input) ^ (read64(secret) + seed),
+                        read64(input + 8) ^ (read64(secret + 8) - seed));
+}
+
+uint64_t hash64_len_17to128(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   uint64_t acc = length * sg_prime64_1;
+   if (length > 32) {
+      if (length > 64) {
+         if (length > 96) {
+            acc += mix16(input + 48, secret + 96, seed);
+            acc += mix16(input + length - 64, secret + 112, seed);
+         }
+         acc += mix16(input + 32, secret + 64, seed);
+         acc += mix16(input + length - 48, secret + 80, seed);
+      }
+      acc += mix16(input + 16, secret + 32, seed);
+      acc += mix16(input + length - 32, secret + 48, seed);
+   }
+   acc += mix16(input, secret, seed);
+   acc += mix16(input + length - 16, secret + 16, seed);
+   return avalanche(acc);
+}
+
+uint64_t hash64_len_129to240(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   uint64_t acc = length * sg_prime64_1;
+   unsigned rounds = static_cast<unsigned>(length) / 16;
+   for (unsigned i = 0; i < 8; ++i) {
+      acc += mix16(input + 16 * i, secret + 16 * i, seed);
+   }
+   acc = avalanche(acc);
+   uint64_t accEnd = mix16(input + length - 16,
+                           secret + sg_secretSizeMin - sg_midSizeLastOffset, seed);
+   for (unsigned i = 8; i < rounds; ++i) {
+      accEnd += mix16(input + 16 * i, secret + 16 * (i - 8) + sg_midSizeStartOffset, seed);
+   }
+   return avalanche(acc + accEnd);
+}
+
+Hash128 hash128_len_1to3(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   uint32_t combinedLow = (static_cast<uint32_t>(input[0]) << 16) |
+         (static_cast<uint32_t>(input[length >> 1]) << 24) |
+         static_cast<uint32_t>(input[length - 1]) |
+         (static_cast<uint32_t>(length) << 8);
+   uint32_t combinedHigh = rotl32(swap_byte_order32(combinedLow), 13);
+   uint64_t bitflipLow = (read32(secret) ^ read32(secret + 4)) + seed;
+   uint64_t bitflipHigh = (read32(secret + 8) ^ read32(secret + 12)) - seed;
+   return {xxh64_avalanche(combinedLow ^ bitflipLow),
+            xxh64_avalanche(combinedHigh ^ bitflipHigh)};
+}
+
+Hash128 hash128_len_4to8(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   seed ^= static_cast<uint64_t>(swap_byte_order32(static_cast<uint32_t>(seed))) << 32;
+   uint32_t inputLow = read32(input);
+   uint32_t inputHigh = read32(input + length - 4);
+   uint64_t input64 = inputLow + (static_cast<uint64_t>(inputHigh) << 32);
+   uint64_t bitflip = (read64(secret + 16) ^ read64(secret + 24)) + seed;
+   // Shifting the length keeps the multiplier odd.
+   Hash128 m128 = mult64to128(input64 ^ bitflip, sg_prime64_1 + (length << 2));
+   m128.high64 += m128.low64 << 1;
+   m128.low64 ^= m128.high64 >> 3;
+   m128.low64 = xorshift64(m128.low64, 35);
+   m128.low64 *= sg_primeMx2;
+   m128.low64 = xorshift64(m128.low64, 28);
+   m128.high64 = avalanche(m128.high64);
+   return m128;
+}
+
+Hash128 hash128_len_9to16(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   uint64_t bitflipLow = (read64(secret + 32) ^ read64(secret + 40)) - seed;
+   uint64_t bitflipHigh = (read64(secret + 48) ^ read64(secret + 56)) + seed;
+   uint64_t inputLow = read64(input);
+   uint64_t inputHigh = read64(input + length - 8);
+   Hash128 m128 = mult64to128(inputLow ^ inputHigh ^ bitflipLow, sg_prime64_1);
+   m128.low64 += static_cast<uint64_t>(length - 1) << 54;
+   inputHigh ^= bitflipHigh;
+   m128.high64 += inputHigh + static_cast<uint64_t>(static_cast<uint32_t>(inputHigh)) *
+         (sg_prime32_2 - 1);
+   m128.low64 ^= swap_byte_order64(m128.high64);
+   Hash128 h128 = mult64to128(m128.low64, sg_prime64_2);
+   h128.high64 += m128.high64 * sg_prime64_2;
+   h128.low64 = avalanche(h128.low64);
+   h128.high64 = avalanche(h128.high64);
+   return h128;
+}
+
+Hash128 hash128_len_0to16(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   if (length > 8) {
+      return hash128_len_9to16(input, length, secret, seed);
+   }
+   if (length >= 4) {
+      return hash128_len_4to8(input, length, secret, seed);
+   }
+   if (length) {
+      return hash128_len_1to3(input, length, secret, seed);
+   }
+   uint64_t bitflipLow = read64(secret + 64) ^ read64(secret + 72);
+   uint64_t bitflipHigh = read64(secret + 80) ^ read64(secret + 88);
+   return {xxh64_avalanche(seed ^ bitflipLow), xxh64_avalanche(seed ^ bitflipHigh)};
+}
+
+inline Hash128 mix32(Hash128 acc, const uint8_t *input1, const uint8_t *input2,
+                     const uint8_t *secret, uint64_t seed)
+{
+   acc.low64 += mix16(input1, secret, seed);
+   acc.low64 ^= read64(input2) + read64(input2 + 8);
+   acc.high64 += mix16(input2, secret + 16, seed);
+   acc.high64 ^= read64(input1) + read64(input1 + 8);
+   return acc;
+}
+
+inline Hash128 finish_mid128(Hash128 acc, size_t length, uint64_t seed)
+{
+   Hash128 h128;
+   h128.low64 = avalanche(acc.low64 + acc.high64);
+   h128.high64 = 0 - avalanche(acc.low64 * sg_prime64_1 + acc.high64 * sg_prime64_4 +
+                               (length - seed) * sg_prime64_2);
+   return h128;
+}
+
+Hash128 hash128_len_17to128(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   Hash128 acc = {length * sg_prime64_1, 0};
+   if (length > 32) {
+      if (length > 64) {
+         if (length > 96) {
+            acc = mix32(acc, input + 48, input + length - 64, secret + 96, seed);
+         }
+         acc = mix32(acc, input + 32, input + length - 48, secret + 64, seed);
+      }
+      acc = mix32(acc, input + 16, input + length - 32, secret + 32, seed);
+   }
+   acc = mix32(acc, input, input + length - 16, secret, seed);
+   return finish_mid128(acc, length, seed);
+}
+
+Hash128 hash128_len_129to240(const uint8_t *input, size_t length, const uint8_t *secret, uint64_t seed)
+{
+   Hash128 acc = {length * sg_prime64_1, 0};
+   for (size_t i = 32; i < 160; i += 32) {
+      acc = mix32(acc, input + i - 32, input + i - 16, secret + i - 32, seed);
+   }
+   acc.low64 = avalanche(acc.low64);
+   acc.high64 = avalanche(acc.high64);
+   for (size_t i = 160; i <= length; i += 32) {
+      acc = mix32(acc, input + i - 32, input + i - 16,
+                  secret + sg_midSizeStartOffset + i - 160, seed);
+   }
+   acc = mix32(acc, input + length - 16, input + length - 32,
+               secret + sg_secretSizeMin - sg_midSizeLastOffset - 16, 0 - seed);
+   return finish_mid128(acc, length, seed);
+}
+
+//===----------------------------------------------------------------------===//
+// Long inputs
+//===----------------------------------------------------------------------===//
+
+/// Accumulates \p stripes stripes of 64 bytes into the eight lanes of
+/// \p acc, advancing the secret by 8 bytes per stripe.
+using AccumulateFunc = void (*)(uint64_t *acc, const uint8_t *input,
+                                const uint8_t *secret, size_t stripes);
+/// Scrambles the lanes once a block of stripes has been accumulated.
+using ScrambleFunc = void (*)(uint64_t *acc, const uint8_t *secret);
+
+struct Xxh3Kernels
+{
+   AccumulateFunc accumulate;
+   ScrambleFunc scramble;
+};
+
+inline void scalar_accumulate_stripe(uint64_t *acc, const uint8_t *input, const uint8_t *secret)
+{
+   for (size_t lane = 0; lane < 8; ++lane) {
+      uint64_t value = read64(input + lane * 8);
+      uint64_t key = value ^ read64(secret + lane * 8);
+      acc[lane ^ 1] += value;
+      acc[lane] += (key & 0xFFFFFFFF) * (key >> 32);
+   }
+}
+
+void scalar_accumulate(uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t stripes)
+{
+   for (size_t i = 0; i < stripes; ++i) {
+      scalar_accumulate_stripe(acc, input + i * sg_stripeLength, secret + i * sg_secretConsumeRate);
+   }
+}
+
+void scalar_scramble(uint64_t *acc, const uint8_t *secret)
+{
+   for (size_t lane = 0; lane < 8; ++lane) {
+      uint64_t value = xorshift64(acc[lane], 47) ^ read64(secret + lane * 8);
+      acc[lane] = value * sg_prime32_1;
+   }
+}
+
+const Xxh3Kernels sg_scalarKernels = {
+   scalar_accumulate,
+   scalar_scramble
+};
+
+#if defined(POLAR_XXH3_X86_KERNELS) && defined(__SSE2__)
+
+// SSE2 is part of the x86-64 baseline, so these kernels need no target
+// attribute. The accumulators are 64-byte aligned.
+
+inline void sse2_accumulate_stripe(__m128i *acc, const uint8_t *input, const uint8_t *secret)
+{
+   for (size_t i = 0; i < sg_stripeLength / sizeof(__m128i); ++i) {
+      __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input) + i);
+      __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + i);
+      __m128i dataKey = _mm_xor_si128(data, key);
+      // (dataKey & 0xffffffff) * (dataKey >> 32) for both lanes.
+      __m128i dataKeyHigh = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+      __m128i product = _mm_mul_epu32(dataKey, dataKeyHigh);
+      __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      acc[i] = _mm_add_epi64(product, _mm_add_epi64(acc[i], swapped));
+   }
+}
+
+void sse2_accumulate(uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t stripes)
+{
+   __m128i *vectors = reinterpret_cast<__m128i *>(acc);
+   for (size_t i = 0; i < stripes; ++i) {
+      sse2_accumulate_stripe(vectors, input + i * sg_stripeLength, secret + i * sg_secretConsumeRate);
+   }
+}
+
+void sse2_scramble(uint64_t *acc, const uint8_t *secret)
+{
+   __m128i *vectors = reinterpret_cast<__m128i *>(acc);
+   const __m128i prime = _mm_set1_epi32(static_cast<int>(sg_prime32_1));
+   for (size_t i = 0; i < sg_stripeLength / sizeof(__m128i); ++i) {
+      __m128i value = _mm_xor_si128(vectors[i], _mm_srli_epi64(vectors[i], 47));
+      __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + i);
+      __m128i dataKey = _mm_xor_si128(value, key);
+      __m128i dataKeyHigh = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+      __m128i productLow = _mm_mul_epu32(dataKey, prime);
+      __m128i productHigh = _mm_mul_epu32(dataKeyHigh, prime);
+      vectors[i] = _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32));
+   }
+}
+
+const Xxh3Kernels sg_sse2Kernels = {
+   sse2_accumulate,
+   sse2_scramble
+};
+
+#endif // POLAR_XXH3_X86_KERNELS && __SSE2__
+
+#ifdef POLAR_XXH3_X86_KERNELS
+
+#define POLAR_AVX2 __attribute__((target("avx2")))
+
+POLAR_AVX2 inline void avx2_accumulate_stripe(__m256i *acc, const uint8_t *input, const uint8_t *secret)
+{
+   for (size_t i = 0; i < sg_stripeLength / sizeof(__m256i); ++i) {
+      __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input) + i);
+      __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(secret) + i);
+      __m256i dataKey = _mm256_xor_si256(data, key);
+      __m256i product = _mm256_mul_epu32(dataKey, _mm256_srli_epi64(dataKey, 32));
+      __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      acc[i] = _mm256_add_epi64(product, _mm256_add_epi64(acc[i], swapped));
+   }
+}
+
+POLAR_AVX2 void avx2_accumulate(uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t stripes)
+{
+   __m256i *vectors = reinterpret_cast<__m256i *>(acc);
+   for (size_t i = 0; i < stripes; ++i) {
+      avx2_accumulate_stripe(vectors, input + i * sg_stripeLength, secret + i * sg_secretConsumeRate);
+   }
+}
+
+POLAR_AVX2 void avx2_scramble(uint64_t *acc, const uint8_t *secret)
+{
+   __m256i *vectors = reinterpret_cast<__m256i *>(acc);
+   const __m256i prime = _mm256_set1_epi32(static_cast<int>(sg_prime32_1));
+   for (size_t i = 0; i < sg_stripeLength / sizeof(__m256i); ++i) {
+      __m256i value = _mm256_xor_si256(vectors[i], _mm256_srli_epi64(vectors[i], 47));
+      __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(secret) + i);
+      __m256i dataKey = _mm256_xor_si256(value, key);
+      __m256i productLow = _mm256_mul_epu32(dataKey, prime);
+      __m256i productHigh = _mm256_mul_epu32(_mm256_srli_epi64(dataKey, 32), prime);
+      vectors[i] = _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32));
+   }
+}
+
+#undef POLAR_AVX2
+
+const Xxh3Kernels sg_avx2Kernels = {
+   avx2_accumulate,
+   avx2_scramble
+};
+
+#endif // POLAR_XXH3_X86_KERNELS
+
+const Xxh3Kernels &select_kernels()
+{
+#ifdef POLAR_XXH3_X86_KERNELS
+   if (__builtin_cpu_supports("avx2")) {
+      return sg_avx2Kernels;
+   }
+#endif
+#if defined(POLAR_XXH3_X86_KERNELS) && defined(__SSE2__)
+   return sg_sse2Kernels;
+#else
+   return sg_scalarKernels;
+#endif
+}
+
+const Xxh3Kernels &get_kernels()
+{
+   static const Xxh3Kernels &kernels = select_kernels();
+   return kernels;
+}
+
+struct InitialAccumulators
+{
+   alignas(64) uint64_t lanes[8] = {
+      sg_prime32_3, sg_prime64_1, sg_prime64_2, sg_prime64_3,
+      sg_prime64_4, sg_prime32_2, sg_prime64_5, sg_prime32_1
+   };
+};
+
+void hash_long_loop(uint64_t *acc, const uint8_t *input, size_t length, const uint8_t *secret)
+{
+   const Xxh3Kernels &kernels = get_kernels();
+   constexpr size_t blockLength = sg_stripeLength * sg_stripesPerBlock;
+   size_t blocks = (length - 1) / blockLength;
+   for (size_t i = 0; i < blocks; ++i) {
+      kernels.accumulate(acc, input + i * blockLength, secret, sg_stripesPerBlock);
+      kernels.scramble(acc, secret + sg_secretLimit);
+   }
+   size_t stripes = ((length - 1) - blockLength * blocks) / sg_stripeLength;
+   kernels.accumulate(acc, input + blocks * blockLength, secret, stripes);
+   // The last stripe is always taken from the end of the input, so it may
+   // overlap the stripes accumulated already.
+   kernels.accumulate(acc, input + length - sg_stripeLength,
+                      secret + sg_secretLimit - sg_secretLastAccStart, 1);
+}
+
+uint64_t merge_accumulators(const uint64_t *acc, const uint8_t *secret, uint64_t start)
+{
+   uint64_t result = start;
+   for (size_t i = 0; i < 4; ++i) {
+      result += mul128_fold64(acc[2 * i] ^ read64(secret + 16 * i),
+                              acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+   }
+   return avalanche(result);
+}
+
+uint64_t merge_accumulators64(const uint64_t *acc, const uint8_t *secret, uint64_t length)
+{
+   return merge_accumulators(acc, secret + sg_secretMergeAccsStart, length * sg_prime64_1);
+}
+
+Hash128 merge_accumulators128(const uint64_t *acc, const uint8_t *secret, uint64_t length)
+{
+   Hash128 h128;
+   h128.low64 = merge_accumulators(acc, secret + sg_secretMergeAccsStart, length * sg_prime64_1);
+   h128.high64 = merge_accumulators(acc, secret + sg_secretSize - 64 - sg_secretMergeAccsStart,
+                                    ~(length * sg_prime64_2));
+   return h128;
+}
+
+/// Derives the secret of a seeded long hash from the default one.
+void init_custom_secret(uint8_t *customSecret, uint64_t seed)
+{
+   for (size_t i = 0; i < sg_secretSize / 16; ++i) {
+      endian::write64le(customSecret + 16 * i, read64(sg_secret + 16 * i) + seed);
+      endian::write64le(customSecret + 16 * i + 8, read64(sg_secret + 16 * i + 8) - seed);
+   }
+}
+
+uint64_t hash64_long(const uint8_t *input, size_t length, uint64_t seed)
+{
+   InitialAccumulators acc;
+   if (seed == 0) {
+      hash_long_loop(acc.lanes, input, length, sg_secret);
+      return merge_accumulators64(acc.lanes, sg_secret, length);
+   }
+   alignas(64) uint8_t secret[sg_secretSize];
+   init_custom_secret(secret, seed);
+   hash_long_loop(acc.lanes, input, length, secret);
+   return merge_accumulators64(acc.lanes, secret, length);
+}
+
+Hash128 hash128_long(const uint8_t *input, size_t length, uint64_t seed)
+{
+   InitialAccumulators acc;
+   if (seed == 0) {
+      hash_long_loop(acc.lanes, input, length, sg_secret);
+      return merge_accumulators128(acc.lanes, sg_secret, length);
+   }
+   alignas(64) uint8_t secret[sg_secretSize];
+   init_custom_secret(secret, seed);
+   hash_long_loop(acc.lanes, input, length, secret);
+   return merge_accumulators128(acc.lanes, secret, length);
+}
+
+uint64_t hash64(const uint8_t *input, size_t length, uint64_t seed)
+{
+   if (length <= 16) {
+      return hash64_len_0to16(input, length, sg_secret, seed);
+   }
+   if (length <= 128) {
+      return hash64_len_17to128(input, length, sg_secret, seed);
+   }
+   if (length <= sg_midSizeMax) {
+      return hash64_len_129to240(input, length, sg_secret, seed);
+   }
+   return hash64_long(input, length, seed);
+}
+
+Hash128 hash128(const uint8_t *input, size_t length, uint64_t seed)
+{
+   if (length <= 16) {
+      return hash128_len_0to16(input, length, sg_secret, seed);
+   }
+   if (length <= 128) {
+      return hash128_len_17to128(input, length, sg_secret, seed);
+   }
+   if (length <= sg_midSizeMax) {
+      return hash128_len_129to240(input, length, sg_secret, seed);
+   }
+   return hash128_long(input, length, seed);
+}
+
+/// Accumulates \p stripes stripes, scrambling whenever a block completes.
+/// \p stripesSoFar is the position within the current block.
+const uint8_t *consume_stripes(uint64_t *acc, size_t &stripesSoFar, const uint8_t *input,
+                               size_t stripes, const uint8_t *secret)
+{
+   const Xxh3Kernels &kernels = get_kernels();
+   const uint8_t *blockSecret = secret + stripesSoFar * sg_secretConsumeRate;
+   size_t stripesLeftInBlock = sg_stripesPerBlock - stripesSoFar;
+   while (stripes >= stripesLeftInBlock) {
+      kernels.accumulate(acc, input, blockSecret, stripesLeftInBlock);
+      kernels.scramble(acc, secret + sg_secretLimit);
+      input += stripesLeftInBlock * sg_stripeLength;
+      stripes -= stripesLeftInBlock;
+      stripesSoFar = 0;
+      stripesLeftInBlock = sg_stripesPerBlock;
+      blockSecret = secret;
+   }
+   if (stripes > 0) {
+      kernels.accumulate(acc, input, blockSecret, stripes);
+      input += stripes * sg_stripeLength;
+      stripesSoFar += stripes;
+   }
+   return input;
+}
+
+} // anonymous namespace
+
+SmallString<32> Hash128::getDigest() const
+{
+   static const char *const digits = "0123456789abcdef";
+   SmallString<32> str;
+   str.resize(32);
+   for (unsigned i = 0; i < 16; ++i) {
+      uint64_t half = i < 8 ? high64 : low64;
+      uint8_t byte = static_cast<uint8_t>(half >> (56 - 8 * (i % 8)));
+      str[2 * i] = digits[byte >> 4];
+      str[2 * i + 1] = digits[byte & 15];
+   }
+   return str;
+}
+
+uint64_t xxh3_hash64(ArrayRef<uint8_t> data, uint64_t seed)
+{
+   return hash64(data.getData(), data.getSize(), seed);
+}
+
+uint64_t xxh3_hash64(StringRef data, uint64_t seed)
+{
+   return hash64(reinterpret_cast<const uint8_t *>(data.getData()), data.getSize(), seed);
+}
+
+Hash128 xxh3_hash128(ArrayRef<uint8_t> data, uint64_t seed)
+{
+   return hash128(data.getData(), data.getSize(), seed);
+}
+
+Hash128 xxh3_hash128(StringRef data, uint64_t seed)
+{
+   return hash128(reinterpret_cast<const uint8_t *>(data.getData()), data.getSize(), seed);
+}
+
+void Xxh3::init(uint64_t seed)
+{
+   static_assert(SECRET_SIZE == sg_secretSize, "secret size mismatch");
+   static_assert(BUFFER_SIZE % sg_stripeLength == 0, "buffer must hold whole stripes");
+   std::memcpy(m_acc, InitialAccumulators().lanes, sizeof(m_acc));
+   if (seed != 0) {
+      init_custom_secret(m_customSecret, seed);
+   }
+   m_seed = seed;
+   m_totalLength = 0;
+   m_bufferedSize = 0;
+   m_stripesSoFar = 0;
+}
+
+const uint8_t *Xxh3::getSecret() const
+{
+   return m_seed != 0 ? m_customSecret : sg_secret;
+}
+
+void Xxh3::update(ArrayRef<uint8_t> data)
+{
+   const uint8_t *input = data.getData();
+   size_t length = data.getSize();
+   m_totalLength += length;
+   if (length <= BUFFER_SIZE - m_bufferedSize) {
+      if (length != 0) {
+         std::memcpy(m_buffer + m_bufferedSize, input, length);
+      }
+      m_bufferedSize += length;
+      return;
+   }
+   const uint8_t *end = input + length;
+   const uint8_t *secret = getSecret();
+   // Stripes are only accumulated once more input is known to follow, the
+   // final stripe is handled differently by the digest.
+   if (m_bufferedSize != 0) {
+      size_t loadSize = BUFFER_SIZE - m_bufferedSize;
+      std::memcpy(m_buffer + m_bufferedSize, input, loadSize);
+      input += loadSize;
+      consume_stripes(m_acc, m_stripesSoFar, m_buffer, BUFFER_SIZE / sg_stripeLength, secret);
+      m_bufferedSize = 0;
+   }
+   if (static_cast<size_t>(end - input) > BUFFER_SIZE) {
+      size_t stripes = static_cast<size_t>(end - 1 - input) / sg_stripeLength;
+      input = consume_stripes(m_acc, m_stripesSoFar, input, stripes, secret);
+      // Keep the last stripe for a digest that finds fewer than 64 bytes
+      // buffered.
+      std::memcpy(m_buffer + BUFFER_SIZE - sg_stripeLength, input - sg_stripeLength,
+                  sg_stripeLength);
+   }
+   m_bufferedSize = static_cast<size_t>(end - input);
+   std::memcpy(m_buffer, input, m_bufferedSize);
+}
+
+void Xxh3::digestLong(uint64_t *acc) const
+{
+   const uint8_t *secret = getSecret();
+   std::memcpy(acc, m_acc, sizeof(m_acc));
+   uint8_t lastStripe[sg_stripeLength];
+   const uint8_t *lastStripePtr;
+   if (m_bufferedSize >= sg_stripeLength) {
+      size_t stripes = (m_bufferedSize - 1) / sg_stripeLength;
+      size_t stripesSoFar = m_stripesSoFar;
+      consume_stripes(acc, stripesSoFar, m_buffer, stripes, secret);
+      lastStripePtr = m_buffer + m_bufferedSize - sg_stripeLength;
+   } else {
+      // Complete the last stripe with the tail of the previous buffer.
+      size_t catchupSize = sg_stripeLength - m_bufferedSize;
+      std::memcpy(lastStripe, m_buffer + BUFFER_SIZE - catchupSize, catchupSize);
+      std::memcpy(lastStripe + catchupSize, m_buffer, m_bufferedSize);
+      lastStripePtr = lastStripe;
+   }
+   get_kernels().accumulate(acc, lastStripePtr,
+                            secret + sg_secretLimit - sg_secretLastAccStart, 1);
+}
+
+uint64_t Xxh3::getHash64() const
+{
+   if (m_totalLength > sg_midSizeMax) {
+      alignas(64) uint64_t acc[8];
+      digestLong(acc);
+      return merge_accumulators64(acc, getSecret(), m_totalLength);
+   }
+   return hash64(m_buffer, static_cast<size_t>(m_totalLength), m_seed);
+}
+
+Hash128 Xxh3::getHash128() const
+{
+   if (m_totalLength > sg_midSizeMax) {
+      alignas(64) uint64_t acc[8];
+      digestLong(acc);
+      return merge_accumulators128(acc, getSecret(), m_totalLength);
+   }
+   return hash128(m_buffer, static_cast<size_t>(m_totalLength), m_seed);
+}
+
+} // polar::utils
@@ -891,6 +891,48 @@ int MappedFileRegion::getAlignment()
    return Process::getPageSizeEstimate();
 }
 
+std::error_code MappedFileRegion::advise(AccessAdvice advice) const
+{
+   assert(m_mapping && "Mapping failed but used anyway!");
+#if defined(POSIX_MADV_NORMAL)
+   int flag = POSIX_MADV_NORMAL;
+   switch (advice) {
+   case normal:
+      flag = POSIX_MADV_NORMAL;
+      break;
+   case sequential:
+      flag = POSIX_MADV_SEQUENTIAL;
+      break;
+   case willneed:
+      flag = POSIX_MADV_WILLNEED;
+      break;
+   case dontneed:
+      if (m_mode == priv) {
+         return make_error_code(ErrorCode::operation_not_permitted);
+      }
+#if defined(MADV_DONTNEED)
+      // posix_madvise() may ignore POSIX_MADV_DONTNEED, madvise() really
+      // drops the pages.
+      if (::madvise(m_mapping, m_size, MADV_DONTNEED) != 0) {
+         return std::error_code(errno, std::generic_category());
+      }
+      return std::error_code();
+#else
+      flag = POSIX_MADV_DONTNEED;
+      break;
+#endif
+   }
+   // posix_madvise() returns the error instead of setting errno.
+   if (int errorNumber = ::posix_madvise(m_mapping, m_size, flag)) {
+      return std::error_code(errorNumber, std::generic_category());
+   }
+   return std::error_code();
+#else
+   (void)advice;
+   return make_error_code(ErrorCode::function_not_supported);
+#endif
+}
+
 namespace internal {
 std::error_code directory_iterator_construct(internal::DirIterState &iter,
                                              StringRef path,
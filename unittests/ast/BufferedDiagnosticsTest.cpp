@@ -0,0 +1,143 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "RecordingDiagnosticConsumer.h"
+#include "polarphp/ast/BufferedDiagnostics.h"
+#include "polarphp/ast/DiagnosticsCommon.h"
+#include "polarphp/ast/DiagnosticSuppression.h"
+#include "polarphp/parser/SourceMgr.h"
+#include "polarphp/utils/ThreadPool.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+
+using polar::ast::DiagnosticEngine;
+using polar::ast::DiagnosticSuppression;
+using polar::ast::DiagnosticTransaction;
+using polar::ast::OrderedDiagnosticMerger;
+using polar::utils::ThreadPool;
+
+namespace diag = polar::ast::diag;
+
+using namespace polar::unittest;
+
+namespace {
+
+std::vector<std::string> collect_args(const RecordingDiagnosticConsumer &consumer)
+{
+   std::vector<std::string> args;
+   for (const RecordingDiagnosticConsumer::Record &record : consumer.records) {
+      args.insert(args.end(), record.args.begin(), record.args.end());
+   }
+   return args;
+}
+
+} // anonymous namespace
+
+TEST(BufferedDiagnosticsTest, testFileOrder)
+{
+   SourceManager sourceMgr;
+   DiagnosticEngine target(sourceMgr);
+   RecordingDiagnosticConsumer consumer;
+   target.addConsumer(consumer);
+   OrderedDiagnosticMerger merger(target, sourceMgr, 3);
+   for (size_t file : {2, 0, 1}) {
+      auto engine = merger.makeFileEngine(file);
+      std::string name = "file" + std::to_string(file);
+      engine->diagnose(SourceLoc(), diag::note_typo_candidate, name + "-first");
+      engine->diagnose(SourceLoc(), diag::note_typo_candidate, name + "-second");
+   }
+   merger.finishFile(2);
+   ASSERT_TRUE(consumer.records.empty());
+   merger.finishFile(0);
+   ASSERT_EQ((std::vector<std::string>{"file0-first", "file0-second"}), collect_args(consumer));
+   ASSERT_FALSE(merger.isComplete());
+   merger.finishFile(1);
+   ASSERT_TRUE(merger.isComplete());
+   ASSERT_EQ((std::vector<std::string>{"file0-first", "file0-second",
+                                       "file1-first", "file1-second",
+                                       "file2-first", "file2-second"}),
+             collect_args(consumer));
+   ASSERT_FALSE(merger.hadAnyError());
+   ASSERT_FALSE(target.hadAnyError());
+}
+
+TEST(BufferedDiagnosticsTest, testParallelFiles)
+{
+   constexpr size_t numFiles = 64;
+   SourceManager sourceMgr;
+   DiagnosticEngine target(sourceMgr);
+   RecordingDiagnosticConsumer consumer;
+   target.addConsumer(consumer);
+   OrderedDiagnosticMerger merger(target, sourceMgr, numFiles);
+   std::vector<std::string> expected;
+   for (size_t file = 0; file < numFiles; ++file) {
+      expected.push_back(std::to_string(file));
+   }
+   {
+      ThreadPool pool(4);
+      // Later files first, so that most of them finish before their turn.
+      for (size_t file = numFiles; file > 0; --file) {
+         pool.async([&merger, file]() {
+            auto engine = merger.makeFileEngine(file - 1);
+            if (file == 10) {
+               engine->diagnose(SourceLoc(), diag::not_implemented, std::to_string(file - 1));
+            } else {
+               engine->diagnose(SourceLoc(), diag::note_typo_candidate,
+                                std::to_string(file - 1));
+            }
+            merger.finishFile(file - 1);
+         });
+      }
+      pool.wait();
+   }
+   ASSERT_TRUE(merger.isComplete());
+   ASSERT_EQ(expected, collect_args(consumer));
+   ASSERT_TRUE(merger.hadAnyError());
+   // Errors of the files count as errors of the target engine.
+   ASSERT_TRUE(target.hadAnyError());
+}
+
+TEST(BufferedDiagnosticsTest, testPerFileState)
+{
+   SourceManager sourceMgr;
+   DiagnosticEngine target(sourceMgr);
+   target.setWarningsAsErrors(true);
+   RecordingDiagnosticConsumer consumer;
+   target.addConsumer(consumer);
+   OrderedDiagnosticMerger merger(target, sourceMgr, 3);
+   auto first = merger.makeFileEngine(0);
+   auto second = merger.makeFileEngine(1);
+   auto third = merger.makeFileEngine(2);
+   // A transaction aborted in one file does not drop the diagnostics of
+   // another file, not even of one diagnosed while it is open.
+   {
+      DiagnosticTransaction transaction(*first);
+      first->diagnose(SourceLoc(), diag::not_implemented, "aborted");
+      second->diagnose(SourceLoc(), diag::not_implemented, "second");
+      transaction.abort();
+   }
+   // Neither does suppression.
+   {
+      DiagnosticSuppression suppression(*third);
+      third->diagnose(SourceLoc(), diag::not_implemented, "suppressed");
+      first->diagnose(SourceLoc(), diag::protocol_extension_redundant_requirement,
+                      "first", "b", "c");
+   }
+   merger.finishFile(2);
+   merger.finishFile(1);
+   merger.finishFile(0);
+   ASSERT_EQ((std::vector<std::string>{"first", "b", "c", "second"}), collect_args(consumer));
+   // The file engines took over the settings of the target.
+   ASSERT_EQ(DiagnosticKind::Error, consumer.records[0].kind);
+   ASSERT_TRUE(target.hadAnyError());
+}
@@ -0,0 +1,138 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "RecordingDiagnosticConsumer.h"
+#include "polarphp/ast/DiagnosticsCommon.h"
+#include "polarphp/ast/DiagnosticSuppression.h"
+#include "polarphp/parser/SourceMgr.h"
+#include "gtest/gtest.h"
+
+#include <string>
+
+using polar::ast::DiagnosticEngine;
+using polar::ast::DiagnosticSuppression;
+using polar::ast::DiagnosticTransaction;
+using polar::parser::SourceRange;
+
+namespace diag = polar::ast::diag;
+
+using namespace polar::unittest;
+
+TEST(DiagnosticEngineTest, testEmitDiagnostic)
+{
+   SourceManager sourceMgr;
+   unsigned bufferID = sourceMgr.addMemBufferCopy("<?php\necho $a;\n", "a.php");
+   SourceLoc loc = sourceMgr.getLocForOffset(bufferID, 6);
+   DiagnosticEngine engine(sourceMgr);
+   RecordingDiagnosticConsumer consumer;
+   engine.addConsumer(consumer);
+   engine.diagnose(loc, diag::not_implemented, "goto")
+         .fixItReplaceChars(loc, loc.getAdvancedLoc(4), "print");
+   engine.diagnose(loc, diag::note_typo_candidate, "$b");
+   ASSERT_TRUE(engine.hadAnyError());
+   ASSERT_EQ(2u, consumer.records.size());
+   const RecordingDiagnosticConsumer::Record &error = consumer.records[0];
+   ASSERT_EQ(loc, error.loc);
+   ASSERT_EQ(DiagnosticKind::Error, error.kind);
+   ASSERT_EQ(diag::not_implemented.id, error.id);
+   ASSERT_EQ("INTERNAL ERROR: feature not implemented: %0", error.formatString);
+   ASSERT_EQ(std::vector<std::string>{"goto"}, error.args);
+   ASSERT_EQ(std::vector<std::string>{"print"}, error.fixIts);
+   ASSERT_EQ(DiagnosticKind::Note, consumer.records[1].kind);
+}
+
+TEST(DiagnosticEngineTest, testTokenRanges)
+{
+   SourceManager sourceMgr;
+   unsigned bufferID = sourceMgr.addMemBufferCopy("<?php\necho $abc;\n", "a.php");
+   SourceLoc echoLoc = sourceMgr.getLocForOffset(bufferID, 6);
+   SourceLoc varLoc = sourceMgr.getLocForOffset(bufferID, 11);
+   DiagnosticEngine engine(sourceMgr);
+   RecordingDiagnosticConsumer consumer;
+   engine.addConsumer(consumer);
+   // Token ranges end after their last token, insertions after a token go
+   // right behind it.
+   engine.diagnose(echoLoc, diag::not_implemented, "echo")
+         .highlight(SourceRange(echoLoc, varLoc))
+         .fixItInsertAfter(varLoc, "[0]");
+   ASSERT_EQ(1u, consumer.records.size());
+   const RecordingDiagnosticConsumer::Record &record = consumer.records[0];
+   ASSERT_EQ(1u, record.ranges.size());
+   ASSERT_EQ(CharSourceRange(echoLoc, 9), record.ranges[0]);
+   ASSERT_EQ(1u, record.fixIts.size());
+   ASSERT_EQ("[0]", record.fixIts[0]);
+   ASSERT_EQ(CharSourceRange(sourceMgr.getLocForOffset(bufferID, 15), 0),
+             record.fixItRanges[0]);
+}
+
+TEST(DiagnosticEngineTest, testBehavior)
+{
+   SourceManager sourceMgr;
+   DiagnosticEngine engine(sourceMgr);
+   RecordingDiagnosticConsumer consumer;
+   engine.addConsumer(consumer);
+   engine.diagnose(SourceLoc(), diag::protocol_extension_redundant_requirement, "a", "b", "c");
+   ASSERT_FALSE(engine.hadAnyError());
+   engine.setWarningsAsErrors(true);
+   engine.diagnose(SourceLoc(), diag::protocol_extension_redundant_requirement, "a", "b", "c");
+   ASSERT_TRUE(engine.hadAnyError());
+   engine.ignoreDiagnostic(diag::not_implemented.id);
+   engine.diagnose(SourceLoc(), diag::not_implemented, "goto");
+   // Notes attached to an ignored diagnostic are ignored too.
+   engine.diagnose(SourceLoc(), diag::note_typo_candidate, "$b");
+   ASSERT_EQ(2u, consumer.records.size());
+   ASSERT_EQ(DiagnosticKind::Warning, consumer.records[0].kind);
+   ASSERT_EQ(DiagnosticKind::Error, consumer.records[1].kind);
+}
+
+TEST(DiagnosticEngineTest, testTransactions)
+{
+   SourceManager sourceMgr;
+   DiagnosticEngine engine(sourceMgr);
+   RecordingDiagnosticConsumer consumer;
+   engine.addConsumer(consumer);
+   {
+      DiagnosticTransaction outer(engine);
+      {
+         DiagnosticTransaction aborted(engine);
+         engine.diagnose(SourceLoc(), diag::not_implemented, "aborted");
+         aborted.abort();
+      }
+      {
+         DiagnosticTransaction inner(engine);
+         // The engine keeps its own copy of the string arguments of the
+         // diagnostics that wait for their transaction.
+         std::string feature = "committed";
+         engine.diagnose(SourceLoc(), diag::not_implemented, feature);
+         feature.assign("XXXXXXXXX");
+         inner.commit();
+      }
+      ASSERT_TRUE(consumer.records.empty());
+   }
+   ASSERT_EQ(1u, consumer.records.size());
+   ASSERT_EQ(std::vector<std::string>{"committed"}, consumer.records[0].args);
+   ASSERT_TRUE(engine.hadAnyError());
+}
+
+TEST(DiagnosticEngineTest, testSuppression)
+{
+   SourceManager sourceMgr;
+   DiagnosticEngine engine(sourceMgr);
+   RecordingDiagnosticConsumer consumer;
+   engine.addConsumer(consumer);
+   {
+      DiagnosticSuppression suppression(engine);
+      engine.diagnose(SourceLoc(), diag::not_implemented, "suppressed");
+   }
+   engine.diagnose(SourceLoc(), diag::not_implemented, "emitted");
+   ASSERT_EQ(1u, consumer.records.size());
+   ASSERT_EQ(std::vector<std::string>{"emitted"}, consumer.records[0].args);
+}
@@ -0,0 +1,86 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#ifndef UNITTEST_AST_RECORDING_DIAGNOSTIC_CONSUMER_H
+#define UNITTEST_AST_RECORDING_DIAGNOSTIC_CONSUMER_H
+
+#include "polarphp/ast/DiagnosticEngine.h"
+
+#include <string>
+#include <vector>
+
+namespace polar::unittest {
+
+using polar::ast::DiagID;
+using polar::ast::DiagnosticArgument;
+using polar::ast::DiagnosticArgumentKind;
+using polar::ast::DiagnosticConsumer;
+using polar::ast::DiagnosticInfo;
+using polar::ast::DiagnosticKind;
+using polar::basic::ArrayRef;
+using polar::basic::StringRef;
+using polar::parser::CharSourceRange;
+using polar::parser::SourceLoc;
+using polar::parser::SourceManager;
+
+/// Keeps a copy of every diagnostic it is handed, with the string, integer
+/// and unsigned arguments spelled out.
+class RecordingDiagnosticConsumer : public DiagnosticConsumer
+{
+public:
+   struct Record
+   {
+      SourceLoc loc;
+      DiagnosticKind kind;
+      DiagID id;
+      std::string formatString;
+      std::vector<std::string> args;
+      std::vector<std::string> fixIts;
+      std::vector<CharSourceRange> fixItRanges;
+      std::vector<CharSourceRange> ranges;
+   };
+
+   void handleDiagnostic(SourceManager &sourceMgr, SourceLoc loc,
+                         DiagnosticKind kind, StringRef formatString,
+                         ArrayRef<DiagnosticArgument> formatArgs,
+                         const DiagnosticInfo &info) override
+   {
+      Record record{loc, kind, info.id, formatString.getStr(), {}, {}, {},
+                    {info.ranges.begin(), info.ranges.end()}};
+      for (const DiagnosticArgument &arg : formatArgs) {
+         switch (arg.getKind()) {
+         case DiagnosticArgumentKind::String:
+            record.args.push_back(arg.getAsString().getStr());
+            break;
+         case DiagnosticArgumentKind::Integer:
+            record.args.push_back(std::to_string(arg.getAsInteger()));
+            break;
+         case DiagnosticArgumentKind::Unsigned:
+            record.args.push_back(std::to_string(arg.getAsUnsigned()));
+            break;
+         default:
+            record.args.push_back("<other>");
+            break;
+         }
+      }
+      for (const DiagnosticInfo::FixIt &fixIt : info.fixIts) {
+         record.fixIts.push_back(fixIt.getText().getStr());
+         record.fixItRanges.push_back(fixIt.getRange());
+      }
+      records.push_back(std::move(record));
+   }
+
+   std::vector<Record> records;
+};
+
+} // polar::unittest
+
+#endif // UNITTEST_AST_RECORDING_DIAGNOSTIC_CONSUMER_H
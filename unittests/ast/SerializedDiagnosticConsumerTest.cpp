@@ -0,0 +1,317 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "polarphp/ast/DiagnosticsCommon.h"
+#include "polarphp/ast/SerializedDiagnosticConsumer.h"
+#include "polarphp/ast/StoredDiagnostic.h"
+#include "polarphp/basic/adt/SmallString.h"
+#include "polarphp/parser/SourceMgr.h"
+#include "polarphp/utils/FileSystem.h"
+#include "polarphp/utils/Leb128.h"
+#include "polarphp/utils/MemoryBuffer.h"
+#include "polarphp/utils/RawOutStream.h"
+#include "gtest/gtest.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using polar::ast::DiagID;
+using polar::ast::DiagnosticArgument;
+using polar::ast::DiagnosticEngine;
+using polar::ast::DiagnosticKind;
+using polar::ast::SerializedDiagnosticConsumer;
+using polar::ast::unpack_diagnostic_arguments;
+using polar::basic::ArrayRef;
+using polar::basic::SmallString;
+using polar::basic::SmallVector;
+using polar::basic::StringRef;
+using polar::parser::SourceLoc;
+using polar::parser::SourceManager;
+using polar::utils::MemoryBuffer;
+using polar::utils::RawStringOutStream;
+
+namespace diag = polar::ast::diag;
+
+namespace {
+
+struct ReadLocation
+{
+   unsigned fileID;
+   unsigned line;
+   unsigned column;
+   unsigned offset;
+};
+
+struct ReadFixIt
+{
+   ReadLocation start;
+   ReadLocation end;
+   std::string text;
+};
+
+struct ReadDiagnostic
+{
+   unsigned id;
+   DiagnosticKind kind;
+   ReadLocation loc;
+   std::vector<std::pair<ReadLocation, ReadLocation>> ranges;
+   std::vector<ReadFixIt> fixIts;
+   std::vector<std::string> args;
+};
+
+/// Reads a serialized diagnostics file back in the way its format is
+/// documented, checking that every record refers only to buffers and
+/// messages that were written before it.
+class SerializedDiagnosticReader
+{
+public:
+   explicit SerializedDiagnosticReader(StringRef data)
+      : m_current(data.getBytesBegin()),
+        m_end(data.getBytesEnd())
+   {}
+
+   bool read()
+   {
+      if (readBytes(4) != "PDIA" ||
+          readByte() != SerializedDiagnosticConsumer::sm_formatVersion) {
+         return false;
+      }
+      while (!m_failed && m_current != m_end) {
+         switch (readByte()) {
+         case SerializedDiagnosticConsumer::BufferRecord: {
+            unsigned fileID = readULEB128();
+            if (fileID != buffers.size() + 1) {
+               return false;
+            }
+            buffers.push_back(readString());
+            break;
+         }
+         case SerializedDiagnosticConsumer::MessageRecord: {
+            unsigned id = readULEB128();
+            if (messages.count(id)) {
+               return false;
+            }
+            messages[id] = readString();
+            break;
+         }
+         case SerializedDiagnosticConsumer::DiagnosticRecord:
+            if (!readDiagnostic()) {
+               return false;
+            }
+            break;
+         default:
+            return false;
+         }
+      }
+      return !m_failed;
+   }
+
+   std::vector<std::string> buffers;
+   std::map<unsigned, std::string> messages;
+   std::vector<ReadDiagnostic> diagnostics;
+
+private:
+   bool readDiagnostic()
+   {
+      ReadDiagnostic diagnostic;
+      diagnostic.id = readULEB128();
+      diagnostic.kind = static_cast<DiagnosticKind>(readByte());
+      if (!messages.count(diagnostic.id)) {
+         return false;
+      }
+      diagnostic.loc = readLocation();
+      for (unsigned count = readULEB128(); count > 0; --count) {
+         ReadLocation start = readLocation();
+         diagnostic.ranges.push_back({start, readLocation()});
+      }
+      for (unsigned count = readULEB128(); count > 0; --count) {
+         ReadFixIt fixIt;
+         fixIt.start = readLocation();
+         fixIt.end = readLocation();
+         fixIt.text = readString();
+         diagnostic.fixIts.push_back(fixIt);
+      }
+      std::string packed = readString();
+      SmallVector<DiagnosticArgument, 4> args;
+      unpack_diagnostic_arguments(
+               ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(packed.data()),
+                                 packed.size()),
+               args);
+      for (const DiagnosticArgument &arg : args) {
+         diagnostic.args.push_back(arg.getAsString().getStr());
+      }
+      diagnostics.push_back(std::move(diagnostic));
+      return true;
+   }
+
+   ReadLocation readLocation()
+   {
+      ReadLocation location{readULEB128(), 0, 0, 0};
+      if (location.fileID > buffers.size()) {
+         m_failed = true;
+      }
+      if (location.fileID != 0) {
+         location.line = readULEB128();
+         location.column = readULEB128();
+         location.offset = readULEB128();
+      }
+      return location;
+   }
+
+   uint8_t readByte()
+   {
+      if (m_current == m_end) {
+         m_failed = true;
+         return 0;
+      }
+      return *m_current++;
+   }
+
+   unsigned readULEB128()
+   {
+      unsigned length;
+      const char *error = nullptr;
+      uint64_t value = polar::utils::decode_uleb128(m_current, &length, m_end, &error);
+      if (error) {
+         m_failed = true;
+         m_current = m_end;
+         return 0;
+      }
+      m_current += length;
+      return static_cast<unsigned>(value);
+   }
+
+   std::string readBytes(size_t length)
+   {
+      if (static_cast<size_t>(m_end - m_current) < length) {
+         m_failed = true;
+         m_current = m_end;
+         return std::string();
+      }
+      std::string bytes(reinterpret_cast<const char *>(m_current), length);
+      m_current += length;
+      return bytes;
+   }
+
+   std::string readString()
+   {
+      return readBytes(readULEB128());
+   }
+
+   const uint8_t *m_current;
+   const uint8_t *m_end;
+   bool m_failed = false;
+};
+
+/// Diagnoses a few diagnostics in two buffers.
+void emit_sample_diagnostics(SourceManager &sourceMgr, DiagnosticEngine &engine)
+{
+   unsigned first = sourceMgr.addMemBufferCopy("<?php\necho $a;\n", "first.php");
+   unsigned second = sourceMgr.addMemBufferCopy("<?php\n\n  goto end;\n", "second.php");
+   SourceLoc varLoc = sourceMgr.getLocForOffset(first, 11);
+   SourceLoc gotoLoc = sourceMgr.getLocForOffset(second, 9);
+   engine.diagnose(gotoLoc, diag::not_implemented, "goto")
+         .highlightChars(gotoLoc, gotoLoc.getAdvancedLoc(4));
+   engine.diagnose(varLoc, diag::note_typo_candidate, "$b")
+         .fixItReplaceChars(varLoc, varLoc.getAdvancedLoc(2), "$b");
+   engine.diagnose(SourceLoc(), diag::not_implemented, "declare");
+}
+
+void check_sample_diagnostics(const SerializedDiagnosticReader &reader)
+{
+   ASSERT_EQ((std::vector<std::string>{"second.php", "first.php"}), reader.buffers);
+   ASSERT_EQ(2u, reader.messages.size());
+   unsigned notImplemented = static_cast<unsigned>(diag::not_implemented.id);
+   unsigned typoCandidate = static_cast<unsigned>(diag::note_typo_candidate.id);
+   ASSERT_EQ("INTERNAL ERROR: feature not implemented: %0",
+             reader.messages.at(notImplemented));
+   ASSERT_EQ("did you mean '%0'?", reader.messages.at(typoCandidate));
+   ASSERT_EQ(3u, reader.diagnostics.size());
+
+   const ReadDiagnostic &gotoError = reader.diagnostics[0];
+   ASSERT_EQ(notImplemented, gotoError.id);
+   ASSERT_EQ(DiagnosticKind::Error, gotoError.kind);
+   ASSERT_EQ(1u, gotoError.loc.fileID);
+   ASSERT_EQ(3u, gotoError.loc.line);
+   ASSERT_EQ(3u, gotoError.loc.column);
+   ASSERT_EQ(9u, gotoError.loc.offset);
+   ASSERT_EQ(1u, gotoError.ranges.size());
+   ASSERT_EQ(9u, gotoError.ranges[0].first.offset);
+   ASSERT_EQ(13u, gotoError.ranges[0].second.offset);
+   ASSERT_TRUE(gotoError.fixIts.empty());
+   ASSERT_EQ(std::vector<std::string>{"goto"}, gotoError.args);
+
+   const ReadDiagnostic &note = reader.diagnostics[1];
+   ASSERT_EQ(typoCandidate, note.id);
+   ASSERT_EQ(DiagnosticKind::Note, note.kind);
+   ASSERT_EQ(2u, note.loc.fileID);
+   ASSERT_EQ(2u, note.loc.line);
+   ASSERT_EQ(6u, note.loc.column);
+   ASSERT_TRUE(note.ranges.empty());
+   ASSERT_EQ(1u, note.fixIts.size());
+   ASSERT_EQ(11u, note.fixIts[0].start.offset);
+   ASSERT_EQ(13u, note.fixIts[0].end.offset);
+   ASSERT_EQ("$b", note.fixIts[0].text);
+   ASSERT_EQ(std::vector<std::string>{"$b"}, note.args);
+
+   const ReadDiagnostic &noLocation = reader.diagnostics[2];
+   ASSERT_EQ(0u, noLocation.loc.fileID);
+   ASSERT_EQ(std::vector<std::string>{"declare"}, noLocation.args);
+}
+
+} // anonymous namespace
+
+TEST(SerializedDiagnosticConsumerTest, testRoundTrip)
+{
+   std::string output;
+   RawStringOutStream outStream(output);
+   SourceManager sourceMgr;
+   DiagnosticEngine engine(sourceMgr);
+   SerializedDiagnosticConsumer consumer(outStream);
+   engine.addConsumer(consumer);
+   emit_sample_diagnostics(sourceMgr, engine);
+   ASSERT_FALSE(engine.finishProcessing());
+   SerializedDiagnosticReader reader(outStream.getStr());
+   ASSERT_TRUE(reader.read());
+   check_sample_diagnostics(reader);
+}
+
+TEST(SerializedDiagnosticConsumerTest, testFile)
+{
+   SmallString<64> path;
+   ASSERT_FALSE(polar::fs::create_temporary_file("SerializedDiagnostics", "dia", path));
+   {
+      std::error_code errorCode;
+      std::unique_ptr<SerializedDiagnosticConsumer> consumer =
+            SerializedDiagnosticConsumer::create(path, errorCode);
+      ASSERT_FALSE(errorCode);
+      ASSERT_TRUE(consumer);
+      SourceManager sourceMgr;
+      DiagnosticEngine engine(sourceMgr);
+      engine.addConsumer(*consumer);
+      emit_sample_diagnostics(sourceMgr, engine);
+      ASSERT_FALSE(engine.finishProcessing());
+   }
+   auto buffer = MemoryBuffer::getFile(path);
+   polar::fs::remove(path);
+   ASSERT_TRUE(bool(buffer));
+   SerializedDiagnosticReader reader((*buffer)->getBuffer());
+   ASSERT_TRUE(reader.read());
+   check_sample_diagnostics(reader);
+}
+
+TEST(SerializedDiagnosticConsumerTest, testCreateFailure)
+{
+   std::error_code errorCode;
+   ASSERT_FALSE(SerializedDiagnosticConsumer::create("/nonexistent/dir/out.dia", errorCode));
+   ASSERT_TRUE(bool(errorCode));
+}
@@ -0,0 +1,209 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "RecordingDiagnosticConsumer.h"
+#include "polarphp/ast/DiagnosticsCommon.h"
+#include "polarphp/ast/StoredDiagnostic.h"
+#include "polarphp/parser/SourceMgr.h"
+#include "polarphp/utils/RawOutStream.h"
+#include "gtest/gtest.h"
+
+#include <string>
+
+using polar::ast::DiagnosticEngine;
+using polar::ast::StoredDiagnosticList;
+using polar::ast::pack_diagnostic_arguments;
+using polar::ast::unpack_diagnostic_arguments;
+using polar::basic::SmallVector;
+using polar::parser::CharSourceRange;
+using polar::utils::RawStringOutStream;
+using polar::utils::VersionTuple;
+
+namespace diag = polar::ast::diag;
+
+using namespace polar::unittest;
+
+namespace {
+
+std::string format_message(StringRef text, ArrayRef<DiagnosticArgument> args)
+{
+   std::string message;
+   RawStringOutStream outStream(message);
+   DiagnosticEngine::formatDiagnosticText(outStream, text, args);
+   outStream.flush();
+   return message;
+}
+
+} // anonymous namespace
+
+TEST(StoredDiagnosticTest, testPackArguments)
+{
+   std::string name = "traits";
+   SmallVector<DiagnosticArgument, 8> args;
+   args.push_back(DiagnosticArgument(StringRef(name)));
+   args.push_back(DiagnosticArgument(-300));
+   args.push_back(DiagnosticArgument(70000u));
+   args.push_back(DiagnosticArgument(StringRef()));
+   args.push_back(DiagnosticArgument(VersionTuple(7)));
+   args.push_back(DiagnosticArgument(VersionTuple(7, 4, 0, 12)));
+   SmallVector<uint8_t, 64> bytes;
+   pack_diagnostic_arguments(args, bytes);
+   // The packed arguments own their strings.
+   name.assign("XXXXXX");
+   SmallVector<DiagnosticArgument, 8> unpacked;
+   unpack_diagnostic_arguments(bytes, unpacked);
+   ASSERT_EQ(args.size(), unpacked.size());
+   for (size_t index = 0; index < args.size(); ++index) {
+      ASSERT_EQ(args[index].getKind(), unpacked[index].getKind());
+   }
+   ASSERT_EQ("traits", unpacked[0].getAsString());
+   ASSERT_EQ(-300, unpacked[1].getAsInteger());
+   ASSERT_EQ(70000u, unpacked[2].getAsUnsigned());
+   ASSERT_TRUE(unpacked[3].getAsString().empty());
+   ASSERT_EQ(VersionTuple(7), unpacked[4].getAsVersionTuple());
+   ASSERT_EQ(VersionTuple(7, 4, 0, 12), unpacked[5].getAsVersionTuple());
+}
+
+TEST(StoredDiagnosticTest, testListRoundTrip)
+{
+   SourceManager sourceMgr;
+   unsigned bufferID = sourceMgr.addMemBufferCopy("<?php\necho $a;\n", "a.php");
+   SourceLoc echoLoc = sourceMgr.getLocForOffset(bufferID, 6);
+   SourceLoc varLoc = sourceMgr.getLocForOffset(bufferID, 11);
+   StoredDiagnosticList list;
+   ASSERT_TRUE(list.empty());
+   std::string first = "a.out";
+   DiagnosticArgument openArgs[] = {StringRef(first), StringRef("permission denied")};
+   list.add(DiagnosticKind::Error, echoLoc, diag::error_opening_output.id, openArgs,
+            {CharSourceRange(echoLoc, 4)}, {});
+   list.add(DiagnosticKind::Note, varLoc, diag::note_typo_candidate.id,
+            {DiagnosticArgument(StringRef("$b"))}, {},
+            {StoredDiagnosticList::FixIt(CharSourceRange(varLoc, 2), "$b")});
+   list.add(DiagnosticKind::Error, SourceLoc(), diag::func_decl_without_brace.id, {}, {}, {});
+   first.assign("XXXXX");
+   ASSERT_EQ(3u, list.size());
+
+   ASSERT_EQ(diag::error_opening_output.id, list[0].id);
+   ASSERT_EQ(DiagnosticKind::Error, list[0].kind);
+   ASSERT_EQ(echoLoc, list[0].loc);
+   SmallVector<DiagnosticArgument, 4> args;
+   list.getArgs(0, args);
+   ASSERT_EQ(2u, args.size());
+   ASSERT_EQ("a.out", args[0].getAsString());
+   ASSERT_EQ("permission denied", args[1].getAsString());
+   ASSERT_EQ(1u, list.getRanges(0).size());
+   ASSERT_EQ(CharSourceRange(echoLoc, 4), list.getRanges(0)[0]);
+   ASSERT_TRUE(list.getFixIts(0).empty());
+
+   args.clear();
+   list.getArgs(1, args);
+   ASSERT_EQ(1u, args.size());
+   ASSERT_EQ("$b", args[0].getAsString());
+   ASSERT_TRUE(list.getRanges(1).empty());
+   ASSERT_EQ(1u, list.getFixIts(1).size());
+   ASSERT_EQ("$b", list.getFixIts(1)[0].getText());
+   ASSERT_EQ(CharSourceRange(varLoc, 2), list.getFixIts(1)[0].getRange());
+
+   args.clear();
+   list.getArgs(2, args);
+   ASSERT_TRUE(args.empty());
+   ASSERT_TRUE(list.getPackedArgs(2).empty());
+   ASSERT_FALSE(list[2].loc.isValid());
+
+   // The message text is formatted from the stored arguments just like
+   // from the original ones.
+   DiagnosticArgument originalArgs[] = {StringRef("a.out"), StringRef("permission denied")};
+   for (size_t index = 0; index < list.size(); ++index) {
+      std::string message;
+      RawStringOutStream outStream(message);
+      list.formatMessage(index, outStream);
+      outStream.flush();
+      ArrayRef<DiagnosticArgument> expectedArgs;
+      if (index == 0) {
+         expectedArgs = originalArgs;
+      } else if (index == 1) {
+         args.clear();
+         args.push_back(DiagnosticArgument(StringRef("$b")));
+         expectedArgs = args;
+      }
+      ASSERT_EQ(format_message(DiagnosticEngine::diagnosticStringFor(list[index].id),
+                               expectedArgs),
+                message);
+   }
+   std::string message;
+   RawStringOutStream outStream(message);
+   list.formatMessage(2, outStream);
+   outStream.flush();
+   ASSERT_EQ("expected '{' in body of function declaration", message);
+}
+
+TEST(StoredDiagnosticTest, testTruncate)
+{
+   SourceManager sourceMgr;
+   unsigned bufferID = sourceMgr.addMemBufferCopy("<?php\necho $a;\n", "a.php");
+   SourceLoc loc = sourceMgr.getLocForOffset(bufferID, 6);
+   StoredDiagnosticList list;
+   list.add(DiagnosticKind::Note, loc, diag::note_typo_candidate.id,
+            {DiagnosticArgument(StringRef("$b"))}, {CharSourceRange(loc, 4)},
+            {StoredDiagnosticList::FixIt(CharSourceRange(loc, 4), "print")});
+   list.add(DiagnosticKind::Note, loc, diag::note_typo_candidate.id,
+            {DiagnosticArgument(StringRef("$c"))}, {CharSourceRange(loc, 2)},
+            {StoredDiagnosticList::FixIt(CharSourceRange(loc, 2), "$c")});
+   list.truncate(1);
+   ASSERT_EQ(1u, list.size());
+   // Whatever is added after truncating does not see the dropped data.
+   list.add(DiagnosticKind::Error, loc, diag::not_implemented.id,
+            {DiagnosticArgument(StringRef("goto"))}, {}, {});
+   ASSERT_EQ(2u, list.size());
+   SmallVector<DiagnosticArgument, 4> args;
+   list.getArgs(1, args);
+   ASSERT_EQ(1u, args.size());
+   ASSERT_EQ("goto", args[0].getAsString());
+   ASSERT_TRUE(list.getRanges(1).empty());
+   ASSERT_TRUE(list.getFixIts(1).empty());
+   ASSERT_EQ(1u, list.getFixIts(0).size());
+   ASSERT_EQ("print", list.getFixIts(0)[0].getText());
+   list.clear();
+   ASSERT_TRUE(list.empty());
+}
+
+TEST(StoredDiagnosticTest, testReplay)
+{
+   SourceManager sourceMgr;
+   unsigned bufferID = sourceMgr.addMemBufferCopy("<?php\necho $a;\n", "a.php");
+   SourceLoc loc = sourceMgr.getLocForOffset(bufferID, 11);
+   StoredDiagnosticList list;
+   list.add(DiagnosticKind::Warning, loc, diag::not_implemented.id,
+            {DiagnosticArgument(StringRef("goto"))}, {CharSourceRange(loc, 2)}, {});
+   list.add(DiagnosticKind::Note, loc, diag::note_typo_candidate.id,
+            {DiagnosticArgument(StringRef("$b"))}, {},
+            {StoredDiagnosticList::FixIt(CharSourceRange(loc, 2), "$b")});
+   list.add(DiagnosticKind::Remark, SourceLoc(), diag::remark_max_determinism_overriding.id,
+            {DiagnosticArgument(StringRef("-j"))}, {}, {});
+   RecordingDiagnosticConsumer consumer;
+   list.replay(1, 3, consumer, sourceMgr);
+   list.replay(0, 1, consumer, sourceMgr);
+   ASSERT_EQ(3u, consumer.records.size());
+   const RecordingDiagnosticConsumer::Record &note = consumer.records[0];
+   ASSERT_EQ(diag::note_typo_candidate.id, note.id);
+   ASSERT_EQ(DiagnosticKind::Note, note.kind);
+   ASSERT_EQ(loc, note.loc);
+   ASSERT_EQ("did you mean '%0'?", note.formatString);
+   ASSERT_EQ(std::vector<std::string>{"$b"}, note.args);
+   ASSERT_EQ(std::vector<std::string>{"$b"}, note.fixIts);
+   ASSERT_TRUE(note.ranges.empty());
+   ASSERT_EQ(DiagnosticKind::Remark, consumer.records[1].kind);
+   ASSERT_FALSE(consumer.records[1].loc.isValid());
+   // The stored kind is replayed, not the declared one.
+   ASSERT_EQ(DiagnosticKind::Warning, consumer.records[2].kind);
+   ASSERT_EQ(std::vector<std::string>{"goto"}, consumer.records[2].args);
+   ASSERT_EQ(1u, consumer.records[2].ranges.size());
+}
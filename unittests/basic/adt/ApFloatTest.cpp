@@ -1076,6 +1076,51 @@ TEST(ApFloatTest, testToString)
    }
 }
 
+TEST(ApFloatTest, testToShortestString)
+{
+   auto toShortestString = [](const ApFloat &value, unsigned pad = 3) {
+      SmallString<32> str;
+      value.toShortestString(str, pad);
+      return std::string(str.getCStr());
+   };
+   ASSERT_EQ("0.1", toShortestString(ApFloat(0.1)));
+   ASSERT_EQ("-0.1", toShortestString(ApFloat(-0.1)));
+   ASSERT_EQ("10", toShortestString(ApFloat(10.0)));
+   ASSERT_EQ("1.0E+1", toShortestString(ApFloat(10.0), 0));
+   ASSERT_EQ("1.0E+5", toShortestString(ApFloat(1e5)));
+   ASSERT_EQ("0.0101", toShortestString(ApFloat(1.01E-2), 2));
+   ASSERT_EQ("1.01E-2", toShortestString(ApFloat(1.01E-2), 1));
+   ASSERT_EQ("0.7853981633974483", toShortestString(ApFloat(0.78539816339744830961)));
+   ASSERT_EQ("5.0E-324", toShortestString(ApFloat(4.9406564584124654e-324)));
+   ASSERT_EQ("873.1834", toShortestString(ApFloat(873.1834), 1));
+   ASSERT_EQ("8.731834E+2", toShortestString(ApFloat(873.1834), 0));
+   ASSERT_EQ("1.7976931348623157E+308", toShortestString(ApFloat(1.7976931348623157E+308), 0));
+   ASSERT_EQ("0", toShortestString(ApFloat(0.0)));
+   ASSERT_EQ("+Inf", toShortestString(ApFloat::getInf(ApFloat::getIEEEDouble())));
+   ASSERT_EQ("NaN", toShortestString(ApFloat::getNaN(ApFloat::getIEEEDouble())));
+
+   // The other formats print what toString() prints by default.
+   SmallString<32> str;
+   ApFloat(0.1f).toString(str);
+   ASSERT_EQ(std::string(str.getCStr()), toShortestString(ApFloat(0.1f)));
+
+   // Every value must read back as itself.
+   uint64_t state = 0x2545f4914f6cdd1d;
+   for (unsigned index = 0; index < 20000; ++index) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      ApFloat value(ApFloat::getIEEEDouble(), ApInt(64, state));
+      if (!value.isFinite()) {
+         continue;
+      }
+      std::string shortest = toShortestString(value);
+      ApFloat readBack(ApFloat::getIEEEDouble());
+      readBack.convertFromString(shortest, ApFloat::RoundingMode::rmNearestTiesToEven);
+      ASSERT_TRUE(value.bitwiseIsEqual(readBack)) << shortest;
+   }
+}
+
 TEST(ApFloatTest, testToInteger)
 {
    bool isExact = false;
@@ -22,6 +22,9 @@
 #include "polarphp/basic/adt/Twine.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <random>
+#include <string>
+#include <vector>
 
 using namespace polar::basic;
 
@@ -2621,4 +2624,111 @@ TEST(ApIntTest, testMultiplicativeInverseExaustive) {
    }
 }
 
+// Up to 128 bits the value is stored in the ApInt itself.
+TEST(ApIntTest, testInlineWideValues)
+{
+   ApInt a(128, "123456789012345678901234567890", 10);
+   ApInt b(128, "987654321098765432109876543", 10);
+   EXPECT_FALSE(a.needsCleanup());
+   EXPECT_TRUE(ApInt(129, 0).needsCleanup());
+   EXPECT_EQ("121932631137021795226185032707696997639644871231852004270",
+             (a.zext(256) * b.zext(256)).toString(10, false));
+   // The product wraps at 128 bits.
+   EXPECT_EQ("266245686375959679093290569048179098542", (a * b).toString(10, false));
+   EXPECT_EQ(124u, a.udiv(b).getZeroExtValue());
+   EXPECT_EQ("987653196098765319609876558", a.urem(b).toString(10, false));
+   ApInt quotient, remainder;
+   ApInt::udivrem(a, b, quotient, remainder);
+   EXPECT_EQ(124u, quotient.getZeroExtValue());
+   EXPECT_EQ(a.urem(b), remainder);
+   // The quotient and remainder may be the operands.
+   ApInt::udivrem(a, b, a, b);
+   EXPECT_EQ(quotient, a);
+   EXPECT_EQ(remainder, b);
+
+   // Values of two words in wider ApInts take the same path.
+   ApInt wide(300, "123456789012345678901234567890", 10);
+   EXPECT_EQ(124u, wide.udiv(ApInt(300, "987654321098765432109876543", 10)).getZeroExtValue());
+   EXPECT_EQ("987653196098765319609876558",
+             wide.urem(ApInt(300, "987654321098765432109876543", 10)).toString(10, false));
+}
+
+// Compares the Karatsuba products against the schoolbook method.
+TEST(ApIntTest, testLargeMultiplication)
+{
+   std::mt19937_64 random(3);
+   for (unsigned lhsWords : {1u, 23u, 24u, 25u, 40u, 64u, 97u}) {
+      for (unsigned rhsWords : {24u, 31u, 64u, 150u}) {
+         std::vector<uint64_t> lhs(lhsWords), rhs(rhsWords);
+         for (uint64_t &word : lhs) {
+            word = random();
+         }
+         for (uint64_t &word : rhs) {
+            word = random();
+         }
+         // All ones maximizes the carries.
+         if (lhsWords == 64) {
+            std::fill(lhs.begin(), lhs.end(), ~uint64_t(0));
+            std::fill(rhs.begin(), rhs.end(), ~uint64_t(0));
+         }
+         std::vector<uint64_t> expected(lhsWords + rhsWords, 0);
+         for (unsigned i = 0; i < lhsWords; ++i) {
+            ApInt::tcMultiplyPart(&expected[i], rhs.data(), lhs[i], 0, rhsWords, rhsWords + 1, true);
+         }
+         std::vector<uint64_t> actual(lhsWords + rhsWords, 1);
+         ApInt::tcFullMultiply(actual.data(), lhs.data(), rhs.data(), lhsWords, rhsWords);
+         EXPECT_EQ(expected, actual) << lhsWords << " x " << rhsWords;
+      }
+   }
+
+   unsigned bitWidth = 64 * 50 - 7;
+   std::vector<uint64_t> lhsWords(50), rhsWords(50);
+   for (unsigned i = 0; i < 50; ++i) {
+      lhsWords[i] = random();
+      rhsWords[i] = random();
+   }
+   ApInt lhs(bitWidth, lhsWords);
+   ApInt rhs(bitWidth, rhsWords);
+   std::vector<uint64_t> expected(50);
+   ApInt::tcMultiply(expected.data(), lhs.getRawData(), rhs.getRawData(), 50);
+   EXPECT_EQ(ApInt(bitWidth, expected), lhs * rhs);
+}
+
+TEST(ApIntTest, testLargeStringConversion)
+{
+   std::mt19937 random(5);
+   for (unsigned radix : {2u, 8u, 10u, 16u, 36u}) {
+      for (size_t numDigits : {1, 19, 20, 303, 304, 1000, 4321}) {
+         std::string digits;
+         digits.push_back("123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[random() % (radix - 1)]);
+         while (digits.size() < numDigits) {
+            digits.push_back("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[random() % radix]);
+         }
+         // Runs of zeros test the padding of the lower halves.
+         if (numDigits > 100) {
+            std::fill(digits.begin() + 50, digits.begin() + 90, '0');
+         }
+         unsigned numBits = ApInt::getBitsNeeded(digits, radix);
+         ApInt value(numBits, digits, radix);
+         EXPECT_EQ(digits, value.toString(radix, false)) << radix << " " << numDigits;
+
+         // Digit by digit, the way the conversion used to go.
+         ApInt expected(numBits, 0);
+         for (char digit : digits) {
+            expected *= radix;
+            expected += digit <= '9' ? digit - '0' : digit - 'A' + 10;
+         }
+         EXPECT_EQ(expected, value) << radix << " " << numDigits;
+
+         ApInt negative(numBits + 1, "-" + digits, radix);
+         EXPECT_EQ("-" + digits, negative.toString(radix, true));
+      }
+   }
+   // A value that does not fill its width.
+   ApInt wide(10000, "10000000000000000000000000000000000000000000000000000000000000001", 10);
+   EXPECT_EQ("10000000000000000000000000000000000000000000000000000000000000001",
+             wide.toString(10, false));
+   EXPECT_EQ("0", ApInt(10000, 0).toString(10, false));
+}
+
 } // anonymous namespace
@@ -44,7 +44,7 @@ TEST(ApSIntTest, testMoveTest)
    A = ApSInt(64, true);
    EXPECT_TRUE(A.isUnsigned());
 
-   wide = ApInt(128, 1);
+   wide = ApInt(256, 1);
    Bits = wide.getRawData();
    A = std::move(wide);
    EXPECT_TRUE(A.isUnsigned());
@@ -22,6 +22,9 @@
 #include "polarphp/basic/adt/SmallBitVector.h"
 #include "gtest/gtest.h"
 
+#include <random>
+#include <vector>
+
 namespace {
 template <typename T>
 class BitVectorTest : public ::testing::Test
@@ -1175,6 +1178,123 @@ TYPED_TEST(BitVectorTest, testPushBack)
    EXPECT_EQ(102U, Vec.count());
 }
 
+// Long enough for the bulk operations to go through the word kernels, with a
+// size that is not a multiple of the vector width.
+TYPED_TEST(BitVectorTest, testLargeSetOperations)
+{
+   std::mt19937 random(7);
+   const unsigned size = 4999;
+   std::vector<bool> expectedA(size), expectedB(size);
+   TypeParam a(size), b(size);
+   for (unsigned i = 0; i < size; ++i) {
+      // A is sparse, with a long zero run in the middle, B is dense.
+      if (random() % 50 == 0 && (i < 1000 || i > 4000)) {
+         a.set(i);
+         expectedA[i] = true;
+      }
+      if (random() % 3 != 0) {
+         b.set(i);
+         expectedB[i] = true;
+      }
+   }
+   auto expect_equal = [&](const TypeParam &vector, const std::vector<bool> &expected) {
+      unsigned count = 0;
+      int next = -1;
+      for (unsigned i = 0; i < size; ++i) {
+         ASSERT_EQ(expected[i], vector.test(i));
+         if (expected[i]) {
+            ++count;
+            next = vector.findNext(next);
+            ASSERT_EQ(static_cast<int>(i), next);
+         }
+      }
+      EXPECT_EQ(-1, vector.findNext(next));
+      EXPECT_EQ(count, vector.count());
+      EXPECT_EQ(count != 0, vector.any());
+   };
+   expect_equal(a, expectedA);
+   expect_equal(b, expectedB);
+
+   TypeParam result = a;
+   result |= b;
+   std::vector<bool> expected(size);
+   for (unsigned i = 0; i < size; ++i) {
+      expected[i] = expectedA[i] || expectedB[i];
+   }
+   expect_equal(result, expected);
+
+   result = a;
+   result &= b;
+   for (unsigned i = 0; i < size; ++i) {
+      expected[i] = expectedA[i] && expectedB[i];
+   }
+   expect_equal(result, expected);
+
+   result = b;
+   result.reset(a);
+   for (unsigned i = 0; i < size; ++i) {
+      expected[i] = expectedB[i] && !expectedA[i];
+   }
+   expect_equal(result, expected);
+
+   result = a;
+   result ^= b;
+   for (unsigned i = 0; i < size; ++i) {
+      expected[i] = expectedA[i] != expectedB[i];
+   }
+   expect_equal(result, expected);
+
+   EXPECT_GT(a.findNext(1000), 4000);
+   EXPECT_EQ(-1, TypeParam(size).findFirst());
+}
+
+TEST(BitVectorKernelsTest, testAgainstGenericKernels)
+{
+   using polar::basic::internal::BitVectorKernels;
+   using polar::basic::internal::BitVectorWord;
+   const BitVectorKernels &kernels = polar::basic::internal::get_bit_vector_kernels();
+   const BitVectorKernels &generic = polar::basic::internal::get_generic_bit_vector_kernels();
+   std::mt19937_64 random(11);
+   for (size_t count = 0; count <= 150; ++count) {
+      std::vector<BitVectorWord> src(count), dest(count);
+      for (size_t i = 0; i < count; ++i) {
+         src[i] = random() & random();
+         dest[i] = random() | random();
+      }
+      auto check = [&](auto kernel, auto genericKernel) {
+         std::vector<BitVectorWord> actual = dest;
+         std::vector<BitVectorWord> expected = dest;
+         EXPECT_EQ((generic.*genericKernel)(expected.data(), src.data(), count),
+                   (kernels.*kernel)(actual.data(), src.data(), count));
+         EXPECT_EQ(expected, actual);
+         // Applying the operation again changes nothing.
+         EXPECT_FALSE((kernels.*kernel)(actual.data(), src.data(), count));
+      };
+      check(&BitVectorKernels::bitwiseOr, &BitVectorKernels::bitwiseOr);
+      check(&BitVectorKernels::bitwiseAnd, &BitVectorKernels::bitwiseAnd);
+      check(&BitVectorKernels::bitwiseAndNot, &BitVectorKernels::bitwiseAndNot);
+
+      std::vector<BitVectorWord> actual = dest;
+      std::vector<BitVectorWord> expected = dest;
+      kernels.bitwiseXor(actual.data(), src.data(), count);
+      generic.bitwiseXor(expected.data(), src.data(), count);
+      EXPECT_EQ(expected, actual);
+      EXPECT_EQ(generic.countPopulation(dest.data(), count),
+                kernels.countPopulation(dest.data(), count));
+
+      std::vector<BitVectorWord> zeros(count);
+      EXPECT_EQ(count, kernels.findNonZero(zeros.data(), count));
+      for (size_t i = 0; i < count; ++i) {
+         zeros[i] = BitVectorWord(1) << (i % 64);
+         EXPECT_EQ(i, kernels.findNonZero(zeros.data(), count));
+         zeros[i] = 0;
+      }
+   }
+   // All ones, where the per-byte sums of the population count are largest.
+   std::vector<BitVectorWord> ones(1000, ~BitVectorWord(0));
+   EXPECT_EQ(1000 * sizeof(BitVectorWord) * 8, kernels.countPopulation(ones.data(), 1000));
+}
+
 }
 
 #endif
@@ -0,0 +1,184 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "polarphp/basic/adt/EditDistanceIndex.h"
+#include "polarphp/basic/adt/EditDistance.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace polar::basic;
+
+namespace {
+
+TEST(EditDistanceIndexTest, testEmpty)
+{
+   EditDistanceIndex index;
+   EXPECT_TRUE(index.isEmpty());
+   EXPECT_EQ(0U, index.getSize());
+   EXPECT_FALSE(index.contains("foo"));
+   EXPECT_TRUE(index.findNearest("foo", 3).empty());
+}
+
+TEST(EditDistanceIndexTest, testInsert)
+{
+   EditDistanceIndex index;
+   EXPECT_TRUE(index.insert("strlen"));
+   EXPECT_TRUE(index.insert("strpos"));
+   EXPECT_FALSE(index.insert("strlen"));
+   EXPECT_TRUE(index.insert(""));
+   EXPECT_FALSE(index.insert(""));
+   EXPECT_EQ(3U, index.getSize());
+   EXPECT_TRUE(index.contains("strlen"));
+   EXPECT_TRUE(index.contains(""));
+   EXPECT_FALSE(index.contains("STRLEN"));
+   // Keys are copied.
+   std::string key = "substr";
+   index.insert(key);
+   key = "xxxxxx";
+   EXPECT_TRUE(index.contains("substr"));
+   EXPECT_FALSE(index.contains("xxxxxx"));
+}
+
+TEST(EditDistanceIndexTest, testFindNearest)
+{
+   EditDistanceIndex index;
+   for (StringRef name : {"strlen", "strpos", "strrpos", "stripos", "substr", "str_replace",
+                          "array_merge", "array_map", "in_array"}) {
+      index.insert(name);
+   }
+   auto matches = index.findNearest("strpso", 3);
+   ASSERT_EQ(4U, matches.size());
+   EXPECT_EQ("strpos", matches[0].key);
+   EXPECT_EQ(2U, matches[0].distance);
+   EXPECT_EQ("stripos", matches[1].key);
+   EXPECT_EQ(3U, matches[1].distance);
+   EXPECT_EQ("strlen", matches[2].key);
+   EXPECT_EQ(3U, matches[2].distance);
+   EXPECT_EQ("strrpos", matches[3].key);
+   EXPECT_EQ(3U, matches[3].distance);
+
+   matches = index.findNearest("strlen", 2);
+   ASSERT_EQ(1U, matches.size());
+   EXPECT_EQ("strlen", matches[0].key);
+   EXPECT_EQ(0U, matches[0].distance);
+
+   matches = index.findNearest("array_mrege", 3, 1);
+   ASSERT_EQ(1U, matches.size());
+   EXPECT_EQ("array_merge", matches[0].key);
+
+   matches = index.findNearest("stpos", 1);
+   ASSERT_EQ(1U, matches.size());
+   EXPECT_EQ("strpos", matches[0].key);
+   EXPECT_EQ(1U, matches[0].distance);
+
+   EXPECT_TRUE(index.findNearest("completely_unrelated", 2).empty());
+}
+
+TEST(EditDistanceIndexTest, testLimitWithManyTies)
+{
+   // Every key is three edits from the query, the limit keeps the
+   // alphabetically first ones.
+   EditDistanceIndex index;
+   std::vector<std::string> keys;
+   for (char first = 'a'; first <= 'z'; ++first) {
+      for (char second = 'a'; second <= 'z'; ++second) {
+         for (char third : {'0', '1', '2', '3'}) {
+            std::string key = std::string("query_") + first + second + third;
+            index.insert(key);
+            keys.push_back(key);
+         }
+      }
+   }
+   std::sort(keys.begin(), keys.end());
+   auto matches = index.findNearest("query_", 3, 5);
+   ASSERT_EQ(5U, matches.size());
+   for (size_t i = 0; i != matches.size(); ++i) {
+      EXPECT_EQ(3U, matches[i].distance);
+      EXPECT_EQ(keys[i], matches[i].key);
+   }
+   EXPECT_EQ(keys.size(), index.findNearest("query_", 3).size());
+}
+
+TEST(EditDistanceIndexTest, testIgnoreCase)
+{
+   EditDistanceIndex index(true);
+   EXPECT_TRUE(index.isIgnoreCase());
+   EXPECT_TRUE(index.insert("ArrayMerge"));
+   EXPECT_FALSE(index.insert("arraymerge"));
+   EXPECT_TRUE(index.insert("ArrayMap"));
+   EXPECT_TRUE(index.contains("ARRAYMERGE"));
+   auto matches = index.findNearest("ARRAYMERG", 1);
+   ASSERT_EQ(1U, matches.size());
+   EXPECT_EQ("ArrayMerge", matches[0].key);
+   EXPECT_EQ(1U, matches[0].distance);
+}
+
+void check_against_linear_scan(bool ignoreCase, size_t maxKeyLength, StringRef alphabet)
+{
+   std::mt19937 engine(1234);
+   std::vector<std::string> keys;
+   EditDistanceIndex index(ignoreCase);
+   for (int i = 0; i != 2000; ++i) {
+      std::string key;
+      for (size_t j = 0, length = 3 + engine() % (maxKeyLength - 2); j != length; ++j) {
+         key.push_back(alphabet[engine() % alphabet.size()]);
+      }
+      if (index.insert(key)) {
+         keys.push_back(key);
+      }
+   }
+   ASSERT_EQ(keys.size(), index.getSize());
+   for (int round = 0; round != 200; ++round) {
+      std::string query = keys[engine() % keys.size()];
+      for (int edit = 0, edits = engine() % 5; edit != edits && !query.empty(); ++edit) {
+         query[engine() % query.size()] = alphabet[engine() % alphabet.size()];
+      }
+      if (engine() % 2) {
+         query.erase(engine() % query.size(), 1);
+      }
+      unsigned maxDistance = engine() % 4;
+      std::vector<std::pair<unsigned, std::string>> expected;
+      for (const std::string &key : keys) {
+         unsigned distance = ignoreCase ? string_edit_distance_lower(query, key)
+                                        : string_edit_distance(query, key);
+         if (distance <= maxDistance) {
+            expected.emplace_back(distance, key);
+         }
+      }
+      std::sort(expected.begin(), expected.end());
+      auto matches = index.findNearest(query, maxDistance);
+      ASSERT_EQ(expected.size(), matches.size());
+      for (size_t i = 0; i != matches.size(); ++i) {
+         EXPECT_EQ(expected[i].first, matches[i].distance);
+         EXPECT_EQ(expected[i].second, matches[i].key);
+      }
+      size_t limit = 1 + engine() % 5;
+      auto limited = index.findNearest(query, maxDistance, limit);
+      ASSERT_EQ(std::min(limit, expected.size()), limited.size());
+      for (size_t i = 0; i != limited.size(); ++i) {
+         EXPECT_EQ(expected[i].first, limited[i].distance);
+         EXPECT_EQ(expected[i].second, limited[i].key);
+      }
+   }
+}
+
+TEST(EditDistanceIndexTest, testRandomAgainstLinearScan)
+{
+   check_against_linear_scan(false, 12, "abcde_");
+   check_against_linear_scan(false, 90, "ab");
+   check_against_linear_scan(true, 12, "abcABC_1");
+}
+
+} // anonymous namespace
@@ -0,0 +1,155 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "polarphp/basic/adt/EditDistance.h"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <string>
+
+using namespace polar::basic;
+
+namespace {
+
+unsigned reference_distance(StringRef from, StringRef to, unsigned maxEditDistance = 0)
+{
+   return compute_edit_distance(make_array_ref(from.data(), from.size()),
+                                make_array_ref(to.data(), to.size()),
+                                true, maxEditDistance);
+}
+
+std::string lower_string(StringRef str)
+{
+   std::string result = str.getStr();
+   for (char &c : result) {
+      if (c >= 'A' && c <= 'Z') {
+         c |= 0x20;
+      }
+   }
+   return result;
+}
+
+std::string random_string(std::mt19937 &engine, size_t length, StringRef alphabet)
+{
+   std::string result;
+   for (size_t i = 0; i != length; ++i) {
+      result.push_back(alphabet[engine() % alphabet.size()]);
+   }
+   return result;
+}
+
+TEST(EditDistanceTest, testBasics)
+{
+   EXPECT_EQ(0U, string_edit_distance("", ""));
+   EXPECT_EQ(3U, string_edit_distance("", "abc"));
+   EXPECT_EQ(3U, string_edit_distance("abc", ""));
+   EXPECT_EQ(0U, string_edit_distance("abc", "abc"));
+   EXPECT_EQ(3U, string_edit_distance("kitten", "sitting"));
+   EXPECT_EQ(2U, string_edit_distance("flaw", "lawn"));
+   EXPECT_EQ(1U, string_edit_distance("strlen", "strln"));
+   EXPECT_EQ(2U, string_edit_distance("array_merge", "aray_merg"));
+   EXPECT_EQ(2U, string_edit_distance("\xff\x80x", "\x80\xff"));
+}
+
+TEST(EditDistanceTest, testMaxEditDistance)
+{
+   EXPECT_EQ(3U, string_edit_distance("kitten", "sitting", 3));
+   EXPECT_EQ(3U, string_edit_distance("kitten", "sitting", 2));
+   EXPECT_EQ(2U, string_edit_distance("kitten", "sitting", 1));
+   EXPECT_EQ(2U, string_edit_distance("a", "abcdefgh", 1));
+   EXPECT_EQ(9U, string_edit_distance("aaaaaaaaaaaaaaaaaaaa", "bbbbbbbbbbbbbbbbbbbb", 8));
+   // The limit holds whenever the distance exceeds it, also in long strings.
+   std::string lhs(300, 'a');
+   std::string rhs(300, 'b');
+   EXPECT_EQ(11U, string_edit_distance(lhs, rhs, 10));
+   EXPECT_EQ(300U, string_edit_distance(lhs, rhs));
+}
+
+TEST(EditDistanceTest, testIgnoreCase)
+{
+   EXPECT_EQ(0U, string_edit_distance_lower("ArrayMerge", "arraymerge"));
+   EXPECT_EQ(1U, string_edit_distance_lower("STRLEN", "strln"));
+   EXPECT_EQ(1U, string_edit_distance("a", "A"));
+   // Only ASCII letters fold, '@' and '`' differ from 'A' and 'a' in bit 5.
+   EXPECT_EQ(1U, string_edit_distance_lower("@", "`"));
+   EXPECT_EQ(1U, string_edit_distance_lower("[", "{"));
+   EXPECT_EQ(1U, string_edit_distance_lower("\xc4", "\xe4"));
+   std::string longUpper(130, 'X');
+   std::string longLower(130, 'x');
+   EXPECT_EQ(0U, string_edit_distance_lower(longUpper, longLower));
+   EXPECT_EQ(0U, LevenshteinMatcher(longUpper, true).getDistance(longLower));
+   EXPECT_EQ(130U, LevenshteinMatcher(longUpper).getDistance(longLower));
+}
+
+TEST(EditDistanceTest, testRandomAgainstReference)
+{
+   std::mt19937 engine(42);
+   // Lengths around and across the 64 character blocks.
+   const size_t lengths[] = {0, 1, 2, 7, 31, 63, 64, 65, 100, 127, 128, 129, 200, 257, 300};
+   for (size_t fromLength : lengths) {
+      for (size_t toLength : lengths) {
+         for (StringRef alphabet : {StringRef("ab"), StringRef("abcdABCD_"),
+                                    StringRef("abcdefghijklmnopqrstuvwxyz")}) {
+            std::string from = random_string(engine, fromLength, alphabet);
+            std::string to = random_string(engine, toLength, alphabet);
+            unsigned expected = reference_distance(from, to);
+            EXPECT_EQ(expected, string_edit_distance(from, to));
+            EXPECT_EQ(expected, string_edit_distance(to, from));
+            EXPECT_EQ(expected, LevenshteinMatcher(from).getDistance(to));
+            EXPECT_EQ(reference_distance(lower_string(from), lower_string(to)),
+                      string_edit_distance_lower(from, to));
+            EXPECT_EQ(reference_distance(lower_string(from), lower_string(to)),
+                      LevenshteinMatcher(from, true).getDistance(to));
+            for (unsigned max : {1U, 5U, 40U}) {
+               unsigned capped = expected > max ? max + 1 : expected;
+               EXPECT_EQ(capped, string_edit_distance(from, to, max));
+               EXPECT_EQ(capped, LevenshteinMatcher(from).getDistance(to, max));
+            }
+         }
+      }
+   }
+}
+
+TEST(EditDistanceTest, testSimilarStrings)
+{
+   // Mostly equal strings keep the distance small, which the random test
+   // above hardly covers.
+   std::mt19937 engine(7);
+   for (size_t length : {10U, 64U, 90U, 200U}) {
+      for (int round = 0; round != 20; ++round) {
+         std::string from = random_string(engine, length, "abcdefgh");
+         std::string to = from;
+         for (int edit = 0, edits = engine() % 6; edit != edits; ++edit) {
+            size_t pos = to.empty() ? 0 : engine() % to.size();
+            switch (engine() % 3) {
+            case 0:
+               to.insert(pos, 1, 'z');
+               break;
+            case 1:
+               if (!to.empty()) {
+                  to.erase(pos, 1);
+               }
+               break;
+            default:
+               if (!to.empty()) {
+                  to[pos] = 'y';
+               }
+               break;
+            }
+         }
+         EXPECT_EQ(reference_distance(from, to), string_edit_distance(from, to));
+         EXPECT_EQ(reference_distance(from, to), LevenshteinMatcher(from).getDistance(to));
+         EXPECT_EQ(reference_distance(from, to, 2), string_edit_distance(from, to, 2));
+      }
+   }
+}
+
+} // anonymous namespace
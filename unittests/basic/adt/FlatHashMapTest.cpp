@@ -0,0 +1,184 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/15.
+
+#include "polarphp/basic/adt/FlatHashMap.h"
+#include "polarphp/basic/adt/FlatHashSet.h"
+#include "polarphp/basic/adt/StringRef.h"
+#include "gtest/gtest.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace {
+
+using namespace polar::basic;
+
+/// Hashes owned strings and string references alike.
+struct StringKeyInfo
+{
+   static unsigned getHashValue(StringRef str)
+   {
+      return DenseMapInfo<StringRef>::getHashValue(str);
+   }
+
+   static bool isEqual(StringRef lhs, StringRef rhs)
+   {
+      return lhs == rhs;
+   }
+};
+
+TEST(FlatHashMapTest, testEmptyMap)
+{
+   FlatHashMap<int, int> map;
+   EXPECT_TRUE(map.empty());
+   EXPECT_EQ(0u, map.size());
+   EXPECT_TRUE(map.begin() == map.end());
+   EXPECT_TRUE(map.find(1) == map.end());
+   EXPECT_EQ(0u, map.count(1));
+   EXPECT_EQ(0, map.lookup(1));
+   EXPECT_FALSE(map.erase(1));
+   EXPECT_EQ(0u, map.getMemorySize());
+}
+
+TEST(FlatHashMapTest, testInsertFindErase)
+{
+   FlatHashMap<int, std::string> map;
+   EXPECT_TRUE(map.insert({1, "one"}).second);
+   EXPECT_FALSE(map.insert({1, "uno"}).second);
+   EXPECT_EQ("one", map.lookup(1));
+   map[2] = "two";
+   EXPECT_TRUE(map.tryEmplace(3, 5, 'x').second);
+   EXPECT_EQ("xxxxx", map.find(3)->second);
+   EXPECT_EQ(3u, map.size());
+
+   EXPECT_TRUE(map.erase(2));
+   EXPECT_FALSE(map.erase(2));
+   map.erase(map.find(1));
+   EXPECT_EQ(1u, map.size());
+   EXPECT_EQ(0u, map.count(1));
+   EXPECT_EQ(1u, map.count(3));
+}
+
+// Keys that DenseMap reserves as empty and tombstone markers are ordinary
+// keys here.
+TEST(FlatHashMapTest, testReservedDenseMapKeys)
+{
+   FlatHashMap<unsigned, unsigned> map;
+   map[DenseMapInfo<unsigned>::getEmptyKey()] = 1;
+   map[DenseMapInfo<unsigned>::getTombstoneKey()] = 2;
+   EXPECT_EQ(1u, map.lookup(~0U));
+   EXPECT_EQ(2u, map.lookup(~0U - 1));
+}
+
+TEST(FlatHashMapTest, testAgainstStdMap)
+{
+   std::mt19937 random(42);
+   FlatHashMap<int, int> map;
+   std::map<int, int> expected;
+   for (int round = 0; round < 200000; ++round) {
+      int key = random() % 5000;
+      switch (random() % 3) {
+      case 0:
+      case 1:
+         map[key] = round;
+         expected[key] = round;
+         break;
+      case 2:
+         EXPECT_EQ(expected.erase(key) != 0, map.erase(key));
+         break;
+      }
+   }
+   ASSERT_EQ(expected.size(), map.size());
+   for (const auto &entry : expected) {
+      EXPECT_EQ(entry.second, map.lookup(entry.first));
+   }
+   size_t iterated = 0;
+   for (const auto &entry : map) {
+      EXPECT_EQ(expected[entry.first], entry.second);
+      ++iterated;
+   }
+   EXPECT_EQ(expected.size(), iterated);
+   // The table grows to the live entries, not to everything ever inserted.
+   EXPECT_LE(map.getCapacity(), 8192u);
+}
+
+TEST(FlatHashMapTest, testCopyMoveAndClear)
+{
+   FlatHashMap<int, std::unique_ptr<int>> owner;
+   for (int index = 0; index < 100; ++index) {
+      owner[index] = std::make_unique<int>(index);
+   }
+   FlatHashMap<int, std::unique_ptr<int>> moved(std::move(owner));
+   EXPECT_TRUE(owner.empty());
+   EXPECT_EQ(100u, moved.size());
+   EXPECT_EQ(42, *moved.find(42)->second);
+
+   FlatHashMap<int, std::string> map{{1, "one"}, {2, "two"}};
+   FlatHashMap<int, std::string> copy(map);
+   map[3] = "three";
+   EXPECT_EQ(2u, copy.size());
+   EXPECT_EQ("two", copy.lookup(2));
+   unsigned capacity = map.getCapacity();
+   map.clear();
+   EXPECT_TRUE(map.empty());
+   EXPECT_EQ(capacity, map.getCapacity());
+   EXPECT_TRUE(map.find(1) == map.end());
+}
+
+TEST(FlatHashMapTest, testReserve)
+{
+   FlatHashMap<int, int> map;
+   map.reserve(1000);
+   unsigned capacity = map.getCapacity();
+   EXPECT_GE(capacity, 1000u);
+   for (int index = 0; index < 1000; ++index) {
+      map[index] = index;
+   }
+   EXPECT_EQ(capacity, map.getCapacity());
+}
+
+TEST(FlatHashMapTest, testHeterogeneousLookup)
+{
+   FlatHashMap<std::string, int, StringKeyInfo> map;
+   map["strlen"] = 1;
+   map["array_map"] = 2;
+   // No std::string is built for these lookups.
+   EXPECT_EQ(2, map.findAs(StringRef("array_map"))->second);
+   EXPECT_TRUE(map.findAs(StringRef("array_filter")) == map.end());
+   EXPECT_EQ(1, map.lookup("strlen"));
+}
+
+TEST(FlatHashMapTest, testHashFunctor)
+{
+   FlatHashMap<std::string, int, HashFunctorInfo<std::hash<std::string>>> map;
+   map["echo"] = 1;
+   map[std::string("print")] = 2;
+   EXPECT_EQ(2, map.lookup("print"));
+   EXPECT_EQ(0u, map.count("exit"));
+}
+
+TEST(FlatHashSetTest, testInsertAndErase)
+{
+   FlatHashSet<StringRef> set{"foo", "bar"};
+   EXPECT_TRUE(set.contains("foo"));
+   EXPECT_FALSE(set.insert("bar").second);
+   EXPECT_TRUE(set.insert("baz").second);
+   EXPECT_EQ(3u, set.size());
+   set.erase(set.find("foo"));
+   EXPECT_FALSE(set.contains("foo"));
+   EXPECT_TRUE(set.erase("bar"));
+   EXPECT_EQ(1u, set.size());
+   EXPECT_EQ("baz", *set.begin());
+}
+
+} // anonymous namespace
@@ -0,0 +1,356 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "polarphp/basic/adt/PersistentHashMap.h"
+#include "gtest/gtest.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace polar::basic;
+
+namespace {
+
+/// Puts many keys on one hash, to exercise the collision nodes.
+struct CollidingKeyInfo
+{
+   static unsigned getHashValue(int key)
+   {
+      return static_cast<unsigned>(key) % 3;
+   }
+
+   static bool isEqual(int lhs, int rhs)
+   {
+      return lhs == rhs;
+   }
+};
+
+/// Counts its live instances, to catch leaked and doubly freed nodes.
+struct CountedValue
+{
+   static int sm_live;
+
+   CountedValue(int value = 0)
+      : value(value)
+   {
+      ++sm_live;
+   }
+
+   CountedValue(const CountedValue &other)
+      : value(other.value)
+   {
+      ++sm_live;
+   }
+
+   ~CountedValue()
+   {
+      --sm_live;
+   }
+
+   CountedValue &operator=(const CountedValue &) = default;
+
+   bool operator==(const CountedValue &other) const
+   {
+      return value == other.value;
+   }
+
+   int value;
+};
+
+int CountedValue::sm_live = 0;
+
+uint64_t next_random(uint64_t &state)
+{
+   state += 0x9e3779b97f4a7c15;
+   uint64_t value = state;
+   value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+   value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+   return value ^ (value >> 31);
+}
+
+template <typename MapT>
+std::map<int, int> to_std_map(const MapT &map)
+{
+   std::map<int, int> result;
+   for (const auto &entry : map) {
+      EXPECT_TRUE(result.emplace(entry.first, entry.second).second);
+   }
+   EXPECT_EQ(result.size(), map.getSize());
+   return result;
+}
+
+TEST(PersistentHashMapTest, testEmptyMap)
+{
+   PersistentHashMap<int, int> map;
+   EXPECT_TRUE(map.isEmpty());
+   EXPECT_EQ(0u, map.getSize());
+   EXPECT_EQ(nullptr, map.lookup(1));
+   EXPECT_TRUE(map.begin() == map.end());
+   EXPECT_TRUE((map == PersistentHashMap<int, int>()));
+   EXPECT_TRUE(map.remove(1).isEmpty());
+}
+
+TEST(PersistentHashMapTest, testAddAndRemove)
+{
+   PersistentHashMap<int, int> empty;
+   PersistentHashMap<int, int> one = empty.add(3, 10);
+   PersistentHashMap<int, int> three = one.add(4, 11).add(5, 12);
+   PersistentHashMap<int, int> replaced = three.add(4, 21);
+
+   EXPECT_TRUE(empty.isEmpty());
+   EXPECT_EQ(1u, one.getSize());
+   EXPECT_EQ(3u, three.getSize());
+   EXPECT_EQ(3u, replaced.getSize());
+   EXPECT_EQ(10, *three.lookup(3));
+   EXPECT_EQ(11, *three.lookup(4));
+   EXPECT_EQ(21, *replaced.lookup(4));
+   EXPECT_EQ(nullptr, one.lookup(4));
+   EXPECT_TRUE(three.contains(5));
+   EXPECT_FALSE(three.contains(6));
+
+   PersistentHashMap<int, int> removed = replaced.remove(3);
+   EXPECT_EQ(2u, removed.getSize());
+   EXPECT_FALSE(removed.contains(3));
+   EXPECT_TRUE(replaced.contains(3));
+   EXPECT_TRUE(removed.remove(42).isIdenticalTo(removed));
+   EXPECT_TRUE(removed.remove(4).remove(5).isEmpty());
+   EXPECT_NE(three, replaced);
+   EXPECT_EQ(three, replaced.add(4, 11));
+}
+
+TEST(PersistentHashMapTest, testCollisions)
+{
+   PersistentHashMap<int, int, CollidingKeyInfo> map;
+   for (int key = 0; key < 100; ++key) {
+      map = map.add(key, key * 2);
+   }
+   EXPECT_EQ(100u, map.getSize());
+   for (int key = 0; key < 100; ++key) {
+      ASSERT_NE(nullptr, map.lookup(key));
+      EXPECT_EQ(key * 2, *map.lookup(key));
+   }
+   EXPECT_EQ(nullptr, map.lookup(100));
+
+   PersistentHashMap<int, int, CollidingKeyInfo> even = map;
+   for (int key = 1; key < 100; key += 2) {
+      even = even.remove(key);
+   }
+   EXPECT_EQ(50u, even.getSize());
+   EXPECT_FALSE(even.contains(1));
+   EXPECT_TRUE(even.contains(98));
+   EXPECT_EQ(100u, map.getSize());
+
+   std::map<int, int> entries = to_std_map(map.difference(even));
+   EXPECT_EQ(50u, entries.size());
+   EXPECT_EQ(1, entries.begin()->first);
+   EXPECT_EQ(map, even.unionWith(map));
+   EXPECT_EQ(even, map.intersectWith(even));
+}
+
+template <typename KeyInfoT>
+void check_against_std_map(uint64_t seed)
+{
+   using MapType = PersistentHashMap<int, int, KeyInfoT>;
+   uint64_t state = seed;
+   std::vector<MapType> maps(1);
+   std::vector<std::map<int, int>> expected(1);
+   for (unsigned step = 0; step < 2000; ++step) {
+      size_t index = next_random(state) % maps.size();
+      int key = static_cast<int>(next_random(state) % 300);
+      int value = static_cast<int>(next_random(state) % 4);
+      MapType map = maps[index];
+      std::map<int, int> entries = expected[index];
+      switch (next_random(state) % 8) {
+      case 0:
+      case 1:
+      case 2:
+         map = map.add(key, value);
+         entries[key] = value;
+         break;
+      case 3:
+      case 4:
+         map = map.remove(key);
+         entries.erase(key);
+         break;
+      case 5: {
+         size_t other = next_random(state) % maps.size();
+         auto merge = [](int, int lhs, int rhs) {
+            return lhs == rhs ? lhs : (lhs * 3 + rhs) % 7;
+         };
+         map = map.unionWith(maps[other], merge);
+         for (const auto &entry : expected[other]) {
+            auto iter = entries.find(entry.first);
+            if (iter == entries.end()) {
+               entries.insert(entry);
+            } else {
+               iter->second = merge(entry.first, iter->second, entry.second);
+            }
+         }
+         break;
+      }
+      case 6: {
+         size_t other = next_random(state) % maps.size();
+         map = map.intersectWith(maps[other]);
+         for (auto iter = entries.begin(); iter != entries.end();) {
+            iter = expected[other].count(iter->first) ? std::next(iter) : entries.erase(iter);
+         }
+         break;
+      }
+      default: {
+         size_t other = next_random(state) % maps.size();
+         map = map.difference(maps[other]);
+         for (const auto &entry : expected[other]) {
+            entries.erase(entry.first);
+         }
+         break;
+      }
+      }
+      ASSERT_EQ(entries, to_std_map(map));
+
+      // The differences must be exactly those of the expected contents.
+      size_t other = next_random(state) % maps.size();
+      std::map<int, std::pair<int, int>> differences;
+      map.forEachDifference(maps[other], [&](int key, const int *lhs, const int *rhs) {
+         EXPECT_TRUE(differences.emplace(key, std::make_pair(lhs ? *lhs : -1,
+                                                             rhs ? *rhs : -1)).second);
+      });
+      std::map<int, std::pair<int, int>> expectedDifferences;
+      for (const auto &entry : entries) {
+         auto iter = expected[other].find(entry.first);
+         if (iter == expected[other].end()) {
+            expectedDifferences[entry.first] = {entry.second, -1};
+         } else if (iter->second != entry.second) {
+            expectedDifferences[entry.first] = {entry.second, iter->second};
+         }
+      }
+      for (const auto &entry : expected[other]) {
+         if (!entries.count(entry.first)) {
+            expectedDifferences[entry.first] = {-1, entry.second};
+         }
+      }
+      ASSERT_EQ(expectedDifferences, differences);
+      ASSERT_EQ(expectedDifferences.empty(), map == maps[other]);
+
+      if (maps.size() < 16) {
+         maps.push_back(map);
+         expected.push_back(entries);
+      } else {
+         maps[index] = map;
+         expected[index] = entries;
+      }
+   }
+}
+
+TEST(PersistentHashMapTest, testAgainstStdMap)
+{
+   check_against_std_map<DenseMapInfo<int>>(1);
+   check_against_std_map<CollidingKeyInfo>(2);
+}
+
+TEST(PersistentHashMapTest, testCanonicalShape)
+{
+   // Tries with the same keys have the same shape whatever the history, so
+   // removing what was added gives back an equal trie.
+   PersistentHashMap<int, int> forward;
+   PersistentHashMap<int, int> backward;
+   for (int key = 0; key < 5000; ++key) {
+      forward = forward.add(key, key);
+      backward = backward.add(4999 - key, 4999 - key);
+   }
+   PersistentHashMap<int, int> shrunk = forward;
+   for (int key = 5000; key < 6000; ++key) {
+      shrunk = shrunk.add(key, key);
+   }
+   for (int key = 5000; key < 6000; ++key) {
+      shrunk = shrunk.remove(key);
+   }
+   EXPECT_EQ(forward, backward);
+   EXPECT_EQ(forward, shrunk);
+
+   // Shared subtrees are reused as they are.
+   PersistentHashMap<int, int> fork = forward.add(7, 70);
+   EXPECT_TRUE(forward.unionWith(forward).isIdenticalTo(forward));
+   EXPECT_TRUE(forward.intersectWith(fork).isIdenticalTo(forward));
+   EXPECT_TRUE(forward.difference(forward).isEmpty());
+   EXPECT_EQ(70, *forward.unionWith(fork).lookup(7));
+   unsigned numDifferences = 0;
+   forward.forEachDifference(fork, [&](int key, const int *lhs, const int *rhs) {
+      EXPECT_EQ(7, key);
+      EXPECT_EQ(7, *lhs);
+      EXPECT_EQ(70, *rhs);
+      ++numDifferences;
+   });
+   EXPECT_EQ(1u, numDifferences);
+}
+
+TEST(PersistentHashMapTest, testNodeLifetime)
+{
+   {
+      PersistentHashMap<int, CountedValue> map;
+      std::vector<PersistentHashMap<int, CountedValue>> versions;
+      for (int key = 0; key < 1000; ++key) {
+         map = map.add(key, CountedValue(key));
+         if (key % 100 == 0) {
+            versions.push_back(map);
+         }
+      }
+      for (int key = 0; key < 1000; key += 3) {
+         map = map.remove(key);
+      }
+      versions.push_back(map.unionWith(versions[3]));
+      versions.push_back(map.intersectWith(versions[5]));
+      versions.push_back(versions[7].difference(map));
+      EXPECT_EQ(666u, map.getSize());
+      EXPECT_GT(CountedValue::sm_live, 0);
+   }
+   EXPECT_EQ(0, CountedValue::sm_live);
+}
+
+TEST(PersistentHashSetTest, testSetOperations)
+{
+   PersistentHashSet<int> empty;
+   PersistentHashSet<int> odd;
+   PersistentHashSet<int> small;
+   std::set<int> expectedOdd;
+   for (int key = 1; key < 1000; key += 2) {
+      odd = odd.add(key);
+      expectedOdd.insert(key);
+   }
+   for (int key = 0; key < 100; ++key) {
+      small = small.add(key);
+   }
+   EXPECT_TRUE(empty.isEmpty());
+   EXPECT_EQ(500u, odd.getSize());
+   EXPECT_TRUE(odd.add(1).isIdenticalTo(odd));
+   EXPECT_TRUE(odd.contains(999));
+   EXPECT_FALSE(odd.contains(998));
+   EXPECT_EQ(expectedOdd, std::set<int>(odd.begin(), odd.end()));
+
+   PersistentHashSet<int> both = odd.unionWith(small);
+   EXPECT_EQ(550u, both.getSize());
+   EXPECT_EQ(50u, odd.intersectWith(small).getSize());
+   EXPECT_EQ(450u, odd.difference(small).getSize());
+   EXPECT_EQ(both, small.unionWith(odd));
+   EXPECT_EQ(small, both.difference(odd.difference(small)));
+
+   std::set<int> onlyInSmall;
+   std::set<int> onlyInOdd;
+   odd.forEachDifference(small, [&](int key, bool inOdd) {
+      (inOdd ? onlyInOdd : onlyInSmall).insert(key);
+   });
+   EXPECT_EQ(50u, onlyInSmall.size());
+   EXPECT_EQ(450u, onlyInOdd.size());
+   EXPECT_TRUE(onlyInSmall.count(0));
+   EXPECT_TRUE(onlyInOdd.count(101));
+}
+
+} // anonymous namespace
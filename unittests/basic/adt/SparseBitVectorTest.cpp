@@ -199,4 +199,50 @@ TEST(SparseBitVectorTest, testFind)
    vector.clear();
 }
 
+
+// Elements of this size are combined by the BitVector word kernels.
+TEST(SparseBitVectorTest, testDenseElements)
+{
+   SparseBitVector<1024> vector1;
+   SparseBitVector<1024> vector2;
+   for (unsigned i = 0; i < 5000; i += 3) {
+      vector1.set(i);
+   }
+   for (unsigned i = 0; i < 5000; i += 5) {
+      vector2.set(i);
+   }
+   vector2.set(9000);
+   EXPECT_EQ(1667u, vector1.count());
+   EXPECT_EQ(1001u, vector2.count());
+
+   SparseBitVector<1024> result = vector1;
+   EXPECT_TRUE(result |= vector2);
+   EXPECT_FALSE(result |= vector2);
+   EXPECT_EQ(1667u + 1001u - 334u, result.count());
+   EXPECT_TRUE(result.test(9000));
+
+   result = vector1;
+   EXPECT_TRUE(result &= vector2);
+   EXPECT_EQ(334u, result.count());
+   EXPECT_EQ(0, result.findFirst());
+   EXPECT_EQ(4995, result.findLast());
+
+   result = vector1;
+   EXPECT_TRUE(result.intersectWithComplement(vector2));
+   EXPECT_EQ(1667u - 334u, result.count());
+   EXPECT_FALSE(result.test(15));
+   EXPECT_TRUE(result.test(3));
+
+   SparseBitVector<1024> difference;
+   difference.intersectWithComplement(vector2, vector1);
+   EXPECT_EQ(1001u - 334u, difference.count());
+   EXPECT_TRUE(difference.test(9000));
+
+   // An element that the intersection clears is dropped.
+   SparseBitVector<1024> high;
+   high.set(9001);
+   high &= vector2;
+   EXPECT_TRUE(high.empty());
+}
+
 }
@@ -17,6 +17,7 @@
 // Created by polarboy on 2018/07/09.
 
 #include "polarphp/basic/adt/StringMap.h"
+#include "polarphp/basic/adt/CachedHashString.h"
 #include "polarphp/basic/adt/Twine.h"
 #include "polarphp/global/DataTypes.h"
 #include "gtest/gtest.h"
@@ -529,6 +530,46 @@ TEST(StringMapCustomTest, testEmplaceTest)
    EXPECT_EQ(42, map["abcd"].Data);
 }
 
+TEST(StringMapCustomTest, testPrecomputedHash)
+{
+   StringMap<int> map;
+   uint32_t hash = StringMapImpl::hash("array_map");
+   EXPECT_TRUE(map.insert({"array_map", 1}, hash).second);
+   EXPECT_FALSE(map.tryEmplaceWithHash("array_map", hash, 2).second);
+   EXPECT_EQ(1, map.find("array_map", hash)->second);
+   EXPECT_EQ(1u, map.count("array_map", hash));
+   EXPECT_EQ(1, map.lookup("array_map"));
+
+   CachedHashStringRef key("strlen");
+   EXPECT_EQ(StringMapImpl::hash("strlen"), key.getHash());
+   map[key.getValue()] = 3;
+   EXPECT_EQ(3, map.find(key.getValue(), key.getHash())->second);
+   CachedHashStringRef missing("str_len");
+   EXPECT_TRUE(map.find(missing.getValue(), missing.getHash()) == map.end());
+}
+
+// Keys of every length up to past the short key path, and keys that differ
+// only in their middle byte, must all be told apart.
+TEST(StringMapCustomTest, testHashAllLengths)
+{
+   StringMap<unsigned> map;
+   std::string key;
+   for (unsigned length = 0; length < 40; ++length) {
+      map[key] = length;
+      key.push_back('a' + length % 26);
+   }
+   map["aza"] = 100;
+   map["aya"] = 101;
+   EXPECT_EQ(42u, map.getSize());
+   key.clear();
+   for (unsigned length = 0; length < 40; ++length) {
+      EXPECT_EQ(length, map.lookup(key));
+      key.push_back('a' + length % 26);
+   }
+   EXPECT_EQ(100u, map.lookup("aza"));
+   EXPECT_EQ(101u, map.lookup("aya"));
+}
+
 // Test that StringMapEntryBase can handle size_t wide sizes.
 TEST(StringMapCustomTest, testStringMapEntryBaseSize)
 {
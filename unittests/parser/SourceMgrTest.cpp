@@ -0,0 +1,170 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/14.
+
+#include "gtest/gtest.h"
+#include "polarphp/ast/DiagnosticEngine.h"
+#include "polarphp/ast/DiagnosticsCommon.h"
+#include "polarphp/parser/SourceMgr.h"
+#include "polarphp/syntax/RawSyntax.h"
+#include "polarphp/utils/FileSystem.h"
+#include "polarphp/utils/MemoryBuffer.h"
+#include "polarphp/utils/RawOutStream.h"
+
+#include <string>
+#include <vector>
+
+using polar::ast::DiagnosticEngine;
+using polar::ast::DiagnosticTransaction;
+using polar::basic::SmallString;
+using polar::basic::StringRef;
+using polar::parser::SourceManager;
+using polar::parser::SourceLoc;
+using polar::utils::MemoryBuffer;
+using polar::syntax::RawSyntax;
+using polar::syntax::RefCountPtr;
+using polar::syntax::SourcePresence;
+using polar::syntax::SyntaxKind;
+using polar::utils::RawFdOutStream;
+
+namespace diag = polar::ast::diag;
+
+namespace {
+
+class SourceMgrResidencyTest : public ::testing::Test
+{
+protected:
+   void TearDown() override
+   {
+      for (const std::string &path : m_paths) {
+         polar::fs::remove(path);
+      }
+   }
+
+   /// Writes a file that is big enough to be memory-mapped and adds it to
+   /// the source manager.
+   unsigned addMappedFile(char fill)
+   {
+      int fd;
+      SmallString<64> path;
+      EXPECT_FALSE(polar::fs::create_temporary_file("SourceMgrResidency", "php",
+                                                    fd, path));
+      {
+         RawFdOutStream outStream(fd, true);
+         outStream << std::string(sm_fileSize, fill);
+      }
+      m_paths.push_back(path.getStr());
+      auto buffer = MemoryBuffer::getFile(path);
+      EXPECT_TRUE(bool(buffer));
+      EXPECT_EQ(MemoryBuffer::BufferKind::MemoryBuffer_MMap,
+                (*buffer)->getBufferKind());
+      return m_sourceMgr.addNewSourceBuffer(std::move(*buffer));
+   }
+
+   // Not a multiple of the page size, so the null terminator is mapped too.
+   static constexpr size_t sm_fileSize = 64 * 1024 + 1;
+
+   SourceManager m_sourceMgr;
+   std::vector<std::string> m_paths;
+};
+
+TEST_F(SourceMgrResidencyTest, testUnlimitedKeepsEverything)
+{
+   unsigned first = addMappedFile('a');
+   unsigned second = addMappedFile('b');
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(first));
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(second));
+   EXPECT_EQ(2 * sm_fileSize, m_sourceMgr.getResidentBufferBytes());
+
+   unsigned copy = m_sourceMgr.addMemBufferCopy("<?php echo 1;", "copy.php");
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(copy));
+   EXPECT_EQ(2 * sm_fileSize, m_sourceMgr.getResidentBufferBytes());
+}
+
+TEST_F(SourceMgrResidencyTest, testLeastRecentlyUsedIsDropped)
+{
+   m_sourceMgr.setResidentBufferLimit(2 * sm_fileSize);
+   unsigned first = addMappedFile('a');
+   unsigned second = addMappedFile('b');
+   SourceLoc firstLoc = m_sourceMgr.getLocForOffset(first, 100);
+   unsigned third = addMappedFile('c');
+   EXPECT_FALSE(m_sourceMgr.isBufferResident(first));
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(second));
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(third));
+   EXPECT_EQ(2 * sm_fileSize, m_sourceMgr.getResidentBufferBytes());
+
+   // Locations into a dropped buffer stay valid and its text comes back.
+   EXPECT_EQ(first, m_sourceMgr.findBufferContainingLoc(firstLoc));
+   StringRef text = m_sourceMgr.getEntireTextForBuffer(first);
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(first));
+   EXPECT_FALSE(m_sourceMgr.isBufferResident(second));
+   EXPECT_EQ(sm_fileSize, text.size());
+   EXPECT_EQ(StringRef::npos, text.findFirstNotOf('a'));
+   EXPECT_EQ('\0', *text.end());
+}
+
+TEST_F(SourceMgrResidencyTest, testRetainedBuffersStay)
+{
+   m_sourceMgr.setResidentBufferLimit(sm_fileSize);
+   unsigned first = addMappedFile('a');
+   m_sourceMgr.retainBuffer(first);
+   unsigned second = addMappedFile('b');
+   unsigned third = addMappedFile('c');
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(first));
+   EXPECT_FALSE(m_sourceMgr.isBufferResident(second));
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(third));
+
+   m_sourceMgr.releaseBuffer(first);
+   EXPECT_FALSE(m_sourceMgr.isBufferResident(first));
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(third));
+   EXPECT_EQ(sm_fileSize, m_sourceMgr.getResidentBufferBytes());
+
+   m_sourceMgr.setResidentBufferLimit(0);
+   m_sourceMgr.retainBuffer(second);
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(second));
+   m_sourceMgr.releaseBuffer(second);
+   EXPECT_EQ(2 * sm_fileSize, m_sourceMgr.getResidentBufferBytes());
+}
+
+TEST_F(SourceMgrResidencyTest, testSyntaxTreesRetainTheirBuffer)
+{
+   m_sourceMgr.setResidentBufferLimit(sm_fileSize);
+   unsigned first = addMappedFile('a');
+   RefCountPtr<RawSyntax> tree = m_sourceMgr.retainBufferForSyntaxTree(
+            first, RawSyntax::make(SyntaxKind::Unknown, {}, SourcePresence::Present));
+   RefCountPtr<RawSyntax> otherRef = tree;
+   addMappedFile('b');
+   addMappedFile('c');
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(first));
+   tree.reset();
+   EXPECT_TRUE(m_sourceMgr.isBufferResident(first));
+   // The buffer is released with the last reference to the tree.
+   otherRef.reset();
+   EXPECT_FALSE(m_sourceMgr.isBufferResident(first));
+   EXPECT_EQ(sm_fileSize, m_sourceMgr.getResidentBufferBytes());
+}
+
+TEST_F(SourceMgrResidencyTest, testPendingDiagnosticsRetainTheirBuffer)
+{
+   m_sourceMgr.setResidentBufferLimit(sm_fileSize);
+   unsigned first = addMappedFile('a');
+   DiagnosticEngine engine(m_sourceMgr);
+   {
+      DiagnosticTransaction transaction(engine);
+      engine.diagnose(m_sourceMgr.getLocForOffset(first, 4), diag::not_implemented, "goto");
+      addMappedFile('b');
+      addMappedFile('c');
+      EXPECT_TRUE(m_sourceMgr.isBufferResident(first));
+   }
+   // Emitting the diagnostics drops them, and with them the retain.
+   EXPECT_FALSE(m_sourceMgr.isBufferResident(first));
+}
+
+} // anonymous namespace
@@ -0,0 +1,83 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/08.
+
+#include "polarphp/syntax/CompactTrivia.h"
+#include "gtest/gtest.h"
+
+using polar::syntax::CompactTrivia;
+using polar::syntax::CompactTriviaPiece;
+using polar::syntax::Trivia;
+using polar::syntax::TriviaKind;
+using polar::syntax::TriviaPiece;
+using polar::basic::SmallVector;
+using polar::basic::StringRef;
+using polar::utils::BumpPtrAllocator;
+
+TEST(CompactTriviaTest, testIndentationIsInline)
+{
+   BumpPtrAllocator allocator;
+   ASSERT_TRUE(CompactTrivia::make(Trivia(), allocator).empty());
+   CompactTrivia indent = CompactTrivia::make(
+            {{TriviaKind::Newline, 1}, {TriviaKind::Space, 100000}}, allocator);
+   ASSERT_TRUE(indent.isInline());
+   ASSERT_EQ(100001u, indent.getTextLength());
+   ASSERT_EQ(CompactTrivia::getIndentation(1, 100000), indent);
+   CompactTrivia spaces = CompactTrivia::make({{TriviaKind::Space, 4}}, allocator);
+   ASSERT_EQ(CompactTrivia::getIndentation(0, 4), spaces);
+   SmallVector<CompactTriviaPiece, 2> pieces;
+   spaces.getPieces(pieces);
+   ASSERT_EQ(1u, pieces.size());
+   ASSERT_EQ((CompactTriviaPiece{TriviaKind::Space, 4}), pieces[0]);
+   // Short mixed lists are encoded in the object itself as well.
+   CompactTrivia mixed = CompactTrivia::make(
+            {{TriviaKind::Tab, 1}, {TriviaKind::Newline, 2}, {TriviaKind::Space, 300}},
+            allocator);
+   ASSERT_TRUE(mixed.isInline());
+   ASSERT_EQ(303u, mixed.getTextLength());
+   ASSERT_EQ(0u, allocator.getBytesAllocated());
+}
+
+TEST(CompactTriviaTest, testExternalStorage)
+{
+   BumpPtrAllocator allocator;
+   SmallVector<CompactTriviaPiece, 16> pieces;
+   for (uint32_t index = 0; index < 16; ++index) {
+      pieces.push_back({index % 2 ? TriviaKind::Space : TriviaKind::BlockComment,
+                        index * 1000 + 1});
+   }
+   CompactTrivia trivia = CompactTrivia::make(pieces, allocator);
+   ASSERT_FALSE(trivia.isInline());
+   SmallVector<CompactTriviaPiece, 16> decoded;
+   trivia.getPieces(decoded);
+   ASSERT_EQ(pieces, decoded);
+   ASSERT_EQ(CompactTrivia::make(pieces, allocator), trivia);
+   pieces.back().length += 1;
+   ASSERT_NE(CompactTrivia::make(pieces, allocator), trivia);
+}
+
+TEST(CompactTriviaTest, testRoundTripWithSource)
+{
+   StringRef source = "\n\t// line comment\n  /* block */ ";
+   Trivia trivia;
+   trivia.push_back(TriviaPiece::getNewlines(1));
+   trivia.push_back(TriviaPiece::getTabs(1));
+   trivia.push_back(TriviaPiece::getLineComment("// line comment"));
+   trivia.push_back(TriviaPiece::getNewlines(1));
+   trivia.push_back(TriviaPiece::getSpaces(2));
+   trivia.push_back(TriviaPiece::getBlockComment("/* block */"));
+   trivia.push_back(TriviaPiece::getSpaces(1));
+   BumpPtrAllocator allocator;
+   CompactTrivia compact = CompactTrivia::make(trivia, allocator);
+   ASSERT_EQ(source.size(), compact.getTextLength());
+   ASSERT_EQ(trivia, compact.getTrivia(source));
+   ASSERT_EQ("// line comment", compact.getPieceText(source, 2));
+   ASSERT_EQ("/* block */", compact.getPieceText(source, 5));
+}
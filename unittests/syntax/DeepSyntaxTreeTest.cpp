@@ -0,0 +1,180 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/11.
+
+#include "SyntaxTestTrees.h"
+#include "polarphp/syntax/SyntaxVisitor.h"
+#include "gtest/gtest.h"
+
+#include <optional>
+#include <string>
+
+using polar::syntax::Syntax;
+using polar::syntax::SyntaxVisitor;
+using polar::syntax::TokenSyntax;
+
+using namespace polar::unittest;
+
+namespace {
+
+/// Deep enough to overflow the native stack with one frame per level.
+constexpr size_t sg_depth = 100000;
+
+/// Builds "((( ... x ... )))" with sg_depth levels of parentheses, the shape
+/// of a deeply nested generated array literal.
+Syntax make_deep_tree()
+{
+   RefCountPtr<RawSyntax> raw = make_token(TokenKindType::T_IDENTIFIER_STRING, "x");
+   for (size_t depth = 0; depth < sg_depth; ++depth) {
+      raw = make_node({make_token(TokenKindType::T_LEFT_PAREN, "("), raw,
+                       make_token(TokenKindType::T_RIGHT_PAREN, ")")});
+   }
+   return polar::syntax::make<Syntax>(raw);
+}
+
+class CountingVisitor : public SyntaxVisitor
+{
+public:
+   size_t numTokens = 0;
+   size_t numPre = 0;
+   size_t numPost = 0;
+   size_t openParens = 0;
+   size_t maxOpenParens = 0;
+
+   void visit(TokenSyntax token) override
+   {
+      ++numTokens;
+      if (token.getTokenKind() == TokenKindType::T_LEFT_PAREN) {
+         maxOpenParens = std::max(maxOpenParens, ++openParens);
+      } else if (token.getTokenKind() == TokenKindType::T_RIGHT_PAREN) {
+         --openParens;
+      }
+   }
+
+   void visitPre(Syntax node) override
+   {
+      ++numPre;
+   }
+
+   void visitPost(Syntax node) override
+   {
+      ++numPost;
+   }
+};
+
+/// Skips every subtree that starts with the identifier "x" on the same
+/// level, like the reused region collector of the parsing cache does.
+class PruningVisitor : public CountingVisitor
+{
+public:
+   using CountingVisitor::visit;
+
+   void visit(Syntax node) override
+   {
+      if (node.getNumChildren() == 3 && node.getChild(1)->isToken()) {
+         return;
+      }
+      SyntaxVisitor::visit(node);
+   }
+};
+
+/// Visits the children of the innermost level explicitly, last child first,
+/// and every other level with the default traversal.
+class ReversingVisitor : public SyntaxVisitor
+{
+public:
+   using SyntaxVisitor::visit;
+
+   std::string text;
+
+   void visit(TokenSyntax token) override
+   {
+      text += token.getText().getStr();
+   }
+
+   void visit(Syntax node) override
+   {
+      if (node.isToken() || !node.getChild(1)->isToken()) {
+         SyntaxVisitor::visit(node);
+         return;
+      }
+      for (size_t index = node.getNumChildren(); index > 0; --index) {
+         visit(*node.getChild(index - 1));
+      }
+   }
+};
+
+} // anonymous namespace
+
+TEST(DeepSyntaxTreeTest, testPositions)
+{
+   Syntax root = make_deep_tree();
+   ASSERT_EQ(2 * sg_depth + 1, root.getTextLength());
+   std::optional<Syntax> node = root;
+   while (!node->isToken()) {
+      node.emplace(*node->getChild(1));
+   }
+   ASSERT_EQ(sg_depth, node->getAbsolutePosition().getOffset());
+   ASSERT_EQ(sg_depth + 1, node->getAbsoluteEndPositionAfterTrailingTrivia().getOffset());
+   auto previous = node->getData().getPreviousNode();
+   ASSERT_EQ("(", previous->getRaw()->getTokenText());
+   auto next = node->getData().getNextNode();
+   ASSERT_EQ(")", next->getRaw()->getTokenText());
+   ASSERT_EQ(2 * sg_depth, root.getChild(2)->getAbsolutePosition().getOffset());
+   // The first token of the innermost level is found without recursion.
+   auto innermost = node->getData().getParent();
+   ASSERT_EQ("(", innermost->getFirstToken()->getRaw()->getTokenText());
+   auto first = root.getData().getFirstToken();
+   ASSERT_EQ(&root.getData(), first->getParent());
+}
+
+TEST(DeepSyntaxTreeTest, testFirstTokenBelowMissingNodes)
+{
+   // A long chain of levels whose first child is missing.
+   RefCountPtr<RawSyntax> raw = make_token(TokenKindType::T_IDENTIFIER_STRING, "x");
+   for (size_t depth = 0; depth < sg_depth; ++depth) {
+      raw = make_node({RawSyntax::missing(TokenKindType::T_LEFT_PAREN,
+                                          OwnedString::makeRefCounted("(")), raw});
+   }
+   Syntax root = polar::syntax::make<Syntax>(raw);
+   ASSERT_EQ(1u, root.getTextLength());
+   auto first = root.getData().getFirstToken();
+   ASSERT_EQ("x", first->getRaw()->getTokenText());
+   ASSERT_EQ(nullptr, first->getPreviousNode().get());
+   ASSERT_EQ(nullptr, first->getNextNode().get());
+}
+
+TEST(DeepSyntaxTreeTest, testVisitor)
+{
+   Syntax root = make_deep_tree();
+   CountingVisitor visitor;
+   root.accept(visitor);
+   ASSERT_EQ(2 * sg_depth + 1, visitor.numTokens);
+   ASSERT_EQ(3 * sg_depth + 1, visitor.numPre);
+   ASSERT_EQ(visitor.numPre, visitor.numPost);
+   ASSERT_EQ(sg_depth, visitor.maxOpenParens);
+   ASSERT_EQ(0u, visitor.openParens);
+
+   PruningVisitor pruning;
+   root.accept(pruning);
+   ASSERT_EQ(2 * (sg_depth - 1), pruning.numTokens);
+   ASSERT_EQ(pruning.numPre, pruning.numPost);
+}
+
+TEST(DeepSyntaxTreeTest, testExplicitVisitOrder)
+{
+   // The nodes an override visits one after another are visited in that
+   // order, also when the calls only schedule them during a walk.
+   Syntax root = make_deep_tree();
+   ReversingVisitor visitor;
+   root.accept(visitor);
+   ASSERT_EQ(std::string(sg_depth - 1, '(') + ")x(" + std::string(sg_depth - 1, ')'),
+             visitor.text);
+}
@@ -0,0 +1,132 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/09.
+
+#include "SyntaxTestTrees.h"
+#include "polarphp/syntax/FrozenSyntaxTree.h"
+#include "polarphp/syntax/SyntaxRef.h"
+#include "gtest/gtest.h"
+
+#include <string>
+
+using polar::syntax::FrozenSyntaxNode;
+using polar::syntax::FrozenSyntaxTree;
+using polar::syntax::SyntaxRef;
+using polar::syntax::Trivia;
+
+using namespace polar::unittest;
+
+namespace {
+
+/// Every token of these trees is followed by a space, \p leadingNewlines
+/// newlines go before it.
+RefCountPtr<RawSyntax> make_word(StringRef text, unsigned leadingNewlines = 0)
+{
+   std::vector<TriviaPiece> leading;
+   if (leadingNewlines) {
+      leading.push_back(TriviaPiece::getNewlines(leadingNewlines));
+   }
+   return make_token(text, leading, {TriviaPiece::getSpaces(1)});
+}
+
+/// Builds "1 /* two */2 \n3 ;" with an absent child and a missing token.
+RefCountPtr<RawSyntax> make_sample_tree()
+{
+   auto two = make_token("2", {TriviaPiece::getBlockComment("/* two */")},
+                         {TriviaPiece::getSpaces(1)});
+   auto semicolon = RawSyntax::missing(TokenKindType::T_SEMICOLON,
+                                       OwnedString::makeRefCounted(";"));
+   return make_node({make_node({make_word("1"), nullptr, two}),
+                     make_node({make_word("3", 1), semicolon})});
+}
+
+} // anonymous namespace
+
+TEST(FrozenSyntaxTreeTest, testLayout)
+{
+   auto raw = make_sample_tree();
+   FrozenSyntaxTree tree = FrozenSyntaxTree::freeze(*raw);
+   // Tokens 1, 2, 3, ; and three layout nodes.
+   ASSERT_EQ(7u, tree.size());
+   ASSERT_EQ(print_tree(*raw), tree.getText().getStr());
+   FrozenSyntaxNode root = tree.getRoot();
+   ASSERT_EQ(tree.getText(), root.getText());
+   ASSERT_EQ(SyntaxKind::Unknown, root.getKind());
+   ASSERT_EQ(2u, root.getNumChildren());
+   ASSERT_EQ(0u, root.getSubtreeBegin());
+
+   FrozenSyntaxNode left = *root.getChild(0);
+   ASSERT_EQ(3u, left.getNumChildren());
+   ASSERT_FALSE(left.getChild(1));
+   FrozenSyntaxNode two = *left.getChild(2);
+   ASSERT_TRUE(two.isToken(TokenKindType::T_LNUMBER));
+   ASSERT_EQ("2", two.getTokenText());
+   ASSERT_EQ("/* two */", two.getLeadingTrivia().pieces[0].getText());
+   ASSERT_EQ(Trivia{{TriviaPiece::getSpaces(1)}}, two.getTrailingTrivia());
+
+   FrozenSyntaxNode right = *root.getChild(1);
+   FrozenSyntaxNode semicolon = *right.getChild(1);
+   ASSERT_TRUE(semicolon.isMissing());
+   ASSERT_EQ(";", semicolon.getTokenText());
+   ASSERT_EQ(0u, semicolon.getTextLength());
+   ASSERT_EQ("\n3 ", right.getText());
+
+   // Offsets agree with the ones of the original tree.
+   SyntaxRef rightRef = *SyntaxRef(*raw).getChild(1);
+   ASSERT_EQ(rightRef.getAbsoluteOffsetBeforeLeadingTrivia(),
+             right.getAbsoluteOffsetBeforeLeadingTrivia());
+   ASSERT_EQ(rightRef.getAbsoluteOffset(), right.getAbsoluteOffset());
+   ASSERT_EQ(rightRef.getAbsoluteEndOffsetAfterTrailingTrivia(),
+             right.getAbsoluteEndOffsetAfterTrailingTrivia());
+
+   // Post-order numbers every child before its parent.
+   for (uint32_t index = 0; index < tree.size(); ++index) {
+      FrozenSyntaxNode node = tree.getNode(index);
+      for (size_t child = 0; child < node.getNumChildren(); ++child) {
+         if (auto childNode = node.getChild(child)) {
+            ASSERT_LT(childNode->getIndex(), index);
+         }
+      }
+   }
+}
+
+TEST(FrozenSyntaxTreeTest, testThaw)
+{
+   auto raw = make_sample_tree();
+   FrozenSyntaxTree tree = FrozenSyntaxTree::freeze(*raw);
+   RefCountPtr<RawSyntax> thawed = tree.thaw();
+   ASSERT_EQ(print_tree(*raw), print_tree(*thawed));
+   ASSERT_EQ(nullptr, thawed->getChild(0)->getChild(1).get());
+   ASSERT_TRUE(thawed->getChild(1)->getChild(1)->isMissing());
+   ASSERT_EQ(";", thawed->getChild(1)->getChild(1)->getTokenText());
+   // Thawing a subtree only converts that subtree.
+   RefCountPtr<RawSyntax> right = tree.getRoot().getChild(1)->thaw();
+   ASSERT_EQ("\n3 ", print_tree(*right));
+}
+
+TEST(FrozenSyntaxTreeTest, testDeepTree)
+{
+   std::string expected;
+   RefCountPtr<RawSyntax> raw = make_word("0");
+   expected = "0 ";
+   for (int depth = 1; depth < 5000; ++depth) {
+      raw = make_node({raw, make_word("x", 1)});
+      expected += "\nx ";
+   }
+   FrozenSyntaxTree tree = FrozenSyntaxTree::freeze(*raw);
+   ASSERT_EQ(9999u, tree.size());
+   ASSERT_EQ(expected, tree.getText().getStr());
+   ASSERT_EQ(expected, print_tree(*tree.thaw()));
+   size_t numTokens = 0;
+   for (uint32_t index = 0; index < tree.size(); ++index) {
+      numTokens += tree.getNode(index).isToken();
+   }
+   ASSERT_EQ(5000u, numTokens);
+}
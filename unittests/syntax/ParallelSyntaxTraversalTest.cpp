@@ -0,0 +1,180 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/10.
+
+#include "SyntaxTestTrees.h"
+#include "polarphp/syntax/ParallelSyntaxTraversal.h"
+#include "polarphp/utils/ThreadPool.h"
+#include "gtest/gtest.h"
+
+#include <future>
+#include <string>
+#include <vector>
+
+using polar::syntax::ParallelSyntaxTraversal;
+using polar::syntax::Syntax;
+using polar::utils::ThreadPool;
+
+using namespace polar::unittest;
+
+namespace {
+
+/// Every token of these trees is followed by a space.
+RefCountPtr<RawSyntax> make_word(StringRef text)
+{
+   return make_token(text, {}, {TriviaPiece::getSpaces(1)});
+}
+
+/// Builds a list of statements of very different sizes, the first one being
+/// a large "class" made of many small "members".
+Syntax make_sample_tree()
+{
+   std::vector<RefCountPtr<RawSyntax>> statements;
+   std::vector<RefCountPtr<RawSyntax>> members;
+   for (int index = 0; index < 200; ++index) {
+      members.push_back(make_node({make_word("m" + std::to_string(index))}));
+   }
+   statements.push_back(make_node(members));
+   for (int index = 0; index < 500; ++index) {
+      std::vector<RefCountPtr<RawSyntax>> tokens;
+      for (int token = 0; token <= index % 7; ++token) {
+         tokens.push_back(make_word(std::to_string(index)));
+      }
+      statements.push_back(make_node(tokens));
+   }
+   return polar::syntax::make<Syntax>(make_node(statements));
+}
+
+void collect_tokens(const Syntax &node, std::string &text)
+{
+   if (node.isToken()) {
+      text += node.getRaw()->getTokenText().getStr();
+      text += ",";
+      return;
+   }
+   for (size_t index = 0; index < node.getNumChildren(); ++index) {
+      if (auto child = node.getChild(index)) {
+         collect_tokens(*child, text);
+      }
+   }
+}
+
+void collect_token_offsets(const Syntax &node, std::vector<size_t> &offsets)
+{
+   if (node.isToken()) {
+      offsets.push_back(node.getAbsolutePosition().getOffset());
+      return;
+   }
+   for (size_t index = 0; index < node.getNumChildren(); ++index) {
+      if (auto child = node.getChild(index)) {
+         collect_token_offsets(*child, offsets);
+      }
+   }
+}
+
+struct TokenCollector
+{
+   std::string text;
+
+   void visit(Syntax node)
+   {
+      collect_tokens(node, text);
+   }
+};
+
+} // anonymous namespace
+
+TEST(ParallelSyntaxTraversalTest, testPartition)
+{
+   ThreadPool pool(4);
+   ParallelSyntaxTraversal traversal(pool, 4);
+   Syntax root = make_sample_tree();
+   traversal.setGrainSize(64);
+   std::vector<Syntax> tasks = traversal.partition(root);
+   // The large first statement is split into its members, the others stay
+   // in one piece.
+   ASSERT_EQ(200u + 500u, tasks.size());
+   size_t offset = 0;
+   for (const Syntax &task : tasks) {
+      ASSERT_EQ(offset, task.getAbsolutePositionBeforeLeadingTrivia().getOffset());
+      offset += task.getTextLength();
+   }
+   ASSERT_EQ(root.getTextLength(), offset);
+   // Small trees are not split at all.
+   traversal.setGrainSize(0);
+   ASSERT_EQ(1u, traversal.partition(*root.getChild(1)).size());
+}
+
+TEST(ParallelSyntaxTraversalTest, testDeterministicResult)
+{
+   Syntax root = make_sample_tree();
+   std::string expected;
+   collect_tokens(root, expected);
+   ThreadPool pool(4);
+   ParallelSyntaxTraversal traversal(pool, 4);
+   traversal.setGrainSize(32);
+   for (int round = 0; round < 5; ++round) {
+      std::string text = traversal.mapReduce(
+               root, std::string(),
+               [](Syntax task) {
+         std::string text;
+         collect_tokens(task, text);
+         return text;
+      },
+      [](std::string accumulated, std::string text) {
+         return accumulated + text;
+      });
+      ASSERT_EQ(expected, text);
+      std::string visited = traversal.visit(
+               root, std::string(), []() { return TokenCollector(); },
+      [](std::string accumulated, TokenCollector &collector) {
+         return accumulated + collector.text;
+      });
+      ASSERT_EQ(expected, visited);
+   }
+}
+
+TEST(ParallelSyntaxTraversalTest, testConcurrentPositions)
+{
+   std::vector<size_t> expected;
+   collect_token_offsets(make_sample_tree(), expected);
+   ThreadPool pool(4);
+   // Threads asking for the positions of the same nodes of a fresh tree fill
+   // in the position caches concurrently.
+   Syntax root = make_sample_tree();
+   std::vector<std::vector<size_t>> offsets(4);
+   std::vector<std::shared_future<void>> futures;
+   for (size_t thread = 0; thread < offsets.size(); ++thread) {
+      futures.push_back(pool.async([&root, &offsets, thread]() {
+         collect_token_offsets(root, offsets[thread]);
+      }));
+   }
+   for (std::shared_future<void> &future : futures) {
+      future.wait();
+   }
+   for (const std::vector<size_t> &threadOffsets : offsets) {
+      ASSERT_EQ(expected, threadOffsets);
+   }
+   // The tasks of a traversal ask for positions within their own subtrees.
+   ParallelSyntaxTraversal traversal(pool, 4);
+   traversal.setGrainSize(32);
+   std::vector<size_t> mapped = traversal.mapReduce(
+            make_sample_tree(), std::vector<size_t>(),
+            [](Syntax task) {
+      std::vector<size_t> taskOffsets;
+      collect_token_offsets(task, taskOffsets);
+      return taskOffsets;
+   },
+   [](std::vector<size_t> accumulated, std::vector<size_t> taskOffsets) {
+      accumulated.insert(accumulated.end(), taskOffsets.begin(), taskOffsets.end());
+      return accumulated;
+   });
+   ASSERT_EQ(expected, mapped);
+}
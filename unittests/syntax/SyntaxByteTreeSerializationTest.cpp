@@ -0,0 +1,131 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/02.
+
+#include "SyntaxTestTrees.h"
+#include "polarphp/syntax/SyntaxByteTreeSerialization.h"
+#include "polarphp/utils/MemoryBuffer.h"
+#include "gtest/gtest.h"
+
+using polar::syntax::serialize_syntax_tree;
+using polar::syntax::deserialize_syntax_tree;
+using polar::basic::ExponentialGrowthAppendingBinaryByteStream;
+using polar::basic::bytetree::ByteTreeWriter;
+using polar::basic::bytetree::UserInfoMap;
+using polar::utils::MemoryBuffer;
+
+using namespace polar::unittest;
+
+namespace {
+
+RefCountPtr<RawSyntax> make_sample_tree()
+{
+   auto first = make_token("123", {TriviaPiece::getNewlines(2), TriviaPiece::getSpaces(3)},
+                           {TriviaPiece::getSpaces(1)});
+   auto second = make_token("456", {TriviaPiece::getBlockComment("/* comment */")});
+   auto missing = RawSyntax::missing(TokenKindType::T_LNUMBER, OwnedString(""));
+   return make_node({first, nullptr, second, missing});
+}
+
+StringRef get_stream_data(ExponentialGrowthAppendingBinaryByteStream &stream)
+{
+   auto data = stream.data();
+   return StringRef(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+} // anonymous namespace
+
+TEST(SyntaxByteTreeSerializationTest, testRoundTrip)
+{
+   auto root = make_sample_tree();
+   ExponentialGrowthAppendingBinaryByteStream stream;
+   serialize_syntax_tree(stream, *root);
+   auto result = deserialize_syntax_tree(get_stream_data(stream));
+   ASSERT_TRUE(static_cast<bool>(result));
+   RefCountPtr<RawSyntax> copy = *result;
+   ASSERT_EQ(print_tree(*root), print_tree(*copy));
+   ASSERT_EQ(root->getId(), copy->getId());
+   ASSERT_EQ(SyntaxKind::Unknown, copy->getKind());
+   ASSERT_EQ(4u, copy->getNumChildren());
+   ASSERT_FALSE(copy->getChild(1));
+   ASSERT_TRUE(copy->getChild(3)->isMissing());
+   auto &first = copy->getChild(0);
+   ASSERT_EQ(TokenKindType::T_LNUMBER, first->getTokenKind());
+   ASSERT_EQ(root->getChild(0)->getId(), first->getId());
+   ASSERT_EQ(2u, first->getLeadingTrivia().size());
+   ASSERT_EQ(TriviaPiece::getSpaces(3), first->getLeadingTrivia()[1]);
+   ASSERT_EQ(TriviaPiece::getBlockComment("/* comment */"),
+             copy->getChild(2)->getLeadingTrivia()[0]);
+}
+
+TEST(SyntaxByteTreeSerializationTest, testTextIsNotCopied)
+{
+   auto root = make_sample_tree();
+   ExponentialGrowthAppendingBinaryByteStream stream;
+   serialize_syntax_tree(stream, *root);
+   auto buffer = MemoryBuffer::getMemBuffer(get_stream_data(stream), "tree",
+                                            /*RequiresNullTerminator=*/false);
+   auto result = deserialize_syntax_tree(*buffer);
+   ASSERT_TRUE(static_cast<bool>(result));
+   StringRef text = (*result)->getChild(0)->getTokenText();
+   ASSERT_EQ("123", text);
+   ASSERT_GE(text.data(), buffer->getBufferStart());
+   ASSERT_LT(text.data(), buffer->getBufferEnd());
+}
+
+TEST(SyntaxByteTreeSerializationTest, testMalformedInput)
+{
+   auto root = make_sample_tree();
+   ExponentialGrowthAppendingBinaryByteStream stream;
+   serialize_syntax_tree(stream, *root);
+   StringRef data = get_stream_data(stream);
+   auto result = deserialize_syntax_tree(data.substr(0, data.size() / 2));
+   ASSERT_FALSE(static_cast<bool>(result));
+   polar::utils::consume_error(result.takeError());
+}
+
+TEST(SyntaxByteTreeSerializationTest, testMatchesByteTreeWriter)
+{
+   // serialize_syntax_tree writes the layout of the RawSyntax ObjectTraits.
+   auto root = make_sample_tree();
+   ExponentialGrowthAppendingBinaryByteStream stream;
+   serialize_syntax_tree(stream, *root);
+   ExponentialGrowthAppendingBinaryByteStream expected;
+   UserInfoMap userInfo;
+   ByteTreeWriter::write(expected, polar::syntax::SyntaxByteTreeProtocolVersion, *root,
+                         userInfo);
+   ASSERT_EQ(get_stream_data(expected), get_stream_data(stream));
+}
+
+TEST(SyntaxByteTreeSerializationTest, testDeepTree)
+{
+   // One native stack frame per level would overflow long before this depth.
+   constexpr size_t depth = 100000;
+   RefCountPtr<RawSyntax> root = make_token(TokenKindType::T_IDENTIFIER_STRING, "x");
+   for (size_t level = 0; level < depth; ++level) {
+      root = make_node({make_token(TokenKindType::T_LEFT_PAREN, "("), root, nullptr});
+   }
+   ExponentialGrowthAppendingBinaryByteStream stream;
+   serialize_syntax_tree(stream, *root);
+   auto result = deserialize_syntax_tree(get_stream_data(stream));
+   ASSERT_TRUE(static_cast<bool>(result));
+   const RawSyntax *original = root.get();
+   const RawSyntax *copy = result->get();
+   for (size_t level = 0; level < depth; ++level) {
+      ASSERT_EQ(3u, copy->getNumChildren());
+      ASSERT_EQ(original->getId(), copy->getId());
+      ASSERT_EQ("(", copy->getChild(0)->getTokenText());
+      ASSERT_FALSE(copy->getChild(2));
+      original = original->getChild(1).get();
+      copy = copy->getChild(1).get();
+   }
+   ASSERT_TRUE(copy->isToken());
+   ASSERT_EQ("x", copy->getTokenText());
+}
@@ -0,0 +1,87 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/06.
+
+#include "SyntaxTestTrees.h"
+#include "polarphp/syntax/SyntaxEditBatch.h"
+#include "gtest/gtest.h"
+
+#include <string>
+
+using polar::syntax::Syntax;
+using polar::syntax::SyntaxEditBatch;
+using polar::syntax::SyntaxRef;
+
+using namespace polar::unittest;
+
+namespace {
+
+/// Every token of these trees is followed by a space.
+RefCountPtr<RawSyntax> make_word(StringRef text)
+{
+   return make_token(text, {}, {TriviaPiece::getSpaces(1)});
+}
+
+/// Builds "1 2 3 4 " as Unknown(Unknown(1, 2), Unknown(3, 4)).
+RefCountPtr<RawSyntax> make_sample_tree()
+{
+   return make_node({make_node({make_word("1"), make_word("2")}),
+                     make_node({make_word("3"), make_word("4")})});
+}
+
+} // anonymous namespace
+
+TEST(SyntaxEditBatchTest, testReplaceSharesUntouchedSubtrees)
+{
+   auto raw = make_sample_tree();
+   Syntax root = polar::syntax::make<Syntax>(raw);
+   SyntaxEditBatch batch(root);
+   batch.replace(*root.getChild(0)->getChild(1), make_word("20"));
+   batch.replace(*root.getChild(0)->getChild(0), make_word("10"));
+   ASSERT_EQ(2u, batch.size());
+   Syntax newRoot = batch.apply();
+   ASSERT_TRUE(batch.empty());
+   ASSERT_EQ("10 20 3 4 ", print_tree(*newRoot.getRaw()));
+   // The untouched subtree is shared, the original tree is unchanged.
+   ASSERT_EQ(raw->getChild(1).get(), newRoot.getRaw()->getChild(1).get());
+   ASSERT_EQ("1 2 3 4 ", print_tree(*raw));
+}
+
+TEST(SyntaxEditBatchTest, testOverlappingEdits)
+{
+   auto raw = make_sample_tree();
+   Syntax root = polar::syntax::make<Syntax>(raw);
+   SyntaxEditBatch batch(root);
+   // The nested edit is dropped because its ancestor is replaced as a whole.
+   batch.replace(*root.getChild(1)->getChild(0), make_word("30"));
+   batch.replace(*root.getChild(1), make_word("x"));
+   batch.replace(*root.getChild(1), make_word("y"));
+   // Edits can also be addressed through SyntaxRef.
+   batch.replace(*SyntaxRef(*raw).getChild(0)->getChild(1), make_word("20"));
+   ASSERT_EQ("1 20 y ", print_tree(*batch.applyRaw()));
+}
+
+TEST(SyntaxEditBatchTest, testManyEdits)
+{
+   std::vector<RefCountPtr<RawSyntax>> statements;
+   std::string expected;
+   for (int index = 0; index < 1000; ++index) {
+      statements.push_back(make_node({make_word(std::to_string(index))}));
+      expected += std::to_string(index * 2) + " ";
+   }
+   auto raw = make_node(statements);
+   Syntax root = polar::syntax::make<Syntax>(raw);
+   SyntaxEditBatch batch(root);
+   for (int index = 999; index >= 0; --index) {
+      batch.replace(*root.getChild(index)->getChild(0),
+                    make_word(std::to_string(index * 2)));
+   }
+   ASSERT_EQ(expected, print_tree(*batch.applyRaw()));
+}
@@ -0,0 +1,124 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/05.
+
+#include "SyntaxTestTrees.h"
+#include "polarphp/syntax/SyntaxRefNodes.h"
+#include "polarphp/syntax/Syntax.h"
+#include "gtest/gtest.h"
+
+using polar::syntax::Syntax;
+using polar::syntax::SyntaxRef;
+using polar::syntax::NullExprSyntaxRef;
+using polar::syntax::ParenDecoratedExprSyntaxRef;
+
+using namespace polar::unittest;
+
+namespace {
+
+/// Builds " 1  22  333    4444" as
+/// Unknown(1, Unknown(22, missing), nullptr, Unknown(333, 4444)).
+RefCountPtr<RawSyntax> make_sample_tree()
+{
+   auto missing = RawSyntax::missing(TokenKindType::T_LNUMBER, OwnedString(""));
+   auto inner = make_node({make_token("22", {TriviaPiece::getSpaces(2)}), missing});
+   auto last = make_node({make_token("333", {TriviaPiece::getSpaces(2)}),
+                          make_token("4444", {TriviaPiece::getSpaces(4)})});
+   return make_node({make_token("1", {TriviaPiece::getSpaces(1)}), inner, nullptr, last});
+}
+
+} // anonymous namespace
+
+TEST(SyntaxRefTest, testNavigation)
+{
+   auto raw = make_sample_tree();
+   SyntaxRef root(*raw);
+   ASSERT_TRUE(root.isRoot());
+   ASSERT_EQ(4u, root.getNumChildren());
+   ASSERT_FALSE(root.getChild(2).has_value());
+   ASSERT_FALSE(root.getParent().has_value());
+
+   auto last = root.getChild(3);
+   ASSERT_TRUE(last.has_value());
+   ASSERT_EQ(raw->getChild(3).get(), last->getRaw());
+   ASSERT_EQ(6u, last->getAbsoluteOffsetBeforeLeadingTrivia());
+   ASSERT_EQ(8u, last->getAbsoluteOffset());
+   ASSERT_EQ(19u, last->getAbsoluteEndOffsetAfterTrailingTrivia());
+
+   auto token = last->getChild(1);
+   ASSERT_TRUE(token.has_value());
+   ASSERT_EQ("4444", token->getTokenText());
+   ASSERT_EQ(15u, token->getAbsoluteOffset());
+   ASSERT_EQ(1u, token->getIndexInParent());
+
+   auto parent = token->getParent();
+   ASSERT_TRUE(parent.has_value());
+   ASSERT_TRUE(parent->hasSameIdentityAs(*last));
+   ASSERT_TRUE(parent->getParent()->hasSameIdentityAs(root));
+
+   auto missing = root.getChild(1)->getChild(1);
+   ASSERT_TRUE(missing->isMissing());
+   ASSERT_EQ(0u, missing->getTextLength());
+   ASSERT_EQ(6u, missing->getAbsoluteOffsetBeforeLeadingTrivia());
+   ASSERT_TRUE(missing->getParent()->hasSameIdentityAs(*root.getChild(1)));
+}
+
+TEST(SyntaxRefTest, testRealize)
+{
+   auto raw = make_sample_tree();
+   Syntax root = polar::syntax::make<Syntax>(raw);
+   SyntaxRef ref = *SyntaxRef(*raw).getChild(3)->getChild(1);
+   Syntax node = ref.realize(root);
+   ASSERT_EQ(ref.getRaw(), node.getRaw().get());
+   ASSERT_EQ(ref.getAbsoluteOffset(), node.getAbsolutePosition().getOffset());
+   SyntaxRef back(node);
+   ASSERT_TRUE(back.hasSameIdentityAs(ref));
+}
+
+TEST(SyntaxRefTest, testSiblings)
+{
+   auto raw = make_sample_tree();
+   SyntaxRef root(*raw);
+   std::vector<size_t> indices;
+   std::vector<size_t> offsets;
+   root.forEachChild([&](const SyntaxRef &child) {
+      indices.push_back(child.getIndexInParent());
+      offsets.push_back(child.getAbsoluteOffsetBeforeLeadingTrivia());
+      ASSERT_TRUE(child.getParent()->hasSameIdentityAs(root));
+   });
+   // The child missing from the layout is skipped.
+   ASSERT_EQ((std::vector<size_t>{0, 1, 3}), indices);
+   ASSERT_EQ((std::vector<size_t>{0, 2, 6}), offsets);
+   ASSERT_FALSE(root.getNextSibling().has_value());
+   auto last = root.getChild(3);
+   ASSERT_FALSE(last->getNextSibling().has_value());
+   auto token = last->getFirstChild()->getNextSibling();
+   ASSERT_TRUE(token->hasSameIdentityAs(*last->getChild(1)));
+}
+
+TEST(SyntaxRefTest, testTypedViews)
+{
+   auto nullExpr = make_node({make_token(TokenKindType::T_NULL, "null")},
+                             SyntaxKind::NullExpr);
+   auto raw = make_node({make_token(TokenKindType::T_LEFT_PAREN, "("), nullExpr,
+                         make_token(TokenKindType::T_RIGHT_PAREN, ")")},
+                        SyntaxKind::ParenDecoratedExpr);
+   SyntaxRef root(*raw);
+   ASSERT_FALSE(root.getAs<NullExprSyntaxRef>().has_value());
+   auto paren = root.getAs<ParenDecoratedExprSyntaxRef>();
+   ASSERT_TRUE(paren.has_value());
+   SyntaxRef expr = paren->getExpr();
+   ASSERT_EQ(nullExpr.get(), expr.getRaw());
+   ASSERT_EQ(1u, expr.getAbsoluteOffset());
+   auto null = expr.getAs<NullExprSyntaxRef>();
+   ASSERT_TRUE(null.has_value());
+   ASSERT_EQ("null", null->getNullKeyword().getTokenText());
+   ASSERT_EQ(")", paren->getRightParenToken().getTokenText());
+}
@@ -0,0 +1,71 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#ifndef UNITTEST_SYNTAX_SYNTAX_TEST_TREES_H
+#define UNITTEST_SYNTAX_SYNTAX_TEST_TREES_H
+
+#include "polarphp/syntax/RawSyntax.h"
+#include "polarphp/basic/adt/SmallString.h"
+#include "polarphp/utils/RawOutStream.h"
+
+#include <string>
+
+namespace polar::unittest {
+
+using polar::basic::ArrayRef;
+using polar::basic::OwnedString;
+using polar::basic::SmallString;
+using polar::basic::StringRef;
+using polar::syntax::RawSyntax;
+using polar::syntax::RefCountPtr;
+using polar::syntax::SourcePresence;
+using polar::syntax::SyntaxKind;
+using polar::syntax::SyntaxPrintOptions;
+using polar::syntax::TokenKindType;
+using polar::syntax::TriviaPiece;
+using polar::utils::RawSvectorOutStream;
+
+/// Make a present token of kind \p kind that owns a copy of \p text.
+inline RefCountPtr<RawSyntax> make_token(TokenKindType kind, StringRef text,
+                                         ArrayRef<TriviaPiece> leadingTrivia = {},
+                                         ArrayRef<TriviaPiece> trailingTrivia = {})
+{
+   return RawSyntax::make(kind, OwnedString::makeRefCounted(text), leadingTrivia,
+                          trailingTrivia, SourcePresence::Present);
+}
+
+/// Make a present number token, the token most test trees are built from.
+inline RefCountPtr<RawSyntax> make_token(StringRef text,
+                                         ArrayRef<TriviaPiece> leadingTrivia = {},
+                                         ArrayRef<TriviaPiece> trailingTrivia = {})
+{
+   return make_token(TokenKindType::T_LNUMBER, text, leadingTrivia, trailingTrivia);
+}
+
+/// Make a present layout node. Null \p children are absent from the layout.
+inline RefCountPtr<RawSyntax> make_node(ArrayRef<RefCountPtr<RawSyntax>> children,
+                                        SyntaxKind kind = SyntaxKind::Unknown)
+{
+   return RawSyntax::make(kind, children, SourcePresence::Present);
+}
+
+/// Spell out \p syntax with full fidelity.
+inline std::string print_tree(const RawSyntax &syntax)
+{
+   SmallString<64> scratch;
+   RawSvectorOutStream outStream(scratch);
+   syntax.print(outStream, SyntaxPrintOptions());
+   return outStream.getStr().getStr();
+}
+
+} // polar::unittest
+
+#endif // UNITTEST_SYNTAX_SYNTAX_TEST_TREES_H
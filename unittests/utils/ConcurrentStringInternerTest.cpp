@@ -0,0 +1,93 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/15.
+
+#include "polarphp/utils/ConcurrentStringInterner.h"
+#include "polarphp/basic/adt/DenseMap.h"
+#include "polarphp/basic/adt/StringMap.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace polar::utils;
+using polar::basic::DenseMap;
+using polar::basic::StringMapImpl;
+
+namespace {
+
+TEST(ConcurrentStringInternerTest, testIntern)
+{
+   ConcurrentStringInterner interner;
+   std::string name = "array_map";
+   InternedString first = interner.intern(name);
+   name[0] = 'A';
+   InternedString second = interner.intern("array_map");
+   EXPECT_TRUE(first == second);
+   EXPECT_EQ("array_map", first.getStr());
+   EXPECT_EQ('\0', first.getData()[first.getSize()]);
+   EXPECT_EQ(StringMapImpl::hash("array_map"), first.getHash());
+   EXPECT_TRUE(interner.intern(name) != first);
+   EXPECT_TRUE(interner.intern("", StringMapImpl::hash("")).getStr().empty());
+
+   EXPECT_TRUE(interner.find("array_map") == first);
+   EXPECT_FALSE(interner.find("array_filter"));
+   EXPECT_EQ(3u, interner.getSize());
+
+   ConcurrentStringInterner::Statistics statistics = interner.getStatistics();
+   EXPECT_EQ(4u, statistics.internCalls);
+   EXPECT_EQ(27u, statistics.internedBytes);
+   EXPECT_EQ(3u, statistics.uniqueStrings);
+}
+
+TEST(ConcurrentStringInternerTest, testHandlesAsMapKeys)
+{
+   ConcurrentStringInterner interner;
+   DenseMap<InternedString, int> map;
+   map[interner.intern("foo")] = 1;
+   map[interner.intern("bar")] = 2;
+   EXPECT_EQ(1, map.lookup(interner.intern("foo")));
+   EXPECT_EQ(2, map.lookup(interner.intern("bar")));
+}
+
+TEST(ConcurrentStringInternerTest, testThreadsShareStrings)
+{
+   ConcurrentStringInterner interner;
+   const unsigned threadCount = 8;
+   const unsigned nameCount = 2000;
+   std::vector<std::vector<InternedString>> results(threadCount);
+   std::vector<std::thread> threads;
+   for (unsigned thread = 0; thread < threadCount; ++thread) {
+      threads.emplace_back([&, thread] {
+         for (unsigned index = 0; index < nameCount; ++index) {
+            // Every thread interns the same names, in a different order.
+            unsigned name = (index * 7 + thread * 131) % nameCount;
+            results[thread].push_back(interner.intern("name" + std::to_string(name)));
+         }
+      });
+   }
+   for (std::thread &thread : threads) {
+      thread.join();
+   }
+   EXPECT_EQ(nameCount, interner.getSize());
+   for (unsigned thread = 0; thread < threadCount; ++thread) {
+      for (unsigned index = 0; index < nameCount; ++index) {
+         unsigned name = (index * 7 + thread * 131) % nameCount;
+         InternedString expected = interner.find("name" + std::to_string(name));
+         ASSERT_TRUE(expected == results[thread][index]);
+      }
+   }
+   ConcurrentStringInterner::Statistics statistics = interner.getStatistics();
+   EXPECT_EQ(threadCount * nameCount, statistics.internCalls);
+   EXPECT_EQ(nameCount, statistics.uniqueStrings);
+}
+
+} // anonymous namespace
@@ -23,8 +23,12 @@
 
 
 #include "polarphp/utils/Crc.h"
+#include "polarphp/utils/JamCRC.h"
+#include "polarphp/utils/ThreadPool.h"
 #include "gtest/gtest.h"
 
+#include <vector>
+
 using namespace polar::basic;
 using namespace polar::utils;
 
@@ -39,4 +43,103 @@ TEST(CRCTest, testCRC32) {
    EXPECT_EQ(0xCBF43926U, polar::utils::crc32(0, StringRef("123456789")));
 }
 
+TEST(CRCTest, testCRC32C)
+{
+   // CRC-32/ISCSI test vectors
+   EXPECT_EQ(0xE3069283U, crc32c(0, StringRef("123456789")));
+   EXPECT_EQ(0x22620404U,
+             crc32c(0, StringRef("The quick brown fox jumps over the lazy dog")));
+   EXPECT_EQ(0U, crc32c(0, StringRef("")));
+}
+
+uint32_t bitwise_crc(uint32_t crc, ArrayRef<uint8_t> data, uint32_t poly)
+{
+   crc = ~crc;
+   for (uint8_t byte : data) {
+      crc ^= byte;
+      for (unsigned bit = 0; bit < 8; ++bit) {
+         crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+      }
+   }
+   return ~crc;
+}
+
+// The table and hardware paths switch at different lengths and alignments,
+// compare them all with the bit-at-a-time definition. The table kernels are
+// called directly as well, the host may never select them.
+TEST(CRCTest, testLengthsAndAlignments)
+{
+   std::vector<uint8_t> buffer(3 * 8192 + 3 * 256 + 100);
+   uint32_t state = 1;
+   for (uint8_t &byte : buffer) {
+      state = state * 1103515245U + 12345U;
+      byte = static_cast<uint8_t>(state >> 16);
+   }
+   std::vector<size_t> lengths;
+   for (size_t length = 0; length <= 300; ++length) {
+      lengths.push_back(length);
+   }
+   for (size_t length : {767, 768, 769, 1000, 24575, 24576, 24577, 25000}) {
+      lengths.push_back(length);
+   }
+   for (size_t length : lengths) {
+      for (size_t offset = 0; offset < 8 && offset + length <= buffer.size(); offset += 3) {
+         ArrayRef<uint8_t> data(buffer.data() + offset, length);
+         EXPECT_EQ(bitwise_crc(0x12345678U, data, 0xEDB88320U), crc32(0x12345678U, data))
+               << length << " " << offset;
+         EXPECT_EQ(bitwise_crc(0x12345678U, data, 0x82F63B78U), crc32c(0x12345678U, data))
+               << length << " " << offset;
+         EXPECT_EQ(bitwise_crc(0x12345678U, data, 0xEDB88320U),
+                   polar::utils::internal::crc32_slicing_by_8(0x12345678U, data))
+               << length << " " << offset;
+         EXPECT_EQ(bitwise_crc(0x12345678U, data, 0x82F63B78U),
+                   polar::utils::internal::crc32c_slicing_by_8(0x12345678U, data))
+               << length << " " << offset;
+      }
+   }
+}
+
+TEST(CRCTest, testCombine)
+{
+   StringRef text = "The quick brown fox jumps over the lazy dog";
+   for (size_t split = 0; split <= text.size(); ++split) {
+      StringRef head = text.takeFront(split);
+      StringRef tail = text.dropFront(split);
+      EXPECT_EQ(crc32(0, text), crc32_combine(crc32(0, head), crc32(0, tail), tail.size()));
+      EXPECT_EQ(crc32c(0, text), crc32c_combine(crc32c(0, head), crc32c(0, tail), tail.size()));
+      // Chaining gives the same result as combining.
+      EXPECT_EQ(crc32(0, text), crc32(crc32(0, head), tail));
+   }
+   std::vector<uint8_t> zeros(1 << 20);
+   uint32_t half = crc32(0, ArrayRef<uint8_t>(zeros.data(), zeros.size() / 2));
+   EXPECT_EQ(crc32(0, zeros), crc32_combine(half, half, zeros.size() / 2));
+}
+
+TEST(CRCTest, testParallel)
+{
+   std::vector<uint8_t> data(100003);
+   for (size_t index = 0; index < data.size(); ++index) {
+      data[index] = static_cast<uint8_t>(index * 2654435761U >> 13);
+   }
+   ThreadPool pool(4);
+   // Chunks that divide the data evenly or not, and a single chunk.
+   for (size_t chunkSize : {1000, 4096, 99999, 1 << 20}) {
+      EXPECT_EQ(crc32(0, data), crc32_parallel(0, data, pool, chunkSize)) << chunkSize;
+      EXPECT_EQ(crc32c(0, data), crc32c_parallel(0, data, pool, chunkSize)) << chunkSize;
+      EXPECT_EQ(crc32(0x12345678U, data), crc32_parallel(0x12345678U, data, pool, chunkSize))
+            << chunkSize;
+   }
+   EXPECT_EQ(0U, crc32_parallel(0, ArrayRef<uint8_t>(), pool));
+}
+
+TEST(CRCTest, testJamCRC)
+{
+   JamCRC jamCrc;
+   StringRef text = "123456789";
+   jamCrc.update(ArrayRef<char>(text.getData(), 4));
+   jamCrc.update(ArrayRef<char>(text.getData() + 4, text.size() - 4));
+   // CRC-32/JAMCRC is CRC32 without the final inversion.
+   EXPECT_EQ(0x340BC6D9U, jamCrc.getCRC());
+}
+
 } // end anonymous namespace
@@ -0,0 +1,190 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/14.
+
+#include "polarphp/utils/DirectoryCrawler.h"
+#include "polarphp/basic/adt/SmallString.h"
+#include "polarphp/utils/FileSystem.h"
+#include "polarphp/utils/MemoryBuffer.h"
+#include "polarphp/utils/Path.h"
+#include "polarphp/utils/RawOutStream.h"
+#include "polarphp/utils/SpecialCaseList.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace polar;
+using namespace polar::basic;
+using namespace polar::utils;
+
+namespace {
+
+class DirectoryCrawlerTest : public testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      ASSERT_FALSE(fs::create_unique_directory("DirectoryCrawlerTest", m_root));
+      addFile("index.php");
+      addFile("README.md");
+      addFile("src/Kernel.php");
+      addFile("src/Http/Request.php");
+      addFile("src/Http/Response.php");
+      addFile("vendor/autoload.php");
+      addFile("vendor/lib/Lib.php");
+      addFile(".git/HEAD");
+   }
+
+   void TearDown() override
+   {
+      fs::remove_directories(m_root);
+   }
+
+   void addFile(StringRef relativePath)
+   {
+      SmallString<128> path(m_root);
+      fs::path::append(path, relativePath);
+      ASSERT_FALSE(fs::create_directories(fs::path::parent_path(path)));
+      std::error_code errorCode;
+      RawFdOutStream outStream(path, errorCode);
+      ASSERT_FALSE(errorCode);
+      outStream << "<?php\n";
+   }
+
+   /// The paths relative to the root, sorted.
+   std::vector<std::string> relativePaths(const std::vector<CrawlEntry> &entries)
+   {
+      std::vector<std::string> paths;
+      for (const CrawlEntry &entry : entries) {
+         EXPECT_FALSE(entry.error);
+         paths.push_back(StringRef(entry.path).substr(m_root.size() + 1).getStr());
+      }
+      std::sort(paths.begin(), paths.end());
+      return paths;
+   }
+
+   SmallString<128> m_root;
+};
+
+TEST_F(DirectoryCrawlerTest, testFindsAllFiles)
+{
+   DirectoryCrawler crawler(4);
+   std::vector<std::string> paths = relativePaths(crawler.crawl({m_root.getStr()}));
+   std::vector<std::string> expected{
+      ".git/HEAD", "README.md", "index.php", "src/Http/Request.php",
+      "src/Http/Response.php", "src/Kernel.php", "vendor/autoload.php",
+      "vendor/lib/Lib.php"
+   };
+   EXPECT_EQ(expected, paths);
+}
+
+TEST_F(DirectoryCrawlerTest, testPatterns)
+{
+   DirectoryCrawler crawler(2);
+   crawler.setSkipHiddenEntries(true);
+   ASSERT_FALSE(bool(crawler.addIncludePattern("*.php")));
+   ASSERT_FALSE(bool(crawler.addExcludePattern("vendor")));
+   ASSERT_FALSE(bool(crawler.addExcludePattern("*/Response.php")));
+   std::vector<std::string> paths = relativePaths(crawler.crawl({m_root.getStr()}));
+   std::vector<std::string> expected{
+      "index.php", "src/Http/Request.php", "src/Kernel.php"
+   };
+   EXPECT_EQ(expected, paths);
+}
+
+TEST_F(DirectoryCrawlerTest, testSpecialCaseList)
+{
+   std::unique_ptr<MemoryBuffer> buffer = MemoryBuffer::getMemBuffer(
+            "[crawl]\nsrc:src/Http\nsrc:*.md\n");
+   std::string error;
+   std::unique_ptr<SpecialCaseList> list = SpecialCaseList::create(buffer.get(), error);
+   ASSERT_TRUE(list != nullptr) << error;
+   DirectoryCrawler crawler(2);
+   crawler.setSkipHiddenEntries(true);
+   crawler.setSpecialCaseList(list.get(), "crawl");
+   std::vector<std::string> paths = relativePaths(crawler.crawl({m_root.getStr()}));
+   std::vector<std::string> expected{
+      "index.php", "src/Kernel.php", "vendor/autoload.php", "vendor/lib/Lib.php"
+   };
+   EXPECT_EQ(expected, paths);
+}
+
+TEST_F(DirectoryCrawlerTest, testStreamingAndErrors)
+{
+   SmallString<128> missing(m_root);
+   fs::path::append(missing, "missing");
+   DirectoryCrawler crawler(3);
+   ASSERT_FALSE(bool(crawler.addIncludePattern("src/*")));
+   CrawlQueue queue;
+   crawler.start({m_root.getStr(), missing.getStr()}, queue);
+   std::vector<CrawlEntry> found;
+   unsigned errors = 0;
+   CrawlEntry entry;
+   while (queue.pop(entry)) {
+      if (entry.error) {
+         EXPECT_EQ(missing.getStr(), entry.path);
+         ++errors;
+      } else {
+         found.push_back(entry);
+      }
+   }
+   crawler.wait();
+   EXPECT_EQ(1u, errors);
+   EXPECT_EQ(3u, found.size());
+}
+
+TEST_F(DirectoryCrawlerTest, testFollowSymlinks)
+{
+   SmallString<128> link(m_root);
+   fs::path::append(link, "src", "Loop");
+   ASSERT_FALSE(fs::create_link(m_root, link));
+
+   DirectoryCrawler crawler(2);
+   crawler.setSkipHiddenEntries(true);
+   ASSERT_FALSE(bool(crawler.addExcludePattern("vendor")));
+   std::vector<std::string> paths = relativePaths(crawler.crawl({m_root.getStr()}));
+   EXPECT_EQ(6u, paths.size());
+   EXPECT_TRUE(std::find(paths.begin(), paths.end(), "src/Loop") != paths.end());
+
+   // Following the link does not read the root a second time.
+   crawler.setFollowSymlinks(true);
+   paths = relativePaths(crawler.crawl({m_root.getStr()}));
+   std::vector<std::string> expected{
+      "README.md", "index.php", "src/Http/Request.php",
+      "src/Http/Response.php", "src/Kernel.php"
+   };
+   EXPECT_EQ(expected, paths);
+}
+
+TEST_F(DirectoryCrawlerTest, testNonRecursive)
+{
+   DirectoryCrawler crawler(2);
+   crawler.setRecursive(false);
+   std::vector<CrawlEntry> entries = crawler.crawl({m_root.getStr()});
+   std::vector<std::string> expected{
+      ".git", "README.md", "index.php", "src", "vendor"
+   };
+   EXPECT_EQ(expected, relativePaths(entries));
+   for (const CrawlEntry &entry : entries) {
+      StringRef name = fs::path::filename(entry.path);
+      bool isDirectory = name == ".git" || name == "src" || name == "vendor";
+      EXPECT_EQ(isDirectory, entry.type == FileType::directory_file) << entry.path;
+   }
+
+   // The filters still apply to the subdirectories.
+   crawler.setSkipHiddenEntries(true);
+   ASSERT_FALSE(bool(crawler.addExcludePattern("vendor")));
+   expected = {"README.md", "index.php", "src"};
+   EXPECT_EQ(expected, relativePaths(crawler.crawl({m_root.getStr()})));
+}
+
+} // anonymous namespace
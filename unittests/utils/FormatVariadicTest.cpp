@@ -493,6 +493,11 @@ TEST(FormatVariadicTest, testDoubleFormatting) {
    EXPECT_EQ("  -1.100", formatv("{0,8:F3}", -1.1).getStr());
    EXPECT_EQ("1234.568", formatv("{0,8:F3}", 1234.5678).getStr());
    EXPECT_EQ("  -0.001", formatv("{0,8:F3}", -.0012345678).getStr());
+
+   // 4. Shortest round trip format, which ignores the precision.
+   EXPECT_EQ("0.1", formatv("{0:S}", 0.1).getStr());
+   EXPECT_EQ("-1234.5678", formatv("{0:s}", -1234.5678).getStr());
+   EXPECT_EQ("   1.0E-5", formatv("{0,9:S3}", 1e-5).getStr());
 }
 
 TEST(FormatVariadicTest, testCustomPaddingCharacter)
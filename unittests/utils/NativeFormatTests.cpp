@@ -20,8 +20,12 @@
 #include "polarphp/utils/NativeFormatting.h"
 #include "polarphp/utils/RawOutStream.h"
 #include "gtest/gtest.h"
-#include <type_traits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <optional>
+#include <type_traits>
 
 using namespace polar;
 using namespace polar::basic;
@@ -122,6 +126,60 @@ TEST(NativeFormatTest, testBasicFloatingPointTests)
    EXPECT_EQ("1.35", format_number(1.346, FloatStyle::Fixed));
 }
 
+std::string format_shortest(double D)
+{
+   char buffer[sg_maxShortestDoubleLength];
+   return std::string(buffer, format_shortest_double(D, buffer));
+}
+
+TEST(NativeFormatTest, testShortestFloatingPointTests)
+{
+   EXPECT_EQ("0", format_number(0.0, FloatStyle::Shortest));
+   EXPECT_EQ("-0", format_number(-0.0, FloatStyle::Shortest));
+   EXPECT_EQ("0.1", format_number(0.1, FloatStyle::Shortest));
+   EXPECT_EQ("0.3", format_number(0.3, FloatStyle::Shortest, 2));
+   EXPECT_EQ("1", format_shortest(1.0));
+   EXPECT_EQ("-123.456", format_shortest(-123.456));
+   EXPECT_EQ("0.6666666666666666", format_shortest(2.0 / 3.0));
+   EXPECT_EQ("873.1834", format_shortest(873.1834));
+   EXPECT_EQ("9007199254740992", format_shortest(9007199254740993.0));
+   EXPECT_EQ("0.0001", format_shortest(1e-4));
+   EXPECT_EQ("1.0E-5", format_shortest(1e-5));
+   EXPECT_EQ("1.25E-5", format_shortest(1.25e-5));
+   EXPECT_EQ("10000000000000000", format_shortest(1e16));
+   EXPECT_EQ("1.0E+17", format_shortest(1e17));
+   EXPECT_EQ("1.0E+25", format_shortest(1e25));
+   EXPECT_EQ("5.0E-324", format_shortest(std::numeric_limits<double>::denorm_min()));
+   EXPECT_EQ("2.2250738585072014E-308", format_shortest(std::numeric_limits<double>::min()));
+   EXPECT_EQ("-1.7976931348623157E+308", format_shortest(-std::numeric_limits<double>::max()));
+   EXPECT_EQ("NAN", format_shortest(std::numeric_limits<double>::quiet_NaN()));
+   EXPECT_EQ("INF", format_shortest(std::numeric_limits<double>::infinity()));
+   EXPECT_EQ("-INF", format_shortest(-std::numeric_limits<double>::infinity()));
+
+   DecimalDouble decimal = to_shortest_decimal(-1.5e300);
+   EXPECT_EQ(15u, decimal.digits);
+   EXPECT_EQ(299, decimal.exponent);
+   decimal = to_shortest_decimal(1200.0);
+   EXPECT_EQ(12u, decimal.digits);
+   EXPECT_EQ(2, decimal.exponent);
+
+   // Every value must read back as itself, with no more than 17 digits.
+   uint64_t state = 0x9e3779b97f4a7c15;
+   for (unsigned index = 0; index < 100000; ++index) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      double value;
+      std::memcpy(&value, &state, sizeof(value));
+      if (!std::isfinite(value)) {
+         continue;
+      }
+      std::string str = format_shortest(value);
+      EXPECT_EQ(value, std::strtod(str.c_str(), nullptr)) << str;
+      EXPECT_LE(to_shortest_decimal(value).digits, 99999999999999999u) << str;
+   }
+}
+
 // Test common boundary cases and min/max conditions.
 TEST(NativeFormatTest, testBoundaryTests)
 {
@@ -0,0 +1,61 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "polarphp/utils/RawXxh3OutStream.h"
+#include "gtest/gtest.h"
+
+using namespace polar::utils;
+
+namespace {
+
+TEST(RawXxh3OutStreamTest, testBasic)
+{
+   RawXxh3OutStream xxh3Stream;
+   xxh3Stream << "Hello World!";
+   EXPECT_EQ("bbce2257f0cec895f56f7a348bed5898", xxh3Stream.getHash128().getDigest());
+   EXPECT_EQ(0x673e3c493921a2d5U, xxh3Stream.getHash64());
+   EXPECT_EQ(12U, xxh3Stream.tell());
+}
+
+// Check that getting the intermediate hash in the middle of the stream does
+// not invalidate the final result.
+TEST(RawXxh3OutStreamTest, testIntermediate)
+{
+   RawXxh3OutStream xxh3Stream;
+   xxh3Stream << "Hello";
+   EXPECT_EQ("1bfd09d1a433fb78117b4c7b1583d16d", xxh3Stream.getHash128().getDigest());
+   xxh3Stream << " World!";
+   EXPECT_EQ("bbce2257f0cec895f56f7a348bed5898", xxh3Stream.getHash128().getDigest());
+}
+
+TEST(RawXxh3OutStreamTest, testReset)
+{
+   RawXxh3OutStream xxh3Stream;
+   xxh3Stream << "Hello";
+   xxh3Stream.resetHash();
+   xxh3Stream << " World!";
+   EXPECT_EQ("0bb06b5383d104348c930579da26dcbf", xxh3Stream.getHash128().getDigest());
+}
+
+TEST(RawXxh3OutStreamTest, testLargeWrites)
+{
+   std::string content;
+   RawXxh3OutStream xxh3Stream(42);
+   for (unsigned i = 0; i < 2000; ++i) {
+      std::string line = "line " + std::to_string(i) + "\n";
+      content += line;
+      xxh3Stream << line;
+   }
+   EXPECT_EQ(xxh3_hash64(content, 42), xxh3Stream.getHash64());
+   EXPECT_EQ(xxh3_hash128(content, 42), xxh3Stream.getHash128());
+}
+
+} // anonymous namespace
@@ -0,0 +1,165 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/04.
+
+#include "polarphp/basic/SegmentedAppendingBinaryByteStream.h"
+#include "polarphp/basic/ByteTreeDeserialization.h"
+#include "polarphp/basic/ByteTreeSerialization.h"
+#include "polarphp/basic/adt/SmallString.h"
+#include "polarphp/utils/BinaryStreamReader.h"
+#include "polarphp/utils/BinaryStreamWriter.h"
+#include "polarphp/utils/FileSystem.h"
+#include "polarphp/utils/MemoryBuffer.h"
+#include "polarphp/utils/Process.h"
+#include "../support/Error.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace polar::basic;
+using namespace polar::utils;
+using namespace polar;
+using polar::sys::Process;
+
+namespace {
+
+using polar::unittest::Succeeded;
+using polar::unittest::Failed;
+
+std::vector<uint8_t> make_pattern(size_t size)
+{
+   std::vector<uint8_t> data(size);
+   for (size_t index = 0; index < size; ++index) {
+      data[index] = static_cast<uint8_t>(index * 7 + 3);
+   }
+   return data;
+}
+
+std::vector<uint8_t> collect_chunks(const SegmentedAppendingBinaryByteStream &stream)
+{
+   std::vector<uint8_t> result;
+   for (size_t index = 0; index < stream.getNumChunks(); ++index) {
+      ArrayRef<uint8_t> chunk = stream.getChunk(index);
+      result.insert(result.end(), chunk.begin(), chunk.end());
+   }
+   return result;
+}
+
+TEST(SegmentedAppendingBinaryByteStreamTest, testAppendAcrossChunks)
+{
+   SegmentedAppendingBinaryByteStream stream(Endianness::Little, 16);
+   std::vector<uint8_t> data = make_pattern(100);
+   BinaryStreamWriter writer(stream);
+   // Write in odd sized pieces so that most of them straddle chunk boundaries.
+   for (size_t offset = 0; offset < data.size(); offset += 7) {
+      size_t size = std::min<size_t>(7, data.size() - offset);
+      ASSERT_THAT_ERROR(writer.writeBytes(ArrayRef<uint8_t>(data).slice(offset, size)),
+                        Succeeded());
+   }
+   EXPECT_EQ(100u, stream.getLength());
+   EXPECT_EQ(7u, stream.getNumChunks());
+   EXPECT_EQ(4u, stream.getChunk(6).size());
+   EXPECT_EQ(data, collect_chunks(stream));
+}
+
+TEST(SegmentedAppendingBinaryByteStreamTest, testReadBytes)
+{
+   SegmentedAppendingBinaryByteStream stream(Endianness::Little, 16);
+   std::vector<uint8_t> data = make_pattern(64);
+   ASSERT_THAT_ERROR(stream.writeBytes(0, data), Succeeded());
+
+   ArrayRef<uint8_t> buffer;
+   // Within one chunk the stream's own storage is returned.
+   ASSERT_THAT_ERROR(stream.readBytes(20, 8, buffer), Succeeded());
+   EXPECT_EQ(stream.getChunk(1).data() + 4, buffer.data());
+   EXPECT_EQ(ArrayRef<uint8_t>(data).slice(20, 8), buffer);
+
+   // Across chunks the bytes are still contiguous and correct.
+   ASSERT_THAT_ERROR(stream.readBytes(10, 40, buffer), Succeeded());
+   EXPECT_EQ(ArrayRef<uint8_t>(data).slice(10, 40), buffer);
+
+   ASSERT_THAT_ERROR(stream.readLongestContiguousChunk(36, buffer), Succeeded());
+   EXPECT_EQ(ArrayRef<uint8_t>(data).slice(36, 12), buffer);
+
+   EXPECT_THAT_ERROR(stream.readBytes(60, 8, buffer), Failed());
+}
+
+TEST(SegmentedAppendingBinaryByteStreamTest, testPatching)
+{
+   SegmentedAppendingBinaryByteStream stream(Endianness::Little, 8);
+   std::vector<uint8_t> data = make_pattern(32);
+   ASSERT_THAT_ERROR(stream.writeBytes(0, data), Succeeded());
+
+   // Patch inside a chunk and across a chunk boundary.
+   ASSERT_THAT_ERROR(stream.writeRaw(0, uint32_t(0xAABBCCDD)), Succeeded());
+   ASSERT_THAT_ERROR(stream.writeRaw(6, uint32_t(0x11223344)), Succeeded());
+   EXPECT_EQ(32u, stream.getLength());
+   ::memcpy(data.data(), "\xDD\xCC\xBB\xAA", 4);
+   ::memcpy(data.data() + 6, "\x44\x33\x22\x11", 4);
+   EXPECT_EQ(data, collect_chunks(stream));
+
+   // Writing past the end is not allowed, appending at the end is.
+   EXPECT_THAT_ERROR(stream.writeRaw(33, uint8_t(1)), Failed());
+   ASSERT_THAT_ERROR(stream.writeRaw(32, uint8_t(1)), Succeeded());
+   EXPECT_EQ(33u, stream.getLength());
+}
+
+TEST(SegmentedAppendingBinaryByteStreamTest, testByteTreeOutputMatches)
+{
+   ExponentialGrowthAppendingBinaryByteStream contiguous;
+   SegmentedAppendingBinaryByteStream segmented(Endianness::Little, 16);
+   bytetree::UserInfoMap userInfo;
+   bytetree::ByteTreeWriter::write(contiguous, 3, std::nullopt, userInfo);
+   bytetree::ByteTreeWriter::write(segmented, 3, std::nullopt, userInfo);
+   EXPECT_EQ(std::vector<uint8_t>(contiguous.data().begin(), contiguous.data().end()),
+             collect_chunks(segmented));
+
+   std::vector<uint8_t> bytes = collect_chunks(segmented);
+   bytetree::ByteTreeReader reader{ArrayRef<uint8_t>(bytes)};
+   uint32_t version;
+   uint32_t numFields;
+   ASSERT_THAT_ERROR(reader.readProtocolVersion(version), Succeeded());
+   EXPECT_EQ(3u, version);
+   ASSERT_THAT_ERROR(reader.readObjectHeader(numFields), Succeeded());
+   EXPECT_EQ(0u, numFields);
+}
+
+TEST(SegmentedAppendingBinaryByteStreamTest, testWriteToFile)
+{
+   SegmentedAppendingBinaryByteStream stream(Endianness::Little, 4096);
+   std::vector<uint8_t> data = make_pattern(3 * 4096 + 123);
+   ASSERT_THAT_ERROR(stream.writeBytes(0, data), Succeeded());
+
+   SmallString<128> testDirectory;
+   ASSERT_FALSE(fs::create_unique_directory("SegmentedStream-test", testDirectory));
+   SmallString<128> viaBuffer(testDirectory);
+   viaBuffer.append("/buffer");
+   SmallString<128> viaDescriptor(testDirectory);
+   viaDescriptor.append("/descriptor");
+
+   ASSERT_THAT_ERROR(stream.writeToFile(viaBuffer), Succeeded());
+   int fd;
+   ASSERT_FALSE(fs::open_file_for_write(viaDescriptor, fd));
+   ASSERT_THAT_ERROR(stream.writeToFileDescriptor(fd), Succeeded());
+   ASSERT_FALSE(Process::safelyCloseFileDescriptor(fd));
+
+   for (StringRef path : {viaBuffer.getStr(), viaDescriptor.getStr()}) {
+      auto bufferOrError = MemoryBuffer::getFile(path);
+      ASSERT_TRUE(bool(bufferOrError));
+      StringRef contents = (*bufferOrError)->getBuffer();
+      EXPECT_EQ(StringRef(reinterpret_cast<const char *>(data.data()), data.size()),
+                contents);
+      EXPECT_FALSE(fs::remove(path));
+   }
+   EXPECT_FALSE(fs::remove(testDirectory.getStr()));
+}
+
+} // anonymous namespace
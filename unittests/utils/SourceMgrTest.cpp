@@ -554,4 +554,101 @@ TEST_F(SourceMgrTest, testFixitForTab)
              output);
 }
 
+TEST_F(SourceMgrTest, testFindBufferContainingLocWithManyBuffers)
+{
+   std::vector<std::string> texts;
+   for (unsigned index = 0; index < 200; ++index) {
+      texts.push_back("buffer " + std::to_string(index) + "\n");
+   }
+   std::vector<unsigned> bufferIDs;
+   for (const std::string &text : texts) {
+      bufferIDs.push_back(SM.addNewSourceBuffer(MemoryBuffer::getMemBufferCopy(text),
+                                                SMLocation()));
+   }
+   // Look the buffers up out of order so the last-hit cache misses.
+   for (unsigned step = 0; step < 2; ++step) {
+      for (unsigned index = step; index < bufferIDs.size(); index += 2) {
+         const MemoryBuffer *buffer = SM.getMemoryBuffer(bufferIDs[index]);
+         const char *start = buffer->getBufferStart();
+         EXPECT_EQ(bufferIDs[index], SM.findBufferContainingLoc(SMLocation::getFromPointer(start)));
+         EXPECT_EQ(bufferIDs[index], SM.findBufferContainingLoc(
+                      SMLocation::getFromPointer(start + buffer->getBufferSize())));
+         EXPECT_EQ(bufferIDs[index], SM.findLastBufferContainingLoc(
+                      SMLocation::getFromPointer(start + 3)));
+      }
+   }
+   char outside = 0;
+   EXPECT_EQ(0U, SM.findBufferContainingLoc(SMLocation::getFromPointer(&outside)));
+}
+
+TEST_F(SourceMgrTest, testFindBufferContainingLocWithAliasBuffers)
+{
+   StringRef text = "aaa bbb\nccc ddd\n";
+   unsigned outerID = SM.addNewSourceBuffer(MemoryBuffer::getMemBuffer(text, "outer"),
+                                            SMLocation());
+   unsigned innerID = SM.addNewSourceBuffer(
+            MemoryBuffer::getMemBuffer(text.substr(4, 7), "inner", false), SMLocation());
+   unsigned otherID = SM.addNewSourceBuffer(MemoryBuffer::getMemBufferCopy("other"),
+                                            SMLocation());
+   SMLocation inBoth = SMLocation::getFromPointer(text.data() + 5);
+   SMLocation outerOnly = SMLocation::getFromPointer(text.data() + 1);
+   EXPECT_EQ(outerID, SM.findBufferContainingLoc(inBoth));
+   EXPECT_EQ(innerID, SM.findLastBufferContainingLoc(inBoth));
+   EXPECT_EQ(outerID, SM.findBufferContainingLoc(outerOnly));
+   EXPECT_EQ(outerID, SM.findLastBufferContainingLoc(outerOnly));
+   EXPECT_EQ(otherID, SM.findLastBufferContainingLoc(SMLocation::getFromPointer(
+                                                        SM.getMemoryBuffer(otherID)->getBufferStart())));
+}
+
+TEST_F(SourceMgrTest, testLineAndColumn)
+{
+   setMainBuffer("aaa\nbb\r\ncc\rdd\n\nee", "file.in");
+   EXPECT_EQ(std::make_pair(1U, 1U), SM.getLineAndColumn(getLoc(0)));
+   EXPECT_EQ(std::make_pair(1U, 4U), SM.getLineAndColumn(getLoc(3)));
+   EXPECT_EQ(std::make_pair(2U, 1U), SM.getLineAndColumn(getLoc(4)));
+   // The '\n' of "\r\n" is in column 1 after the '\r'.
+   EXPECT_EQ(std::make_pair(2U, 1U), SM.getLineAndColumn(getLoc(7)));
+   EXPECT_EQ(std::make_pair(3U, 2U), SM.getLineAndColumn(getLoc(9)));
+   // A lone '\r' starts a new column but not a new line.
+   EXPECT_EQ(std::make_pair(3U, 1U), SM.getLineAndColumn(getLoc(11)));
+   EXPECT_EQ(std::make_pair(4U, 1U), SM.getLineAndColumn(getLoc(14)));
+   EXPECT_EQ(std::make_pair(5U, 3U), SM.getLineAndColumn(getLoc(17)));
+}
+
+TEST_F(SourceMgrTest, testLineAndUtf8Column)
+{
+   // Make the second line long enough to span several blocks of the index.
+   std::string text = "x\n";
+   for (unsigned index = 0; index < 3000; ++index) {
+      text += "\xC3\xA4";
+   }
+   text += "end";
+   setMainBuffer(text, "file.in");
+   EXPECT_EQ(std::make_pair(1U, 2U), SM.getLineAndUtf8Column(getLoc(1)));
+   EXPECT_EQ(std::make_pair(2U, 1U), SM.getLineAndUtf8Column(getLoc(2)));
+   EXPECT_EQ(std::make_pair(2U, 2U), SM.getLineAndUtf8Column(getLoc(4)));
+   EXPECT_EQ(std::make_pair(2U, 3001U), SM.getLineAndUtf8Column(getLoc(6002)));
+   EXPECT_EQ(std::make_pair(2U, 3003U), SM.getLineAndUtf8Column(getLoc(6004)));
+   EXPECT_EQ(std::make_pair(2U, 6003U), SM.getLineAndColumn(getLoc(6004)));
+}
+
+TEST_F(SourceMgrTest, testLinesAndColumns)
+{
+   setMainBuffer("a\xC3\xA4" "b\ncc\r\nddd\n", "file.in");
+   SMLocation locations[] = {getLoc(0), getLoc(3), getLoc(3), getLoc(5), getLoc(9), getLoc(11)};
+   SmallVector<std::pair<unsigned, unsigned>, 8> byteColumns;
+   SM.getLinesAndColumns(locations, mainBufferID, byteColumns);
+   SmallVector<std::pair<unsigned, unsigned>, 8> utf8Columns;
+   SM.getLinesAndColumns(locations, mainBufferID, utf8Columns, true);
+   ASSERT_EQ(6U, byteColumns.size());
+   ASSERT_EQ(6U, utf8Columns.size());
+   for (size_t index = 0; index < 6; ++index) {
+      EXPECT_EQ(SM.getLineAndColumn(locations[index]), byteColumns[index]);
+      EXPECT_EQ(SM.getLineAndUtf8Column(locations[index]), utf8Columns[index]);
+   }
+   EXPECT_EQ(std::make_pair(1U, 4U), byteColumns[1]);
+   EXPECT_EQ(std::make_pair(1U, 3U), utf8Columns[1]);
+   EXPECT_EQ(std::make_pair(3U, 3U), byteColumns[5]);
+}
+
 } // anonymous namespace
@@ -28,8 +28,10 @@
 #include "polarphp/basic/adt/IntrusiveRefCountPtr.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <map>
 #include <string>
+#include <thread>
 
 using namespace polar;
 using namespace polar::basic;
@@ -953,6 +955,189 @@ TEST(VirtualFileSystemTest, testBasicProxy) {
    EXPECT_FALSE(Local);
 }
 
+namespace {
+
+/// Counts the calls that reach the wrapped file system.
+class CountingFileSystem : public vfs::ProxyFileSystem
+{
+public:
+   explicit CountingFileSystem(IntrusiveRefCountPtr<vfs::FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+   OptionalError<vfs::Status> getStatus(const Twine &path) override {
+      ++StatusCalls;
+      if (Failure) {
+         return Failure;
+      }
+      return ProxyFileSystem::getStatus(path);
+   }
+   OptionalError<std::unique_ptr<vfs::File>>
+   openFileForRead(const Twine &path) override {
+      ++OpenCalls;
+      return ProxyFileSystem::openFileForRead(path);
+   }
+   vfs::DirectoryIterator dirBegin(const Twine &Dir,
+                                   std::error_code &errorCode) override {
+      ++DirCalls;
+      if (Failure) {
+         errorCode = Failure;
+         return vfs::DirectoryIterator();
+      }
+      return ProxyFileSystem::dirBegin(Dir, errorCode);
+   }
+
+   /// When set, status and directory requests fail with it.
+   std::error_code Failure;
+   unsigned StatusCalls = 0;
+   unsigned OpenCalls = 0;
+   unsigned DirCalls = 0;
+};
+
+} // end anonymous namespace
+
+TEST(VirtualFileSystemTest, testCachingStatus) {
+   IntrusiveRefCountPtr<vfs::InMemoryFileSystem> Base(
+            new vfs::InMemoryFileSystem());
+   Base->addFile("/dir/a.php", 0, MemoryBuffer::getMemBuffer("<?php"));
+   IntrusiveRefCountPtr<CountingFileSystem> Counting(new CountingFileSystem(Base));
+   vfs::CachingFileSystem CFS(Counting);
+   ASSERT_FALSE(CFS.setCurrentWorkingDirectory("/dir"));
+
+   for (int I = 0; I < 3; ++I) {
+      auto Stat = CFS.getStatus("/dir/a.php");
+      ASSERT_FALSE(Stat.getError());
+      EXPECT_TRUE(Stat->isRegularFile());
+      EXPECT_EQ("/dir/a.php", Stat->getName());
+      EXPECT_EQ(ErrorCode::no_such_file_or_directory,
+                CFS.getStatus("/vendor/autoload.php").getError());
+   }
+   EXPECT_EQ(2u, Counting->StatusCalls);
+
+   // Relative paths share the entries of the working directory, but keep
+   // their own spelling.
+   auto Relative = CFS.getStatus("a.php");
+   ASSERT_FALSE(Relative.getError());
+   EXPECT_EQ("a.php", Relative->getName());
+   EXPECT_EQ(2u, Counting->StatusCalls);
+
+   // A path known not to exist does not reach the wrapped file system.
+   EXPECT_TRUE(CFS.openFileForRead("/vendor/autoload.php").getError());
+   EXPECT_EQ(0u, Counting->OpenCalls);
+   auto File = CFS.openFileForRead("/dir/a.php");
+   ASSERT_FALSE(File.getError());
+   EXPECT_EQ("<?php", (*(*File)->getBuffer("ignored"))->getBuffer());
+   EXPECT_EQ(1u, Counting->OpenCalls);
+
+   vfs::CachingFileSystem::Statistics Stats = CFS.getStatistics();
+   EXPECT_EQ(5u, Stats.statusHits);
+   EXPECT_EQ(2u, Stats.negativeStatusHits);
+   EXPECT_EQ(2u, Stats.statusMisses);
+   EXPECT_EQ(1u, Stats.openHits);
+   EXPECT_EQ(1u, Stats.openMisses);
+}
+
+TEST(VirtualFileSystemTest, testCachingInvalidation) {
+   IntrusiveRefCountPtr<vfs::InMemoryFileSystem> Base(
+            new vfs::InMemoryFileSystem());
+   Base->addFile("/dir/a.php", 0, MemoryBuffer::getMemBuffer("a"));
+   IntrusiveRefCountPtr<CountingFileSystem> Counting(new CountingFileSystem(Base));
+   vfs::CachingFileSystem CFS(Counting);
+
+   EXPECT_TRUE(CFS.getStatus("/dir/b.php").getError());
+   EXPECT_TRUE(CFS.openFileForRead("/dir/c.php").getError());
+   Base->addFile("/dir/b.php", 0, MemoryBuffer::getMemBuffer("b"));
+   Base->addFile("/dir/c.php", 0, MemoryBuffer::getMemBuffer("c"));
+   EXPECT_TRUE(CFS.getStatus("/dir/b.php").getError());
+   EXPECT_TRUE(CFS.openFileForRead("/dir/c.php").getError());
+
+   CFS.invalidate("/dir/b.php");
+   EXPECT_FALSE(CFS.getStatus("/dir/b.php").getError());
+   EXPECT_TRUE(CFS.openFileForRead("/dir/c.php").getError());
+   CFS.invalidateAll();
+   EXPECT_FALSE(CFS.openFileForRead("/dir/c.php").getError());
+
+   // With a time to live the entries expire on their own.
+   Base->addFile("/dir/d.php", 0, MemoryBuffer::getMemBuffer("d"));
+   CFS.setTimeToLive(std::chrono::nanoseconds(1));
+   unsigned Calls = Counting->StatusCalls;
+   EXPECT_FALSE(CFS.getStatus("/dir/d.php").getError());
+   std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   EXPECT_FALSE(CFS.getStatus("/dir/d.php").getError());
+   EXPECT_EQ(Calls + 2, Counting->StatusCalls);
+}
+
+TEST(VirtualFileSystemTest, testCachingDirectories) {
+   IntrusiveRefCountPtr<vfs::InMemoryFileSystem> Base(
+            new vfs::InMemoryFileSystem());
+   Base->addFile("/dir/a.php", 0, MemoryBuffer::getMemBuffer("a"));
+   Base->addFile("/dir/sub/b.php", 0, MemoryBuffer::getMemBuffer("b"));
+   IntrusiveRefCountPtr<CountingFileSystem> Counting(new CountingFileSystem(Base));
+   vfs::CachingFileSystem CFS(Counting);
+
+   for (int I = 0; I < 2; ++I) {
+      std::error_code errorCode;
+      std::vector<std::string> Entries;
+      for (vfs::DirectoryIterator Iter = CFS.dirBegin("/dir", errorCode), End;
+           !errorCode && Iter != End; Iter.increment(errorCode)) {
+         Entries.push_back(getPosixPath(Iter->path()));
+      }
+      ASSERT_FALSE(errorCode);
+      std::sort(Entries.begin(), Entries.end());
+      ASSERT_EQ(2u, Entries.size());
+      EXPECT_EQ("/dir/a.php", Entries[0]);
+      EXPECT_EQ("/dir/sub", Entries[1]);
+
+      CFS.dirBegin("/missing", errorCode);
+      EXPECT_TRUE(errorCode);
+   }
+   EXPECT_EQ(2u, Counting->DirCalls);
+   EXPECT_EQ(2u, CFS.getStatistics().directoryHits);
+
+   // Adding a file changes the listing of its directory.
+   Base->addFile("/dir/c.php", 0, MemoryBuffer::getMemBuffer("c"));
+   CFS.invalidate("/dir/c.php");
+   std::error_code errorCode;
+   unsigned Count = 0;
+   for (vfs::DirectoryIterator Iter = CFS.dirBegin("/dir", errorCode), End;
+        !errorCode && Iter != End; Iter.increment(errorCode)) {
+      ++Count;
+   }
+   EXPECT_EQ(3u, Count);
+}
+
+TEST(VirtualFileSystemTest, testCachingTransientErrors) {
+   IntrusiveRefCountPtr<vfs::InMemoryFileSystem> Base(
+            new vfs::InMemoryFileSystem());
+   Base->addFile("/dir/a.php", 0, MemoryBuffer::getMemBuffer("a"));
+   IntrusiveRefCountPtr<CountingFileSystem> Counting(new CountingFileSystem(Base));
+   vfs::CachingFileSystem CFS(Counting);
+
+   // Failures other than a missing file are not remembered.
+   Counting->Failure = std::make_error_code(std::errc::too_many_files_open);
+   EXPECT_EQ(std::errc::too_many_files_open, CFS.getStatus("/dir/a.php").getError());
+   std::error_code errorCode;
+   CFS.dirBegin("/dir", errorCode);
+   EXPECT_EQ(std::errc::too_many_files_open, errorCode);
+   Counting->Failure = std::make_error_code(std::errc::permission_denied);
+   EXPECT_EQ(std::errc::permission_denied, CFS.getStatus("/dir/a.php").getError());
+
+   Counting->Failure = std::error_code();
+   EXPECT_FALSE(CFS.getStatus("/dir/a.php").getError());
+   std::error_code listError;
+   vfs::DirectoryIterator Iter = CFS.dirBegin("/dir", listError);
+   ASSERT_FALSE(listError);
+   EXPECT_EQ("/dir/a.php", getPosixPath(Iter->path()));
+   EXPECT_EQ(3u, Counting->StatusCalls);
+   EXPECT_EQ(2u, Counting->DirCalls);
+
+   // A missing file is.
+   Counting->Failure = std::make_error_code(std::errc::no_such_file_or_directory);
+   EXPECT_TRUE(CFS.getStatus("/dir/b.php").getError());
+   Counting->Failure = std::error_code();
+   EXPECT_TRUE(CFS.getStatus("/dir/b.php").getError());
+   EXPECT_EQ(4u, Counting->StatusCalls);
+}
+
 class InMemoryFileSystemTest : public ::testing::Test
 {
 protected:
@@ -1064,13 +1249,18 @@ TEST_F(InMemoryFileSystemTest, testDirectoryIteration)
    std::error_code errorCode;
    vfs::DirectoryIterator I = FS.dirBegin("/", errorCode);
    ASSERT_FALSE(errorCode);
-   ASSERT_EQ("/a", I->path());
-   I.increment(errorCode);
-   ASSERT_FALSE(errorCode);
-   ASSERT_EQ("/b", I->path());
-   I.increment(errorCode);
-   ASSERT_FALSE(errorCode);
+   // The entries come in hash order.
+   std::vector<std::string> paths;
+   for (int index = 0; index < 2; ++index) {
+      ASSERT_NE(vfs::DirectoryIterator(), I);
+      paths.push_back(I->path());
+      I.increment(errorCode);
+      ASSERT_FALSE(errorCode);
+   }
    ASSERT_EQ(vfs::DirectoryIterator(), I);
+   std::sort(paths.begin(), paths.end());
+   ASSERT_EQ("/a", paths[0]);
+   ASSERT_EQ("/b", paths[1]);
 
    I = FS.dirBegin("/b", errorCode);
    ASSERT_FALSE(errorCode);
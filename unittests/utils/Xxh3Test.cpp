@@ -0,0 +1,134 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2019 polarphp software foundation
+// Copyright (c) 2017 - 2019 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/07/16.
+
+#include "polarphp/utils/Xxh3.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace polar::utils;
+
+namespace {
+
+struct HashSample
+{
+   size_t length;
+   uint64_t hash64;
+   uint64_t low64;
+   uint64_t high64;
+};
+
+// Lengths at the edges of every code path, hashed with xxHash 0.8.2.
+const HashSample sg_unseededSamples[] = {
+   {0, 0x2d06800538d394c2ULL, 0x6001c324468d497fULL, 0x99aa06d3014798d8ULL},
+   {1, 0x324714f62fca15ceULL, 0x324714f62fca15ceULL, 0xf5950428e527e5baULL},
+   {3, 0xba1f63906a243fe3ULL, 0xba1f63906a243fe3ULL, 0x9e43192baa7c6ac5ULL},
+   {4, 0x485dc06788e22938ULL, 0xc1f521bbe4d6cea7ULL, 0x8046bc63dfcc2087ULL},
+   {8, 0xfc9c51157f9dc270ULL, 0xab75705d5f1601d0ULL, 0xfb68a18f00d5a259ULL},
+   {9, 0x488cc492d0c67caeULL, 0xca75836a063d7f5aULL, 0xb7b32f87e3967cadULL},
+   {16, 0xf36a7b9e4142befbULL, 0x0b5aa12589656b9dULL, 0xb9a9da162f904509ULL},
+   {17, 0x09556bc305612284ULL, 0xe554430ac879d960ULL, 0xc2f808c0cb50a0faULL},
+   {128, 0xfbde93d30edba066ULL, 0x54bdbd51c69322b6ULL, 0xaa14e5172f0993e2ULL},
+   {129, 0x7abff83234eec985ULL, 0x4e749970aa17b857ULL, 0x43e94c4a81aeaee0ULL},
+   {240, 0x5c2ea2814dfd07d9ULL, 0xd9de4149dc8e6783ULL, 0x7ea8cbde183e55a3ULL},
+   {241, 0x713a7042ea992fccULL, 0x713a7042ea992fccULL, 0x66254c63f3889c75ULL},
+   {1024, 0x2b86d47a4334dae8ULL, 0x2b86d47a4334dae8ULL, 0xd71909ac3456acfaULL},
+   {4096, 0xd18bbd493556b42cULL, 0xd18bbd493556b42cULL, 0xc834335b7f4bdca2ULL},
+};
+
+const uint64_t sg_seed = 0x9E3779B97F4A7C15ULL;
+
+const HashSample sg_seededSamples[] = {
+   {0, 0x602b0e2cd6662c8bULL, 0x4ca5176998171787ULL, 0xd142977a2cca554bULL},
+   {1, 0xb9173778ba46d55dULL, 0xb9173778ba46d55dULL, 0xeda9a492b0498300ULL},
+   {3, 0x99f6815bd998e883ULL, 0x99f6815bd998e883ULL, 0x39666567a9b2d3cbULL},
+   {4, 0x1c644774ef2d47c6ULL, 0x28731fa3daa59953ULL, 0x5edd106a9b037954ULL},
+   {8, 0x053a7c44d4054a32ULL, 0xb7c92e9be5adb69eULL, 0xe95db3cbf964234aULL},
+   {9, 0xd5a79e11eeb2ce38ULL, 0x38513f1d7c84b30bULL, 0x92202209c8aedc8dULL},
+   {16, 0x4a3d1a29b5607a21ULL, 0x26ea8f960af53ed4ULL, 0xfd7cfd63c50e7013ULL},
+   {17, 0xc5b71552456ac26fULL, 0xa0a62481ae8e1c31ULL, 0x5f93be360dfa9013ULL},
+   {128, 0xdcb313fcf57e4ac0ULL, 0x55ffcb823a77eb26ULL, 0xaf66abfa2ba36690ULL},
+   {129, 0x15d97be63b76ff25ULL, 0x01bf7bc8a64b126aULL, 0x97006a51e7d87ae3ULL},
+   {240, 0xcc6e9fb6086cfefeULL, 0xa21b398a232b6d13ULL, 0x5ceed905859d36b2ULL},
+   {241, 0xf3c29e7945d7932bULL, 0xf3c29e7945d7932bULL, 0xca17b104e407398cULL},
+   {1024, 0xd9a308a1db330a01ULL, 0xd9a308a1db330a01ULL, 0xcb43ffc357061af9ULL},
+   {4096, 0xfe7e4ea9af5d37f4ULL, 0xfe7e4ea9af5d37f4ULL, 0xf378f2e76da2261cULL},
+};
+
+std::vector<uint8_t> make_input(size_t length)
+{
+   std::vector<uint8_t> input(length);
+   uint64_t state = 0;
+   for (uint8_t &byte : input) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      byte = static_cast<uint8_t>(state >> 56);
+   }
+   return input;
+}
+
+TEST(Xxh3Test, testKnownValues)
+{
+   std::vector<uint8_t> input = make_input(4096);
+   for (const HashSample &sample : sg_unseededSamples) {
+      ArrayRef<uint8_t> data(input.data(), sample.length);
+      EXPECT_EQ(sample.hash64, xxh3_hash64(data)) << sample.length;
+      EXPECT_EQ((Hash128{sample.low64, sample.high64}), xxh3_hash128(data)) << sample.length;
+   }
+   for (const HashSample &sample : sg_seededSamples) {
+      ArrayRef<uint8_t> data(input.data(), sample.length);
+      EXPECT_EQ(sample.hash64, xxh3_hash64(data, sg_seed)) << sample.length;
+      EXPECT_EQ((Hash128{sample.low64, sample.high64}), xxh3_hash128(data, sg_seed)) << sample.length;
+   }
+   EXPECT_EQ(0xab6e5f64077e7d8aU, xxh3_hash64("foo"));
+}
+
+TEST(Xxh3Test, testDigest)
+{
+   EXPECT_EQ("99aa06d3014798d86001c324468d497f", xxh3_hash128("").getDigest());
+   EXPECT_EQ("bbce2257f0cec895f56f7a348bed5898", xxh3_hash128("Hello World!").getDigest());
+}
+
+TEST(Xxh3Test, testStreaming)
+{
+   std::vector<uint8_t> input = make_input(4096);
+   for (const HashSample &sample : sg_seededSamples) {
+      for (size_t chunkSize : {1, 7, 64, 100, 256, 300, 4096}) {
+         Xxh3 hasher(sg_seed);
+         for (size_t offset = 0; offset < sample.length; offset += chunkSize) {
+            size_t size = std::min(chunkSize, sample.length - offset);
+            hasher.update(ArrayRef<uint8_t>(input.data() + offset, size));
+         }
+         EXPECT_EQ(sample.length, hasher.getTotalLength());
+         EXPECT_EQ(sample.hash64, hasher.getHash64()) << sample.length << " " << chunkSize;
+         EXPECT_EQ((Hash128{sample.low64, sample.high64}), hasher.getHash128())
+               << sample.length << " " << chunkSize;
+      }
+   }
+}
+
+// Reading the hash in the middle of the stream does not disturb the state.
+TEST(Xxh3Test, testIntermediate)
+{
+   std::vector<uint8_t> input = make_input(4096);
+   Xxh3 hasher;
+   for (size_t offset = 0; offset < input.size(); offset += 97) {
+      size_t size = std::min<size_t>(97, input.size() - offset);
+      hasher.update(ArrayRef<uint8_t>(input.data() + offset, size));
+      ArrayRef<uint8_t> prefix(input.data(), offset + size);
+      ASSERT_EQ(xxh3_hash64(prefix), hasher.getHash64());
+      ASSERT_EQ(xxh3_hash128(prefix), hasher.getHash128());
+   }
+   hasher.init();
+   hasher.update("Hello World!");
+   EXPECT_EQ(xxh3_hash64("Hello World!"), hasher.getHash64());
+}
+
+} // anonymous namespace